@@ -0,0 +1,94 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+/*
+ * File:   TimerWheel_LongTest.cc
+ */
+
+#include "TimerWheel_LongTest.hh"
+
+#include <cppunit/TestAssert.h>
+
+#include <atomic>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "karabo/net/EventLoop.hh"
+#include "karabo/net/TimerWheel.hh"
+
+using karabo::net::EventLoop;
+using karabo::net::TimerWheel;
+using namespace std::chrono;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimerWheel_LongTest);
+
+
+void TimerWheel_LongTest::testScheduleCancelRate() {
+    // Benchmark of the typical timeout use case: Schedule many timeouts and cancel all of them before they expire,
+    // once with the event loop's timer wheel and once with a steady_timer each (as EventLoop::post(func, delay) and
+    // async requests did before).
+    // Event loop is started in netLongTestRunner.cc's main()
+    const unsigned int numTimeouts = 1000000;
+    const milliseconds timeout(10000);
+
+    std::clog << "\nLong testScheduleCancelRate (" << numTimeouts << " timeouts):" << std::endl;
+
+    TimerWheel::Pointer wheel = EventLoop::getTimerWheel();
+    std::atomic<unsigned int> numWheelCalls(0);
+    const auto wheelStart = steady_clock::now();
+    std::vector<TimerWheel::Id> ids(numTimeouts);
+    for (unsigned int i = 0; i < numTimeouts; ++i) {
+        ids[i] = wheel->schedule(timeout + milliseconds(i % 1000), [&numWheelCalls]() { ++numWheelCalls; });
+    }
+    for (const TimerWheel::Id id : ids) {
+        CPPUNIT_ASSERT(wheel->cancel(id));
+    }
+    const duration<double> wheelDuration = steady_clock::now() - wheelStart;
+    CPPUNIT_ASSERT_EQUAL(0ul, wheel->size());
+    std::clog << "  TimerWheel:   " << wheelDuration.count() << " s, i.e. " << numTimeouts / wheelDuration.count()
+              << " Hz" << std::endl;
+
+    // Cancelled steady_timers still call their handler (with operation_aborted) - wait for all of them
+    std::atomic<unsigned int> numAborted(0);
+    std::promise<void> allAborted;
+    const auto timerStart = steady_clock::now();
+    std::vector<std::shared_ptr<boost::asio::steady_timer>> timers(numTimeouts);
+    for (unsigned int i = 0; i < numTimeouts; ++i) {
+        auto timer = std::make_shared<boost::asio::steady_timer>(EventLoop::getIOService());
+        timer->expires_after(timeout + milliseconds(i % 1000));
+        timer->async_wait([timer, &numAborted, &allAborted, numTimeouts](const boost::system::error_code& ec) {
+            if (ec && ++numAborted == numTimeouts) allAborted.set_value();
+        });
+        timers[i] = std::move(timer);
+    }
+    for (std::shared_ptr<boost::asio::steady_timer>& timer : timers) {
+        timer->cancel();
+        timer.reset();
+    }
+    auto future = allAborted.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, future.wait_for(seconds(600)));
+    const duration<double> timerDuration = steady_clock::now() - timerStart;
+    std::clog << "  steady_timer: " << timerDuration.count() << " s, i.e. " << numTimeouts / timerDuration.count()
+              << " Hz" << std::endl;
+
+    CPPUNIT_ASSERT_EQUAL(0u, numWheelCalls.load());
+}
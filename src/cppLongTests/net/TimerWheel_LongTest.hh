@@ -0,0 +1,38 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+/*
+ * File:   TimerWheel_LongTest.hh
+ */
+
+#ifndef TIMERWHEEL_LONGTEST_HH
+#define TIMERWHEEL_LONGTEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TimerWheel_LongTest : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TimerWheel_LongTest);
+
+    CPPUNIT_TEST(testScheduleCancelRate);
+
+    CPPUNIT_TEST_SUITE_END();
+
+   private:
+    void testScheduleCancelRate();
+};
+
+#endif /* TIMERWHEEL_LONGTEST_HH */
@@ -26,13 +26,17 @@
 
 #include <cppunit/TestAssert.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "boost/shared_ptr.hpp"
 #include "karabo/data/types/StringTools.hh"
+#include "karabo/net/EventLoop.hh"
 #include "karabo/xms/SignalSlotable.hh"
 
 using namespace karabo::data;
@@ -144,3 +148,55 @@ void SignalSlotable_LongTest::testStressAsyncReplies() {
     std::clog << "Test duration: " << sec << " s, i.e. request-receiveAsync at " << numIterations / sec << " Hz"
               << std::endl;
 }
+
+
+void SignalSlotable_LongTest::testSlotCallRate() {
+    // Benchmark of slot dispatch: Several senders call the same slot of a receiver in the same process, i.e. via
+    // the in-process shortcut and thus without broker. Messages of different senders are processed in parallel.
+    const unsigned int numSenders = 4;
+    const unsigned int numCallsPerSender = 100000; // not more: all messages may be queued before being processed
+    karabo::net::EventLoop::addThread(numSenders);
+
+    auto receiver = std::make_shared<SignalSlotable>("receiver");
+    receiver->start();
+    std::atomic<unsigned int> numCalls(0);
+    std::promise<void> allCalled;
+    auto slot = [&receiver, &numCalls, &allCalled, numSenders, numCallsPerSender](unsigned int counter) {
+        receiver->reply(counter); // dropped since not requested, but exercises placing the reply
+        if (++numCalls == numSenders * numCallsPerSender) allCalled.set_value();
+    };
+    receiver->registerSlot<unsigned int>(slot, "slot");
+
+    std::vector<SignalSlotable::Pointer> senders;
+    for (unsigned int i = 0; i < numSenders; ++i) {
+        senders.push_back(std::make_shared<SignalSlotable>("sender" + toString(i)));
+        senders.back()->start();
+    }
+
+    std::clog << "Long testSlotCallRate starting (" << numSenders << " x " << numCallsPerSender << " calls): "
+              << std::flush;
+    const auto testStartTime = std::chrono::high_resolution_clock::now();
+    std::vector<std::jthread> sendThreads;
+    for (const SignalSlotable::Pointer& sender : senders) {
+        sendThreads.emplace_back([sender, numCallsPerSender]() {
+            for (unsigned int counter = 0; counter < numCallsPerSender; ++counter) {
+                sender->call("receiver", "slot", counter);
+            }
+        });
+    }
+    for (std::jthread& thread : sendThreads) {
+        thread.join();
+    }
+    std::future<void> future = allCalled.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, future.wait_for(std::chrono::seconds(600)));
+    CPPUNIT_ASSERT_EQUAL(numSenders * numCallsPerSender, numCalls.load());
+
+    float sec = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() -
+                                                                      testStartTime)
+                      .count();
+    sec /= 1000.f;
+    std::clog << "Test duration: " << sec << " s, i.e. slot calls at " << (numSenders * numCallsPerSender) / sec
+              << " Hz" << std::endl;
+
+    karabo::net::EventLoop::removeThread(numSenders);
+}
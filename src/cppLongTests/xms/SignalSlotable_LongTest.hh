@@ -31,6 +31,7 @@ class SignalSlotable_LongTest : public CPPUNIT_NS::TestFixture {
 
     CPPUNIT_TEST(testStressSyncReplies);
     CPPUNIT_TEST(testStressAsyncReplies);
+    CPPUNIT_TEST(testSlotCallRate);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -43,6 +44,7 @@ class SignalSlotable_LongTest : public CPPUNIT_NS::TestFixture {
    private:
     void testStressSyncReplies();
     void testStressAsyncReplies();
+    void testSlotCallRate();
 };
 
 #endif /* SIGNALSLOTABLE_LONGTEST_HH */
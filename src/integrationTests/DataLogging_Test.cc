@@ -30,6 +30,7 @@
 #include <future>
 #include <karabo/net/EventLoop.hh>
 #include <karabo/net/InfluxDbClientUtils.hh>
+#include <karabo/util/ColumnArchive.hh>
 #include <karabo/util/DataLogUtils.hh>
 #include <nlohmann/json.hpp>
 #include <sstream>
@@ -200,6 +201,139 @@ void DataLogging_Test::testMigrateFileLoggerData() {
 }
 
 
+void DataLogging_Test::testFileColumnarHistory() {
+    std::clog << "Testing property history from the columnar archive of the FileDataLogger ..." << std::endl;
+
+    CPPUNIT_ASSERT_NO_THROW_MESSAGE(
+          "Failed to set logger level of device server '" + m_server + "' to 'FATAL'",
+          m_deviceClient->execute(m_server, "slotLoggerLevel", KRB_TEST_MAX_TIMEOUT, "FATAL"));
+
+    const std::string deviceId(getDeviceIdPrefix() + "ColumnarHistory");
+    std::pair<bool, std::string> success =
+          m_deviceClient->instantiate(m_server, "PropertyTest", Hash("deviceId", deviceId), KRB_TEST_MAX_TIMEOUT);
+    CPPUNIT_ASSERT_MESSAGE(success.second, success.first);
+
+    // A flush interval much longer than the test: the last, not yet full block is only stored by the flushes below.
+    Hash managerConf("deviceId", "loggerManager", "flushInterval", 3600, "logger", "FileDataLogger");
+    managerConf.set<std::vector<std::string>>("serverList", {m_server});
+    managerConf.set("fileDataLogger.directory", m_fileLoggerDirectory + "/karaboHistory");
+    managerConf.set("fileDataLogger.columnarArchive", true);
+    const int blockSize = 10;
+    managerConf.set("fileDataLogger.columnarBlockSize", static_cast<unsigned int>(blockSize));
+    success = m_deviceClient->instantiate(m_server, "DataLoggerManager", managerConf, KRB_TEST_MAX_TIMEOUT);
+    CPPUNIT_ASSERT_MESSAGE(success.second, success.first);
+
+    testAllInstantiated();
+    waitUntilLogged(deviceId, "testFileColumnarHistory");
+
+    const std::string loggerId = karabo::util::DATALOGGER_PREFIX + m_server;
+    const std::string dlReader = karabo::util::DATALOGREADER_PREFIX + m_server;
+    auto flush = [this, &loggerId]() {
+        // Give the updates time to arrive at the logger before flushing
+        std::this_thread::sleep_for(200ms);
+        CPPUNIT_ASSERT_NO_THROW(m_sigSlot->request(loggerId, "flush").timeout(FLUSH_REQUEST_TIMEOUT_MILLIS).receive());
+    };
+    flush();
+    const Epochstamp beforeWrites;
+
+    // Values increasing over several blocks: the initial value logged as login starts the first block, the last value
+    // is in the block that is not yet full
+    const int numBlocks = 4;
+    const int numWrites = numBlocks * blockSize;
+    for (int i = 0; i < numWrites; ++i) {
+        CPPUNIT_ASSERT_NO_THROW(m_deviceClient->set<int>(deviceId, "int32Property", i));
+        std::this_thread::sleep_for(10ms);
+    }
+    flush();
+    const Epochstamp afterWrites;
+
+    Hash params("from", beforeWrites.toIso8601(), "to", afterWrites.toIso8601(), "maxNumData", 2 * numWrites);
+    std::string replyDevice, replyProperty;
+
+    // The columnar archive needs no index, so its history is available right away
+    std::vector<Hash> columnarFull;
+    CPPUNIT_ASSERT_NO_THROW(m_sigSlot->request(dlReader, "slotGetPropertyHistory", deviceId, "int32Property", params)
+                                  .timeout(SLOT_REQUEST_TIMEOUT_MILLIS)
+                                  .receive(replyDevice, replyProperty, columnarFull));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(toString(columnarFull), static_cast<size_t>(numWrites), columnarFull.size());
+    for (int i = 0; i < numWrites; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, columnarFull[i].get<int>("v"));
+    }
+
+    // Decimated such that each block is represented by its extrema as stored in the block summaries
+    const int maxNumDataDecimated = numBlocks;
+    params.set("maxNumData", maxNumDataDecimated);
+    std::vector<Hash> columnarDecimated;
+    CPPUNIT_ASSERT_NO_THROW(m_sigSlot->request(dlReader, "slotGetPropertyHistory", deviceId, "int32Property", params)
+                                  .timeout(SLOT_REQUEST_TIMEOUT_MILLIS)
+                                  .receive(replyDevice, replyProperty, columnarDecimated));
+
+    // Points of a decimated history must be points of the full history, i.e. same value, time and train id
+    auto assertInFullHistory = [&columnarFull](const std::vector<Hash>& decimated, const std::string& source) {
+        for (const Hash& point : decimated) {
+            const int value = point.get<int>("v");
+            CPPUNIT_ASSERT_MESSAGE(source + " value " + toString(value) + " unexpected",
+                                   value >= 0 && value < static_cast<int>(columnarFull.size()));
+            const Hash::Attributes& fullAttrs = columnarFull[value].getAttributes("v");
+            const Hash::Attributes& attrs = point.getAttributes("v");
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(source + " time of value " + toString(value),
+                                         toColumnTime(Epochstamp::fromHashAttributes(fullAttrs)),
+                                         toColumnTime(Epochstamp::fromHashAttributes(attrs)));
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(source + " train id of value " + toString(value),
+                                         TimeId::fromHashAttributes(fullAttrs).getTid(),
+                                         TimeId::fromHashAttributes(attrs).getTid());
+        }
+    };
+    assertInFullHistory(columnarDecimated, "Decimated columnar");
+    CPPUNIT_ASSERT_MESSAGE(toString(columnarDecimated), !columnarDecimated.empty());
+    CPPUNIT_ASSERT_MESSAGE(toString(columnarDecimated), columnarDecimated.size() <= 2ul * numBlocks);
+    for (size_t i = 1; i < columnarDecimated.size(); ++i) {
+        CPPUNIT_ASSERT_LESS(columnarDecimated[i].get<int>("v"), columnarDecimated[i - 1].get<int>("v"));
+    }
+    // Extrema of the first and last block - plain sampling of the decoded values would miss the last one
+    CPPUNIT_ASSERT_EQUAL(0, columnarDecimated.front().get<int>("v"));
+    CPPUNIT_ASSERT_EQUAL(numWrites - 1, columnarDecimated.back().get<int>("v"));
+
+    // Hide the columnar archive: the reader falls back to the text archive for the same request
+    const std::string deviceDir = m_fileLoggerDirectory + "/karaboHistory/" + deviceId;
+    std::filesystem::rename(deviceDir + "/col", deviceDir + "/col.hidden");
+
+    params.set("maxNumData", 2 * numWrites);
+    std::vector<Hash> textFull;
+    // The text archive may first have to be indexed
+    const bool textFullReady = waitForCondition(
+          [this, &dlReader, &deviceId, &params, &replyDevice, &replyProperty, &textFull, numWrites]() {
+              try {
+                  m_sigSlot->request(dlReader, "slotGetPropertyHistory", deviceId, "int32Property", params)
+                        .timeout(SLOT_REQUEST_TIMEOUT_MILLIS)
+                        .receive(replyDevice, replyProperty, textFull);
+              } catch (const karabo::data::TimeoutException&) {
+                  karabo::data::Exception::clearTrace();
+              } catch (const karabo::data::RemoteException&) {
+                  karabo::data::Exception::clearTrace();
+              }
+              return textFull.size() == static_cast<size_t>(numWrites);
+          },
+          NUM_RETRY * PAUSE_BEFORE_RETRY_MILLIS, PAUSE_BEFORE_RETRY_MILLIS);
+    CPPUNIT_ASSERT_MESSAGE("Full history from text archive: " + toString(textFull), textFullReady);
+    for (int i = 0; i < numWrites; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, textFull[i].get<int>("v"));
+    }
+    assertInFullHistory(textFull, "Text");
+
+    params.set("maxNumData", maxNumDataDecimated);
+    std::vector<Hash> textDecimated;
+    CPPUNIT_ASSERT_NO_THROW(m_sigSlot->request(dlReader, "slotGetPropertyHistory", deviceId, "int32Property", params)
+                                  .timeout(SLOT_REQUEST_TIMEOUT_MILLIS)
+                                  .receive(replyDevice, replyProperty, textDecimated));
+    CPPUNIT_ASSERT_MESSAGE(toString(textDecimated), !textDecimated.empty());
+    CPPUNIT_ASSERT_MESSAGE(toString(textDecimated), textDecimated.size() <= static_cast<size_t>(maxNumDataDecimated));
+    assertInFullHistory(textDecimated, "Decimated text");
+
+    std::clog << "OK" << std::endl;
+}
+
+
 void DataLogging_Test::influxAllTestRunnerWithDataMigration() {
     m_keepLoggerDirectory = false;
 
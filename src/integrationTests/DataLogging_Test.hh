@@ -31,6 +31,7 @@ class DataLogging_Test : public BaseLogging_Test {
     CPPUNIT_TEST_SUITE(DataLogging_Test);
 
     CPPUNIT_TEST(fileAllTestRunner);
+    CPPUNIT_TEST(testFileColumnarHistory);
     CPPUNIT_TEST(influxAllTestRunnerWithDataMigration);
     CPPUNIT_TEST(testNoInfluxServerHandling);
     CPPUNIT_TEST(testInfluxMaxPerDevicePropLogRate);
@@ -47,6 +48,12 @@ class DataLogging_Test : public BaseLogging_Test {
     void influxAllTestRunnerWithDataMigration(); // Supports data migration test.
     void testMigrateFileLoggerData();
 
+    /**
+     * Checks property history retrieval from the columnar archive of the FileDataLogger, at full resolution and
+     * decimated from the block summaries, against the history read from the text archive of the same updates.
+     */
+    void testFileColumnarHistory();
+
     /**
      * Checks that the Influx logger and reader fail as soon as
      * possible when there's no Influx server available. Uses an
@@ -567,7 +567,7 @@ namespace karabind {
         void replyPy(const Args&... args) {
             auto reply(std::make_shared<karabo::data::Hash>());
             packPy(*reply, args...);
-            // Can keep GIL: only a mutex lock in C++, no I/O
+            // Can keep GIL: no lock and no I/O in C++
             registerReply(reply);
         }
 
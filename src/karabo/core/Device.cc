@@ -260,7 +260,8 @@ namespace karabo {
         }
 
 
-        Device::Device(const karabo::data::Hash& configuration) : m_lastBrokerErrorStamp(0ull, 0ull) {
+        Device::Device(const karabo::data::Hash& configuration)
+            : m_timeReference(&m_ownTimeReference), m_lastBrokerErrorStamp(0ull, 0ull) {
             // Set serverId
             if (configuration.has("serverId")) configuration.get("serverId", m_serverId);
             else m_serverId = KARABO_NO_SERVER;
@@ -272,11 +273,6 @@ namespace karabo {
             // Make the configuration the initial state of the device
             m_parameters = configuration;
 
-            m_timeId = 0;
-            m_timeSec = 0;
-            m_timeFrac = 0;
-            m_timePeriod = 0; // zero as identifier of initial value used in slotTimeTick
-
             // Setup the validation classes
             karabo::data::Validator::ValidationRules rules;
             rules.allowAdditionalKeys = false;
@@ -704,16 +700,32 @@ namespace karabo {
 
         void Device::slotTimeTick(unsigned long long id, unsigned long long sec, unsigned long long frac,
                                   unsigned long long period) {
-            {
-                std::lock_guard<std::mutex> lock(m_timeChangeMutex);
-                m_timeId = id;
-                m_timeSec = sec;
-                m_timeFrac = frac;
-                m_timePeriod = period;
-            }
+            // Called directly, so from now on use the own reference, even if the one of the server was shared before
+            m_ownTimeReference.set(id, sec, frac, period);
+            m_timeReference.store(&m_ownTimeReference, std::memory_order_release);
+            onTimeTick(id, sec, frac, period);
+        }
+
+
+        void Device::setTimeReference(const TimeReference::ConstPointer& serverTimeReference) {
+            m_serverTimeReference = serverTimeReference;
+            m_timeReference.store(m_serverTimeReference.get(), std::memory_order_release);
+        }
+
+
+        void Device::timeTickFromServer(unsigned long long id, unsigned long long sec, unsigned long long frac,
+                                        unsigned long long period) {
             onTimeTick(id, sec, frac, period);
         }
 
+
+        void Device::timeUpdates(unsigned long long firstId, unsigned long long lastId, unsigned long long sec,
+                                 unsigned long long frac, unsigned long long period) {
+            for (unsigned long long id = firstId; id <= lastId; ++id) {
+                onTimeUpdate(id, sec, frac, period);
+            }
+        }
+
         void Device::appendSchemaMaxSize(const std::string& path, unsigned int value, bool emitFlag) {
             internalAppendSchemaMultiMaxSize({path}, {value}, emitFlag);
         }
@@ -766,24 +778,22 @@ namespace karabo {
 
         karabo::data::Timestamp Device::getTimestamp(const karabo::data::Epochstamp& epoch) const {
             unsigned long long id = 0;
-            {
-                std::lock_guard<std::mutex> lock(m_timeChangeMutex);
-                if (m_timePeriod > 0) {
-                    const karabo::data::Epochstamp epochLastReceived(m_timeSec, m_timeFrac);
-                    // duration is always positive, irrespective whether epoch or epochLastReceived is more recent
-                    const karabo::data::TimeDuration duration = epoch.elapsed(epochLastReceived);
-                    const unsigned long long nPeriods = (duration.getTotalSeconds() * 1000000ull +
-                                                         duration.getFractions(karabo::data::TIME_UNITS::MICROSEC)) /
-                                                        m_timePeriod;
-                    if (epochLastReceived <= epoch) {
-                        id = m_timeId + nPeriods;
-                    } else if (m_timeId >= nPeriods + 1ull) { // sanity check
-                        id = m_timeId - nPeriods - 1ull;
-                    } else {
-                        KARABO_LOG_FRAMEWORK_WARN << "Bad input: (train)Id zero since epoch = " << epoch.toIso8601()
-                                                  << "; from time server: epoch = " << epochLastReceived.toIso8601()
-                                                  << ", id = " << m_timeId << ", period = " << m_timePeriod << " mus";
-                    }
+            const TimeReference::Snapshot ref(m_timeReference.load(std::memory_order_acquire)->get());
+            if (ref.period > 0) {
+                const karabo::data::Epochstamp epochLastReceived(ref.sec, ref.frac);
+                // duration is always positive, irrespective whether epoch or epochLastReceived is more recent
+                const karabo::data::TimeDuration duration = epoch.elapsed(epochLastReceived);
+                const unsigned long long nPeriods = (duration.getTotalSeconds() * 1000000ull +
+                                                     duration.getFractions(karabo::data::TIME_UNITS::MICROSEC)) /
+                                                    ref.period;
+                if (epochLastReceived <= epoch) {
+                    id = ref.id + nPeriods;
+                } else if (ref.id >= nPeriods + 1ull) { // sanity check
+                    id = ref.id - nPeriods - 1ull;
+                } else {
+                    KARABO_LOG_FRAMEWORK_WARN << "Bad input: (train)Id zero since epoch = " << epoch.toIso8601()
+                                              << "; from time server: epoch = " << epochLastReceived.toIso8601()
+                                              << ", id = " << ref.id << ", period = " << ref.period << " mus";
                 }
             }
             return karabo::data::Timestamp(epoch, karabo::data::TimeId(id));
@@ -1037,6 +1047,15 @@ namespace karabo {
                             self->set(h);
                         }
                     });
+                    channel->registerShowCompressionStatisticsHandler(
+                          [weakThis, path](const std::vector<float>& ratios,
+                                           const std::vector<unsigned long long>& times) {
+                              Device::Pointer self(weakThis.lock());
+                              if (self) {
+                                  self->set(karabo::data::Hash(path + ".compressionRatio", ratios,
+                                                               path + ".compressionTime", times));
+                              }
+                          });
                     karabo::data::Hash update(path, channel->getInitialConfiguration());
                     // do not lock since this method is called under m_objectStateChangeMutex
                     setNoLock(update, getActualTimestamp());
@@ -1064,6 +1083,8 @@ namespace karabo {
                 KARABO_LOG_FRAMEWORK_ERROR << "*** 'createInputChannel' for channel name '" << path
                                            << "' failed to create input channel";
             } else {
+                // Not yet connected (that needs slot calls to the output), so registration is still fine
+                if (handlers.trainHandler) channel->registerTrainHandler(handlers.trainHandler);
                 // Set configured connections as missing for now
                 // NOTE: Setting ".missingConnections" here and in trackInputChannelConnections(...) (registered as
                 // status tracker
@@ -1304,9 +1325,9 @@ namespace karabo {
             Hash::Node& refNode = result.set("reference", true);
             auto& attrs = refNode.getAttributes();
             {
-                std::lock_guard<std::mutex> lock(m_timeChangeMutex);
-                const Epochstamp epoch(m_timeSec, m_timeFrac);
-                const TimeId train(m_timeId);
+                const TimeReference::Snapshot ref(m_timeReference.load(std::memory_order_acquire)->get());
+                const Epochstamp epoch(ref.sec, ref.frac);
+                const TimeId train(ref.id);
                 const Timestamp stamp(epoch, train);
                 stamp.toHashAttributes(attrs);
             }
@@ -27,12 +27,14 @@
 
 #include <unistd.h>
 
+#include <atomic>
 #include <boost/algorithm/string.hpp>
 #include <string>
 #include <tuple>
 #include <unordered_set>
 
 #include "DeviceClient.hh"
+#include "TimeReference.hh"
 #include "karabo/data/schema/AlarmConditionElement.hh"
 #include "karabo/data/schema/OverwriteElement.hh"
 #include "karabo/data/schema/SimpleElement.hh"
@@ -106,6 +108,8 @@ namespace karabo {
          * the possible configurations of the device.
          */
         class Device : public karabo::xms::SignalSlotable {
+            friend class DeviceServer; // to share its time reference and forward time ticks
+
             std::vector<std::function<void()>> m_initialFunc;
             /// Validators to validate...
             karabo::data::Validator m_validatorIntern; /// ...internal updates via 'Device::set'
@@ -119,11 +123,9 @@ namespace karabo {
             // To be injected at initialization time; for internal use only.
             std::string m_timeServerId;
 
-            unsigned long long m_timeId;
-            unsigned long long m_timeSec;    // seconds
-            unsigned long long m_timeFrac;   // attoseconds
-            unsigned long long m_timePeriod; // microseconds
-            mutable std::mutex m_timeChangeMutex;
+            TimeReference m_ownTimeReference;              // updated by slotTimeTick
+            TimeReference::ConstPointer m_serverTimeReference; // reference shared by DeviceServer, if any
+            std::atomic<const TimeReference*> m_timeReference; // the one of the two above that is in use
 
             mutable std::mutex m_objectStateChangeMutex;
             karabo::data::Hash m_parameters;
@@ -771,8 +773,9 @@ namespace karabo {
                                                                   const std::string& sep = ".") const;
 
             /**
-             * A slot called by the device server if the external time ticks update to synchronize
-             * this device with the timing system.
+             * A slot to synchronize this device with the timing system.
+             * Usually not needed: the device server shares its time information with its devices. Once called,
+             * the device uses the time information given here instead of the one of the server.
              *
              * @param id: current train id
              * @param sec: current system seconds
@@ -785,7 +788,7 @@ namespace karabo {
             // protected since called in Device::slotTimeTick
             /**
              * A hook which is called if the device receives external time-server update, i.e. if slotTimeTick on the
-             * device server is called.
+             * device server (or on the device) is called.
              * Can be overwritten by derived classes.
              *
              * @param id: train id
@@ -871,6 +874,26 @@ namespace karabo {
            private: // Functions
             void wrapRegisteredInit();
 
+            /**
+             * Use the time reference of the DeviceServer instead of an own one.
+             * To be called before finalizeInternalInitialization.
+             */
+            void setTimeReference(const TimeReference::ConstPointer& serverTimeReference);
+
+            /**
+             * Called by the DeviceServer when it received a time tick: its time reference, that is shared with this
+             * device, is already updated, so just call the hook.
+             */
+            void timeTickFromServer(unsigned long long id, unsigned long long sec, unsigned long long frac,
+                                    unsigned long long period);
+
+            /**
+             * Call onTimeUpdate for all ids from firstId to lastId (inclusive), all with the same time.
+             * Posted by the DeviceServer once per period instead of once per id.
+             */
+            void timeUpdates(unsigned long long firstId, unsigned long long lastId, unsigned long long sec,
+                             unsigned long long frac, unsigned long long period);
+
             void initClassId() {
                 m_classId = getClassInfo().getClassId();
             }
@@ -22,6 +22,7 @@
 
 #include "DeviceClient.hh"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <functional>
@@ -241,6 +242,11 @@ namespace karabo {
         std::string DeviceClient::findInstance(const std::string& instanceId) const {
             // NOT: std::mutex::scoped_lock lock(m_runtimeSystemDescriptionMutex);
             //      As documented, that is callers responsibility.
+            const std::string& type = m_topologyIndex.getType(instanceId);
+            if (!type.empty()) {
+                return (type + ".") += instanceId;
+            }
+            // Not (yet) in the topology, but maybe something of it is cached, e.g. a configuration
             for (Hash::const_iterator it = m_runtimeSystemDescription.begin(); it != m_runtimeSystemDescription.end();
                  ++it) {
                 Hash& tmp = it->getValue<Hash>();
@@ -254,19 +260,39 @@ namespace karabo {
 
 
         std::string DeviceClient::findInstanceSafe(const std::string& instanceId) const {
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             return this->findInstance(instanceId);
         }
 
 
         void DeviceClient::mergeIntoRuntimeSystemDescription(const karabo::data::Hash& entry) {
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             m_runtimeSystemDescription.merge(entry);
+            indexTopologyEntry(entry);
+        }
+
+
+        void DeviceClient::indexTopologyEntry(const karabo::data::Hash& entry) {
+            // NOT: std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+            //      As documented, that is callers responsibility.
+            for (Hash::const_iterator typeIt = entry.begin(); typeIt != entry.end(); ++typeIt) {
+                if (!typeIt->is<Hash>()) continue;
+                const std::string& type = typeIt->getKey();
+                const Hash& merged = m_runtimeSystemDescription.get<Hash>(type);
+                const Hash& instances = typeIt->getValue<Hash>();
+                for (Hash::const_iterator it = instances.begin(); it != instances.end(); ++it) {
+                    // Only topology entries have the instanceInfo as attributes - cached schemas etc. do not
+                    const Hash::Node& node = merged.getNode(it->getKey());
+                    if (node.hasAttribute("type")) {
+                        m_topologyIndex.insert(it->getKey(), type, node.getAttributes());
+                    }
+                }
+            }
         }
 
 
         bool DeviceClient::existsInRuntimeSystemDescription(const std::string& path) const {
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             return m_runtimeSystemDescription.has(path);
         }
 
@@ -278,7 +304,7 @@ namespace karabo {
             const Hash entry(prepareTopologyEntry(path, instanceInfo));
 
             {
-                std::unique_lock<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::unique_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 if (m_runtimeSystemDescription.has(path)) {
                     // The instance was probably killed and restarted again before we noticed that the heartbeats
                     // stopped. We should properly treat its death first (especially for servers, see
@@ -299,6 +325,7 @@ namespace karabo {
                     lock.lock();
                 }
                 m_runtimeSystemDescription.merge(entry);
+                indexTopologyEntry(entry);
             }
             if (isImmortal(instanceId)) { // A "zombie" that now gets alive again - connect and fill cache
                 connectAndRequest(instanceId);
@@ -323,8 +350,17 @@ namespace karabo {
 
         bool DeviceClient::eraseFromRuntimeSystemDescription(const std::string& path) {
             try {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
-                return m_runtimeSystemDescription.erase(path);
+                std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+                if (!m_runtimeSystemDescription.erase(path)) return false;
+                // If 'path' is "<type>.<instanceId>", the instance is not in the topology anymore
+                const size_t dotPos = path.find('.');
+                if (dotPos != std::string::npos && path.find('.', dotPos + 1) == std::string::npos) {
+                    const std::string instanceId(path.substr(dotPos + 1));
+                    if (m_topologyIndex.getType(instanceId) == path.substr(0, dotPos)) {
+                        m_topologyIndex.erase(instanceId);
+                    }
+                }
+                return true;
             } catch (...) {
                 KARABO_LOG_FRAMEWORK_ERROR << "Could not erase path \"" << path << " from device-client cache";
                 return false;
@@ -333,7 +369,7 @@ namespace karabo {
 
 
         data::Hash DeviceClient::getSectionFromRuntimeDescription(const std::string& section) const {
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
 
             boost::optional<const data::Hash::Node&> sectionNode = m_runtimeSystemDescription.find(section);
             if (sectionNode && sectionNode->is<data::Hash>()) {
@@ -345,7 +381,7 @@ namespace karabo {
 
 
         void DeviceClient::removeFromSystemTopology(const std::string& instanceId) {
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             for (Hash::iterator it = m_runtimeSystemDescription.begin(); it != m_runtimeSystemDescription.end(); ++it) {
                 Hash& tmp = it->getValue<Hash>();
                 boost::optional<Hash::Node&> node = tmp.find(instanceId);
@@ -354,6 +390,7 @@ namespace karabo {
                     break;
                 }
             }
+            m_topologyIndex.erase(instanceId);
         }
 
 
@@ -363,7 +400,7 @@ namespace karabo {
             const Hash entry(prepareTopologyEntry(path, instanceInfo));
 
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 if (!m_runtimeSystemDescription.has(path)) {
                     // Not sure how we can get into this. But we do in the field with 2.20.2, at least if not tracking
                     // instances. Maybe some instanceGone arrives after instaceNew? Ordering should prevent that,
@@ -387,6 +424,7 @@ namespace karabo {
                     return;
                 }
                 m_runtimeSystemDescription.merge(entry);
+                indexTopologyEntry(entry);
             }
 
             if (m_instanceUpdatedHandler) m_instanceUpdatedHandler(entry);
@@ -404,7 +442,7 @@ namespace karabo {
 
                 std::vector<std::pair<std::string, Hash>> devicesOfServer;
                 {
-                    std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                    std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                     if (!m_runtimeSystemDescription.has(path)) {
                         KARABO_LOG_FRAMEWORK_ERROR << instanceId
                                                    << " received instance gone although not in runtime description";
@@ -415,6 +453,7 @@ namespace karabo {
                     }
                     // clear cache
                     m_runtimeSystemDescription.erase(path);
+                    m_topologyIndex.erase(instanceId);
                 }
                 for (const auto& pairDeviceIdAndInstanceInfo : devicesOfServer) {
                     treatInstanceAsGone(pairDeviceIdAndInstanceInfo.first, pairDeviceIdAndInstanceInfo.second);
@@ -434,26 +473,27 @@ namespace karabo {
             if (deviceNode) {
                 Hash& devices = deviceNode->getValue<Hash>();
 
-                for (Hash::iterator it = devices.begin(); it != devices.end(); ++it) {
-                    const Hash::Attributes& attributes = it->getAttributes();
-                    if (attributes.has("serverId") && attributes.get<string>("serverId") == serverId) {
-                        // OK, device belongs to the server that is gone.
-                        const string& deviceId = it->getKey();
-                        KARABO_LOG_FRAMEWORK_DEBUG << "Treat device '" << deviceId << "' as gone since its server '"
-                                                   << serverId << "' is.";
-                        // Generate instanceInfo as it would come with instanceGone:
-                        Hash deviceInstanceInfo;
-                        for (Hash::Attributes::const_iterator jt = attributes.begin(); jt != attributes.end(); ++jt) {
-                            deviceInstanceInfo.set(jt->getKey(), jt->getValueAsAny());
-                        }
-                        devicesOfServer.push_back(std::make_pair(deviceId, std::move(deviceInstanceInfo)));
+                // The index knows which instances belong to the server - no need to check all devices
+                for (const std::string& deviceId : m_topologyIndex.getByServer(serverId)) {
+                    boost::optional<Hash::Node&> node = devices.find(deviceId);
+                    if (!node || m_topologyIndex.getType(deviceId) != "device") continue;
+                    // OK, device belongs to the server that is gone.
+                    KARABO_LOG_FRAMEWORK_DEBUG << "Treat device '" << deviceId << "' as gone since its server '"
+                                               << serverId << "' is.";
+                    // Generate instanceInfo as it would come with instanceGone:
+                    const Hash::Attributes& attributes = node->getAttributes();
+                    Hash deviceInstanceInfo;
+                    for (Hash::Attributes::const_iterator jt = attributes.begin(); jt != attributes.end(); ++jt) {
+                        deviceInstanceInfo.set(jt->getKey(), jt->getValueAsAny());
                     }
+                    devicesOfServer.push_back(std::make_pair(deviceId, std::move(deviceInstanceInfo)));
                 }
                 // Erase the found devices from m_runtimeSystemDescription ('devices' is a reference into it!):
                 auto sigSlot = m_signalSlotable.lock();
                 for (const auto& pairDeviceIdInstanceInfo : devicesOfServer) {
                     const std::string& deviceId = pairDeviceIdInstanceInfo.first;
                     devices.erase(deviceId);
+                    m_topologyIndex.erase(deviceId);
                     // Tell signalslotable that device is gone. That ensures that we will get instanceNew even if the
                     // device recovers before signalslotable itself notices that the device might be gone.
                     if (sigSlot) {
@@ -574,7 +614,7 @@ namespace karabo {
         Hash DeviceClient::getSystemInformation() {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(Hash());
             initTopology();
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             return m_runtimeSystemDescription;
         }
 
@@ -582,7 +622,7 @@ namespace karabo {
         Hash DeviceClient::getSystemTopology() {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(Hash());
             initTopology();
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             Hash topology;
             for (Hash::const_map_iterator it = m_runtimeSystemDescription.mbegin();
                  it != m_runtimeSystemDescription.mend(); ++it) {
@@ -601,27 +641,19 @@ namespace karabo {
         std::vector<std::string> DeviceClient::getServers() {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(vector<string>());
             initTopology();
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
-            if (m_runtimeSystemDescription.has("server")) {
-                const Hash& tmp = m_runtimeSystemDescription.get<Hash>("server");
-                vector<string> deviceServers;
-                deviceServers.reserve(tmp.size());
-                karabo::xms::SignalSlotable::Pointer p = m_signalSlotable.lock();
-                for (Hash::const_map_iterator it = tmp.mbegin(); it != tmp.mend(); ++it) {
-                    deviceServers.push_back(it->second.getKey());
-                }
-                return deviceServers;
-            } else {
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+            vector<string> deviceServers(m_topologyIndex.getByType("server"));
+            if (deviceServers.empty()) {
                 KARABO_LOG_FRAMEWORK_INFO << "No device servers found in the system";
-                return vector<string>();
             }
+            return deviceServers;
         }
 
 
         std::vector<std::string> DeviceClient::getClasses(const std::string& deviceServer) {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(std::vector<std::string>());
             initTopology();
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             if (!m_runtimeSystemDescription.has("server." + deviceServer)) {
                 KARABO_LOG_FRAMEWORK_DEBUG << "Requested device server '" << deviceServer << "' does not exist.";
                 return vector<string>();
@@ -639,42 +671,50 @@ namespace karabo {
         std::vector<std::string> DeviceClient::getDevices() {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(vector<string>());
             initTopology();
-            karabo::xms::SignalSlotable::Pointer p = m_signalSlotable.lock();
 
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
-            if (!m_runtimeSystemDescription.has("device")) {
-                return vector<string>();
-            } else {
-                const Hash& tmp = m_runtimeSystemDescription.get<Hash>("device");
-                vector<string> devices;
-                devices.reserve(tmp.size());
-                for (Hash::const_map_iterator it = tmp.mbegin(); it != tmp.mend(); ++it) {
-                    devices.push_back(it->second.getKey());
-                }
-                return devices;
-            }
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+            return m_topologyIndex.getByType("device");
         }
 
 
         std::vector<std::string> DeviceClient::getDevices(const std::string& deviceServer) {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(vector<string>());
             initTopology();
-            karabo::xms::SignalSlotable::Pointer p = m_signalSlotable.lock();
 
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
-            if (!m_runtimeSystemDescription.has("device")) {
-                return vector<string>();
-            } else {
-                const Hash& tmp = m_runtimeSystemDescription.get<Hash>("device");
-                vector<string> devices;
-                devices.reserve(tmp.size());
-                for (Hash::const_map_iterator it = tmp.mbegin(); it != tmp.mend(); ++it) {
-                    if (it->second.getAttribute<string>("serverId") == deviceServer) {
-                        devices.push_back(it->second.getKey());
-                    }
-                }
-                return devices;
-            }
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+            vector<string> devices(m_topologyIndex.getByServer(deviceServer));
+            // A server has its own id as serverId
+            devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                         [this](const string& id) { return m_topologyIndex.getType(id) != "device"; }),
+                          devices.end());
+            return devices;
+        }
+
+
+        std::vector<std::string> DeviceClient::getDevicesOfClass(const std::string& classId) {
+            KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(vector<string>());
+            initTopology();
+
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+            vector<string> devices(m_topologyIndex.getByClass(classId));
+            devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                         [this](const string& id) { return m_topologyIndex.getType(id) != "device"; }),
+                          devices.end());
+            return devices;
+        }
+
+
+        std::vector<std::string> DeviceClient::getInstancesOnHost(const std::string& host) {
+            KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(vector<string>());
+            initTopology();
+
+            std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
+            return m_topologyIndex.getByHost(host);
+        }
+
+
+        unsigned long long DeviceClient::getTopologyVersion() const {
+            return m_topologyIndex.getVersion(); // atomic, no need to lock
         }
 
 
@@ -691,7 +731,7 @@ namespace karabo {
             std::string path;
 
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 path = findInstance(instanceId);
                 if (path.empty()) {
                     path = "device." + instanceId + ".fullSchema";
@@ -713,7 +753,7 @@ namespace karabo {
                   .timeout(m_internalTimeout)
                   .receive(schema, dummy); // 2nd "return value" is deviceId
 
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             return m_runtimeSystemDescription.set(path, schema).getValue<Schema>();
         }
 
@@ -721,7 +761,7 @@ namespace karabo {
         karabo::data::Schema DeviceClient::getDeviceSchemaNoWait(const std::string& instanceId) {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(Schema());
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 std::string path(findInstance(instanceId));
                 if (!path.empty()) {
                     path += ".fullSchema";
@@ -765,7 +805,7 @@ namespace karabo {
         void DeviceClient::_slotSchemaUpdated(const karabo::data::Schema& schema, const std::string& deviceId) {
             KARABO_LOG_FRAMEWORK_DEBUG << "_slotSchemaUpdated for " << deviceId;
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 const string path(findInstance(deviceId));
                 if (path.empty()) {
                     KARABO_LOG_FRAMEWORK_WARN << "got schema for unknown instance '" << deviceId << "'.";
@@ -788,7 +828,7 @@ namespace karabo {
             const std::string state(get<State>(instanceId, "state").name());
             std::string path;
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 path = findInstance(instanceId);
                 if (path.empty()) {
                     path = "device." + instanceId + ".activeSchema." + state;
@@ -807,7 +847,7 @@ namespace karabo {
                   .timeout(m_internalTimeout)
                   .receive(schema, dummy); // 2nd "return value" is deviceId
 
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             return m_runtimeSystemDescription.set(path, schema).getValue<Schema>();
         }
 
@@ -822,7 +862,7 @@ namespace karabo {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(Schema());
             std::string path("server." + serverId + ".classes." + classId + ".description");
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 boost::optional<Hash::Node&> node = m_runtimeSystemDescription.find(path);
                 if (node) return node->getValue<Schema>();
             }
@@ -834,7 +874,7 @@ namespace karabo {
                   .timeout(m_internalTimeout)
                   .receive(schema); // Retrieves full schema
 
-            std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+            std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
             return m_runtimeSystemDescription.set(path, schema).getValue<Schema>();
         }
 
@@ -845,7 +885,7 @@ namespace karabo {
 
             {
                 std::string path("server." + serverId + ".classes." + classId + ".description");
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 boost::optional<Hash::Node&> node = m_runtimeSystemDescription.find(path);
                 if (node && !node->getValue<Schema>().empty()) return node->getValue<Schema>();
             }
@@ -861,7 +901,7 @@ namespace karabo {
             KARABO_LOG_FRAMEWORK_DEBUG << "_slotClassSchema";
             {
                 std::string path("server." + serverId + ".classes." + classId + ".description");
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 m_runtimeSystemDescription.set(path, schema);
             }
             if (m_classSchemaHandler) m_classSchemaHandler(serverId, classId, schema);
@@ -1017,7 +1057,7 @@ namespace karabo {
                 int waitedInMillis = 0;
                 while (!isThere && waitedInMillis < timeoutInMillis) {
                     {
-                        std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                        std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                         isThere = m_runtimeSystemDescription.has("device." + reply);
                     }
                     std::this_thread::sleep_for(100ms);
@@ -1054,7 +1094,7 @@ namespace karabo {
             do {
                 std::this_thread::sleep_for(1s);
                 nTrials++;
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 isThere = m_runtimeSystemDescription.has("device." + deviceId);
             } while (isThere && (nTrials < timeoutInSeconds));
 
@@ -1091,7 +1131,7 @@ namespace karabo {
             do {
                 std::this_thread::sleep_for(1s);
                 nTrials++;
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 isThere = m_runtimeSystemDescription.has("server." + serverId);
             } while (isThere && (nTrials < timeoutInSeconds));
 
@@ -1120,7 +1160,7 @@ namespace karabo {
             Hash result;
             std::string path;
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 path = findInstance(deviceId);
 
                 if (path.empty()) {
@@ -1149,7 +1189,7 @@ namespace karabo {
                           KARABO_TIMEOUT_EXCEPTION("Configuration request for device \"" + deviceId + "\" timed out"));
                     return result; // empty Hash
                 }
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 result = m_runtimeSystemDescription.set(path, hash).getValue<Hash>();
             }
             return result;
@@ -1164,7 +1204,7 @@ namespace karabo {
         karabo::data::Hash DeviceClient::getConfigurationNoWait(const std::string& deviceId) {
             KARABO_IF_SIGNAL_SLOTABLE_EXPIRED_THEN_RETURN(Hash());
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::shared_lock<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 std::string path(findInstance(deviceId));
                 if (!path.empty()) {
                     path += ".configuration";
@@ -1764,7 +1804,7 @@ namespace karabo {
 
         void DeviceClient::_slotChanged(const karabo::data::Hash& hash, const std::string& instanceId) {
             {
-                std::lock_guard<std::mutex> lock(m_runtimeSystemDescriptionMutex);
+                std::lock_guard<std::shared_mutex> lock(m_runtimeSystemDescriptionMutex);
                 // TODO Optimize speed
                 string path(findInstance(instanceId));
                 if (path.empty()) {
@@ -26,11 +26,13 @@
 #include <atomic>
 #include <boost/asio.hpp>
 #include <karabo/core/InstanceChangeThrottler.hh>
+#include <karabo/core/TopologyIndex.hh>
 #include <karabo/util/DataLogUtils.hh>
 #include <karabo/xms/SignalSlotable.hh>
 #include <map>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -104,7 +106,11 @@ namespace karabo {
              */
             karabo::data::Hash m_runtimeSystemDescription;
 
-            mutable std::mutex m_runtimeSystemDescriptionMutex;
+            /// Index of the instances in m_runtimeSystemDescription, protected by m_runtimeSystemDescriptionMutex
+            TopologyIndex m_topologyIndex;
+
+            /// Shared for reading, exclusive for writing m_runtimeSystemDescription and m_topologyIndex
+            mutable std::shared_mutex m_runtimeSystemDescriptionMutex;
 
             std::weak_ptr<karabo::xms::SignalSlotable> m_signalSlotable;
 
@@ -341,6 +347,26 @@ namespace karabo {
              */
             std::vector<std::string> getDevices();
 
+            /**
+             * Retrieves all devices of a given class in the distributed system.
+             * @param classId class of the devices
+             * @return array of device instanceIds
+             */
+            std::vector<std::string> getDevicesOfClass(const std::string& classId);
+
+            /**
+             * Retrieves all instances (devices, servers, clients, ...) running on a given host.
+             * @param host name of the host
+             * @return array of instanceIds
+             */
+            std::vector<std::string> getInstancesOnHost(const std::string& host);
+
+            /**
+             * Version of the system topology, increases whenever an instance appears, changes or disappears.
+             * Compare with an earlier value to know whether the topology changed in between.
+             */
+            unsigned long long getTopologyVersion() const;
+
             /**
              * Retrieves the full Schema (parameter description) of the given instance;
              * @param instanceId Device's instance ID
@@ -1536,6 +1562,13 @@ namespace karabo {
             std::vector<std::pair<std::string, karabo::data::Hash>> findAndEraseDevicesAsGone(
                   const std::string& serverId);
 
+            /**
+             * Add the instances of a topology entry (as from prepareTopologyEntry) to m_topologyIndex, using their
+             * attributes as merged into m_runtimeSystemDescription.
+             * Requires protection of m_runtimeSystemDescriptionMutex.
+             */
+            void indexTopologyEntry(const karabo::data::Hash& entry);
+
             /**
              * Helper for _slotInstanceGone
              *
@@ -40,6 +40,7 @@
 #include "karabo/data/schema/NodeElement.hh"
 #include "karabo/data/schema/SimpleElement.hh"
 #include "karabo/data/schema/VectorElement.hh"
+#include "karabo/data/types/BufferPool.hh"
 #include "karabo/log/Logger.hh"
 #include "karabo/log/utils.hh"
 #include "karabo/net/Broker.hh"
@@ -149,6 +150,46 @@ namespace karabo {
                   .defaultValue("")
                   .commit();
 
+            UINT32_ELEMENT(expected)
+                  .key("eventLoopShards")
+                  .displayedName("Event Loop Shards")
+                  .description(
+                        "If larger than 0, network channels are distributed on this number of additional event loop "
+                        "shards, each run by its own thread")
+                  .assignmentOptional()
+                  .defaultValue(0u)
+                  .expertAccess()
+                  .init()
+                  .commit();
+
+            BOOL_ELEMENT(expected)
+                  .key("pinEventLoopShards")
+                  .displayedName("Pin Event Loop Shards")
+                  .description(
+                        "If true, each event loop shard thread is bound to one of the CPUs the server may use, "
+                        "starting with the first one. Restrict the CPUs of each server (e.g. with taskset) if several "
+                        "servers on a host pin their threads, otherwise they share the same CPUs.")
+                  .assignmentOptional()
+                  .defaultValue(false)
+                  .expertAccess()
+                  .init()
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("bufferPoolSize")
+                  .displayedName("Buffer Pool Size")
+                  .description(
+                        "If larger than 0, buffers of NDArrays and ByteArrays are reused via a pool that keeps up to "
+                        "this size of unused buffers. That avoids allocations when large data is received regularly, "
+                        "e.g. pipeline data.")
+                  .unit(Unit::BYTE)
+                  .metricPrefix(MetricPrefix::MEGA)
+                  .assignmentOptional()
+                  .defaultValue(0u)
+                  .expertAccess()
+                  .init()
+                  .commit();
+
             VECTOR_STRING_ELEMENT(expected)
                   .key("serverFlags")
                   .displayedName("Server Flags")
@@ -162,11 +203,7 @@ namespace karabo {
         }
 
         DeviceServer::DeviceServer(const karabo::data::Hash& config)
-            : m_timeId(0ull),
-              m_timeSec(0ull),
-              m_timeFrac(0ull),
-              m_timePeriod(1ull) // non-zero as double protection against division by zero in DeviceServer::timeTick
-              ,
+            : m_timeReference(std::make_shared<TimeReference>()),
               m_noTimeTickYet(true),
               m_timeIdLastTick(0ull),
               m_timeTickerTimer(EventLoop::getIOService()) {
@@ -178,6 +215,16 @@ namespace karabo {
 
             config.get("deviceClasses", m_deviceClasses);
 
+            const unsigned int nShards = config.get<unsigned int>("eventLoopShards");
+            if (nShards > 0u) {
+                // Throws if the event loop is already running, e.g. when the server is not created by the Runner
+                EventLoop::setNumberOfShards(nShards, 1u, config.get<bool>("pinEventLoopShards"));
+            }
+            const unsigned int bufferPoolSize = config.get<unsigned int>("bufferPoolSize");
+            if (bufferPoolSize > 0u) {
+                BufferPool::setMaxResidentBytes(bufferPoolSize * 1'000'000ul);
+            }
+
             // Device configurations for those to automatically start
             // Runner establishes 'autoStart' property as (json) string (default: "")
             if (config.has("autoStart")) {
@@ -339,22 +386,15 @@ namespace karabo {
                                  << ", frac=" << frac;
                 return;
             }
-            bool firstCall = false;
-            {
-                karabo::data::Epochstamp epochNow; // before mutex lock since that could add a delay
-                std::lock_guard<std::mutex> lock(m_timeChangeMutex);
-                m_timeId = id;
-                m_timeSec = sec;
-                m_timeFrac = frac;
+            if (sec == 0) {
                 // Fallback to the local timing ...
-                if (sec == 0) {
-                    m_timeSec = epochNow.getSeconds();
-                    m_timeFrac = epochNow.getFractionalSeconds();
-                }
-                m_timePeriod = period;
-                firstCall = m_noTimeTickYet;
-                m_noTimeTickYet = false;
+                const karabo::data::Epochstamp epochNow;
+                m_timeReference->set(id, epochNow.getSeconds(), epochNow.getFractionalSeconds(), period);
+            } else {
+                m_timeReference->set(id, sec, frac, period);
             }
+            // Devices share m_timeReference and are thus already updated
+            const bool firstCall = m_noTimeTickYet.exchange(false);
 
             {
                 // Just forward to devices this external update
@@ -365,7 +405,7 @@ namespace karabo {
                     // devices. On the other hand, posting always adds some delay and the risk is low since
                     //  Device::onTimeTick is barely used (if at all).
                     if (kv.second.second) { // otherwise not yet fully initialized
-                        kv.second.first->slotTimeTick(id, sec, frac, period);
+                        kv.second.first->timeTickFromServer(id, sec, frac, period);
                     }
                 }
             }
@@ -383,14 +423,11 @@ namespace karabo {
         void DeviceServer::timeTick(const boost::system::error_code ec, unsigned long long newId) {
             if (ec) return;
             // Get values of last 'external' update via slotTimeTick.
-            unsigned long long id = 0, period = 0;
-            data::Epochstamp stamp(0ull, 0ull);
-            {
-                std::lock_guard<std::mutex> lock(m_timeChangeMutex);
-                id = m_timeId;
-                stamp = data::Epochstamp(m_timeSec, m_timeFrac);
-                period = m_timePeriod;
-            }
+            const TimeReference::Snapshot ref(m_timeReference->get());
+            const unsigned long long id = ref.id;
+            // Period is non-zero since set in slotTimeTick, but protect against division by zero below anyway
+            const unsigned long long period = std::max(ref.period, 1ull);
+            data::Epochstamp stamp(ref.sec, ref.frac);
 
             // Internal ticking might have been too slow while external update could not cancel the timer (because
             // timeTick was already posted to the event loop, but did not yet reach the timer reload).
@@ -412,7 +449,6 @@ namespace karabo {
             //
             // But first some safeguards for first tick at all or if a very big jump happened.
             if (m_timeIdLastTick == 0ull) m_timeIdLastTick = newId - 1; // first time tick
-            // It is safe to divide by period: non-zero value taken care of when setting m_timePeriod:
             const unsigned long long largestOnTimeUpdateBacklog = 600000000ull / period; // 6*10^8: 10 min in microsec
             if (newId > m_timeIdLastTick + largestOnTimeUpdateBacklog) {
                 // Don't treat an 'id' older than 10 min - for a period of 100 millisec that is 6000 ids in the past
@@ -421,12 +457,14 @@ namespace karabo {
                                 << " ids.";
                 m_timeIdLastTick = newId - largestOnTimeUpdateBacklog;
             }
-            while (m_timeIdLastTick < newId) {
-                ++m_timeIdLastTick;
+            if (m_timeIdLastTick < newId) {
+                // A single post per device for all ids, keeping the order of ids per device
+                const unsigned long long firstId = m_timeIdLastTick + 1ull;
+                m_timeIdLastTick = newId;
                 std::lock_guard<std::mutex> lock(m_deviceInstanceMutex);
                 for (auto& kv : m_deviceInstanceMap) {
                     if (kv.second.second) { // otherwise not yet fully initialized
-                        kv.second.second->post(bind_weak(&Device::onTimeUpdate, kv.second.first.get(), m_timeIdLastTick,
+                        kv.second.second->post(bind_weak(&Device::timeUpdates, kv.second.first.get(), firstId, newId,
                                                          stamp.getSeconds(), stamp.getFractionalSeconds(), period));
                     }
                 }
@@ -575,6 +613,9 @@ namespace karabo {
                         throw KARABO_LOGIC_EXCEPTION("Device '" + deviceId +
                                                      "' already running/starting on this server.");
                     }
+                    // Share the time information - before finalizeInternalInitialization, i.e. before anything could
+                    // ask the device for a timestamp
+                    device->setTimeReference(m_timeReference);
                     // Keep the device instance - doing this before finalizeInternalInitialization to enable the
                     // device to kill itself during instantiation (see slotDeviceGone).
                     m_deviceInstanceMap[deviceId] = std::make_pair(device, Strand::Pointer());
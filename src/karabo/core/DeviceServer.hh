@@ -27,12 +27,14 @@
 
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <boost/asio/deadline_timer.hpp>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "Device.hh"
+#include "TimeReference.hh"
 #include "karabo/data/schema/Configurator.hh"
 #include "karabo/data/types/State.hh"
 #include "karabo/log/Logger.hh"
@@ -74,13 +76,9 @@ namespace karabo {
 
             std::string m_serverId;
             std::string m_timeServerId;
-            unsigned long long m_timeId;
-            unsigned long long m_timeSec;    // seconds
-            unsigned long long m_timeFrac;   // attoseconds
-            unsigned long long m_timePeriod; // microseconds
-            bool m_noTimeTickYet;            // whether slotTimeTick received a first call
-            mutable std::mutex m_timeChangeMutex;
-            unsigned long long m_timeIdLastTick; // only for onTimeTick, no need for mutex protection
+            TimeReference::Pointer m_timeReference; // last slotTimeTick, shared with all devices
+            std::atomic<bool> m_noTimeTickYet;      // whether slotTimeTick received a first call
+            unsigned long long m_timeIdLastTick;    // only for onTimeTick, no need for mutex protection
             boost::asio::system_timer m_timeTickerTimer;
             std::string m_hostname;
 
@@ -175,6 +173,7 @@ namespace karabo {
             /**
              * Helper function for internal time ticker deadline timer to provide internal clock
              * that calls 'onTimeUpdate' for every id even if slotTimeTick is called less often.
+             * If ids were missed, a single post per device covers all of them.
              *
              * @param ec error code indicating whether deadline timer was cancelled
              * @param id: current train id
@@ -23,7 +23,6 @@
 
 #include "InstanceChangeThrottler.hh"
 
-#include <boost/asio/placeholders.hpp>
 #include <chrono>
 #include <karabo/log/Logger.hh>
 #include <karabo/net/EventLoop.hh>
@@ -55,7 +54,8 @@ namespace karabo {
                                                          unsigned int cycleIntervalMs, unsigned int maxChangesPerCycle)
             : m_cycleIntervalMs(cycleIntervalMs),
               m_maxChangesPerCycle(maxChangesPerCycle),
-              m_throttlerTimer(karabo::net::EventLoop::getIOService()),
+              m_timerWheel(karabo::net::EventLoop::getTimerWheel()),
+              m_cycleTimeoutId(0ull),
               m_instChangeHandler(instChangeHandler){};
 
 
@@ -64,6 +64,7 @@ namespace karabo {
             // a shared_ptr to an instance of it, decreasing the chances of existing another
             // thread that refers to the instance being destroyed.
             std::lock_guard<std::mutex> lock(m_instChangesMutex);
+            m_timerWheel->cancel(m_cycleTimeoutId);
             flushThrottler(false);
         }
 
@@ -225,7 +226,7 @@ namespace karabo {
             if (m_totalChangesInCycle >= m_maxChangesPerCycle) {
                 // Maximum number of changes reached - cancels the next scheduled flush (if possible) and
                 // flushes immediately.
-                if (m_throttlerTimer.cancel() > 0) {
+                if (m_timerWheel->cancel(m_cycleTimeoutId)) {
                     flushThrottler();
                 }
             }
@@ -248,9 +249,7 @@ namespace karabo {
         }
 
 
-        void InstanceChangeThrottler::runThrottlerCycleAsync(const boost::system::error_code& e) {
-            if (e) return;
-
+        void InstanceChangeThrottler::runThrottlerCycleAsync() {
             std::lock_guard<std::mutex> lock(m_instChangesMutex);
             flushThrottler();
         }
@@ -282,9 +281,10 @@ namespace karabo {
 
 
         void InstanceChangeThrottler::kickNextThrottlerCycleAsync() {
-            m_throttlerTimer.expires_after(milliseconds(m_cycleIntervalMs));
-            m_throttlerTimer.async_wait(
-                  bind_weak(&InstanceChangeThrottler::runThrottlerCycleAsync, this, boost::asio::placeholders::error));
+            // A flush() before the cycle is over must not leave the cycle pending
+            m_timerWheel->cancel(m_cycleTimeoutId);
+            m_cycleTimeoutId = m_timerWheel->schedule(milliseconds(m_cycleIntervalMs),
+                                                      bind_weak(&InstanceChangeThrottler::runThrottlerCycleAsync, this));
         }
 
 
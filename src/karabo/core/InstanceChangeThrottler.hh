@@ -24,7 +24,6 @@
 #ifndef KARABO_CORE_INSTANCEMESSAGETHROTTLER_HH
 #define KARABO_CORE_INSTANCEMESSAGETHROTTLER_HH
 
-#include <boost/asio/steady_timer.hpp>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -34,6 +33,7 @@
 
 #include "karabo/data/types/ClassInfo.hh"
 #include "karabo/data/types/Hash.hh"
+#include "karabo/net/TimerWheel.hh"
 
 namespace karabo {
 
@@ -166,7 +166,9 @@ namespace karabo {
             // The number of changes to be dispatched in the next Throttler cycle (<=  m_maxChangesPerCycle).
             unsigned int m_totalChangesInCycle;
 
-            boost::asio::steady_timer m_throttlerTimer;
+            // Cycles are scheduled on the event loop's timer wheel
+            karabo::net::TimerWheel::Pointer m_timerWheel;
+            karabo::net::TimerWheel::Id m_cycleTimeoutId;
 
             InstanceChangeHandler m_instChangeHandler;
 
@@ -209,10 +211,8 @@ namespace karabo {
 
             /**
              * Throttler cycle execution. For each cycle, the throttler dispatches the instances changes hash.
-             *
-             * @param e Error code passed by the boost::asio::deadline_timer ticking mechanism.
              */
-            void runThrottlerCycleAsync(const boost::system::error_code& e);
+            void runThrottlerCycleAsync();
 
             /**
              * Schedules the next throttler event dispatching cycle.
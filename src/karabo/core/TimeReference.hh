@@ -0,0 +1,102 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_CORE_TIMEREFERENCE_HH
+#define KARABO_CORE_TIMEREFERENCE_HH
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace karabo {
+
+    namespace core {
+
+        /**
+         * @class TimeReference
+         * @brief The last time information received from a time server: an id, its epoch and the period of ids
+         *
+         * The reference is written on each time tick, but read whenever a device creates a timestamp. It is
+         * therefore protected by a sequence lock: writers are serialised by a mutex and increment a sequence
+         * counter before and after writing, readers never lock but repeat reading until the counter is even and
+         * unchanged. The DeviceServer shares its reference with all its devices.
+         */
+        class TimeReference {
+           public:
+            typedef std::shared_ptr<TimeReference> Pointer;
+            typedef std::shared_ptr<const TimeReference> ConstPointer;
+
+            struct Snapshot {
+                unsigned long long id;
+                unsigned long long sec;    // seconds
+                unsigned long long frac;   // attoseconds
+                unsigned long long period; // microseconds, zero if no time information received yet
+            };
+
+            TimeReference() : m_sequence(0ull), m_id(0ull), m_sec(0ull), m_frac(0ull), m_period(0ull) {}
+
+            TimeReference(const TimeReference&) = delete;
+            TimeReference& operator=(const TimeReference&) = delete;
+
+            /**
+             * Update the reference - thread safe
+             */
+            void set(unsigned long long id, unsigned long long sec, unsigned long long frac,
+                     unsigned long long period) {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                const unsigned long long seq = m_sequence.load(std::memory_order_relaxed);
+                m_sequence.store(seq + 1ull, std::memory_order_relaxed); // odd: write in progress
+                std::atomic_thread_fence(std::memory_order_release);
+                m_id.store(id, std::memory_order_relaxed);
+                m_sec.store(sec, std::memory_order_relaxed);
+                m_frac.store(frac, std::memory_order_relaxed);
+                m_period.store(period, std::memory_order_relaxed);
+                m_sequence.store(seq + 2ull, std::memory_order_release);
+            }
+
+            /**
+             * Get a consistent copy of the reference - thread safe and lock free
+             */
+            Snapshot get() const {
+                Snapshot result;
+                unsigned long long seqBefore, seqAfter;
+                do {
+                    seqBefore = m_sequence.load(std::memory_order_acquire);
+                    result.id = m_id.load(std::memory_order_relaxed);
+                    result.sec = m_sec.load(std::memory_order_relaxed);
+                    result.frac = m_frac.load(std::memory_order_relaxed);
+                    result.period = m_period.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    seqAfter = m_sequence.load(std::memory_order_relaxed);
+                } while ((seqBefore & 1ull) || seqBefore != seqAfter);
+                return result;
+            }
+
+           private:
+            std::mutex m_writeMutex;
+            std::atomic<unsigned long long> m_sequence;
+            // Atomics only to avoid formal data races, consistency is ensured by m_sequence
+            std::atomic<unsigned long long> m_id;
+            std::atomic<unsigned long long> m_sec;
+            std::atomic<unsigned long long> m_frac;
+            std::atomic<unsigned long long> m_period;
+        };
+    } // namespace core
+} // namespace karabo
+
+#endif /* KARABO_CORE_TIMEREFERENCE_HH */
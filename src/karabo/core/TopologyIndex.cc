@@ -0,0 +1,144 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TopologyIndex.hh"
+
+using karabo::data::Hash;
+
+namespace karabo {
+
+    namespace core {
+
+        namespace {
+            std::string stringAttribute(const Hash::Attributes& attributes, const std::string& key) {
+                if (attributes.has(key) && attributes.is<std::string>(key)) {
+                    return attributes.get<std::string>(key);
+                }
+                return std::string();
+            }
+        } // namespace
+
+
+        TopologyIndex::TopologyIndex() : m_version(0ull) {}
+
+
+        void TopologyIndex::insert(const std::string& instanceId, const std::string& type,
+                                   const Hash::Attributes& instanceInfo) {
+            Entry entry{type, stringAttribute(instanceInfo, "serverId"), stringAttribute(instanceInfo, "classId"),
+                        stringAttribute(instanceInfo, "host")};
+            auto it = m_entries.find(instanceId);
+            if (it != m_entries.end()) {
+                removeFromSecondaries(instanceId, it->second);
+                it->second = std::move(entry);
+            } else {
+                it = m_entries.emplace(instanceId, std::move(entry)).first;
+            }
+            const Entry& newEntry = it->second;
+            add(m_byType, newEntry.type, instanceId);
+            add(m_byServer, newEntry.serverId, instanceId);
+            add(m_byClass, newEntry.classId, instanceId);
+            add(m_byHost, newEntry.host, instanceId);
+            ++m_version;
+        }
+
+
+        bool TopologyIndex::erase(const std::string& instanceId) {
+            auto it = m_entries.find(instanceId);
+            if (it == m_entries.end()) return false;
+            removeFromSecondaries(instanceId, it->second);
+            m_entries.erase(it);
+            ++m_version;
+            return true;
+        }
+
+
+        void TopologyIndex::clear() {
+            m_entries.clear();
+            m_byType.clear();
+            m_byServer.clear();
+            m_byClass.clear();
+            m_byHost.clear();
+            ++m_version;
+        }
+
+
+        const std::string& TopologyIndex::getType(const std::string& instanceId) const {
+            static const std::string unknown;
+            auto it = m_entries.find(instanceId);
+            return (it != m_entries.end() ? it->second.type : unknown);
+        }
+
+
+        std::vector<std::string> TopologyIndex::getByType(const std::string& type) const {
+            return get(m_byType, type);
+        }
+
+
+        std::vector<std::string> TopologyIndex::getByServer(const std::string& serverId) const {
+            return get(m_byServer, serverId);
+        }
+
+
+        std::vector<std::string> TopologyIndex::getByClass(const std::string& classId) const {
+            return get(m_byClass, classId);
+        }
+
+
+        std::vector<std::string> TopologyIndex::getByHost(const std::string& host) const {
+            return get(m_byHost, host);
+        }
+
+
+        size_t TopologyIndex::size() const {
+            return m_entries.size();
+        }
+
+
+        unsigned long long TopologyIndex::getVersion() const {
+            return m_version;
+        }
+
+
+        void TopologyIndex::add(SecondaryIndex& index, const std::string& key, const std::string& instanceId) {
+            if (!key.empty()) index[key].insert(instanceId);
+        }
+
+
+        void TopologyIndex::remove(SecondaryIndex& index, const std::string& key, const std::string& instanceId) {
+            auto it = index.find(key);
+            if (it == index.end()) return;
+            it->second.erase(instanceId);
+            if (it->second.empty()) index.erase(it);
+        }
+
+
+        std::vector<std::string> TopologyIndex::get(const SecondaryIndex& index, const std::string& key) {
+            auto it = index.find(key);
+            if (it == index.end()) return std::vector<std::string>();
+            return std::vector<std::string>(it->second.begin(), it->second.end());
+        }
+
+
+        void TopologyIndex::removeFromSecondaries(const std::string& instanceId, const Entry& entry) {
+            remove(m_byType, entry.type, instanceId);
+            remove(m_byServer, entry.serverId, instanceId);
+            remove(m_byClass, entry.classId, instanceId);
+            remove(m_byHost, entry.host, instanceId);
+        }
+    } // namespace core
+} // namespace karabo
@@ -0,0 +1,120 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_CORE_TOPOLOGYINDEX_HH
+#define KARABO_CORE_TOPOLOGYINDEX_HH
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "karabo/data/types/Hash.hh"
+
+namespace karabo {
+
+    namespace core {
+
+        /**
+         * @class TopologyIndex
+         * @brief Index of the instances in the system topology by their id and by some of their instanceInfo
+         *
+         * Lookups by instanceId are constant time, lookups of all instances of a given type, server, class or host
+         * only cost in proportion to the number of instances found.
+         *
+         * Not thread safe, except for getVersion(): the user protects it like the topology it indexes.
+         */
+        class TopologyIndex {
+           public:
+            TopologyIndex();
+
+            /**
+             * Add an instance or update it, e.g. after it changed its host
+             *
+             * @param instanceId of the instance
+             * @param type of the instance, e.g. "device" or "server"
+             * @param instanceInfo attributes of the instance in the topology - indexed are the string values of
+             *                     "serverId", "classId" and "host"
+             */
+            void insert(const std::string& instanceId, const std::string& type,
+                        const karabo::data::Hash::Attributes& instanceInfo);
+
+            /**
+             * Remove an instance
+             *
+             * @return whether the instance was known
+             */
+            bool erase(const std::string& instanceId);
+
+            /// Remove all instances
+            void clear();
+
+            /// Type of the instance, empty string if unknown
+            const std::string& getType(const std::string& instanceId) const;
+
+            /// Ids of all instances of the type, sorted
+            std::vector<std::string> getByType(const std::string& type) const;
+
+            /// Ids of all instances with the serverId, sorted
+            std::vector<std::string> getByServer(const std::string& serverId) const;
+
+            /// Ids of all instances with the classId, sorted
+            std::vector<std::string> getByClass(const std::string& classId) const;
+
+            /// Ids of all instances on the host, sorted
+            std::vector<std::string> getByHost(const std::string& host) const;
+
+            /// Number of instances
+            size_t size() const;
+
+            /**
+             * Counter that increases with every change - compare with an earlier value to know whether anything
+             * changed in between
+             */
+            unsigned long long getVersion() const;
+
+           private:
+            struct Entry {
+                std::string type;
+                std::string serverId;
+                std::string classId;
+                std::string host;
+            };
+
+            typedef std::unordered_map<std::string, std::set<std::string>> SecondaryIndex;
+
+            static void add(SecondaryIndex& index, const std::string& key, const std::string& instanceId);
+
+            static void remove(SecondaryIndex& index, const std::string& key, const std::string& instanceId);
+
+            static std::vector<std::string> get(const SecondaryIndex& index, const std::string& key);
+
+            void removeFromSecondaries(const std::string& instanceId, const Entry& entry);
+
+            std::unordered_map<std::string, Entry> m_entries;
+            SecondaryIndex m_byType;
+            SecondaryIndex m_byServer;
+            SecondaryIndex m_byClass;
+            SecondaryIndex m_byHost;
+            std::atomic<unsigned long long> m_version;
+        };
+    } // namespace core
+} // namespace karabo
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "BinaryFileIndex.hh"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace karabo {
+    namespace data {
+
+        namespace {
+            const char indexMagic[] = {'K', 'R', 'B', 'I', 'N', 'D', 'E', 'X'};
+            // dataEnd, number of records and magic
+            const size_t trailerSize = 2 * sizeof(unsigned long long) + sizeof(indexMagic);
+
+            /**
+             * Check the trailer, i.e. the last 'trailerSize' bytes of a file of size 'fileSize',
+             * and extract dataEnd and the number of records from it.
+             */
+            bool validTrailer(const char* trailer, unsigned long long fileSize, unsigned long long& dataEnd,
+                              unsigned long long& numRecords) {
+                if (std::memcmp(trailer + 2 * sizeof(unsigned long long), indexMagic, sizeof(indexMagic)) != 0) {
+                    return false;
+                }
+                std::memcpy(&dataEnd, trailer, sizeof(dataEnd));
+                std::memcpy(&numRecords, trailer + sizeof(dataEnd), sizeof(numRecords));
+                // Careful with overflows in case of garbage
+                if (numRecords > fileSize / sizeof(unsigned long long) || dataEnd > fileSize) return false;
+                return (fileSize - dataEnd == numRecords * sizeof(unsigned long long) + trailerSize);
+            }
+
+            bool validOffsets(const std::vector<unsigned long long>& offsets, unsigned long long dataEnd) {
+                unsigned long long previous = 0ull;
+                for (size_t i = 0; i < offsets.size(); ++i) {
+                    if ((i > 0 && offsets[i] <= previous) || offsets[i] >= dataEnd) return false;
+                    previous = offsets[i];
+                }
+                return true;
+            }
+        } // namespace
+
+
+        size_t binaryFileIndexSize(size_t numRecords) {
+            return numRecords * sizeof(unsigned long long) + trailerSize;
+        }
+
+
+        void writeBinaryFileIndex(std::ostream& out, const std::vector<unsigned long long>& offsets,
+                                  unsigned long long dataEnd) {
+            const unsigned long long numRecords = offsets.size();
+            out.write(reinterpret_cast<const char*>(offsets.data()), numRecords * sizeof(unsigned long long));
+            out.write(reinterpret_cast<const char*>(&dataEnd), sizeof(dataEnd));
+            out.write(reinterpret_cast<const char*>(&numRecords), sizeof(numRecords));
+            out.write(indexMagic, sizeof(indexMagic));
+        }
+
+
+        bool readBinaryFileIndex(const char* data, size_t size, std::vector<unsigned long long>& offsets,
+                                 unsigned long long& dataEnd) {
+            if (size < trailerSize) return false;
+            unsigned long long end = 0ull, numRecords = 0ull;
+            if (!validTrailer(data + size - trailerSize, size, end, numRecords)) return false;
+
+            std::vector<unsigned long long> tmp(numRecords);
+            std::memcpy(tmp.data(), data + end, numRecords * sizeof(unsigned long long));
+            if (!validOffsets(tmp, end)) return false;
+
+            offsets.swap(tmp);
+            dataEnd = end;
+            return true;
+        }
+
+
+        bool readBinaryFileIndex(std::istream& in, std::vector<unsigned long long>& offsets,
+                                 unsigned long long& dataEnd) {
+            in.seekg(0, std::ios::end);
+            const std::streamoff size = in.tellg();
+            if (!in || size < static_cast<std::streamoff>(trailerSize)) return false;
+
+            char trailer[trailerSize];
+            in.seekg(size - static_cast<std::streamoff>(trailerSize));
+            if (!in.read(trailer, trailerSize)) return false;
+            unsigned long long end = 0ull, numRecords = 0ull;
+            if (!validTrailer(trailer, size, end, numRecords)) return false;
+
+            std::vector<unsigned long long> tmp(numRecords);
+            in.seekg(end);
+            if (!in.read(reinterpret_cast<char*>(tmp.data()), numRecords * sizeof(unsigned long long))) return false;
+            if (!validOffsets(tmp, end)) return false;
+
+            offsets.swap(tmp);
+            dataEnd = end;
+            return true;
+        }
+    } // namespace data
+} // namespace karabo
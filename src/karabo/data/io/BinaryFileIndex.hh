@@ -0,0 +1,81 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_DATA_IO_BINARYFILEINDEX_HH
+#define KARABO_DATA_IO_BINARYFILEINDEX_HH
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace karabo {
+
+    namespace data {
+
+        /**
+         * Record index footer of binary files that contain one serialized object per record.
+         *
+         * The footer is appended after the last record:
+         *
+         *     offset[0] ... offset[N-1] | dataEnd | N | "KRBINDEX"
+         *
+         * with all numbers as native unsigned 64 bit integers. offset[i] is the position of record i in the file,
+         * dataEnd the position where the records end (and the footer starts).
+         */
+
+        /**
+         * Number of bytes of the footer for the given number of records
+         */
+        size_t binaryFileIndexSize(size_t numRecords);
+
+        /**
+         * Write the index footer to the current position of the stream
+         *
+         * @param out stream to write to
+         * @param offsets positions of the records
+         * @param dataEnd position where the records end, i.e. where the footer is written
+         */
+        void writeBinaryFileIndex(std::ostream& out, const std::vector<unsigned long long>& offsets,
+                                  unsigned long long dataEnd);
+
+        /**
+         * Read the index footer from a complete file in memory
+         *
+         * @param data begin of file content
+         * @param size size of file content
+         * @param offsets filled with the positions of the records
+         * @param dataEnd filled with the position where the records end
+         * @return false (and offsets, dataEnd untouched) if there is no valid footer
+         */
+        bool readBinaryFileIndex(const char* data, size_t size, std::vector<unsigned long long>& offsets,
+                                 unsigned long long& dataEnd);
+
+        /**
+         * Read the index footer from the end of a file stream, leaving the stream position undefined
+         *
+         * @param in stream of the file, opened in binary mode
+         * @param offsets filled with the positions of the records
+         * @param dataEnd filled with the position where the records end
+         * @return false (and offsets, dataEnd untouched) if there is no valid footer
+         */
+        bool readBinaryFileIndex(std::istream& in, std::vector<unsigned long long>& offsets,
+                                 unsigned long long& dataEnd);
+    } // namespace data
+} // namespace karabo
+
+#endif
@@ -25,11 +25,18 @@
 #ifndef KARABO_DATA_IO_BINARYFILEINPUT_HH
 #define KARABO_DATA_IO_BINARYFILEINPUT_HH
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <iosfwd>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
+#include "BinaryFileIndex.hh"
 #include "BinarySerializer.hh"
 #include "Input.hh"
 #include "karabo/data/schema/Configurator.hh"
@@ -52,13 +59,37 @@ namespace karabo {
          *        data from a binary file types T have been serialized to. The actual
          *        serialization format depends on the Serializer selected in this
          *        class' configuration.
+         *
+         *        By default the full file is read and deserialized when constructing.
+         *        In memory mapped mode, the file is mapped and a record is deserialized
+         *        only when read. The positions of the records are taken from the index
+         *        footer written by the BinaryFileOutput with 'recordIndex' enabled. Without
+         *        such a footer, the file is scanned once for concatenated records.
          */
         template <class T>
         class BinaryFileInput : public Input<T> {
             std::filesystem::path m_filename;
+            std::string m_serializerClassId;
+            karabo::data::Hash m_serializerConfig;
             typename BinarySerializer<T>::Pointer m_serializer;
             std::vector<T> m_sequenceBuffer;
 
+            // Memory mapped mode
+            bool m_memoryMapped;
+            boost::interprocess::file_mapping m_mapping;
+            boost::interprocess::mapped_region m_region;
+            std::vector<unsigned long long> m_offsets;
+            unsigned long long m_dataEnd;
+
+            // Background prefetching of the records following the last one read
+            unsigned int m_prefetch;
+            std::thread m_prefetchThread;
+            std::mutex m_prefetchMutex;
+            std::condition_variable m_prefetchCondition;
+            std::map<size_t, T> m_prefetched;
+            size_t m_prefetchBegin;
+            bool m_stopPrefetch;
+
            public:
             KARABO_CLASSINFO(BinaryFileInput<T>, "BinaryFile", "1.0");
 
@@ -85,31 +116,190 @@ namespace karabo {
                       .key("Bin")
                       .appendParametersOfConfigurableClass<BinarySerializer<T>>("Bin")
                       .commit();
+
+                BOOL_ELEMENT(expected)
+                      .key("memoryMapped")
+                      .displayedName("Memory Mapped")
+                      .description(
+                            "If true, the file is memory mapped and records are deserialized only when read. "
+                            "Otherwise the full file is read and deserialized when the input is created.")
+                      .assignmentOptional()
+                      .defaultValue(false)
+                      .commit();
+
+                UINT32_ELEMENT(expected)
+                      .key("prefetch")
+                      .displayedName("Prefetch")
+                      .description(
+                            "Number of records following the one read last that are deserialized in a background "
+                            "thread (memory mapped mode only)")
+                      .assignmentOptional()
+                      .defaultValue(0u)
+                      .commit();
             }
 
             BinaryFileInput(const karabo::data::Hash& config)
-                : Input<T>(config), m_filename(config.get<std::string>("filename")) {
+                : Input<T>(config),
+                  m_filename(config.get<std::string>("filename")),
+                  m_memoryMapped(false),
+                  m_dataEnd(0ull),
+                  m_prefetch(0u),
+                  m_prefetchBegin(0u),
+                  m_stopPrefetch(false) {
                 if (config.has("format")) {
-                    const std::string& selected = config.get<std::string>("format");
-                    m_serializer = BinarySerializer<T>::create(selected, config.get<Hash>(selected));
+                    m_serializerClassId = config.get<std::string>("format");
+                    m_serializerConfig = config.get<Hash>(m_serializerClassId);
+                    m_serializer = BinarySerializer<T>::create(m_serializerClassId, m_serializerConfig);
                 } else {
                     guessAndSetFormat();
                 }
-                // Read file already here
-                std::vector<char> archive;
-                readFile(archive);
-                m_serializer->load(m_sequenceBuffer, archive);
+                config.get("memoryMapped", m_memoryMapped);
+                config.get("prefetch", m_prefetch);
+
+                if (m_memoryMapped) {
+                    mapFile();
+                    if (m_prefetch > 0u && !m_offsets.empty()) {
+                        m_prefetchThread = std::thread(&BinaryFileInput<T>::prefetchLoop, this);
+                    }
+                } else {
+                    // Read file already here
+                    std::vector<char> archive;
+                    readFile(archive);
+                    if (readBinaryFileIndex(archive.data(), archive.size(), m_offsets, m_dataEnd)) {
+                        m_sequenceBuffer.resize(m_offsets.size());
+                        for (size_t i = 0; i < m_offsets.size(); ++i) {
+                            const unsigned long long end = (i + 1 < m_offsets.size() ? m_offsets[i + 1] : m_dataEnd);
+                            m_serializer->load(m_sequenceBuffer[i], archive.data() + m_offsets[i], end - m_offsets[i]);
+                        }
+                    } else {
+                        m_serializer->load(m_sequenceBuffer, archive);
+                    }
+                }
+            }
+
+            virtual ~BinaryFileInput() {
+                if (m_prefetchThread.joinable()) {
+                    {
+                        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+                        m_stopPrefetch = true;
+                    }
+                    m_prefetchCondition.notify_one();
+                    m_prefetchThread.join();
+                }
             }
 
             void read(T& data, size_t idx = 0) {
-                data = m_sequenceBuffer[idx];
+                if (!m_memoryMapped) {
+                    data = m_sequenceBuffer[idx];
+                    return;
+                }
+                if (idx >= m_offsets.size()) {
+                    throw KARABO_PARAMETER_EXCEPTION("Record " + karabo::data::toString(idx) + " requested, but " +
+                                                     m_filename.string() + " has only " +
+                                                     karabo::data::toString(m_offsets.size()));
+                }
+                if (m_prefetchThread.joinable()) {
+                    std::unique_lock<std::mutex> lock(m_prefetchMutex);
+                    auto it = m_prefetched.find(idx);
+                    const bool found = (it != m_prefetched.end());
+                    if (found) data = std::move(it->second);
+                    // Move the prefetch window behind the requested record and forget what is outside
+                    m_prefetchBegin = idx + 1;
+                    m_prefetched.erase(m_prefetched.begin(), m_prefetched.lower_bound(m_prefetchBegin));
+                    m_prefetched.erase(m_prefetched.lower_bound(m_prefetchBegin + m_prefetch), m_prefetched.end());
+                    lock.unlock();
+                    m_prefetchCondition.notify_one();
+                    if (found) return;
+                }
+                loadRecord(*m_serializer, data, idx);
             }
 
             size_t size() {
-                return m_sequenceBuffer.size();
+                return (m_memoryMapped ? m_offsets.size() : m_sequenceBuffer.size());
             }
 
            private:
+            void mapFile() {
+                using namespace boost::interprocess;
+
+                const std::string filename = m_filename.string();
+                if (!std::filesystem::exists(m_filename)) {
+                    throw KARABO_IO_EXCEPTION("Cannot open file: " + filename);
+                }
+                if (std::filesystem::file_size(m_filename) == 0u) return; // nothing to map, no records
+                try {
+                    file_mapping mapping(filename.c_str(), read_only);
+                    mapped_region region(mapping, read_only);
+                    m_mapping.swap(mapping);
+                    m_region.swap(region);
+                } catch (const interprocess_exception& e) {
+                    throw KARABO_IO_EXCEPTION("Cannot map file " + filename + ": " + e.what());
+                }
+                const char* data = static_cast<const char*>(m_region.get_address());
+                const size_t size = m_region.get_size();
+                if (!readBinaryFileIndex(data, size, m_offsets, m_dataEnd)) {
+                    // No index footer: find the records by deserializing them once
+                    T object;
+                    size_t pos = 0;
+                    while (pos < size) {
+                        const size_t nBytes = m_serializer->load(object, data + pos, size - pos);
+                        if (nBytes == 0u) {
+                            throw KARABO_IO_EXCEPTION("Failed to index records of file: " + filename);
+                        }
+                        m_offsets.push_back(pos);
+                        pos += nBytes;
+                    }
+                    m_dataEnd = pos;
+                }
+            }
+
+            void loadRecord(BinarySerializer<T>& serializer, T& data, size_t idx) const {
+                const char* begin = static_cast<const char*>(m_region.get_address());
+                const unsigned long long start = m_offsets[idx];
+                const unsigned long long end = (idx + 1 < m_offsets.size() ? m_offsets[idx + 1] : m_dataEnd);
+                serializer.load(data, begin + start, end - start);
+            }
+
+            /**
+             * Find the next record inside the prefetch window that is not yet prefetched.
+             * Requires m_prefetchMutex to be locked.
+             */
+            bool nextToPrefetch(size_t& next) const {
+                const size_t end = std::min(m_prefetchBegin + m_prefetch, m_offsets.size());
+                for (size_t i = m_prefetchBegin; i < end; ++i) {
+                    if (m_prefetched.find(i) == m_prefetched.end()) {
+                        next = i;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void prefetchLoop() {
+                // Own serializer to not share any state with read(..)
+                typename BinarySerializer<T>::Pointer serializer =
+                      BinarySerializer<T>::create(m_serializerClassId, m_serializerConfig);
+                std::unique_lock<std::mutex> lock(m_prefetchMutex);
+                while (true) {
+                    size_t next = 0;
+                    m_prefetchCondition.wait(lock, [this, &next]() { return m_stopPrefetch || nextToPrefetch(next); });
+                    if (m_stopPrefetch) return;
+                    lock.unlock();
+                    T object;
+                    try {
+                        loadRecord(*serializer, object, next);
+                    } catch (const std::exception&) {
+                        // Give up prefetching - read(..) will load itself and report the problem
+                        return;
+                    }
+                    lock.lock();
+                    // Window might have moved meanwhile
+                    if (next >= m_prefetchBegin && next < m_prefetchBegin + m_prefetch) {
+                        m_prefetched[next] = std::move(object);
+                    }
+                }
+            }
+
             void guessAndSetFormat() {
                 using namespace std;
                 using namespace karabo::data;
@@ -122,6 +312,7 @@ namespace karabo {
                     string lKey(key);
                     boost::to_lower(lKey);
                     if (lKey == extension) {
+                        m_serializerClassId = key;
                         m_serializer = BinarySerializer<T>::create(key);
                         return;
                     }
@@ -31,6 +31,7 @@
 #include <iosfwd>
 #include <sstream>
 
+#include "BinaryFileIndex.hh"
 #include "BinarySerializer.hh"
 #include "Output.hh"
 #include "karabo/data/schema/Configurator.hh"
@@ -47,6 +48,11 @@ namespace karabo {
          *        data of type T to a binary file. The actual
          *        serialization format depends on the Serializer selected in this
          *        class' configuration.
+         *
+         *        With 'recordIndex' enabled, each object is appended to the file as a record
+         *        of its own and a footer indexing the records is (re-)written on update()
+         *        and on destruction. BinaryFileInput can then access the records individually
+         *        without reading the full file.
          */
         template <class T>
         class BinaryFileOutput : public Output<T> {
@@ -55,6 +61,13 @@ namespace karabo {
             typename BinarySerializer<T>::Pointer m_serializer;
             std::vector<T> m_sequenceBuffer;
 
+            // Record index mode
+            bool m_recordIndex;
+            std::fstream m_file;
+            std::vector<unsigned long long> m_offsets;
+            unsigned long long m_dataEnd;
+            bool m_indexPending;
+
            public:
             KARABO_CLASSINFO(BinaryFileOutput<T>, "BinaryFile", "1.0")
 
@@ -70,9 +83,10 @@ namespace karabo {
 
                 STRING_ELEMENT(expected)
                       .key("writeMode")
-                      .description("Defines the behaviour in case of already existent file")
+                      .description(
+                            "Defines the behaviour in case of already existent file ('append' requires 'recordIndex')")
                       .displayedName("Write Mode")
-                      .options("exclusive, truncate")
+                      .options("exclusive, truncate, append")
                       .assignmentOptional()
                       .defaultValue(std::string("truncate"))
                       .commit();
@@ -90,11 +104,29 @@ namespace karabo {
                       .key("Bin")
                       .appendParametersOfConfigurableClass<BinarySerializer<T>>("Bin")
                       .commit();
+
+                BOOL_ELEMENT(expected)
+                      .key("recordIndex")
+                      .displayedName("Record Index")
+                      .description(
+                            "If true, each object is appended to the file as a record of its own and an index of "
+                            "all records is written as footer of the file")
+                      .assignmentOptional()
+                      .defaultValue(false)
+                      .commit();
             }
 
             BinaryFileOutput(const karabo::data::Hash& config)
-                : Output<T>(config), m_filename(config.get<std::string>("filename")) {
+                : Output<T>(config),
+                  m_filename(config.get<std::string>("filename")),
+                  m_recordIndex(false),
+                  m_dataEnd(0ull),
+                  m_indexPending(false) {
                 config.get("writeMode", m_writeMode);
+                config.get("recordIndex", m_recordIndex);
+                if (m_writeMode == "append" && !m_recordIndex) {
+                    throw KARABO_PARAMETER_EXCEPTION("Write mode 'append' requires 'recordIndex'");
+                }
                 if (config.has("format")) {
                     const std::string& selected = config.get<std::string>("format");
                     m_serializer = BinarySerializer<T>::create(selected, config.get<Hash>(selected));
@@ -103,8 +135,19 @@ namespace karabo {
                 }
             }
 
+            virtual ~BinaryFileOutput() {
+                try {
+                    writeIndex();
+                } catch (const std::exception&) {
+                    // Must not throw from destructor - the file then lacks its index
+                }
+            }
+
             void write(const T& data) {
-                if (this->m_appendModeEnabled) {
+                if (m_recordIndex) {
+                    // Rewriting the index after each record would be quadratic in the number of records
+                    appendRecord(data);
+                } else if (this->m_appendModeEnabled) {
                     m_sequenceBuffer.push_back(data);
                 } else {
                     std::vector<char> archive;
@@ -115,7 +158,9 @@ namespace karabo {
 
            private:
             void update() {
-                if (this->m_appendModeEnabled) {
+                if (m_recordIndex) {
+                    writeIndex();
+                } else if (this->m_appendModeEnabled) {
                     std::vector<char> archive;
                     m_serializer->save(m_sequenceBuffer, archive);
                     writeFile(archive);
@@ -142,6 +187,59 @@ namespace karabo {
                 throw KARABO_NOT_SUPPORTED_EXCEPTION("Can not interprete extension: \"" + extension + "\"");
             }
 
+            void openIndexedFile() {
+                using namespace std;
+
+                if (m_file.is_open()) return;
+                const string filename = m_filename.string();
+                if (m_writeMode == "append" && std::filesystem::exists(m_filename)) {
+                    m_file.open(filename.c_str(), ios::in | ios::out | ios::binary);
+                    if (!m_file.is_open()) {
+                        throw KARABO_IO_EXCEPTION("Cannot open file: " + filename);
+                    }
+                    if (!readBinaryFileIndex(m_file, m_offsets, m_dataEnd)) {
+                        m_file.close();
+                        throw KARABO_IO_EXCEPTION("File " + filename + " has no record index to append to");
+                    }
+                    m_file.clear();
+                } else {
+                    if (m_writeMode == "exclusive" && std::filesystem::exists(m_filename)) {
+                        throw KARABO_IO_EXCEPTION("File " + filename + " does already exist");
+                    }
+                    m_file.open(filename.c_str(), ios::out | ios::trunc | ios::binary);
+                    if (!m_file.is_open()) {
+                        throw KARABO_IO_EXCEPTION("Cannot open file: " + filename);
+                    }
+                }
+            }
+
+            void appendRecord(const T& data) {
+                openIndexedFile();
+                std::vector<char> archive;
+                m_serializer->save(data, archive);
+                // Overwrites a previously written index - it will be rewritten with the new record
+                m_file.seekp(m_dataEnd);
+                m_file.write(archive.data(), archive.size());
+                if (!m_file) {
+                    throw KARABO_IO_EXCEPTION("Failed to write to file: " + m_filename.string());
+                }
+                m_offsets.push_back(m_dataEnd);
+                m_dataEnd += archive.size();
+                m_indexPending = true;
+            }
+
+            void writeIndex() {
+                if (!m_indexPending) return;
+                // Records and index only grow, so the file never needs to be truncated
+                m_file.seekp(m_dataEnd);
+                writeBinaryFileIndex(m_file, m_offsets, m_dataEnd);
+                m_file.flush();
+                if (!m_file) {
+                    throw KARABO_IO_EXCEPTION("Failed to write record index to file: " + m_filename.string());
+                }
+                m_indexPending = false;
+            }
+
             void writeFile(std::vector<char>& buffer) {
                 using namespace std;
 
@@ -19,6 +19,7 @@
 
 #include "BinarySerializer.hh"
 #include "boost/core/null_deleter.hpp"
+#include "karabo/data/types/BufferPool.hh"
 #include "karabo/data/types/StringTools.hh"
 
 /**
@@ -67,14 +68,14 @@ namespace karabo {
                 if (m_buffers.empty() || m_buffers.back().size) {
                     // See https://www.boost.org/doc/libs/1_61_0/libs/smart_ptr/sp_techniques.html#array
                     m_buffers.push_back(Buffer(std::shared_ptr<BufferType>(new BufferType()),
-                                               std::shared_ptr<char>(new char[size], std::default_delete<char[]>()),
+                                               BufferPool::allocate(size),
                                                size, BufferContents::NO_COPY_BYTEARRAY_CONTENTS));
                     m_currentBuffer++;
                 } else {
                     // Last buffer in BufferSet has size 0 - assign it a newly allocated buffer of size.
                     m_buffers[m_buffers.size() - 1] =
                           Buffer(std::shared_ptr<BufferType>(new BufferType()),
-                                 std::shared_ptr<char>(new char[size], std::default_delete<char[]>()), size,
+                                 BufferPool::allocate(size), size,
                                  BufferContents::NO_COPY_BYTEARRAY_CONTENTS);
                 }
             } else {
@@ -83,6 +84,52 @@ namespace karabo {
         }
 
 
+        void BufferSet::add(const karabo::data::ByteArray& array) {
+            updateSize();
+            Buffer buffer(std::shared_ptr<BufferType>(new BufferType()), array.first, array.second,
+                          BufferContents::NO_COPY_BYTEARRAY_CONTENTS);
+            if (m_buffers.empty() || m_buffers.back().size) {
+                m_buffers.push_back(std::move(buffer));
+                m_currentBuffer++;
+            } else {
+                m_buffers.back() = std::move(buffer);
+            }
+        }
+
+
+        void BufferSet::insert(std::size_t position, const karabo::data::ByteArray& array) {
+            updateSize();
+            // Directly behind the preceding non-empty buffer (that e.g. contains the size of the array)
+            auto it = m_buffers.begin();
+            for (std::size_t nonEmpty = 0; position > 0 && it != m_buffers.end();) {
+                if ((it++)->size > 0 && ++nonEmpty == position) break;
+            }
+            m_buffers.insert(it, Buffer(std::shared_ptr<BufferType>(new BufferType()), array.first, array.second,
+                                        BufferContents::NO_COPY_BYTEARRAY_CONTENTS));
+            rewind();
+        }
+
+
+        BufferSet::Pointer BufferSet::copyWithout(
+              const std::function<bool(std::size_t, const karabo::data::ByteArray&)>& leaveOut) const {
+            BufferSet::Pointer result(new BufferSet(false));
+            result->m_buffers.clear();
+            std::size_t nonEmpty = 0;
+            for (const Buffer& buffer : m_buffers) {
+                if (buffer.size > 0) {
+                    const std::size_t position = nonEmpty++;
+                    if (buffer.contentType == BufferContents::NO_COPY_BYTEARRAY_CONTENTS &&
+                        leaveOut(position, std::make_pair(buffer.ptr, buffer.size))) {
+                        continue;
+                    }
+                }
+                result->m_buffers.push_back(buffer);
+            }
+            if (result->m_buffers.empty()) result->m_buffers.push_back(Buffer());
+            return result;
+        }
+
+
         bool BufferSet::next() const {
             if (m_currentBuffer + 1 < m_buffers.size()) {
                 m_currentBuffer++;
@@ -110,7 +157,7 @@ namespace karabo {
             if (m_copyAllData) {
                 // Copy, but keep an extra buffer: That's beneficial when further processed, e.g. de-serialised.
                 m_buffers.push_back(Buffer(std::shared_ptr<BufferType>(new BufferType()),
-                                           std::shared_ptr<char>(new char[arraySize], std::default_delete<char[]>()),
+                                           BufferPool::allocate(arraySize),
                                            arraySize, BufferContents::NO_COPY_BYTEARRAY_CONTENTS));
 
                 auto* rawPtrDest = m_buffers.back().ptr.get();
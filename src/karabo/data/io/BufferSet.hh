@@ -26,6 +26,7 @@
 #define KARABO_DATA_IO_BUFFERSET_HH
 
 #include <boost/asio/buffer.hpp> //boost::asio::const_buffer
+#include <functional>            //std::function
 #include <memory>                //std::shared_ptr<T>
 #include <ostream>               //std::ostream
 #include <vector>                //std::vector
@@ -119,6 +120,33 @@ namespace karabo {
              */
             void add(std::size_t size, int type);
 
+            /**
+             * Add a buffer of NO_COPY_BYTEARRAY_CONTENTS type that refers to the given memory instead of allocating
+             * it, e.g. a slice of a larger receive buffer. As add(size, type), it replaces the last buffer if that is
+             * empty.
+             * @param array - memory and its size, kept alive as long as the buffer (or ByteArrays taken from it)
+             */
+            void add(const karabo::data::ByteArray& array);
+
+            /**
+             * Insert a buffer of NO_COPY_BYTEARRAY_CONTENTS type that refers to the given memory, e.g. to put back a
+             * buffer that copyWithout(..) has left out. Rewinds the BufferSet.
+             * @param position that the buffer gets among the non-empty buffers - it is placed directly behind the
+             *                 preceding non-empty buffer
+             * @param array - memory and its size, kept alive as long as the buffer (or ByteArrays taken from it)
+             */
+            void insert(std::size_t position, const karabo::data::ByteArray& array);
+
+            /**
+             * Create a BufferSet sharing the buffers of this one, but leaving out some buffers of
+             * NO_COPY_BYTEARRAY_CONTENTS type, e.g. to transfer their data in another way.
+             * @param leaveOut called for each non-empty buffer of NO_COPY_BYTEARRAY_CONTENTS type with its position
+             *                 among the non-empty buffers and its content - returns true if the buffer shall be left
+             *                 out
+             */
+            BufferSet::Pointer copyWithout(
+                  const std::function<bool(std::size_t, const karabo::data::ByteArray&)>& leaveOut) const;
+
             /**
              * Update the size of the current buffer to reflect the size of the vector is refers to
              */
@@ -24,6 +24,7 @@
 #include <boost/shared_array.hpp>
 
 #include "SchemaBinarySerializer.hh"
+#include "karabo/data/types/BufferPool.hh"
 
 using namespace karabo::data;
 using namespace std;
@@ -680,13 +681,13 @@ namespace karabo {
         template <>
         karabo::data::ByteArray HashBinarySerializer::readSingleValue(std::istream& is) const {
             const size_t size = readSize(is);
-            ByteArray result(std::shared_ptr<char>(new char[size], std::default_delete<char[]>()), size);
+            ByteArray result(BufferPool::allocate(size), size);
             is.read(result.first.get(), size);
             return result;
         }
 
         karabo::data::ByteArray HashBinarySerializer::readByteArrayAsCopy(std::istream& is, size_t size) const {
-            ByteArray result(std::shared_ptr<char>(new char[size], std::default_delete<char[]>()), size);
+            ByteArray result(BufferPool::allocate(size), size);
             is.read(result.first.get(), size);
             return result;
         }
@@ -0,0 +1,208 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "BufferPool.hh"
+
+#include <sys/mman.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace karabo {
+    namespace data {
+
+        namespace {
+
+            // Size classes are 2^n, 1.25 * 2^n, 1.5 * 2^n and 1.75 * 2^n for n from 12 (i.e. 4 kiB) to 47
+            const unsigned int minPooledExponent = 12;
+            const unsigned int maxPooledExponent = 47;
+            const unsigned int numClasses = 4 * (maxPooledExponent + 1 - minPooledExponent);
+            // From this size on buffers are mapped, for multiples of it as huge pages
+            const size_t hugePageSize = 2ul * 1024ul * 1024ul;
+
+            struct Pool {
+                std::mutex mutex;
+                std::array<std::vector<char*>, numClasses> freeBuffers;
+                size_t residentBytes = 0;
+                size_t residentBuffers = 0;
+                std::atomic<size_t> maxResidentBytes{0ul}; // disabled unless configured
+                std::atomic<unsigned long long> hits{0ull};
+                std::atomic<unsigned long long> misses{0ull};
+                std::atomic<bool> tryHugeTlb{true};
+            };
+
+            Pool& pool() {
+                // Never destructed: buffers may still be given back during static destruction
+                static Pool* thePool = new Pool();
+                return *thePool;
+            }
+
+            /// Number of bytes of the buffers of a size class
+            size_t classSize(unsigned int sizeClass) {
+                const unsigned int exponent = minPooledExponent + sizeClass / 4;
+                return static_cast<size_t>(4u + sizeClass % 4) << (exponent - 2);
+            }
+
+            /// Smallest size class with buffers of at least byteSize bytes, numClasses if not pooled
+            unsigned int sizeClassOf(size_t byteSize) {
+                if (byteSize == 0ul) return numClasses;
+                unsigned int exponent = std::bit_width(byteSize) - 1u; // i.e. 2^exponent <= byteSize
+                if (exponent < minPooledExponent) return numClasses;
+                const unsigned int quarterShift = exponent - 2u;
+                size_t quarters = (byteSize - (1ul << exponent) + (1ul << quarterShift) - 1ul) >> quarterShift;
+                if (quarters == 4ul) {
+                    ++exponent;
+                    quarters = 0ul;
+                }
+                if (exponent > maxPooledExponent) return numClasses;
+                return 4u * (exponent - minPooledExponent) + quarters;
+            }
+
+            char* allocateBuffer(unsigned int sizeClass) {
+                const size_t size = classSize(sizeClass);
+                if (size < hugePageSize) return new char[size];
+
+                Pool& p = pool();
+                void* ptr = MAP_FAILED;
+                if (p.tryHugeTlb && size % hugePageSize == 0ul) {
+                    // Needs huge pages reserved by the administrator - do not retry once that failed
+                    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1,
+                               0);
+                    if (ptr == MAP_FAILED) p.tryHugeTlb = false;
+                }
+                if (ptr == MAP_FAILED) {
+                    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (ptr == MAP_FAILED) throw std::bad_alloc();
+                    // Ask for transparent huge pages instead
+                    madvise(ptr, size, MADV_HUGEPAGE);
+                }
+                return static_cast<char*>(ptr);
+            }
+
+            void freeBuffer(char* buffer, unsigned int sizeClass) {
+                const size_t size = classSize(sizeClass);
+                if (size < hugePageSize) {
+                    delete[] buffer;
+                } else {
+                    munmap(buffer, size);
+                }
+            }
+
+            /**
+             * Free unused buffers until the resident bytes are within the limit.
+             * Requires the pool mutex to be locked.
+             */
+            void shrink(Pool& p) {
+                for (unsigned int sizeClass = numClasses; sizeClass-- > 0u;) {
+                    std::vector<char*>& buffers = p.freeBuffers[sizeClass];
+                    while (p.residentBytes > p.maxResidentBytes && !buffers.empty()) {
+                        freeBuffer(buffers.back(), sizeClass);
+                        buffers.pop_back();
+                        p.residentBytes -= classSize(sizeClass);
+                        --p.residentBuffers;
+                    }
+                }
+            }
+
+            struct PoolDeleter {
+                unsigned int sizeClass;
+
+                void operator()(char* buffer) const {
+                    const size_t size = classSize(sizeClass);
+                    Pool& p = pool();
+                    {
+                        std::lock_guard<std::mutex> lock(p.mutex);
+                        if (p.residentBytes + size <= p.maxResidentBytes) {
+                            p.freeBuffers[sizeClass].push_back(buffer);
+                            p.residentBytes += size;
+                            ++p.residentBuffers;
+                            return;
+                        }
+                    }
+                    freeBuffer(buffer, sizeClass);
+                }
+            };
+        } // namespace
+
+
+        std::shared_ptr<char> BufferPool::allocate(size_t byteSize) {
+            Pool& p = pool();
+            const unsigned int sizeClass = sizeClassOf(byteSize);
+            if (sizeClass >= numClasses || p.maxResidentBytes == 0ul) {
+                return std::shared_ptr<char>(new char[byteSize], std::default_delete<char[]>());
+            }
+
+            char* buffer = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(p.mutex);
+                std::vector<char*>& buffers = p.freeBuffers[sizeClass];
+                if (!buffers.empty()) {
+                    buffer = buffers.back();
+                    buffers.pop_back();
+                    p.residentBytes -= classSize(sizeClass);
+                    --p.residentBuffers;
+                }
+            }
+            if (buffer) {
+                ++p.hits;
+            } else {
+                ++p.misses;
+                buffer = allocateBuffer(sizeClass);
+            }
+            return std::shared_ptr<char>(buffer, PoolDeleter{sizeClass});
+        }
+
+
+        karabo::data::Hash BufferPool::getStatistics() {
+            Pool& p = pool();
+            std::lock_guard<std::mutex> lock(p.mutex);
+            return Hash("hits", p.hits.load(), "misses", p.misses.load(), "residentBytes",
+                        static_cast<unsigned long long>(p.residentBytes), "residentBuffers",
+                        static_cast<unsigned long long>(p.residentBuffers));
+        }
+
+
+        void BufferPool::setMaxResidentBytes(size_t maxBytes) {
+            Pool& p = pool();
+            std::lock_guard<std::mutex> lock(p.mutex);
+            p.maxResidentBytes = maxBytes;
+            shrink(p);
+        }
+
+
+        size_t BufferPool::getMaxResidentBytes() {
+            Pool& p = pool();
+            std::lock_guard<std::mutex> lock(p.mutex);
+            return p.maxResidentBytes;
+        }
+
+
+        void BufferPool::clear() {
+            Pool& p = pool();
+            std::lock_guard<std::mutex> lock(p.mutex);
+            const size_t maxBytes = p.maxResidentBytes;
+            p.maxResidentBytes = 0ul;
+            shrink(p);
+            p.maxResidentBytes = maxBytes;
+        }
+    } // namespace data
+} // namespace karabo
@@ -0,0 +1,83 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_DATA_TYPES_BUFFERPOOL_HH
+#define KARABO_DATA_TYPES_BUFFERPOOL_HH
+
+#include <cstddef>
+#include <memory>
+
+#include "Hash.hh"
+
+namespace karabo {
+    namespace data {
+
+        /**
+         * @class BufferPool
+         * @brief Process wide pool of byte buffers, e.g. for NDArray data and ByteArrays.
+         *
+         * The pool is disabled by default, i.e. allocate(..) then just allocates the requested bytes.
+         * It is enabled by setMaxResidentBytes(..) with a non-zero limit, e.g. by the 'bufferPoolSize' of the
+         * DeviceServer.
+         *
+         * If enabled, buffers are grouped in size classes of a quarter of a power of two, so at most 25% of
+         * a buffer is unused. When the last reference to a buffer obtained from allocate(..) is dropped, the
+         * buffer goes back to the pool and is handed out again for the next request of the same size class.
+         * The pool keeps at most getMaxResidentBytes() in unused buffers, everything beyond is freed.
+         *
+         * Pooled buffers of at least 2 MiB are directly mapped from the operating system, using huge pages if
+         * available. Buffers below 4 kiB are not pooled.
+         */
+        class BufferPool {
+           public:
+            /**
+             * Get a buffer of (at least) byteSize bytes, content is undefined.
+             *
+             * @param byteSize number of bytes needed
+             * @return pointer to the buffer that is given back to the pool when the last copy is destructed
+             */
+            static std::shared_ptr<char> allocate(size_t byteSize);
+
+            /**
+             * Get pool statistics:
+             * - hits: number of allocations served from the pool
+             * - misses: number of allocations that needed new memory
+             * - residentBytes: bytes kept in unused buffers
+             * - residentBuffers: number of unused buffers
+             *
+             * Hits and misses count only allocations of pooled sizes while the pool is enabled.
+             */
+            static karabo::data::Hash getStatistics();
+
+            /**
+             * Limit the total size of unused buffers kept in the pool - 0 (the default) disables pooling.
+             * Unused buffers exceeding a reduced limit are freed.
+             */
+            static void setMaxResidentBytes(size_t maxBytes);
+
+            static size_t getMaxResidentBytes();
+
+            /**
+             * Free all unused buffers
+             */
+            static void clear();
+        };
+    } // namespace data
+} // namespace karabo
+
+#endif
@@ -40,6 +40,8 @@
 #include <list>
 
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
 
@@ -759,7 +761,38 @@ namespace karabo {
             template <class Visitor>
             bool visit2(Visitor& visitor);
 
+            /**
+             * Call 'leafFunc(path, node)' for every leaf of the hash, in the same order as getPaths.
+             *
+             * Paths are the keys of the hierarchy levels glued together by 'separator', with "[i]" appended for the
+             * elements of vectors of Hashes. Hash sub classes (NDArray, ImageData) are leaves. Whether a vector of
+             * Hashes is a leaf itself or whether its elements are iterated is decided by 'isVectorLeaf(path, node)'.
+             * In contrast to getPaths, empty Hashes (and thus empty vectors of Hashes that are iterated) do not show up.
+             *
+             * Since the path is built in a single buffer while walking the tree, this is much cheaper than getPaths
+             * followed by a getNode(path) for each path. The path passed to 'leafFunc' is only valid during the call.
+             *
+             * @param leafFunc callable with signature void(const std::string& path, const Hash::Node& node)
+             * @param isVectorLeaf callable with signature bool(const std::string& path, const Hash::Node& node)
+             * @param separator to glue keys of the hierarchy levels
+             */
+            template <class LeafFunc, class VectorLeafPredicate>
+            requires std::is_invocable_r_v<bool, VectorLeafPredicate&, const std::string&, const Node&>
+            void forEachLeaf(LeafFunc&& leafFunc, VectorLeafPredicate&& isVectorLeaf,
+                             const char separator = k_defaultSep) const;
+
+            /**
+             * Call 'leafFunc(path, node)' for every leaf of the hash, iterating into all vectors of Hashes.
+             * See forEachLeaf(leafFunc, isVectorLeaf, separator) for details.
+             */
+            template <class LeafFunc>
+            void forEachLeaf(LeafFunc&& leafFunc, const char separator = k_defaultSep) const;
+
            private:
+            template <class LeafFunc, class VectorLeafPredicate>
+            static void forEachLeaf_r(const Hash& hash, std::string& path, LeafFunc& leafFunc,
+                                      VectorLeafPredicate& isVectorLeaf, const char separator);
+
             template <class Visitor>
             static bool visit(karabo::data::Hash& hash, Visitor& visitor);
 
@@ -1190,6 +1223,45 @@ namespace karabo {
             return true;
         }
 
+        template <class LeafFunc, class VectorLeafPredicate>
+        requires std::is_invocable_r_v<bool, VectorLeafPredicate&, const std::string&, const Hash::Node&>
+        void Hash::forEachLeaf(LeafFunc&& leafFunc, VectorLeafPredicate&& isVectorLeaf, const char separator) const {
+            std::string path;
+            forEachLeaf_r(*this, path, leafFunc, isVectorLeaf, separator);
+        }
+
+        template <class LeafFunc>
+        void Hash::forEachLeaf(LeafFunc&& leafFunc, const char separator) const {
+            forEachLeaf(
+                  leafFunc, [](const std::string&, const Node&) { return false; }, separator);
+        }
+
+        template <class LeafFunc, class VectorLeafPredicate>
+        void Hash::forEachLeaf_r(const Hash& hash, std::string& path, LeafFunc& leafFunc,
+                                 VectorLeafPredicate& isVectorLeaf, const char separator) {
+            const size_t prefixSize = path.size();
+            for (const_iterator it = hash.begin(), end = hash.end(); it != end; ++it) {
+                if (prefixSize > 0) path += separator;
+                path += it->getKey();
+                if (it->is<Hash>() && !it->hasAttribute(KARABO_HASH_CLASS_ID)) { // Recursion, but no hash sub classes
+                    forEachLeaf_r(it->getValue<Hash>(), path, leafFunc, isVectorLeaf, separator);
+                } else if (it->is<std::vector<Hash> >() && !isVectorLeaf(std::as_const(path), *it)) {
+                    const std::vector<Hash>& vec = it->getValue<std::vector<Hash> >();
+                    const size_t vectorPathSize = path.size();
+                    for (size_t i = 0; i < vec.size(); ++i) {
+                        path += '[';
+                        path += std::to_string(i);
+                        path += ']';
+                        forEachLeaf_r(vec[i], path, leafFunc, isVectorLeaf, separator);
+                        path.resize(vectorPathSize);
+                    }
+                } else {
+                    leafFunc(std::as_const(path), *it);
+                }
+                path.resize(prefixSize);
+            }
+        }
+
         template <class Visitor>
         bool karabo::data::Hash::visit2(Visitor& visitor) {
             return karabo::data::Hash::visit2(*this, visitor);
@@ -29,8 +29,7 @@ namespace karabo {
 
         NDArray::NDArray(const Dims& shape, const karabo::data::Types::ReferenceType& type, const bool isBigEndian) {
             const size_t byteSize = shape.size() * Types::to<ToSize>(type);
-            char* buffer = new char[byteSize];
-            set("data", std::make_pair(DataPointer(buffer, &NDArray::deallocator), byteSize));
+            set("data", std::make_pair(BufferPool::allocate(byteSize), byteSize));
             set("type", static_cast<int>(type));
             setShape(shape);
             setBigEndian(isBigEndian);
@@ -43,7 +42,7 @@ namespace karabo {
             const size_t byteSize = numElems * itemSize;
             if (copy) {
                 // Allocate space for the new DataPointer and copy
-                auto newptr = DataPointer(new char[byteSize], &NDArray::deallocator);
+                auto newptr = BufferPool::allocate(byteSize);
                 std::copy(ptr.get(), ptr.get() + byteSize, newptr.get());
                 set("data", std::make_pair(newptr, byteSize));
             } else {
@@ -184,7 +183,7 @@ namespace karabo {
                         ByteArray& byteArr = ndArrayAsHash.get<ByteArray>("data");
                         NDArray::DataPointer& dataPtr = byteArr.first;
                         const size_t byteSize = byteArr.second;
-                        auto newDataPtr = NDArray::DataPointer(new char[byteSize], &NDArray::deallocator);
+                        auto newDataPtr = BufferPool::allocate(byteSize);
                         std::copy(dataPtr.get(), dataPtr.get() + byteSize, newDataPtr.get());
                         byteArr.first = newDataPtr; // assign to ByteArray in 'input'
 
@@ -24,6 +24,7 @@
 #ifndef KARABO_DATA_TYPES_NDARRAY_HH
 #define KARABO_DATA_TYPES_NDARRAY_HH
 
+#include "BufferPool.hh"
 #include "ByteSwap.hh"
 #include "Dims.hh"
 #include "Exception.hh"
@@ -252,15 +253,15 @@ namespace karabo {
             template <typename T>
             void setData(const Dims& shape) {
                 const size_t byteSize = shape.size() * sizeof(T);
-                set("data", std::make_pair(DataPointer(new char[byteSize], &NDArray::deallocator), byteSize));
+                set("data", std::make_pair(BufferPool::allocate(byteSize), byteSize));
             }
 
             template <typename T>
             void setData(const T* data, const size_t nelems) {
                 const size_t byteSize = nelems * sizeof(T);
-                char* buffer = new char[byteSize];
-                std::memcpy(buffer, reinterpret_cast<const char*>(data), byteSize);
-                set("data", std::make_pair(DataPointer(buffer, &NDArray::deallocator), byteSize));
+                DataPointer buffer = BufferPool::allocate(byteSize);
+                std::memcpy(buffer.get(), reinterpret_cast<const char*>(data), byteSize);
+                set("data", std::make_pair(buffer, byteSize));
             }
 
             template <typename T, typename D>
@@ -292,11 +293,9 @@ namespace karabo {
         NDArray::NDArray(const Dims& shape, const T& fill, const bool isBigEndian) {
             const size_t itemSize = sizeof(T);
             const size_t byteSize = shape.size() * itemSize;
-            T* buffer = new T[shape.size()];
-            for (size_t i = 0; i < shape.size(); ++i) {
-                buffer[i] = fill;
-            }
-            set("data", std::make_pair(DataPointer(reinterpret_cast<char*>(buffer), &NDArray::deallocator), byteSize));
+            DataPointer dataPtr = BufferPool::allocate(byteSize);
+            std::uninitialized_fill_n(reinterpret_cast<T*>(dataPtr.get()), shape.size(), fill);
+            set("data", std::make_pair(dataPtr, byteSize));
             setType<T>();
             setShape(shape);
             setBigEndian(isBigEndian);
@@ -316,7 +315,7 @@ namespace karabo {
 
             // Create data structure and specify type
             const size_t byteSize = (last - first) * sizeof(DataType);
-            set("data", std::make_pair(DataPointer(new char[byteSize], &NDArray::deallocator), byteSize));
+            set("data", std::make_pair(BufferPool::allocate(byteSize), byteSize));
             setType<DataType>();
 
             // Set further input
@@ -89,10 +89,21 @@ namespace karabo {
                   .initialValue(std::string())
                   .commit();
 
+            FLOAT_ELEMENT(lastUpdateSchema)
+                  .key("updateRate")
+                  .displayedName("Update Rate")
+                  .description("Property updates per second received from the device")
+                  .unit(Unit::HERTZ)
+                  .readOnly()
+                  .initialValue(0.f)
+                  .commit();
+
             TABLE_ELEMENT(expected)
                   .key("lastUpdatesUtc")
                   .displayedName("Last Updates (UTC)")
-                  .description("Timestamps of last recorded parameter update in UTC (updated in flush interval)")
+                  .description(
+                        "Timestamps of last recorded parameter update in UTC and update rates (updated in flush "
+                        "interval, rates are averaged over at least 10 seconds)")
                   .setColumns(lastUpdateSchema)
                   .readOnly()
                   .initialValue(std::vector<Hash>())
@@ -126,6 +137,8 @@ namespace karabo {
               m_lastTimestampMutex(),
               m_lastDataTimestamp(Epochstamp(0ull, 0ull), TimeId()),
               m_updatedLastTimestamp(false),
+              m_numUpdates(0ull),
+              m_updateRate(0.f),
               m_pendingLogin(true),
               m_onDataBeforeComplete(0u) {}
 
@@ -134,7 +147,9 @@ namespace karabo {
 
 
         DataLogger::DataLogger(const Hash& input)
-            : karabo::core::Device(input), m_flushDeadline(karabo::net::EventLoop::getIOService()) {
+            : karabo::core::Device(input),
+              m_lastRateUpdate(),
+              m_flushDeadline(karabo::net::EventLoop::getIOService()) {
             // start "flush" actor ...
             input.get("flushInterval", m_flushInterval); // in seconds
 
@@ -522,31 +537,32 @@ namespace karabo {
         }
 
 
-        void DeviceData::getPathsForConfiguration(const karabo::data::Hash& configuration,
-                                                  const karabo::data::Schema& schema,
-                                                  std::vector<std::string>& paths) const {
-            {
-                using karabo::data::Epochstamp;
-
-                // Gets the paths for the leaf nodes in the configuration sorted by their order in the schema.
-                getLeaves(configuration, schema, paths);
-
-                // Sort the paths by ascending order of their corresponding nodes Epochstamps.
-                std::sort(paths.begin(), paths.end(),
-                          [&configuration](const std::string& firstPath, const std::string& secondPath) {
-                              const Hash::Node& firstNode = configuration.getNode(firstPath);
-                              const Hash::Node& secondNode = configuration.getNode(secondPath);
-                              Epochstamp firstTime(0, 0);
-                              Epochstamp secondTime(0, 0);
-                              if (Epochstamp::hashAttributesContainTimeInformation(firstNode.getAttributes())) {
-                                  firstTime = Epochstamp::fromHashAttributes(firstNode.getAttributes());
-                              }
-                              if (Epochstamp::hashAttributesContainTimeInformation(secondNode.getAttributes())) {
-                                  secondTime = Epochstamp::fromHashAttributes(secondNode.getAttributes());
-                              }
-                              return (firstTime < secondTime);
-                          });
-            }
+        void DeviceData::getLeavesForConfiguration(const karabo::data::Hash& configuration,
+                                                   const karabo::data::Schema& schema,
+                                                   std::vector<ConfigurationLeaf>& leaves) const {
+            using karabo::data::Epochstamp;
+
+            if (configuration.empty() || schema.empty()) return;
+
+            // Collect the leaf nodes in the order of the configuration, see also karabo::util::getLeaves ...
+            configuration.forEachLeaf(
+                  [&leaves](const std::string& path, const Hash::Node& node) {
+                      const Hash::Attributes& attrs = node.getAttributes();
+                      if (Epochstamp::hashAttributesContainTimeInformation(attrs)) {
+                          leaves.push_back(ConfigurationLeaf{path, &node, Epochstamp::fromHashAttributes(attrs)});
+                      } else {
+                          leaves.push_back(ConfigurationLeaf{path, &node, Epochstamp(0ull, 0ull)});
+                      }
+                  },
+                  [&schema](const std::string& path, const Hash::Node&) {
+                      return schema.has(path) && schema.isLeaf(path);
+                  });
+
+            // ... and sort them by ascending order of their Epochstamps.
+            std::stable_sort(leaves.begin(), leaves.end(),
+                             [](const ConfigurationLeaf& first, const ConfigurationLeaf& second) {
+                                 return (first.stamp < second.stamp);
+                             });
         }
 
 
@@ -588,9 +604,20 @@ namespace karabo {
             bool updatedAnyStamp = false;
             {
                 std::lock_guard<std::mutex> lock(m_perDeviceDataMutex);
+                // Calculate update rates only if enough time passed since last time - flush may be called any time
+                const Epochstamp now;
+                const double elapsed = now - m_lastRateUpdate;
+                const bool updateRates = (elapsed >= 10.);
+                if (updateRates) m_lastRateUpdate = now;
+
                 lastStamps.reserve(m_perDeviceData.size());
                 for (auto& idData : m_perDeviceData) {
                     DeviceData::Pointer data = idData.second;
+                    if (updateRates) {
+                        const float rate = data->m_numUpdates.exchange(0ull) / elapsed;
+                        updatedAnyStamp |= (rate != data->m_updateRate);
+                        data->m_updateRate = rate;
+                    }
                     {
                         // To avoid this mutex lock, access to m_lastTimestampMutex would have to be posted on m_strand.
                         std::lock_guard<std::mutex> lock(data->m_lastTimestampMutex);
@@ -604,6 +631,7 @@ namespace karabo {
                             node.setValue(ts.toFormattedString()); //"%Y%m%dT%H%M%S"));
                         }
                         ts.getEpochstamp().toHashAttributes(node.getAttributes());
+                        h.set("updateRate", data->m_updateRate);
                         lastStamps.push_back(std::move(h));
                     }
                 }
@@ -611,6 +639,7 @@ namespace karabo {
 
             if (updatedAnyStamp || (lastStamps.size() != get<std::vector<Hash>>("lastUpdatesUtc").size())) {
                 // If sizes are equal, but devices have changed, then at least one time stamp must have changed as well.
+                // (Changed rates are included in 'updatedAnyStamp'.)
                 set("lastUpdatesUtc", lastStamps);
             }
 
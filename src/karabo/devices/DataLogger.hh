@@ -20,6 +20,7 @@
 #ifndef KARABO_DEVICES_DATALOGGER_HH
 #define KARABO_DEVICES_DATALOGGER_HH
 
+#include <atomic>
 #include <fstream>
 
 #include "karabo/core/Device.hh"
@@ -68,18 +69,31 @@ namespace karabo {
                                              const karabo::data::Timestamp& stamp) = 0;
 
             /**
-             * Retrieves the paths of the leaf nodes in a given configuration. The paths are returned in
-             * ascending order of their corresponding nodes timestamps.
+             * A leaf node of a configuration together with its path and Epochstamp
+             */
+            struct ConfigurationLeaf {
+                std::string path;
+                const karabo::data::Hash::Node* node;
+                karabo::data::Epochstamp stamp; // Epochstamp(0, 0) if the node lacks time information
+            };
+
+            /**
+             * Retrieves the leaf nodes of a given configuration. The leaves are returned in ascending order of
+             * their timestamps.
              *
-             * @param configuration A configuration with the nodes corresponding to the paths.
+             * The configuration is walked only once, so the nodes do not need to be looked up by path and their
+             * time attributes are parsed only once.
+             *
+             * @param configuration A configuration with the leaf nodes.
              * @param schema The schema for the configuration hash.
-             * @param paths The paths of the leaf nodes in the configuration, sorted by nodes timestamps.
+             * @param leaves The leaves of the configuration, sorted by nodes timestamps. They refer to nodes of
+             *               'configuration', so must not be used after that is modified or destructed.
              *
              * @note karabo::devices::DataLogReader depends on the configuration items being properly sorted
              * in time to retrieve configuration changes.
              */
-            void getPathsForConfiguration(const karabo::data::Hash& configuration, const karabo::data::Schema& schema,
-                                          std::vector<std::string>& paths) const;
+            void getLeavesForConfiguration(const karabo::data::Hash& configuration, const karabo::data::Schema& schema,
+                                           std::vector<ConfigurationLeaf>& leaves) const;
 
             virtual void stopLogging() {}
 
@@ -97,6 +111,10 @@ namespace karabo {
 
             bool m_updatedLastTimestamp;
 
+            std::atomic<unsigned long long> m_numUpdates; // property updates received since last rate calculation
+
+            float m_updateRate; // property updates per second, needs DataLogger::m_perDeviceDataMutex protection
+
             bool m_pendingLogin;
 
             unsigned int m_onDataBeforeComplete; // Only to avoid spamming...
@@ -121,6 +139,7 @@ namespace karabo {
             DeviceDataMap m_perDeviceData;
             std::unordered_map<std::string, unsigned int>
                   m_nonTreatedSlotChanged; // also needs m_perDeviceDataMutex protection
+            karabo::data::Epochstamp m_lastRateUpdate; // also needs m_perDeviceDataMutex protection
 
            private:
             boost::asio::steady_timer m_flushDeadline;
@@ -66,6 +66,13 @@
  *     can appear if the manager was down when the device went down so the manager could not inform the logger.)
  * * When treatment of all loggers and their devices is finished, a summary of the findings are logged and published
  *   as "topologyCheck.lastCheckResult" and the procedure is triggered again in "topologyCheck.interval" minutes.
+ * * The "lastUpdatesUtc" tables also contain the update rate of each device. These are kept and used to place new
+ *   devices on the least loaded logger server.
+ *
+ * Rebalancing (only for InfluxDataLogger, triggered by "loadBalancing.slotRebalance") moves devices to other loggers:
+ * * For each device to move, the logger map is changed and the old logger is told to stop logging.
+ * * Only once that is confirmed (or failed), the device is treated as a new device to log for its new server.
+ *   That way the "-LOG" event of the old logger always precedes the "+LOG" event of the new one.
  */
 
 #include "DataLoggerManager.hh"
@@ -76,6 +83,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <chrono>
+#include <limits>
 #include <set>
 #include <string>
 #include <unordered_set>
@@ -194,6 +202,26 @@ namespace karabo {
                   .defaultValue(100)
                   .commit();
 
+            BOOL_ELEMENT(expected)
+                  .key("fileDataLogger.columnarArchive")
+                  .displayedName("Columnar archive")
+                  .description(
+                        "If true, loggers additionally store property updates as compressed per-property column "
+                        "blocks that serve property history requests without index building")
+                  .assignmentOptional()
+                  .defaultValue(false)
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("fileDataLogger.columnarBlockSize")
+                  .displayedName("Columnar block size")
+                  .description("Number of updates of a property in a block of the columnar archive")
+                  .assignmentOptional()
+                  .defaultValue(1024u)
+                  .minInc(1u)
+                  .expertAccess()
+                  .commit();
+
             NODE_ELEMENT(expected)
                   .key("influxDataLogger")
                   .displayedName("InfluxDataLogger")
@@ -348,7 +376,7 @@ namespace karabo {
                   .displayedName("Server list")
                   .description(
                         "List of device server IDs where the DataLogger instance run. "
-                        "The load balancing is round-robin. Must not be empty")
+                        "See 'Load balancing' for how devices are distributed. Must not be empty")
                   .init()
                   .minSize(1)
                   .assignmentMandatory()
@@ -454,6 +482,64 @@ namespace karabo {
                   .maxInc(600)
                   .commit();
 
+            NODE_ELEMENT(expected)
+                  .key("loadBalancing")
+                  .displayedName("Load balancing")
+                  .description("Distribution of devices among the loggers")
+                  .commit();
+
+            STRING_ELEMENT(expected)
+                  .key("loadBalancing.placement")
+                  .displayedName("Placement")
+                  .description(
+                        "How to choose the logger for a device that is not yet in the logger map: "
+                        "'leastLoaded' takes the logger with the lowest sum of update rates of its devices "
+                        "(rates as of the last topology check, ties resolved by number of devices), "
+                        "'roundRobin' takes the loggers in turn")
+                  .options(std::vector<std::string>{"leastLoaded", "roundRobin"})
+                  .assignmentOptional()
+                  .defaultValue("leastLoaded")
+                  .reconfigurable()
+                  .commit();
+
+            SLOT_ELEMENT(expected)
+                  .key("loadBalancing.slotRebalance")
+                  .displayedName("Rebalance")
+                  .description(
+                        "Move the busiest devices of overloaded loggers to less loaded ones (InfluxDataLogger only)")
+                  .allowedStates(State::ON)
+                  .commit();
+
+            FLOAT_ELEMENT(expected)
+                  .key("loadBalancing.maxImbalance")
+                  .displayedName("Max. imbalance")
+                  .description(
+                        "Rebalancing moves devices away from loggers whose load exceeds this factor times the mean "
+                        "load of all running loggers")
+                  .assignmentOptional()
+                  .defaultValue(1.5f)
+                  .minExc(1.f)
+                  .reconfigurable()
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("loadBalancing.maxMoves")
+                  .displayedName("Max. moves")
+                  .description("Maximum number of devices moved to another logger in a single rebalancing")
+                  .assignmentOptional()
+                  .defaultValue(10u)
+                  .minInc(1u)
+                  .reconfigurable()
+                  .commit();
+
+            STRING_ELEMENT(expected)
+                  .key("loadBalancing.lastRebalanceResult")
+                  .displayedName("Rebalance result")
+                  .description("Result of last rebalancing")
+                  .readOnly()
+                  .initialValue("")
+                  .commit();
+
             STRING_ELEMENT(expected)
                   .key("loggermap")
                   .displayedName("Logger map file")
@@ -546,6 +632,7 @@ namespace karabo {
             KARABO_SIGNAL("signalLoggerMap", Hash /*loggerMap*/);
             KARABO_SLOT(slotGetLoggerMap);
             KARABO_SLOT(topologyCheck_slotForceCheck);
+            KARABO_SLOT(loadBalancing_slotRebalance);
 
             if (std::filesystem::exists(m_blockListFile)) {
                 Hash blocked;
@@ -737,6 +824,154 @@ namespace karabo {
         }
 
 
+        void DataLoggerManager::loadBalancing_slotRebalance() {
+            m_strand->post(bind_weak(&Self::rebalanceOnStrand, this));
+        }
+
+
+        void DataLoggerManager::rebalanceOnStrand() {
+            std::string result;
+            if (m_loggerClassId != "InfluxDataLogger") {
+                // Data of a FileDataLogger can only be read back from the server that wrote it - moving a device
+                // to another logger would split its history.
+                result = "Not supported for " + m_loggerClassId;
+                KARABO_LOG_FRAMEWORK_WARN << "Rebalancing requested: " << result;
+                set("loadBalancing.lastRebalanceResult", result);
+                return;
+            }
+
+            // Loads of running loggers - do not move devices to or from others
+            std::map<std::string, float> loads;
+            float totalLoad = 0.f;
+            const float unknownRate = meanDeviceRate();
+            for (const Hash::Node& serverNode : m_loggerData) {
+                const Hash& serverData = serverNode.getValue<Hash>();
+                if (serverData.get<LoggerState>("state") == LoggerState::RUNNING) {
+                    const float load = loggerLoad(serverData, unknownRate).first;
+                    loads[serverNode.getKey()] = load;
+                    totalLoad += load;
+                }
+            }
+            if (loads.size() < 2ul) {
+                result = "Nothing to do, less than two loggers running";
+                KARABO_LOG_FRAMEWORK_INFO << "Rebalancing requested: " << result;
+                set("loadBalancing.lastRebalanceResult", result);
+                return;
+            }
+
+            const float meanLoad = totalLoad / loads.size();
+            const float maxLoad = meanLoad * get<float>("loadBalancing.maxImbalance");
+            const unsigned int maxMoves = get<unsigned int>("loadBalancing.maxMoves");
+            std::ostringstream moves;
+            unsigned int numMoves = 0;
+            while (numMoves < maxMoves) {
+                auto lessLoaded = [](const std::pair<const std::string, float>& a,
+                                     const std::pair<const std::string, float>& b) { return a.second < b.second; };
+                auto [minIt, maxIt] = std::minmax_element(loads.begin(), loads.end(), lessLoaded);
+                if (maxIt->second <= maxLoad) break;
+
+                // Take the busiest device whose move still reduces the maximum load
+                const float gap = maxIt->second - minIt->second;
+                const std::string& fromServer = maxIt->first;
+                const std::string& toServer = minIt->first;
+                auto& devices = m_loggerData.get<Hash>(fromServer).get<std::unordered_set<std::string>>("devices");
+                auto bestIt = devices.end();
+                float bestRate = 0.f;
+                for (auto it = devices.begin(); it != devices.end(); ++it) {
+                    auto rateIt = m_deviceRates.find(*it);
+                    if (rateIt != m_deviceRates.end() && rateIt->second > bestRate && rateIt->second < gap) {
+                        bestIt = it;
+                        bestRate = rateIt->second;
+                    }
+                }
+                if (bestIt == devices.end()) break;
+
+                const std::string deviceId(*bestIt);
+                KARABO_LOG_FRAMEWORK_INFO << "Rebalancing: move '" << deviceId << "' (" << bestRate << " Hz) from '"
+                                          << fromServer << "' to '" << toServer << "'";
+                moves << (numMoves > 0 ? ", " : "") << deviceId << " (" << fromServer << " -> " << toServer << ")";
+                ++numMoves;
+                {
+                    std::lock_guard<std::mutex> lock(m_loggerMapMutex);
+                    m_loggerMap.set(DATALOGGER_PREFIX + deviceId, toServer);
+                }
+                // Old logger keeps logging the device until the new one confirms to log it, see
+                // addDevicesDoneOnStrand - so no update is lost while moving.
+                devices.erase(bestIt);
+                m_migrations[deviceId] = fromServer;
+                Hash& toServerData = m_loggerData.get<Hash>(toServer);
+                toServerData.get<std::unordered_set<std::string>>("backlog").insert(deviceId);
+                addDevicesToBeLogged(serverIdToLoggerId(toServer), toServerData);
+                maxIt->second -= bestRate;
+                minIt->second += bestRate;
+            }
+
+            if (numMoves > 0) {
+                std::lock_guard<std::mutex> lock(m_loggerMapMutex);
+                set("loggerMap", makeLoggersTable());
+                emit<Hash>("signalLoggerMap", m_loggerMap);
+                karabo::data::saveToFile(m_loggerMap, m_loggerMapFile);
+                result = "Moved " + toString(numMoves) + " devices: " + moves.str();
+            } else {
+                result = "Nothing moved, mean load " + toString(meanLoad) + " Hz";
+            }
+            KARABO_LOG_FRAMEWORK_INFO << "Rebalancing done: " << result;
+            set("loadBalancing.lastRebalanceResult", result);
+        }
+
+
+        std::pair<float, size_t> DataLoggerManager::loggerLoad(const Hash& serverData, float unknownRate) const {
+            std::pair<float, size_t> result(0.f, 0ul);
+            for (const char* key : {"devices", "beingAdded", "backlog"}) {
+                const auto& deviceIds = serverData.get<std::unordered_set<std::string>>(key);
+                for (const std::string& deviceId : deviceIds) {
+                    auto it = m_deviceRates.find(deviceId);
+                    result.first += (it != m_deviceRates.end() ? it->second : unknownRate);
+                }
+                result.second += deviceIds.size();
+            }
+            return result;
+        }
+
+
+        float DataLoggerManager::meanDeviceRate() const {
+            if (m_deviceRates.empty()) return 0.f;
+            float sum = 0.f;
+            for (const auto& idRate : m_deviceRates) {
+                sum += idRate.second;
+            }
+            return sum / m_deviceRates.size();
+        }
+
+
+        void DataLoggerManager::migrationDone(const std::string& deviceId) {
+            auto it = m_migrations.find(deviceId);
+            if (it == m_migrations.end()) return; // not moved, or the device is gone meanwhile
+            const std::string fromServer(it->second);
+            m_migrations.erase(it);
+            KARABO_LOG_FRAMEWORK_INFO << "Rebalancing: '" << deviceId << "' logged by new logger, stop logging it on '"
+                                      << fromServer << "'";
+            request(serverIdToLoggerId(fromServer), "slotTagDeviceToBeDiscontinued", std::string("rebalancing"),
+                    deviceId)
+                  .timeout(get<unsigned int>("timeout"))
+                  .receiveAsync(bind_weak(&Self::migrationStopped, this, true, deviceId),
+                                bind_weak(&Self::migrationStopped, this, false, deviceId));
+        }
+
+
+        void DataLoggerManager::migrationStopped(bool ok, const std::string& deviceId) {
+            if (!ok) {
+                try {
+                    throw;
+                } catch (const std::exception& e) {
+                    // E.g. old logger just went down - it will anyway not log the device anymore after restart
+                    KARABO_LOG_FRAMEWORK_WARN << "Failed to stop logging '" << deviceId
+                                              << "' on the logger it was moved away from: " << e.what();
+                }
+            }
+        }
+
+
         void DataLoggerManager::launchTopologyCheck() {
             // Publish last results except if in INIT (because then there was no last run!):
             if (getState() != State::INIT) {
@@ -925,6 +1160,9 @@ namespace karabo {
                     const Hash::Node& lastUpdateNode = row.getNode("lastUpdateUtc");
                     const std::string& lastUpdateStr = lastUpdateNode.getValue<std::string>();
                     const std::string& deviceId = row.get<std::string>("deviceId");
+                    if (row.has("updateRate")) { // not from loggers of older versions
+                        m_deviceRates[deviceId] = row.get<float>("updateRate");
+                    }
 
                     if (lastUpdateStr.empty() ||
                         !Epochstamp::hashAttributesContainTimeInformation(lastUpdateNode.getAttributes())) {
@@ -1139,7 +1377,25 @@ namespace karabo {
                           " You have to define one data logger server, at least!");
                 }
                 m_serverIndex %= m_serverList.size();
-                serverId = m_serverList[m_serverIndex++];
+                size_t index = m_serverIndex;
+                if (get<std::string>("loadBalancing.placement") == "leastLoaded") {
+                    // Start at round robin index: in case of equal loads, behave like round robin.
+                    // Devices without measured rate yet (e.g. from a burst of instanceNew) count with the mean rate,
+                    // otherwise all of them would go to the same logger until the next topology check.
+                    const float unknownRate = meanDeviceRate();
+                    std::pair<float, size_t> minLoad(std::numeric_limits<float>::max(), 0ul);
+                    for (size_t i = 0; i < m_serverList.size(); ++i) {
+                        const size_t candidate = (m_serverIndex + i) % m_serverList.size();
+                        const Hash& serverData = m_loggerData.get<Hash>(m_serverList[candidate]);
+                        const std::pair<float, size_t> load(loggerLoad(serverData, unknownRate));
+                        if (load < minLoad) {
+                            minLoad = load;
+                            index = candidate;
+                        }
+                    }
+                }
+                serverId = m_serverList[index];
+                m_serverIndex = index + 1;
                 m_loggerMap.set(deviceIdInMap, serverId);
 
                 // Logger map changed, so publish - online and as backup
@@ -1286,6 +1542,10 @@ namespace karabo {
                     beingAdded.erase(calledDevice);
                 }
                 data.get<std::unordered_set<std::string>>("devices").insert(calledDevices.begin(), calledDevices.end());
+                // Devices moved here by rebalancing can now be dropped by their previous logger
+                for (const std::string& calledDevice : calledDevices) {
+                    migrationDone(calledDevice);
+                }
             } else {
                 // Can happen as timeout when logger just shutdown
                 KARABO_LOG_FRAMEWORK_ERROR << "For '" << loggerId << "', failed to add '" << toString(calledDevices)
@@ -1433,6 +1693,13 @@ namespace karabo {
 
 
         void DataLoggerManager::goneDeviceToLog(const std::string& deviceId) {
+            m_deviceRates.erase(deviceId);
+            auto migrationIt = m_migrations.find(deviceId);
+            if (migrationIt != m_migrations.end()) {
+                // Being moved: the old logger still logs it, the new one is treated below
+                call(serverIdToLoggerId(migrationIt->second), "slotTagDeviceToBeDiscontinued", "D", deviceId);
+                m_migrations.erase(migrationIt);
+            }
             const std::string serverId(loggerServerId(deviceId, false));
             if (!serverId.empty()) { // else device not in map and thus neither logged
                 // Remove from any tracking:
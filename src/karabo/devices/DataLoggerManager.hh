@@ -62,14 +62,21 @@ namespace karabo {
          *
          * - flushInterval: at which loggers flush their data to disk
          * - maximumFileSize: of log files after which a new log file chunk is created
+         * - columnarArchive: whether file based loggers additionally write the compressed columnar archive
+         * - columnarBlockSize: number of updates of a property per block of the columnar archive
          * - directory: the directory into which loggers should write their data
          * - serverList: a list of device servers which each runs one logger.
          *               Each device in the distributed system is assigned to one logger.
-         *               They are added to the loggers on these servers in a round robin fashion,
-         *               allowing for load balancing. Assignment is made permanent in a loggermap.xml
+         *               A new device is added to the logger with the lowest load, i.e. the lowest sum of
+         *               property update rates (as reported by the loggers) of the devices it logs, or,
+         *               if configured, in a round robin fashion. Assignment is made permanent in a loggermap.xml
          *               file that is regularly written to disk. This allows to distribute the servers
          *               in the serverList to be distributed among several hosts and still have fixed
          *               places for reading the data back.
+         * - loadBalancing: how new devices are placed and how much imbalance between loggers is tolerated
+         *               when rebalancing is requested. Rebalancing moves the busiest devices of overloaded loggers
+         *               to less loaded ones. It is only supported for InfluxDataLogger since file based loggers
+         *               write to directories that are only readable from their own server.
          *
          */
         class DataLoggerManager : public karabo::core::Device {
@@ -94,6 +101,38 @@ namespace karabo {
 
             void topologyCheck_slotForceCheck();
 
+            void loadBalancing_slotRebalance();
+
+            /**
+             * Move devices from loggers whose load exceeds "loadBalancing.maxImbalance" times the mean load
+             * to the least loaded logger. Loads are based on the update rates collected during the last topology
+             * check. Needs to be protected by m_strand.
+             */
+            void rebalanceOnStrand();
+
+            /**
+             * Sum of update rates and number of devices of a logger, including those not yet confirmed to be logged.
+             * Needs to be protected by m_strand.
+             *
+             * @param serverData the entry of the logger server in m_loggerData
+             * @param unknownRate rate to count for devices without a rate reported by their logger (yet)
+             */
+            std::pair<float, size_t> loggerLoad(const karabo::data::Hash& serverData, float unknownRate) const;
+
+            /**
+             * Mean update rate of all devices with a rate reported by their logger, 0 if there are none.
+             * Needs to be protected by m_strand.
+             */
+            float meanDeviceRate() const;
+
+            /**
+             * If deviceId is being moved by rebalancing, tell the logger it is moved away from to stop logging it.
+             * To be called once the new logger confirmed to log it. Needs to be protected by m_strand.
+             */
+            void migrationDone(const std::string& deviceId);
+
+            void migrationStopped(bool ok, const std::string& deviceId);
+
             void launchTopologyCheck();
 
             /**
@@ -188,10 +227,12 @@ namespace karabo {
 
             /**
              * Get id of server that should run logger for given device that should be logged
+             * Needs to be protected by m_strand if addIfNotYetInMap == true.
              *
              * @param deviceId the device that should be logged
              * @param addIfNotYetInMap whether to create a server/logger relation in the logger map
-             *                         in case it does not yet exist for deviceId
+             *                         in case it does not yet exist for deviceId - according to
+             *                         "loadBalancing.placement"
              * @return the server id - can be empty if addIfNotYetInMap == false
              */
             std::string loggerServerId(const std::string& deviceId, bool addIfNotYetInMap);
@@ -289,6 +330,10 @@ namespace karabo {
                                              /// "beingAdded" and "devices"
             karabo::data::Hash m_checkStatus; /// Keep track of all important stuff during check
             std::unordered_map<std::string, std::set<std::string>> m_knownClasses; /// to be accessed on the strand
+            std::unordered_map<std::string, float> m_deviceRates; /// update rates from last check, only on the strand
+            /// Devices that are being moved to another logger and the server they are moved away from, to be accessed
+            /// on the strand
+            std::unordered_map<std::string, std::string> m_migrations;
             karabo::net::Strand::Pointer m_strand;
 
             boost::asio::steady_timer m_topologyCheckTimer;
@@ -41,13 +41,16 @@ namespace karabo {
             : DeviceData(input),
               m_directory(input.get<std::string>("directory")),
               m_maxFileSize(input.get<int>("maximumFileSize")),
+              m_columnarArchive(input.get<bool>("columnarArchive")),
+              m_columnarBlockSize(input.get<unsigned int>("columnarBlockSize")),
               m_configStream(),
               m_lastIndex(0u),
               m_idxMap(),
               m_idxprops(),
               m_propsize(0u),
               m_lasttime(0h),
-              m_serializer(TextSerializer<Hash>::create(Hash("Xml.indentation", -1))) {}
+              m_serializer(TextSerializer<Hash>::create(Hash("Xml.indentation", -1))),
+              m_columnWriter() {}
 
 
         FileDeviceData::~FileDeviceData() {
@@ -57,6 +60,13 @@ namespace karabo {
             }
 
             const std::string& deviceId = m_deviceToBeLogged;
+            if (m_columnWriter) {
+                try {
+                    m_columnWriter->flush();
+                } catch (const std::exception& e) {
+                    KARABO_LOG_FRAMEWORK_ERROR << "Failed to write columnar archive of " << deviceId << ": " << e.what();
+                }
+            }
             // Mark as logger stopped.
             // Although this destructor is not running on the strand, accessing all members is safe:
             // All other actions touching the members are posted on the strand and have a shared  pointer
@@ -121,6 +131,28 @@ namespace karabo {
                   .assignmentOptional()
                   .defaultValue(100)
                   .commit();
+
+            BOOL_ELEMENT(expected)
+                  .key("columnarArchive")
+                  .displayedName("Columnar archive")
+                  .description(
+                        "If true, property updates are additionally stored as compressed per-property column blocks "
+                        "that serve property history requests without index building. The text archive is still "
+                        "written since configurations from the past are read from it.")
+                  .assignmentOptional()
+                  .defaultValue(false)
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("columnarBlockSize")
+                  .displayedName("Columnar block size")
+                  .description(
+                        "Number of updates of a property in a block of the columnar archive. Updates of blocks "
+                        "that are not yet full are stored separately at each flush.")
+                  .assignmentOptional()
+                  .defaultValue(1024u)
+                  .minInc(1u)
+                  .commit();
         }
 
 
@@ -128,6 +160,8 @@ namespace karabo {
             Hash config = cfg;
             config.set("directory", get<std::string>("directory"));
             config.set("maximumFileSize", get<int>("maximumFileSize"));
+            config.set("columnarArchive", get<bool>("columnarArchive"));
+            config.set("columnarBlockSize", get<unsigned int>("columnarBlockSize"));
             DeviceData::Pointer devicedata =
                   Factory<karabo::devices::DeviceData>::create<karabo::data::Hash>("FileDataLoggerDeviceData", config);
             FileDeviceData::Pointer data = std::static_pointer_cast<FileDeviceData>(devicedata);
@@ -200,6 +234,9 @@ namespace karabo {
             if (!std::filesystem::exists(fullDir + "/idx")) {
                 std::filesystem::create_directory(fullDir + "/idx");
             }
+            if (m_columnarArchive) {
+                m_columnWriter = std::make_unique<ColumnArchiveWriter>(fullDir + "/col", m_columnarBlockSize);
+            }
 
             m_lastIndex = determineLastIndex(m_deviceToBeLogged);
         }
@@ -212,8 +249,9 @@ namespace karabo {
 
             // To write log I need schema - but that has arrived before connecting signal[State]Changed to slotChanged
             // and thus before any data can arrive here in handleChanged.
-            vector<string> paths;
-            getPathsForConfiguration(configuration, m_currentSchema, paths);
+            std::vector<ConfigurationLeaf> leaves;
+            getLeavesForConfiguration(configuration, m_currentSchema, leaves);
+            m_numUpdates += leaves.size();
 
             if (newPropToIndex) {
                 // DataLogReader got request for history of a property not indexed
@@ -224,15 +262,15 @@ namespace karabo {
                 this->ensureFileClosed();
             }
 
-            for (size_t i = 0; i < paths.size(); ++i) {
-                const string& path = paths[i];
+            for (const ConfigurationLeaf& leaf : leaves) {
+                const std::string& path = leaf.path;
 
                 // Skip those elements which should not be archived
                 const bool noArchive = (!m_currentSchema.has(path) ||
                                         (m_currentSchema.hasArchivePolicy(path) &&
                                          (m_currentSchema.getArchivePolicy(path) == Schema::NO_ARCHIVING)));
 
-                const Hash::Node& leafNode = configuration.getNode(path);
+                const Hash::Node& leafNode = *leaf.node;
 
                 // Check for timestamp ...
                 if (!Timestamp::hashAttributesContainTimeInformation(leafNode.getAttributes())) {
@@ -243,7 +281,7 @@ namespace karabo {
                     continue;
                 }
 
-                Timestamp t = Timestamp::fromHashAttributes(leafNode.getAttributes());
+                Timestamp t(leaf.stamp, TimeId::fromHashAttributes(leafNode.getAttributes()));
                 {
                     // Update time stamp for updates of property "lastUpdatesUtc" and for LOGOUT timestamp.
                     // Since for "lastUpdatesUtc" it is accessed when not posted on m_strand, need mutex protection:
@@ -288,6 +326,14 @@ namespace karabo {
                 const std::pair<bool, size_t> newFilePlusPosition = ensureFileOpen();
                 if (newFilePlusPosition.second == -1ul) continue; // problem with file permissions, skip and go on
                 logValue(deviceId, path, t, value, typeString, newFilePlusPosition.second);
+                if (m_columnWriter) {
+                    try {
+                        m_columnWriter->append(path, t, leafNode, typeString, value, m_pendingLogin);
+                    } catch (const std::exception& e) {
+                        KARABO_LOG_FRAMEWORK_ERROR << "Failed to store '" << path << "' of '" << deviceId
+                                                   << "' in columnar archive: " << e.what();
+                    }
+                }
 
                 // Possibly add new line to index file:
                 if (m_pendingLogin || newFilePlusPosition.first) {
@@ -298,10 +344,9 @@ namespace karabo {
                         // TRICK: 'configuration' is the one requested at the beginning. For devices which have
                         // properties with older timestamps than the time of their instantiation (as e.g. read from
                         // hardware), we keep stamps in the archive_index.txt file sequential by overwriting here these
-                        // old stamps with the most recent one ('paths' are sorted above!) which should be one of the
+                        // old stamps with the most recent one ('leaves' are sorted above!) which should be one of the
                         // 'Karabo only' properties like _deviceId_ etc.
-                        const auto& attrsOfPathWithMostRecentStamp = configuration.getAttributes(paths.back());
-                        t = Timestamp::fromHashAttributes(attrsOfPathWithMostRecentStamp);
+                        t = Timestamp::fromHashAttributes(leaves.back().node->getAttributes());
 
                         m_pendingLogin = false;
                     } else {
@@ -428,6 +473,14 @@ namespace karabo {
             if (m_configStream.is_open()) {
                 m_configStream.flush();
             }
+            if (m_columnWriter) {
+                try {
+                    m_columnWriter->flush();
+                } catch (const std::exception& e) {
+                    KARABO_LOG_FRAMEWORK_ERROR << "Failed to flush columnar archive of " << m_deviceToBeLogged << ": "
+                                               << e.what();
+                }
+            }
             for (std::map<string, MetaData::Pointer>::iterator it = m_idxMap.begin(); it != m_idxMap.end(); ++it) {
                 MetaData::Pointer mdp = it->second;
                 if (mdp && mdp->idxStream.is_open()) mdp->idxStream.flush();
@@ -23,6 +23,7 @@
 
 #include "DataLogger.hh"
 #include "karabo/data/io/TextSerializer.hh"
+#include "karabo/util/ColumnArchive.hh"
 #include "karabo/util/Version.hh"
 
 namespace karabo {
@@ -68,6 +69,8 @@ namespace karabo {
 
             std::string m_directory;
             int m_maxFileSize;
+            bool m_columnarArchive;
+            unsigned int m_columnarBlockSize;
             std::fstream m_configStream;
 
             unsigned int m_lastIndex;
@@ -78,6 +81,9 @@ namespace karabo {
             std::filesystem::file_time_type m_lasttime;
 
             karabo::data::TextSerializer<karabo::data::Hash>::Pointer m_serializer;
+
+            /// Writer of the columnar archive, only present if "columnarArchive" is configured
+            std::unique_ptr<karabo::util::ColumnArchiveWriter> m_columnWriter;
         };
 
 
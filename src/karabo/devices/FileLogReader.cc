@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <cstdlib>
+#include <cstring>
 #include <map>
 #include <nlohmann/json.hpp>
 #include <sstream>
@@ -37,6 +38,7 @@
 #include "karabo/data/time/Epochstamp.hh"
 #include "karabo/data/time/TimeDuration.hh"
 #include "karabo/data/types/FromLiteral.hh"
+#include "karabo/util/ColumnArchive.hh"
 #include "karabo/util/DataLogUtils.hh"
 #include "karabo/util/TimeProfiler.hh"
 #include "karabo/util/Version.hh"
@@ -161,11 +163,30 @@ namespace karabo {
 
                 p.startPeriod("reaction");
 
-
-                bool rebuildIndex = false;
+                Epochstamp from;
+                if (params.has("from")) from = Epochstamp(params.get<string>("from"));
+                Epochstamp to;
+                if (params.has("to")) to = Epochstamp(params.get<string>("to"));
+                unsigned int maxNumData = 0;
+                if (params.has("maxNumData")) maxNumData = params.getAs<int>("maxNumData");
 
                 vector<Hash> result;
 
+                // If the logger writes the columnar archive and it covers the requested range, no index is needed.
+                if (readColumnarHistory(deviceId, property, from, to, maxNumData, result)) {
+                    reply(deviceId, property, result);
+                    onOk();
+
+                    p.stopPeriod("reaction");
+                    p.close();
+                    KARABO_LOG_FRAMEWORK_DEBUG << "slotGetPropertyHistory: sent " << result.size()
+                                               << " data points from columnar archive. Request processing time : "
+                                               << p.getPeriod("reaction").getDuration() << " [s]";
+                    return;
+                }
+
+                bool rebuildIndex = false;
+
                 int lastFileIndex = getFileIndex(deviceId);
 
                 // Register a property in prop file for indexing if it is not there
@@ -230,25 +251,16 @@ namespace karabo {
                     throw KARABO_LOGIC_EXCEPTION(getInstanceId() + " fails registering property file");
                 }
 
-                Epochstamp from;
-                if (params.has("from")) from = Epochstamp(params.get<string>("from"));
-                Epochstamp to;
-                if (params.has("to")) to = Epochstamp(params.get<string>("to"));
-                unsigned int maxNumData = 0;
-                if (params.has("maxNumData")) maxNumData = params.getAs<int>("maxNumData");
-
                 // start rebuilding index for deviceId, property and all files
                 if (rebuildIndex) {
                     // We use previously read value of lastFileIndex as we do not want to  trigger rebuilding of the
                     // very last index file, i.e. the one that the DataLogger will start to write from now on!
                     // (See also comment about DataLogReader in DataLogger::slotChanged.)
-                    int idx = lastFileIndex;
-                    while (idx >= 0) {
-                        // files are processed starting from the most recent as we arbitrarily assume user is more
-                        // likely interested to recent data
-                        m_ibs->buildIndexFor(get<string>("directory") + " " + deviceId + " " + property + " " +
-                                             toString(idx));
-                        idx--;
+                    // A single job covers all files: karabo-idxbuild indexes them in parallel, starting from the most
+                    // recent, and skips what its checkpoints mark as already indexed.
+                    if (lastFileIndex >= 0) {
+                        m_ibs->buildIndexFor(get<string>("directory") + " " + deviceId + " " + property + " 0:" +
+                                             toString(lastFileIndex));
                     }
                     throw KARABO_NOT_SUPPORTED_EXCEPTION(getInstanceId() + " cannot fulfill first history request to " +
                                                          deviceId + "." + property +
@@ -543,6 +555,104 @@ namespace karabo {
         }
 
 
+        bool FileLogReader::readColumnarHistory(const std::string& deviceId, const std::string& property,
+                                                const Epochstamp& from, const Epochstamp& to, unsigned int maxNumData,
+                                                std::vector<Hash>& result) const {
+            ColumnArchiveReader reader(get<string>("directory") + "/" + deviceId + "/col", property);
+            if (!reader.exists()) return false;
+
+            const std::vector<ColumnBlockSummary>& summaries = reader.summaries();
+            const long long fromTime = toColumnTime(from);
+            const long long toTime = toColumnTime(to);
+            // Data from before the columnar archive was switched on has to come from the text archive
+            if (summaries.empty() || summaries.front().minTime > fromTime) return false;
+
+            // Select blocks overlapping the range and count their data points
+            std::vector<size_t> selected;
+            size_t lastBlockBefore = summaries.size(); // i.e. none
+            size_t ndata = 0;
+            for (size_t i = 0; i < summaries.size(); ++i) {
+                const ColumnBlockSummary& summary = summaries[i];
+                if (summary.maxTime < fromTime) {
+                    lastBlockBefore = i;
+                } else if (summary.minTime <= toTime) {
+                    selected.push_back(i);
+                    ndata += summary.numRecords;
+                }
+            }
+            // reduction factor to skip data points - nothing skipped if zero
+            const size_t reductionFactor = (maxNumData ? (ndata + maxNumData - 1) / maxNumData : 0);
+
+            auto addPoint = [&result](bool login) -> Hash& {
+                if (login && !result.empty()) {
+                    result.back().setAttribute("v", "isLast", 'L');
+                }
+                result.push_back(Hash());
+                return result.back();
+            };
+            auto addRecord = [this, &addPoint](const ColumnBlock& block, size_t i) {
+                const Timestamp stamp(fromColumnTime(block.times[i]), TimeId(block.trainIds[i]));
+                Hash& point = addPoint(block.logins[i]);
+                if (block.kind == ColumnValueKind::TEXT) {
+                    readToHash(point, "v", stamp, block.type, block.texts[i]);
+                } else {
+                    unsigned long long raw;
+                    if (block.kind == ColumnValueKind::INTEGER) {
+                        raw = static_cast<unsigned long long>(block.integers[i]);
+                    } else {
+                        std::memcpy(&raw, &block.floats[i], sizeof(raw));
+                    }
+                    Hash::Node& node = setColumnValue(point, "v", Types::from<FromLiteral>(block.type), raw);
+                    stamp.toHashAttributes(node.getAttributes());
+                }
+            };
+
+            ColumnBlock block;
+            size_t indx = 0; // counter of processed records
+            for (const size_t iBlock : selected) {
+                const ColumnBlockSummary& summary = summaries[iBlock];
+                const bool inRange = (summary.minTime >= fromTime && summary.maxTime <= toTime);
+                if (reductionFactor && inRange && summary.kind != static_cast<unsigned char>(ColumnValueKind::TEXT) &&
+                    summary.numLogins == 0u && summary.numRecords < 2 * reductionFactor) {
+                    // At most two points would survive decimation: take the extrema, no need to decode.
+                    const Types::ReferenceType type = static_cast<Types::ReferenceType>(summary.type);
+                    const bool minFirst = (summary.minValueTime <= summary.maxValueTime);
+                    const size_t numPoints = (summary.minValueTime == summary.maxValueTime ? 1 : 2);
+                    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+                        const bool takeMin = (minFirst == (iPoint == 0));
+                        const long long time = (takeMin ? summary.minValueTime : summary.maxValueTime);
+                        const unsigned long long trainId = (takeMin ? summary.minValueTrainId : summary.maxValueTrainId);
+                        Hash& point = addPoint(false);
+                        Hash::Node& node =
+                              setColumnValue(point, "v", type, (takeMin ? summary.minValue : summary.maxValue));
+                        Timestamp(fromColumnTime(time), TimeId(trainId)).toHashAttributes(node.getAttributes());
+                    }
+                    indx += summary.numRecords;
+                    continue;
+                }
+                reader.read(summary, block);
+                for (size_t i = 0; i < block.size(); ++i) {
+                    if (block.times[i] < fromTime || block.times[i] > toTime) continue;
+                    if (reductionFactor && (indx++ % reductionFactor) != 0 && !block.logins[i]) {
+                        continue; // skip data point
+                    }
+                    addRecord(block, i);
+                }
+            }
+
+            if (result.empty() && lastBlockBefore < summaries.size()) {
+                // Nothing in range: provide the last value before, as the text archive does
+                reader.read(summaries[lastBlockBefore], block);
+                size_t iLast = 0;
+                for (size_t i = 1; i < block.size(); ++i) {
+                    if (block.times[i] >= block.times[iLast]) iLast = i;
+                }
+                if (block.size() > 0) addRecord(block, iLast);
+            }
+            return true;
+        }
+
+
         void FileLogReader::readToHash(Hash& hashOut, const std::string& path, const Timestamp& timestamp,
                                        const std::string& typeString, const string& value) const {
             using karabo::util::DATALOG_NEWLINE_MANGLE;
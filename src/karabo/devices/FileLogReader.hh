@@ -152,6 +152,18 @@ namespace karabo {
                             const karabo::data::Timestamp& timestamp, const std::string& type,
                             const std::string& value) const;
 
+            /**
+             * Internal helper:
+             * Fill 'result' with the history of 'property' between 'from' and 'to' from the columnar archive.
+             * If more than 'maxNumData' (if non-zero) points are in that range, the data is decimated, using block
+             * summaries (minimum and maximum) instead of decoding the block where this suffices.
+             *
+             * @return false if there is no columnar archive for the property or it does not cover 'from'
+             */
+            bool readColumnarHistory(const std::string& deviceId, const std::string& property,
+                                     const karabo::data::Epochstamp& from, const karabo::data::Epochstamp& to,
+                                     unsigned int maxNumData, std::vector<karabo::data::Hash>& result) const;
+
             /**
              * Retrieves, from the logger index, the event of type "device became online" that is closest, but not after
              * a given timepoint. The retrieved logger index event can be used as a starting point for sweeping the
@@ -2233,6 +2233,10 @@ namespace karabo {
                 const bool subscribe = info.get<bool>("subscribe");
                 KARABO_LOG_FRAMEWORK_DEBUG << "onSubscribeNetwork : channelName = '" << channelName << "' "
                                            << (subscribe ? "+" : "-");
+                // Parse (and validate) before any state is touched
+                const bool hasReduction = subscribe && info.has("imageReduction");
+                const ImageReduction reduction(hasReduction ? ImageReduction::fromHash(info.get<Hash>("imageReduction"))
+                                                            : ImageReduction());
 
                 std::lock_guard<std::mutex> lock(m_networkMutex);
                 auto& channelSet = m_networkConnections[channelName];
@@ -2248,6 +2252,11 @@ namespace karabo {
                     }
                     // Mark as ready - no matter whether ready already before...
                     m_readyNetworkConnections[channelName][channel] = true;
+                    if (hasReduction) {
+                        m_networkImageReductions[channelName][channel] = reduction;
+                    } else {
+                        eraseImageReduction(channelName, channel);
+                    }
                     if (notYetRegistered) {
                         KARABO_LOG_FRAMEWORK_DEBUG << "Register to monitor '" << channelName << "'";
 
@@ -2278,6 +2287,7 @@ namespace karabo {
                             m_readyNetworkConnections.erase(itReadyByChannel);
                         }
                     }
+                    eraseImageReduction(channelName, channel);
                     if (channelSet.empty()) {
                         if (!remote().unregisterChannelMonitor(channelName)) {
                             // See comment above about channelSet.erase(..)
@@ -2369,24 +2379,58 @@ namespace karabo {
                 dataNode.getValue<Hash>() = std::move(const_cast<Hash&>(data));
                 Hash::Node& metaNode = h.set("meta.timestamp", true);
                 meta.getTimestamp().toHashAttributes(metaNode.getAttributes());
-                std::lock_guard<std::mutex> lock(m_networkMutex);
-                NetworkMap::const_iterator iter = m_networkConnections.find(channelName);
-                if (iter != m_networkConnections.cend()) {
-                    for (const WeakChannelPointer& channel : iter->second) { // iter->second is set<WeakChannelPointer>
-                        bool& ready = m_readyNetworkConnections[channelName][channel];
-                        if (ready) {
-                            // Ready for data, so send and set non-ready.
+                // Clients ready for data, grouped by the image reduction they want
+                std::map<ImageReduction, std::vector<WeakChannelPointer>> readyChannels;
+                {
+                    std::lock_guard<std::mutex> lock(m_networkMutex);
+                    NetworkMap::const_iterator iter = m_networkConnections.find(channelName);
+                    if (iter != m_networkConnections.cend()) {
+                        auto itReductions = m_networkImageReductions.find(channelName);
+                        for (const WeakChannelPointer& channel : iter->second) { // set<WeakChannelPointer>
+                            bool& ready = m_readyNetworkConnections[channelName][channel];
+                            if (ready) {
+                                // Ready for data, so will send and set non-ready.
+                                ImageReduction reduction;
+                                if (itReductions != m_networkImageReductions.end()) {
+                                    auto itReduction = itReductions->second.find(channel);
+                                    if (itReduction != itReductions->second.end()) reduction = itReduction->second;
+                                }
+                                readyChannels[reduction].push_back(channel);
+                                ready = false; // it's a reference
+                            }
+                        }
+                    } // else: all clients lost interest, but still some data arrives
+                }
+                // Reduce outside the lock and only once for all clients wanting the same
+                for (const auto& reductionAndChannels : readyChannels) {
+                    const ImageReduction& reduction = reductionAndChannels.first;
+                    if (reduction.isNoop()) {
+                        for (const WeakChannelPointer& channel : reductionAndChannels.second) {
                             safeClientWrite(channel, h, FAST_DATA);
-                            ready = false; // it's a reference
+                        }
+                    } else {
+                        Hash reduced(h);
+                        reduceImages(reduced.get<Hash>("data"), reduction);
+                        for (const WeakChannelPointer& channel : reductionAndChannels.second) {
+                            safeClientWrite(channel, reduced, FAST_DATA);
                         }
                     }
-                } // else: all clients lost interest, but still some data arrives
+                }
             } catch (const std::exception& e) {
                 KARABO_LOG_FRAMEWORK_ERROR << "Problem in onNetworkData: " << e.what();
             }
         }
 
 
+        void GuiServerDevice::eraseImageReduction(const std::string& channelName, const WeakChannelPointer& channel) {
+            auto it = m_networkImageReductions.find(channelName);
+            if (it != m_networkImageReductions.end()) {
+                it->second.erase(channel);
+                if (it->second.empty()) m_networkImageReductions.erase(it);
+            }
+        }
+
+
         void GuiServerDevice::sendSystemTopology(WeakChannelPointer channel) {
             try {
                 Hash topology(remote().getSystemTopology());
@@ -2483,6 +2527,7 @@ namespace karabo {
                             // Use the reference 'channelName' before invalidating it by invalidating mapIter:
                             remote().unregisterChannelMonitor(channelName);
                             m_readyNetworkConnections.erase(channelName);
+                            m_networkImageReductions.erase(channelName);
                             mapIter = m_networkConnections.erase(mapIter);
                         } else {
                             ++mapIter;
@@ -2684,6 +2729,7 @@ namespace karabo {
                                 ++itPair;
                             }
                         }
+                        eraseImageReduction(iter->first, channel);
                         if (channelSet.empty()) {
                             // First use 'iter', then remove it:
                             remote().unregisterChannelMonitor(iter->first);
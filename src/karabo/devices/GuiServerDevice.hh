@@ -37,6 +37,7 @@
 #include "karabo/net/Broker.hh"
 #include "karabo/net/Connection.hh"
 #include "karabo/util/Version.hh"
+#include "karabo/xms/ImageReduction.hh"
 #include "karabo/xms/InputChannel.hh"
 
 /**
@@ -159,6 +160,9 @@ namespace karabo {
             // Next map<string, ...> not unordered before use of C++14 because we erase from it while looping over it.
             std::map<std::string, std::map<WeakChannelPointer, bool, WeakChannelPointerCompare>>
                   m_readyNetworkConnections;
+            // Image reduction requested by a client for its subscription - no entry means full data
+            std::map<std::string, std::map<WeakChannelPointer, karabo::xms::ImageReduction, WeakChannelPointerCompare>>
+                  m_networkImageReductions;
 
             typedef std::map<karabo::net::Channel::Pointer, ChannelData>::const_iterator ConstChannelIterator;
             typedef std::map<karabo::net::Channel::Pointer, ChannelData>::iterator ChannelIterator;
@@ -907,6 +911,9 @@ namespace karabo {
              * is maintained, even if multiple gui-clients listen to it. The gui-server
              * thus acts as a kind of hub for pipe-lined processing onto gui-clients.
              *
+             * An optional ``imageReduction`` Hash in ``info`` requests that ImageData in the pipeline data
+             * is reduced for this client before being sent, see ``karabo::xms::ImageReduction::fromHash``.
+             *
              * If ``subscribe`` is set to false, the connection is removed from the list of
              * registered connections, but is kept open.
              *
@@ -950,6 +957,9 @@ namespace karabo {
              * the following hash message format: ``type=networkData``, ``name`` is the
              * channel name and ``data`` holding the data.
              *
+             * Clients that requested an image reduction get the data with reduced ImageData. The
+             * reduction is done once per data and distinct reduction, i.e. shared among clients.
+             *
              * @param channelName: name of the InputChannel that provides these data
              * @param data: the data coming from channelName
              * @param meta: corresponding meta data
@@ -957,6 +967,12 @@ namespace karabo {
             void onNetworkData(const std::string& channelName, const karabo::data::Hash& data,
                                const karabo::xms::InputChannel::MetaData& meta);
 
+            /**
+             * Forget the image reduction a client requested for an output channel.
+             * Requires m_networkMutex to be locked.
+             */
+            void eraseImageReduction(const std::string& channelName, const WeakChannelPointer& channel);
+
             /**
              * sends the current system topology to the client connected on ``channel``.
              * The hash reply contains ``type=systemTopology`` and the ``systemTopology``.
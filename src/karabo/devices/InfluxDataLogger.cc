@@ -159,20 +159,21 @@ namespace karabo {
             std::vector<RejectedData> rejectedPaths; // path and reason
             // To write log I need schema - but that has arrived before connecting signal[State]Changed to
             // slotChanged and thus before any data can arrive here in handleChanged.
-            std::vector<std::string> paths;
-            getPathsForConfiguration(configuration, m_currentSchema, paths);
+            std::vector<ConfigurationLeaf> leaves;
+            getLeavesForConfiguration(configuration, m_currentSchema, leaves);
+            m_numUpdates += leaves.size();
             std::stringstream query;
             Timestamp lineTimestamp(Epochstamp(0ull, 0ull), TimeId(0ull));
 
-            for (size_t i = 0; i < paths.size(); ++i) {
-                const std::string& path = paths[i];
+            for (const ConfigurationLeaf& leaf : leaves) {
+                const std::string& path = leaf.path;
 
                 // Skip those elements which should not be archived
                 const bool noArchive = (!m_currentSchema.has(path) ||
                                         (m_currentSchema.hasArchivePolicy(path) &&
                                          (m_currentSchema.getArchivePolicy(path) == Schema::NO_ARCHIVING)));
 
-                const Hash::Node& leafNode = configuration.getNode(path);
+                const Hash::Node& leafNode = *leaf.node;
 
                 // Check for timestamp ...
                 if (!Timestamp::hashAttributesContainTimeInformation(leafNode.getAttributes())) {
@@ -184,11 +185,11 @@ namespace karabo {
                 }
 
                 if (m_pendingLogin) {
-                    login(configuration, paths);
+                    login(configuration, leaves);
                     m_pendingLogin = false;
                 }
 
-                Timestamp t = Timestamp::fromHashAttributes(leafNode.getAttributes());
+                Timestamp t(leaf.stamp, TimeId::fromHashAttributes(leafNode.getAttributes()));
                 if (t.getEpochstamp() < m_loggingStartStamp.getEpochstamp()) {
                     // Stamp is older than logging start time. To avoid confusion, especially for properties with no
                     // default value i.e. which may not exist at some points in time) we overwrite the stamp with
@@ -340,11 +341,11 @@ namespace karabo {
 
 
         void InfluxDeviceData::login(const karabo::data::Hash& configuration,
-                                     const std::vector<std::string>& sortedPaths) {
+                                     const std::vector<ConfigurationLeaf>& sortedLeaves) {
             // TRICK: 'configuration' is the one requested at the beginning. For devices which have
             // properties with older timestamps than the time of their instantiation (as e.g. read from
             // hardware), we can claim that logging is active only from the most recent update we receive here.
-            const auto& attrsOfPathWithMostRecentStamp = configuration.getAttributes(sortedPaths.back());
+            const auto& attrsOfPathWithMostRecentStamp = sortedLeaves.back().node->getAttributes();
             m_loggingStartStamp = Timestamp::fromHashAttributes(attrsOfPathWithMostRecentStamp);
             const unsigned long long ts = m_loggingStartStamp.toTimestamp() * INFLUX_PRECISION_FACTOR;
             std::stringstream ss;
@@ -79,9 +79,9 @@ namespace karabo {
              * Helper to store logging start event
              *
              * @param configuration full device configuration received when logging starts
-             * @param sortedPaths full paths of configuration, sorted by increasing timestamp
+             * @param sortedLeaves leaves of configuration, sorted by increasing timestamp
              */
-            void login(const karabo::data::Hash& configuration, const std::vector<std::string>& sortedPaths);
+            void login(const karabo::data::Hash& configuration, const std::vector<ConfigurationLeaf>& sortedLeaves);
 
             void terminateQuery(std::stringstream& query, const karabo::data::Timestamp& stamp,
                                 std::vector<RejectedData>& rejectedPathReasons);
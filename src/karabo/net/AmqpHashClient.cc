@@ -41,14 +41,23 @@ namespace karabo::net {
                                                    AMQP::Table queueArgs, AmqpHashClient::HashReadHandler readHandler,
                                                    AmqpHashClient::ErrorReadHandler errorReadHandler) {
         Pointer result(new AmqpHashClient(std::move(connection), std::move(instanceId), std::move(queueArgs),
-                                          std::move(readHandler), std::move(errorReadHandler)));
-        // Cannot use yet use bind_weak in constructor, so do here
-        result->m_rawClient->setReadHandler(util::bind_weak(&AmqpHashClient::onRead, result.get(), _1, _2, _3));
+                                          std::move(readHandler), LazyReadHandler(), std::move(errorReadHandler)));
+        result->setRawReadHandler();
+        return result;
+    }
+
+    AmqpHashClient::Pointer AmqpHashClient::create(AmqpConnection::Pointer connection, std::string instanceId,
+                                                   AMQP::Table queueArgs, AmqpHashClient::LazyReadHandler readHandler,
+                                                   AmqpHashClient::ErrorReadHandler errorReadHandler) {
+        Pointer result(new AmqpHashClient(std::move(connection), std::move(instanceId), std::move(queueArgs),
+                                          HashReadHandler(), std::move(readHandler), std::move(errorReadHandler)));
+        result->setRawReadHandler();
         return result;
     }
 
     AmqpHashClient::AmqpHashClient(AmqpConnection::Pointer connection, std::string instanceId, AMQP::Table queueArgs,
                                    AmqpHashClient::HashReadHandler readHandler,
+                                   AmqpHashClient::LazyReadHandler lazyReadHandler,
                                    AmqpHashClient::ErrorReadHandler errorReadHandler)
         : m_rawClient(std::make_shared<AmqpClient>(std::move(connection), std::move(instanceId), std::move(queueArgs),
                                                    AmqpClient::ReadHandler())), // Cannot use bind_weak in constructor,
@@ -56,10 +65,16 @@ namespace karabo::net {
           m_serializer(data::BinarySerializer<data::Hash>::create("Bin")),
           m_deserializeStrand(std::make_shared<Strand>(EventLoop::getIOService())),
           m_readHandler(std::move(readHandler)),
+          m_lazyReadHandler(std::move(lazyReadHandler)),
           m_errorReadHandler(std::move(errorReadHandler)) {}
 
     AmqpHashClient::~AmqpHashClient() {}
 
+    void AmqpHashClient::setRawReadHandler() {
+        // Cannot use yet use bind_weak in constructor, so do here
+        m_rawClient->setReadHandler(util::bind_weak(&AmqpHashClient::onRead, this, _1, _2, _3));
+    }
+
     void AmqpHashClient::asyncPublish(const std::string& exchange, const std::string& routingKey,
                                       const data::Hash::Pointer& header, const data::Hash::Pointer& body,
                                       AsyncHandler onPublishDone) {
@@ -85,14 +100,18 @@ namespace karabo::net {
     void AmqpHashClient::deserialize(const std::shared_ptr<std::vector<char>>& data, const std::string& exchange,
                                      const std::string& routingKey) {
         data::Hash::Pointer header(std::make_shared<data::Hash>());
-        data::Hash::Pointer body(std::make_shared<data::Hash>());
+        data::Hash::Pointer body;
+        LazyHashBody::Pointer lazyBody;
         try {
             const size_t bytes = m_serializer->load(*header, data->data(), data->size());
 
-            // TODO:
-            // The old client had a m_skipFlag here to potentially avoid deserialisation of 'body'.
-            // This is used in the broker rates tool.
-            m_serializer->load(*body, data->data() + bytes, data->size() - bytes);
+            if (m_lazyReadHandler) {
+                // Leave it to the handler whether (and when) to pay for deserialisation of the body
+                lazyBody = std::make_shared<LazyHashBody>(data, bytes, m_serializer);
+            } else {
+                body = std::make_shared<data::Hash>();
+                m_serializer->load(*body, data->data() + bytes, data->size() - bytes);
+            }
         } catch (const data::Exception& e) {
             const std::string userMsg(e.userFriendlyMsg(false));                       // Do not clear trace yet
             KARABO_LOG_FRAMEWORK_WARN << "Failed to deserialize: " << e.detailedMsg(); // Clears exception trace
@@ -104,6 +123,41 @@ namespace karabo::net {
             return;
         }
         // Deserialization succeeded, so call handler
-        m_readHandler(header, body, exchange, routingKey);
+        if (m_lazyReadHandler) {
+            m_lazyReadHandler(header, lazyBody, exchange, routingKey);
+        } else {
+            m_readHandler(header, body, exchange, routingKey);
+        }
+    }
+
+    LazyHashBody::LazyHashBody(std::shared_ptr<std::vector<char>> data, size_t offset,
+                               data::BinarySerializer<data::Hash>::Pointer serializer)
+        : m_data(std::move(data)), m_offset(offset), m_serializer(std::move(serializer)) {}
+
+    size_t LazyHashBody::size() const {
+        return m_data->size() - m_offset;
+    }
+
+    const char* LazyHashBody::data() const {
+        return m_data->data() + m_offset;
+    }
+
+    const std::shared_ptr<std::vector<char>>& LazyHashBody::message() const {
+        return m_data;
+    }
+
+    bool LazyHashBody::isDeserialized() const {
+        std::lock_guard<std::mutex> lock(m_bodyMutex);
+        return static_cast<bool>(m_body);
+    }
+
+    data::Hash::Pointer LazyHashBody::get() {
+        std::lock_guard<std::mutex> lock(m_bodyMutex);
+        if (!m_body) {
+            auto body = std::make_shared<data::Hash>();
+            m_serializer->load(*body, data(), size());
+            m_body = std::move(body); // only if deserialisation succeeded
+        }
+        return m_body;
     }
 } // namespace karabo::net
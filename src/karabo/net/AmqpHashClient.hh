@@ -25,7 +25,10 @@
 #ifndef KARABO_NET_AMQPHASHCLIENT_HH
 #define KARABO_NET_AMQPHASHCLIENT_HH
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "AmqpClient.hh"
 #include "AmqpConnection.hh"
@@ -36,6 +39,55 @@
 
 namespace karabo::net {
 
+    /**
+     * @brief Serialised body of a message received by an AmqpHashClient, deserialised only on demand
+     *
+     * Allows to look at the header of a message (e.g. to filter on it) before paying for the deserialisation of the
+     * body - or to use the serialised body as it is, e.g. to know its size or to forward it.
+     * Thread safe.
+     */
+    class LazyHashBody {
+       public:
+        KARABO_CLASSINFO(LazyHashBody, "LazyHashBody", "1.0")
+
+        /**
+         * Construct from a serialised message
+         *
+         * @param data serialised header and body
+         * @param offset where in 'data' the body starts, i.e. the size of the serialised header
+         * @param serializer to deserialise the body with
+         */
+        LazyHashBody(std::shared_ptr<std::vector<char>> data, size_t offset,
+                     data::BinarySerializer<data::Hash>::Pointer serializer);
+
+        /// Size of the serialised body in bytes
+        size_t size() const;
+
+        /// Begin of the serialised body - valid as long as this object lives
+        const char* data() const;
+
+        /// The full message as received, i.e. serialised header and body - e.g. to record or forward it unchanged
+        const std::shared_ptr<std::vector<char>>& message() const;
+
+        /// Whether get() already deserialised the body
+        bool isDeserialized() const;
+
+        /**
+         * Get the body, deserialise it if not yet done
+         *
+         * @return the body, the same object for each call
+         * @throw karabo::data::Exception or std::exception if the body cannot be deserialised
+         */
+        data::Hash::Pointer get();
+
+       private:
+        const std::shared_ptr<std::vector<char>> m_data;
+        const size_t m_offset;
+        const data::BinarySerializer<data::Hash>::Pointer m_serializer;
+        mutable std::mutex m_bodyMutex;
+        data::Hash::Pointer m_body;
+    };
+
     /**
      * @brief Class that wraps around AmqpClient to provide a message interface with Hash header and body
      *
@@ -49,6 +101,8 @@ namespace karabo::net {
 
         using HashReadHandler = std::function<void(const data::Hash::Pointer&, const data::Hash::Pointer&,
                                                    const std::string&, const std::string&)>;
+        using LazyReadHandler = std::function<void(const data::Hash::Pointer&, const LazyHashBody::Pointer&,
+                                                   const std::string&, const std::string&)>;
         using ErrorReadHandler = std::function<void(const std::string&)>;
 
         /**
@@ -67,6 +121,18 @@ namespace karabo::net {
         static Pointer create(AmqpConnection::Pointer connection, std::string instanceId, AMQP::Table queueArgs,
                               HashReadHandler readHandler, ErrorReadHandler errorReadHandler);
 
+        /**
+         * Create client with message interface based on a Hash header and a body that is deserialised on demand.
+         *
+         * Meant for clients that do not need the body of all messages, e.g. monitoring tools that filter on the
+         * header. Otherwise as the other create(..), except that the error handler is only called for messages
+         * whose header cannot be deserialised.
+         *
+         * @param readHandler a valid read handler for all received messages
+         */
+        static Pointer create(AmqpConnection::Pointer connection, std::string instanceId, AMQP::Table queueArgs,
+                              LazyReadHandler readHandler, ErrorReadHandler errorReadHandler);
+
         virtual ~AmqpHashClient();
 
         /**
@@ -108,12 +174,26 @@ namespace karabo::net {
         void asyncPublish(const std::string& exchange, const std::string& routingKey, const data::Hash::Pointer& header,
                           const data::Hash::Pointer& body, AsyncHandler onPublishDone);
 
+        /**
+         * Asynchronously publish a message that is already serialised, e.g. one received before (see
+         * LazyHashBody::message()), by just forwarding to AmqpClient::asyncPublish
+         *
+         *  ==> See docs of that.
+         */
+        inline void asyncPublishRaw(const std::string& exchange, const std::string& routingKey,
+                                    const std::shared_ptr<std::vector<char>>& message, AsyncHandler onPublishDone) {
+            m_rawClient->asyncPublish(exchange, routingKey, message, std::move(onPublishDone));
+        }
+
        private:
         /**
          * Internal constructor, use static create instead: raw clients read handler has to be set after construction
          */
         AmqpHashClient(AmqpConnection::Pointer connection, std::string instanceId, AMQP::Table queueArgs,
-                       HashReadHandler readHandler, ErrorReadHandler errorReadHandler);
+                       HashReadHandler readHandler, LazyReadHandler lazyReadHandler, ErrorReadHandler errorReadHandler);
+
+        /// Set read handler of raw client, to be called directly after construction
+        void setRawReadHandler();
 
         /**
          * Handler passed to raw client (i.e. runs in io context of connection).
@@ -124,7 +204,8 @@ namespace karabo::net {
                     const std::string& routingKey);
 
         /**
-         * Deserializes 'data' input into Hash for header and body and calls handlers passed to constructor
+         * Deserializes 'data' input into Hash for header and body (or a LazyHashBody) and calls handlers passed to
+         * constructor
          */
         void deserialize(const std::shared_ptr<std::vector<char>>& data, const std::string& exchange,
                          const std::string& routingKey);
@@ -134,6 +215,7 @@ namespace karabo::net {
         karabo::data::BinarySerializer<data::Hash>::Pointer m_serializer;
         karabo::net::Strand::Pointer m_deserializeStrand;
         const HashReadHandler m_readHandler;
+        const LazyReadHandler m_lazyReadHandler; // if set, m_readHandler is not
         const ErrorReadHandler m_errorReadHandler;
 
     }; // AmqpHashClient
@@ -618,6 +618,14 @@ namespace karabo {
                 throw KARABO_NOT_SUPPORTED_EXCEPTION("Not implemented!");
             }
 
+            /**
+             * Smoothed round trip time of the underlying connection as measured by the operating system
+             * @return round trip time in microseconds, 0 if not known
+             */
+            virtual unsigned int roundTripTime() {
+                return 0u;
+            }
+
             /**
              * Set a timeout in when synchronous reads timeout if the haven't been handled
              * @param milliseconds
@@ -24,7 +24,12 @@
 
 #include "EventLoop.hh"
 
+#include <pthread.h>
+#include <sched.h>
+
+#include <condition_variable>
 #include <csignal>
+#include <cstring>
 #include <iostream>
 #include <thread>
 
@@ -58,6 +63,87 @@ namespace karabo {
         }
 
 
+        TimerWheel::Pointer EventLoop::getTimerWheel() {
+            return instance()->m_timerWheel;
+        }
+
+
+        void EventLoop::setNumberOfShards(unsigned int nShards, unsigned int threadsPerShard, bool pinThreads) {
+            auto loop = instance();
+            std::lock_guard<std::mutex> lock(loop->m_shardsMutex);
+            if (loop->m_running) {
+                throw KARABO_LOGIC_EXCEPTION("Cannot shard the event loop while it is running");
+            }
+            if (!loop->m_shards.empty()) {
+                throw KARABO_LOGIC_EXCEPTION("Event loop is already sharded");
+            }
+            loop->m_threadsPerShard = std::max(1u, threadsPerShard);
+            loop->m_pinShardThreads = pinThreads;
+            for (unsigned int i = 0; i < nShards; ++i) {
+                loop->m_shards.push_back(std::make_unique<Shard>());
+            }
+            loop->m_nShards.store(nShards, std::memory_order_release);
+        }
+
+
+        size_t EventLoop::getNumberOfShards() {
+            return instance()->m_nShards.load(std::memory_order_acquire);
+        }
+
+
+        boost::asio::io_context& EventLoop::getShardIOService() {
+            auto loop = instance();
+            const size_t nShards = loop->m_nShards.load(std::memory_order_acquire);
+            if (nShards == 0) return loop->m_ioService;
+            return loop->m_shards[loop->m_nextShard++ % nShards]->ioContext;
+        }
+
+
+        void EventLoop::setLatencyProbeInterval(unsigned int intervalMs) {
+            instance()->m_probeIntervalMs = intervalMs;
+        }
+
+
+        karabo::data::Hash EventLoop::getStatistics() {
+            auto loop = instance();
+            karabo::data::Hash result("numberOfThreads", static_cast<unsigned int>(loop->_getNumberOfThreads()),
+                                      "latency", loop->m_latency.toHash());
+            std::vector<karabo::data::Hash> shards;
+            const size_t nShards = loop->m_nShards.load(std::memory_order_acquire);
+            for (size_t i = 0; i < nShards; ++i) {
+                shards.push_back(karabo::data::Hash("threads", loop->m_threadsPerShard, "latency",
+                                                    loop->m_shards[i]->latency.toHash()));
+            }
+            result.set("shards", std::move(shards));
+            return result;
+        }
+
+
+        void EventLoop::LatencyStatistics::reset() {
+            samples = 0ull;
+            sum = 0ull;
+            max = 0ull;
+            last = 0ull;
+        }
+
+
+        void EventLoop::LatencyStatistics::add(unsigned long long latency) {
+            last = latency;
+            sum += latency;
+            unsigned long long oldMax = max.load();
+            while (latency > oldMax && !max.compare_exchange_weak(oldMax, latency)) {
+            }
+            ++samples; // last, so a sample counted is fully accounted
+        }
+
+
+        karabo::data::Hash EventLoop::LatencyStatistics::toHash() const {
+            const unsigned long long n = samples.load();
+            return karabo::data::Hash("last", last.load(), "mean", (n > 0ull ? sum.load() / n : 0ull), "max",
+                                      max.load(), "samples", n);
+        }
+
+
         void EventLoop::work() {
             // Note: If signal set is changed, adjust documentation (also in karabind)
             boost::asio::signal_set signals(getIOService(), SIGINT, SIGTERM);
@@ -108,16 +194,114 @@ namespace karabo {
             // before this run() and after a previous run() had finished since out of work.
             m_ioService.restart();
             m_running = true; // _addThread(..) must not directly add a thread before m_ioService.restart();
-            bool ret = true;
-            while (ret) {
-                if (m_ioService.stopped()) break;
-                ret = runProtected();
+            startShards();
+            m_latency.reset();
+            m_probeThread = std::jthread([this](std::stop_token stoken) { probeLatency(stoken); });
+            auto stopHelpers = [this]() {
+                m_probeThread.request_stop();
+                m_probeThread.join();
+                stopShards();
+            };
+            try {
+                bool ret = true;
+                while (ret) {
+                    if (m_ioService.stopped()) break;
+                    ret = runProtected(m_ioService);
+                }
+            } catch (...) {
+                stopHelpers();
+                throw;
             }
+            stopHelpers();
             m_running = false;
             clearThreadPool();
         }
 
 
+        void EventLoop::startShards() {
+            std::lock_guard<std::mutex> lock(m_shardsMutex);
+            if (m_shards.empty()) return;
+
+            std::vector<int> cpus;
+            if (m_pinShardThreads) {
+                cpu_set_t allowed;
+                CPU_ZERO(&allowed);
+                if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+                    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                        if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+                    }
+                }
+            }
+            size_t iCpu = 0;
+            for (std::unique_ptr<Shard>& shard : m_shards) {
+                shard->ioContext.restart();
+                shard->latency.reset();
+                shard->work = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(
+                      boost::asio::make_work_guard(shard->ioContext));
+                for (unsigned int i = 0; i < m_threadsPerShard; ++i) {
+                    boost::asio::io_context* ioContext = &shard->ioContext;
+                    std::jthread& thread = shard->threads.emplace_back([this, ioContext](std::stop_token stoken) {
+                        while (!stoken.stop_requested()) {
+                            if (!runProtected(*ioContext)) return;
+                        }
+                    });
+                    if (!cpus.empty()) {
+                        cpu_set_t cpuSet;
+                        CPU_ZERO(&cpuSet);
+                        CPU_SET(cpus[iCpu++ % cpus.size()], &cpuSet);
+                        const int rc = pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+                        if (rc != 0) {
+                            KARABO_LOG_FRAMEWORK_WARN << "Failed to pin event loop shard thread to CPU: "
+                                                      << std::strerror(rc);
+                        }
+                    }
+                }
+            }
+            KARABO_LOG_FRAMEWORK_DEBUG << "Started " << m_shards.size() << " event loop shards with "
+                                       << m_threadsPerShard << " thread(s) each";
+        }
+
+
+        void EventLoop::stopShards() {
+            std::lock_guard<std::mutex> lock(m_shardsMutex);
+            for (std::unique_ptr<Shard>& shard : m_shards) {
+                shard->work.reset();
+                shard->ioContext.stop();
+            }
+            for (std::unique_ptr<Shard>& shard : m_shards) {
+                for (std::jthread& thread : shard->threads) {
+                    thread.request_stop();
+                    thread.join();
+                }
+                shard->threads.clear();
+            }
+        }
+
+
+        void EventLoop::probeLatency(std::stop_token stoken) {
+            std::mutex mutex;
+            std::condition_variable_any cv;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stoken.stop_requested()) {
+                const unsigned int intervalMs = m_probeIntervalMs;
+                // Disabled probe: just look from time to time whether it got enabled
+                cv.wait_for(lock, stoken, milliseconds(intervalMs > 0u ? intervalMs : 1000u), []() { return false; });
+                if (intervalMs == 0u || stoken.stop_requested()) continue;
+
+                const steady_clock::time_point posted = steady_clock::now();
+                auto measure = [posted](LatencyStatistics* stats) {
+                    stats->add(duration_cast<microseconds>(steady_clock::now() - posted).count());
+                };
+                boost::asio::post(m_ioService, std::bind(measure, &m_latency));
+                const size_t nShards = m_nShards.load(std::memory_order_acquire);
+                for (size_t i = 0; i < nShards; ++i) {
+                    Shard* shard = m_shards[i].get();
+                    boost::asio::post(shard->ioContext, std::bind(measure, &shard->latency));
+                }
+            }
+        }
+
+
         void EventLoop::stop() {
             auto theInstance = instance();
             if (theInstance->m_running) {
@@ -165,7 +349,8 @@ namespace karabo {
                     std::unique_ptr<std::jthread> jt(new std::jthread([](std::stop_token stoken) {
                         while (true) {
                             if (stoken.stop_requested()) return;
-                            if (!instance()->runProtected()) return;
+                            auto loop = instance();
+                            if (!loop->runProtected(loop->m_ioService)) return;
                         }
                     }));
                     std::jthread::id jid = jt->get_id();
@@ -281,7 +466,7 @@ namespace karabo {
         }
 
 
-        bool EventLoop::runProtected() {
+        bool EventLoop::runProtected(boost::asio::io_context& ioContext) {
             // See http://www.boost.org/doc/libs/1_55_0/doc/html/boost_asio/reference/io_service.html:
             // "If an exception is thrown from a handler, the exception is allowed to propagate through the throwing
             //  thread's invocation of run(), run_one(), poll() or poll_one(). No other threads that are calling any
@@ -295,7 +480,7 @@ namespace karabo {
             const std::string fullMessage(" during event-loop callback (io_context) ");
 
             try {
-                m_ioService.run();
+                ioContext.run();
                 return false; // Regular exit
             } catch (const RemoveThreadException&) {
                 // This is a sign to remove this thread from the pool
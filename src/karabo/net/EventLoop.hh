@@ -33,8 +33,12 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
+#include "TimerWheel.hh"
 #include "karabo/data/types/ClassInfo.hh"
+#include "karabo/data/types/Hash.hh"
 
 namespace karabo {
     namespace net {
@@ -72,6 +76,9 @@ namespace karabo {
 
             /**
              * Post a task on the underlying io event loop for later execution
+             *
+             * Delayed tasks are scheduled on the TimerWheel of the event loop, see getTimerWheel().
+             *
              * @param func a functor not taking any argument, but with any return type
              * @param delayMs execution will be delayed by given time (in milliseconds)
              */
@@ -84,6 +91,66 @@ namespace karabo {
              */
             static boost::asio::io_context& getIOService();
 
+            /**
+             * Return the TimerWheel of the event loop that posts to getIOService() with a granularity of 1 ms.
+             *
+             * Use it instead of an own timer for timeouts that are usually cancelled before they expire or for
+             * many timeouts in parallel. All of them are served by a single timer.
+             */
+            static TimerWheel::Pointer getTimerWheel();
+
+            /**
+             * Split the event loop into shards, i.e. additional io_contexts that are each run by their own
+             * threads. Work assigned to a shard (see getShardIOService()) does not contend on the internal
+             * queue of the central io_context.
+             *
+             * The shard threads are started when run() or work() is entered and stopped when it returns.
+             * The threads added via addThread() keep serving only the central io_context.
+             *
+             * Must be called at most once and before run() or work(), otherwise a LogicException is thrown.
+             *
+             * @param nShards number of shards, 0 means no sharding
+             * @param threadsPerShard number of threads running each shard (at least 1)
+             * @param pinThreads if true, each shard thread is bound to one of the CPUs the process may use,
+             *                   starting with the first one - so better restrict the CPUs of each process if several
+             *                   processes on a host pin their threads
+             */
+            static void setNumberOfShards(unsigned int nShards, unsigned int threadsPerShard = 1,
+                                          bool pinThreads = false);
+
+            /**
+             * Return the number of shards as defined by setNumberOfShards(..)
+             */
+            static size_t getNumberOfShards();
+
+            /**
+             * Return the io_context of a shard, assigned round robin on each call.
+             * If the event loop is not sharded, this is the same as getIOService().
+             *
+             * Objects that serialise their work (e.g. a Strand or a TcpChannel) should take their io_context
+             * from here once and keep it, so that their handlers stay on the same shard.
+             */
+            static boost::asio::io_context& getShardIOService();
+
+            /**
+             * Set the interval of the latency probe that measures the time between posting a handler and
+             * its execution for the central io_context and each shard.
+             *
+             * @param intervalMs probe interval in milliseconds, 0 disables the probe (default is 1000)
+             */
+            static void setLatencyProbeInterval(unsigned int intervalMs);
+
+            /**
+             * Get event loop statistics:
+             * - numberOfThreads: as getNumberOfThreads()
+             * - latency: latency of the central io_context
+             * - shards: vector of Hash, for each shard "threads" and its "latency"
+             *
+             * Each latency is a Hash with "last", "mean" and "max" (all in microseconds) and the number of
+             * "samples" since run() or work() was entered.
+             */
+            static karabo::data::Hash getStatistics();
+
             /** Start the event loop and block until EventLoop::stop() is called.
              *
              *  The system signals SIGINT and SIGTERM will be caught and trigger the following actions:
@@ -143,7 +210,15 @@ namespace karabo {
             }
 
            private:
-            EventLoop() : m_running(false), m_catchExceptions(true){};
+            EventLoop()
+                : m_running(false),
+                  m_catchExceptions(true),
+                  m_nShards(0),
+                  m_threadsPerShard(1u),
+                  m_pinShardThreads(false),
+                  m_nextShard(0),
+                  m_timerWheel(std::make_shared<TimerWheel>(m_ioService, std::chrono::milliseconds(1), 256)),
+                  m_probeIntervalMs(1000u){};
 
             // Delete copy constructor and assignment operator since EventLoop is a singleton:
             EventLoop(const EventLoop&) = delete;
@@ -159,7 +234,32 @@ namespace karabo {
 
             void _removeThread(const int nThreads);
 
-            bool runProtected();
+            bool runProtected(boost::asio::io_context& ioContext);
+
+            /// Latency between posting to an io_context and running the handler, in microseconds
+            struct LatencyStatistics {
+                std::atomic<unsigned long long> samples{0ull};
+                std::atomic<unsigned long long> sum{0ull};
+                std::atomic<unsigned long long> max{0ull};
+                std::atomic<unsigned long long> last{0ull};
+
+                void reset();
+                void add(unsigned long long latency);
+                karabo::data::Hash toHash() const;
+            };
+
+            struct Shard {
+                boost::asio::io_context ioContext;
+                std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work;
+                std::vector<std::jthread> threads;
+                LatencyStatistics latency;
+            };
+
+            void startShards();
+
+            void stopShards();
+
+            void probeLatency(std::stop_token stoken);
 
             static void asyncInjectException();
 
@@ -182,6 +282,20 @@ namespace karabo {
             std::atomic<bool> m_running;
             std::atomic<bool> m_catchExceptions;
 
+            // Filled once before m_nShards is set: references to the io_contexts are handed out
+            std::vector<std::unique_ptr<Shard>> m_shards;
+            std::atomic<size_t> m_nShards;
+            unsigned int m_threadsPerShard;
+            bool m_pinShardThreads;
+            std::atomic<size_t> m_nextShard;
+            std::mutex m_shardsMutex;
+
+            TimerWheel::Pointer m_timerWheel;
+
+            LatencyStatistics m_latency;
+            std::atomic<unsigned int> m_probeIntervalMs;
+            std::jthread m_probeThread;
+
             static std::shared_ptr<EventLoop> m_instance;
             static std::once_flag m_initInstanceFlag;
 
@@ -196,23 +310,17 @@ namespace karabo {
         // Implementation of templated functions
         template <class Function>
         void EventLoop::post(Function&& func, unsigned int delayMs) {
-            boost::asio::io_context& service = getIOService();
             if (0 == delayMs) {
-                boost::asio::post(service, std::forward<Function>(func));
+                boost::asio::post(getIOService(), std::forward<Function>(func));
             } else {
-                auto timer = std::make_shared<boost::asio::steady_timer>(service);
-                timer->expires_after(std::chrono::milliseconds(delayMs));
-                // Bind timer shared_ptr to lambda to keep it alive as long as needed
-#if __cplusplus < 201402L
-                // Pre-C++14 does not support generalized lambda capture
-                timer->async_wait([func, timer]
-#else
-                timer->async_wait([func = std::forward<Function>(func), timer]
-#endif
-                                  (const boost::system::error_code& e) {
-                                      if (e) return;
-                                      func();
-                                  });
+                using Functor = std::decay_t<Function>;
+                if constexpr (std::is_copy_constructible_v<Functor>) {
+                    getTimerWheel()->schedule(std::chrono::milliseconds(delayMs), std::forward<Function>(func));
+                } else {
+                    // std::function needs a copyable target: share move-only functors
+                    auto shared = std::make_shared<Functor>(std::forward<Function>(func));
+                    getTimerWheel()->schedule(std::chrono::milliseconds(delayMs), [shared]() { (*shared)(); });
+                }
             }
         }
     } // namespace net
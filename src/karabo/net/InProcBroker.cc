@@ -0,0 +1,399 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "InProcBroker.hh"
+
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "EventLoop.hh"
+#include "karabo/data/types/Exception.hh"
+#include "karabo/log/Logger.hh"
+
+
+using namespace karabo::data;
+
+KARABO_REGISTER_FOR_CONFIGURATION(karabo::net::Broker, karabo::net::InProcBroker)
+
+namespace karabo {
+    namespace net {
+
+
+        /**
+         * Routing tables shared by all InProcBrokers of the same URL and domain
+         *
+         * Consumers are identified by their raw pointer (to remove them, even from their destructor) and
+         * referenced by a weak pointer (to deliver to them).
+         */
+        struct InProcBroker::Hub {
+            struct Consumer {
+                InProcBroker* broker;
+                std::weak_ptr<Broker> weakBroker;
+            };
+            typedef std::vector<Consumer> Consumers;
+
+            /// Get the hub for the key, create it if there is none yet
+            static std::shared_ptr<Hub> get(const std::string& key);
+
+            /// Add broker to consumers unless already in - requires mutex to be locked exclusively
+            static void add(Consumers& consumers, InProcBroker* broker, const std::weak_ptr<Broker>& weakBroker);
+
+            /// Remove broker from consumers - requires mutex to be locked exclusively
+            static void remove(Consumers& consumers, const InProcBroker* broker);
+
+            /// Remove broker from consumers of the key, erase the key if no consumers are left - requires mutex
+            /// to be locked exclusively
+            static void remove(std::unordered_map<std::string, Consumers>& consumersMap, const std::string& key,
+                               const InProcBroker* broker);
+
+            /// Collect the consumers that are still alive, at most one if firstOnly - requires mutex to be locked
+            static std::vector<std::shared_ptr<InProcBroker>> alive(const Consumers& consumers, bool firstOnly);
+
+            /// Remove broker from all consumers
+            void removeAll(const InProcBroker* broker);
+
+            std::shared_mutex mutex;
+            std::unordered_map<std::string, Consumers> oneToOne; // key is receiverId
+            Consumers broadcasts;
+            Consumers heartbeats;
+            std::unordered_map<std::string, Consumers> signals; // key is <senderId>.<signalName>
+        };
+
+
+        std::shared_ptr<InProcBroker::Hub> InProcBroker::Hub::get(const std::string& key) {
+            static std::mutex registryMutex;
+            static std::map<std::string, std::weak_ptr<Hub>> registry;
+
+            std::lock_guard<std::mutex> lock(registryMutex);
+            std::erase_if(registry, [](const auto& keyAndHub) { return keyAndHub.second.expired(); });
+            std::weak_ptr<Hub>& weakHub = registry[key];
+            std::shared_ptr<Hub> hub = weakHub.lock();
+            if (!hub) {
+                hub = std::make_shared<Hub>();
+                weakHub = hub;
+            }
+            return hub;
+        }
+
+
+        void InProcBroker::Hub::add(Consumers& consumers, InProcBroker* broker,
+                                    const std::weak_ptr<Broker>& weakBroker) {
+            for (const Consumer& consumer : consumers) {
+                if (consumer.broker == broker) return;
+            }
+            consumers.push_back(Consumer{broker, weakBroker});
+        }
+
+
+        void InProcBroker::Hub::remove(Consumers& consumers, const InProcBroker* broker) {
+            std::erase_if(consumers, [broker](const Consumer& consumer) { return consumer.broker == broker; });
+        }
+
+
+        void InProcBroker::Hub::remove(std::unordered_map<std::string, Consumers>& consumersMap,
+                                       const std::string& key, const InProcBroker* broker) {
+            auto it = consumersMap.find(key);
+            if (it != consumersMap.end()) {
+                remove(it->second, broker);
+                if (it->second.empty()) consumersMap.erase(it);
+            }
+        }
+
+
+        std::vector<std::shared_ptr<InProcBroker>> InProcBroker::Hub::alive(const Consumers& consumers,
+                                                                            bool firstOnly) {
+            std::vector<std::shared_ptr<InProcBroker>> result;
+            for (const Consumer& consumer : consumers) {
+                if (auto broker = consumer.weakBroker.lock()) {
+                    result.push_back(std::static_pointer_cast<InProcBroker>(broker));
+                    if (firstOnly) break;
+                }
+            }
+            return result;
+        }
+
+
+        void InProcBroker::Hub::removeAll(const InProcBroker* broker) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            for (auto it = oneToOne.begin(); it != oneToOne.end();) {
+                remove(it->second, broker);
+                it = (it->second.empty() ? oneToOne.erase(it) : ++it);
+            }
+            remove(broadcasts, broker);
+            remove(heartbeats, broker);
+            for (auto it = signals.begin(); it != signals.end();) {
+                remove(it->second, broker);
+                it = (it->second.empty() ? signals.erase(it) : ++it);
+            }
+        }
+
+
+        void InProcBroker::expectedParameters(karabo::data::Schema& s) {}
+
+
+        InProcBroker::InProcBroker(const karabo::data::Hash& config)
+            : Broker(config),
+              m_hub(),
+              m_handlerStrand(Configurator<Strand>::create("Strand", Hash("maxInARow", 10u))),
+              m_isReading(false) {}
+
+
+        InProcBroker::InProcBroker(const InProcBroker& o, const std::string& newInstanceId)
+            : Broker(o, newInstanceId),
+              m_hub(),
+              m_handlerStrand(Configurator<Strand>::create("Strand", Hash("maxInARow", 10u))),
+              m_isReading(false) {}
+
+
+        Broker::Pointer InProcBroker::clone(const std::string& instanceId) {
+            return Broker::Pointer(new InProcBroker(*this, instanceId));
+        }
+
+
+        InProcBroker::~InProcBroker() {
+            if (m_hub) m_hub->removeAll(this);
+        }
+
+
+        void InProcBroker::connect() {
+            if (!m_hub) {
+                m_hub = Hub::get((getBrokerUrl() + " ") += m_topic);
+            }
+        }
+
+
+        void InProcBroker::disconnect() {
+            if (m_hub) {
+                m_hub->removeAll(this);
+                m_hub.reset();
+            }
+        }
+
+
+        bool InProcBroker::isConnected() const {
+            return static_cast<bool>(m_hub);
+        }
+
+
+        std::string InProcBroker::getBrokerUrl() const {
+            return (m_availableBrokerUrls.empty() ? std::string() : m_availableBrokerUrls[0]);
+        }
+
+
+        void InProcBroker::deliver(const std::string& slot, bool isBroadcast, bool isSignal, const Hash& header,
+                                   const Hash& body) {
+            auto callReadHandler = [weakSelf{weak_from_this()}, slot, isBroadcast, isSignal,
+                                    header{std::make_shared<Hash>(header)}, body{std::make_shared<Hash>(body)}]() {
+                if (auto self = std::static_pointer_cast<Self>(weakSelf.lock())) {
+                    if (!self->m_readHandler) {
+                        KARABO_LOG_FRAMEWORK_ERROR << "Lack read handler for message with header " << *header;
+                    } else if (isSignal) {
+                        // Here 'slot' is the signal key that maps to the slots - copy them since the read handler
+                        // may (un)subscribe
+                        std::set<std::string> signalSlots;
+                        {
+                            std::lock_guard<std::mutex> lock(self->m_slotsForSignalsMutex);
+                            auto it = self->m_slotsForSignals.find(slot);
+                            if (it != self->m_slotsForSignals.end()) signalSlots = it->second;
+                        }
+                        for (const std::string& signalSlot : signalSlots) {
+                            self->m_readHandler(signalSlot, false, header, body);
+                        }
+                    } else {
+                        self->m_readHandler(slot, isBroadcast, header, body);
+                    }
+                }
+            };
+            m_handlerStrand->post(std::move(callReadHandler));
+        }
+
+
+        boost::system::error_code InProcBroker::subscribeToRemoteSignal(const std::string& slot,
+                                                                        const std::string& signalInstanceId,
+                                                                        const std::string& signalFunction) {
+            if (!m_hub) {
+                return boost::system::errc::make_error_code(boost::system::errc::not_connected);
+            }
+
+            const std::string signalKey = (signalInstanceId + ".") += signalFunction;
+            // Book-keeping is updated before the routing, so any signal routed here finds its slot.
+            // Done directly instead of in m_handlerStrand: that would block if called from the read handler.
+            std::lock_guard<std::mutex> slotsLock(m_slotsForSignalsMutex);
+            m_slotsForSignals[signalKey].insert(slot);
+            std::unique_lock<std::shared_mutex> lock(m_hub->mutex);
+            Hub::add(m_hub->signals[signalKey], this, weak_from_this());
+            return boost::system::error_code();
+        }
+
+
+        void InProcBroker::subscribeToRemoteSignalAsync(const std::string& slot, const std::string& signalInstanceId,
+                                                        const std::string& signalFunction,
+                                                        const AsyncHandler& completionHandler) {
+            const boost::system::error_code ec = subscribeToRemoteSignal(slot, signalInstanceId, signalFunction);
+            if (completionHandler) EventLoop::post(std::bind(completionHandler, ec));
+        }
+
+
+        boost::system::error_code InProcBroker::unsubscribeFromRemoteSignal(const std::string& slot,
+                                                                            const std::string& signalInstanceId,
+                                                                            const std::string& signalFunction) {
+            if (!m_hub) {
+                return boost::system::errc::make_error_code(boost::system::errc::not_connected);
+            }
+
+            const std::string signalKey = (signalInstanceId + ".") += signalFunction;
+            // See comment in subscribeToRemoteSignal
+            std::lock_guard<std::mutex> slotsLock(m_slotsForSignalsMutex);
+            std::set<std::string>& slots = m_slotsForSignals[signalKey];
+            if (0 == slots.erase(slot)) {
+                KARABO_LOG_FRAMEWORK_WARN << "Slot " << slot << " not registered for " << signalKey
+                                          << ", but trying to unsubscribe";
+            }
+            if (slots.empty()) {
+                m_slotsForSignals.erase(signalKey);
+                std::unique_lock<std::shared_mutex> lock(m_hub->mutex);
+                Hub::remove(m_hub->signals, signalKey, this);
+            }
+            return boost::system::error_code();
+        }
+
+
+        void InProcBroker::unsubscribeFromRemoteSignalAsync(const std::string& slot,
+                                                            const std::string& signalInstanceId,
+                                                            const std::string& signalFunction,
+                                                            const AsyncHandler& completionHandler) {
+            const boost::system::error_code ec = unsubscribeFromRemoteSignal(slot, signalInstanceId, signalFunction);
+            if (completionHandler) EventLoop::post(std::bind(completionHandler, ec));
+        }
+
+
+        void InProcBroker::sendSignal(const std::string& signal, const karabo::data::Hash::Pointer& header,
+                                      const karabo::data::Hash::Pointer& body) {
+            if (!m_hub) {
+                throw KARABO_NETWORK_EXCEPTION("Cannot send signal " + signal + " before connected");
+            }
+            const std::string signalKey = (m_instanceId + ".") += signal;
+            std::vector<std::shared_ptr<InProcBroker>> receivers;
+            {
+                std::shared_lock<std::shared_mutex> lock(m_hub->mutex);
+                auto it = m_hub->signals.find(signalKey);
+                if (it != m_hub->signals.end()) receivers = Hub::alive(it->second, false);
+            }
+            for (const std::shared_ptr<InProcBroker>& receiver : receivers) {
+                receiver->deliver(signalKey, false, true, *header, *body);
+            }
+        }
+
+
+        void InProcBroker::sendBroadcast(const std::string& slot, const karabo::data::Hash::Pointer& header,
+                                         const karabo::data::Hash::Pointer& body) {
+            const bool isHeartbeat = (slot == "slotHeartbeat");
+            if (!isHeartbeat && std::find(m_broadcastSlots.begin(), m_broadcastSlots.end(), slot) ==
+                                      m_broadcastSlots.end()) {
+                throw KARABO_PARAMETER_EXCEPTION(slot + " is not known broadcast slot");
+            }
+            if (!m_hub) {
+                throw KARABO_NETWORK_EXCEPTION("Cannot send broadcast " + slot + " before connected");
+            }
+            std::vector<std::shared_ptr<InProcBroker>> receivers;
+            {
+                std::shared_lock<std::shared_mutex> lock(m_hub->mutex);
+                receivers = Hub::alive(isHeartbeat ? m_hub->heartbeats : m_hub->broadcasts, false);
+            }
+            for (const std::shared_ptr<InProcBroker>& receiver : receivers) {
+                receiver->deliver(slot, true, false, *header, *body);
+            }
+        }
+
+
+        void InProcBroker::sendOneToOne(const std::string& receiverId, const std::string& slot,
+                                        const karabo::data::Hash::Pointer& header,
+                                        const karabo::data::Hash::Pointer& body) {
+            if (!m_hub) {
+                throw KARABO_NETWORK_EXCEPTION("Cannot send to " + receiverId + " before connected");
+            }
+            std::vector<std::shared_ptr<InProcBroker>> receivers;
+            {
+                std::shared_lock<std::shared_mutex> lock(m_hub->mutex);
+                auto it = m_hub->oneToOne.find(receiverId);
+                if (it != m_hub->oneToOne.end()) receivers = Hub::alive(it->second, true);
+            }
+            // Empty if receiver does not exist (yet) - as for AMQP, the message is lost then
+            for (const std::shared_ptr<InProcBroker>& receiver : receivers) {
+                receiver->deliver(slot, false, false, *header, *body);
+            }
+        }
+
+
+        void InProcBroker::startReading(const consumer::MessageHandler& handler,
+                                        const consumer::ErrorNotifier& errorNotifier) {
+            if (!m_hub) {
+                throw KARABO_LOGIC_EXCEPTION("Cannot startReading before connected");
+            }
+
+            // All access to handler on strand, so post there - before any message can be routed here.
+            // Capture 'this' as well since weakThis is Broker, not InProcBroker.
+            m_handlerStrand->post([this, weakThis{weak_from_this()}, handler, errorNotifier]() {
+                if (auto self = weakThis.lock()) {
+                    this->m_readHandler = std::move(handler);
+                    this->m_errorNotifier = std::move(errorNotifier);
+                }
+            });
+            m_isReading = true;
+
+            std::unique_lock<std::shared_mutex> lock(m_hub->mutex);
+            Hub::add(m_hub->oneToOne[m_instanceId], this, weak_from_this());
+            if (m_consumeBroadcasts) {
+                Hub::add(m_hub->broadcasts, this, weak_from_this());
+            }
+        }
+
+
+        void InProcBroker::stopReading() {
+            if (!m_hub) return; // Not yet connected...
+            // Remove all routes to us, i.e. slots, broadcasts, heartbeats and any signals we have subscribed
+            m_hub->removeAll(this);
+            m_isReading = false;
+
+            // Post erasure of handlers on the handler strand, see startReading
+            m_handlerStrand->post([this, weakThis{weak_from_this()}]() {
+                if (auto self = weakThis.lock()) {
+                    this->m_readHandler = nullptr;
+                    this->m_errorNotifier = nullptr;
+                    std::lock_guard<std::mutex> lock(this->m_slotsForSignalsMutex);
+                    this->m_slotsForSignals.clear();
+                }
+            });
+        }
+
+
+        void InProcBroker::startReadingHeartbeats() {
+            // Not checking m_readHandler: waiting for m_handlerStrand would block if called from the read handler
+            if (!m_isReading || !m_hub) {
+                throw KARABO_LOGIC_EXCEPTION("Cannot startReadingHeartbeats before startReading");
+            }
+
+            std::unique_lock<std::shared_mutex> lock(m_hub->mutex);
+            Hub::add(m_hub->heartbeats, this, weak_from_this());
+        }
+
+    } // namespace net
+} // namespace karabo
@@ -0,0 +1,165 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_NET_INPROCBROKER_HH
+#define KARABO_NET_INPROCBROKER_HH
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "Broker.hh"
+#include "Strand.hh"
+#include "karabo/data/types/Hash.hh"
+
+namespace karabo {
+    namespace data {
+        class Schema;
+    }
+    namespace net {
+
+
+        /**
+         * @class InProcBroker
+         * @brief Broker that routes all messages within the process, i.e. without any broker server
+         *
+         * Selected by broker URLs with the "inproc" protocol, e.g. KARABO_BROKER=inproc://local.
+         * All InProcBroker instances with the same (first) URL and domain share an in-memory hub that
+         * plays the role of the AMQP exchanges:
+         *
+         *  - 1-to-1 messages go to the broker that reads for the receiverId - if several do, only to the one
+         *    that started reading first (as for AMQP where they would share a queue). Messages to unknown
+         *    receivers are dropped.
+         *  - Broadcasts go to all brokers that read and did not call setConsumeBroadcasts(false), including the
+         *    sender. Heartbeats go to those brokers that called startReadingHeartbeats().
+         *  - Signals go to all brokers that subscribed to them, for each of the slots they subscribed.
+         *
+         * Every receiving broker gets its own copy of header and body, as if they were serialised.
+         * Messages to a receiver are queued in its Strand, so the receiver's read handler sees the messages
+         * of any sender in the order they were sent, as for AMQP.
+         */
+        class InProcBroker : public Broker {
+           public:
+            KARABO_CLASSINFO(InProcBroker, "inproc", "1.0")
+
+            static void expectedParameters(karabo::data::Schema& s);
+
+            explicit InProcBroker(const karabo::data::Hash& configuration = karabo::data::Hash());
+
+            virtual ~InProcBroker();
+
+            Broker::Pointer clone(const std::string& instanceId) override;
+
+            /**
+             * Join the hub of the first broker URL and the domain - never fails
+             */
+            void connect() override;
+
+            void disconnect() override;
+
+            bool isConnected() const override;
+
+            std::string getBrokerUrl() const override;
+
+            std::string getBrokerType() const override {
+                return getClassInfo().getClassId();
+            }
+
+            boost::system::error_code subscribeToRemoteSignal(const std::string& slot,
+                                                              const std::string& signalInstanceId,
+                                                              const std::string& signalFunction) override;
+
+            boost::system::error_code unsubscribeFromRemoteSignal(const std::string& slot,
+                                                                  const std::string& signalInstanceId,
+                                                                  const std::string& signalFunction) override;
+
+            void subscribeToRemoteSignalAsync(const std::string& slot, const std::string& signalInstanceId,
+                                              const std::string& signalFunction,
+                                              const AsyncHandler& completionHandler) override;
+
+            void unsubscribeFromRemoteSignalAsync(const std::string& slot, const std::string& signalInstanceId,
+                                                  const std::string& signalFunction,
+                                                  const AsyncHandler& completionHandler) override;
+
+            /**
+             * Start reading 1-to-1 messages for this instance and, unless setConsumeBroadcasts(false) was called
+             * before, broadcasts other than heartbeats
+             *
+             * @param handler       - success handler
+             * @param errorNotifier - error handler, never called since messages are not deserialised
+             */
+            void startReading(const consumer::MessageHandler& handler,
+                              const consumer::ErrorNotifier& errorNotifier = consumer::ErrorNotifier()) override;
+
+            void stopReading() override;
+
+            /**
+             * Start reading heartbeats as well - must be called after startReading
+             */
+            void startReadingHeartbeats() override;
+
+            void sendSignal(const std::string& signal, const karabo::data::Hash::Pointer& header,
+                            const karabo::data::Hash::Pointer& body) override;
+
+            void sendBroadcast(const std::string& slot, const karabo::data::Hash::Pointer& header,
+                               const karabo::data::Hash::Pointer& body) override;
+
+            void sendOneToOne(const std::string& receiverId, const std::string& slot,
+                              const karabo::data::Hash::Pointer& header,
+                              const karabo::data::Hash::Pointer& body) override;
+
+           private:
+            struct Hub;
+
+            InProcBroker(const InProcBroker& o) = delete;
+            InProcBroker(const InProcBroker& o, const std::string& newInstanceId);
+
+            /**
+             * Hand a message over to this broker's read handler (via the strand)
+             *
+             * @param slot to call or, if isSignal, the signal key <senderId>.<signalName>
+             * @param isBroadcast passed to the read handler
+             * @param isSignal whether the message is a signal, i.e. goes to all slots subscribed for it
+             * @param header will be copied
+             * @param body will be copied
+             */
+            void deliver(const std::string& slot, bool isBroadcast, bool isSignal, const karabo::data::Hash& header,
+                         const karabo::data::Hash& body);
+
+            std::shared_ptr<Hub> m_hub;
+
+            karabo::net::Strand::Pointer m_handlerStrand;
+            karabo::net::consumer::MessageHandler m_readHandler;
+            karabo::net::consumer::ErrorNotifier m_errorNotifier;
+            /// Whether between startReading and stopReading - m_readHandler may only be touched in m_handlerStrand
+            std::atomic<bool> m_isReading;
+
+            /// Key is signal key (<instanceId>.<signalName>), value is set of slot names subscribed
+            /// Not confined to m_handlerStrand, so (un)subscribing does not wait for it, e.g. from the read handler.
+            std::map<std::string, std::set<std::string>> m_slotsForSignals;
+            std::mutex m_slotsForSignalsMutex;
+        };
+
+    } // namespace net
+} // namespace karabo
+
+
+#endif /* KARABO_NET_INPROCBROKER_HH */
@@ -25,7 +25,10 @@
 
 #include "Strand.hh"
 
+#include <chrono>
+#include <memory>
 #include <utility> // for std::move
+#include <vector>
 
 #include "EventLoop.hh"
 #include "karabo/data/schema/SimpleElement.hh"
@@ -51,6 +54,17 @@ namespace karabo {
                   .minInc(1u)
                   .commit();
 
+            UINT32_ELEMENT(expected)
+                  .key("maxTimeInARow")
+                  .description(
+                        "If 'maxInARow' is above 1, stop running handlers in a row once this time is exceeded and give "
+                        "control back to the event loop (0 means no time limit)")
+                  .unit(karabo::data::Unit::SECOND)
+                  .metricPrefix(karabo::data::MetricPrefix::MICRO)
+                  .assignmentOptional()
+                  .defaultValue(1000u)
+                  .commit();
+
             BOOL_ELEMENT(expected)
                   .key("guaranteeToRun")
                   .description(
@@ -69,8 +83,11 @@ namespace karabo {
 
         Strand::Strand(const karabo::data::Hash& cfg)
             : m_ioContext(&karabo::net::EventLoop::getIOService()),
-              m_tasksRunning(false),
+              m_head(&m_stub),
+              m_tail(&m_stub),
+              m_numTasks(0ul),
               m_maxInARow(cfg.get<unsigned int>("maxInARow")),
+              m_maxTimeInARow(cfg.has("maxTimeInARow") ? cfg.get<unsigned int>("maxTimeInARow") : 1000u),
               m_guaranteeToRun(cfg.get<bool>("guaranteeToRun")) {
             if (m_maxInARow == 0u) { // Cannot happen if created via Configurator<Strand>::create
                 // nevertheless silently convert to useful value
@@ -79,25 +96,27 @@ namespace karabo {
         }
 
         Strand::~Strand() {
-            if (m_guaranteeToRun) {
-                // We are being destructed, so there is no shared pointer left pointing to us.
-                // ==> No need for mutex protection.
-                if (!m_tasks.empty()) {
-                    auto runTasks = [tasks{std::move(m_tasks)}]() mutable { // mutable to be able to modify 'tasks'
-                        while (!tasks.empty()) {
-                            try {
-                                tasks.front()();
-                            } catch (const std::exception& e) {
-                                KARABO_LOG_FRAMEWORK_ERROR << "Caught exception in method posted from destructor: "
-                                                           << e.what();
-                            }
-                            tasks.pop();
+            // We are being destructed, so there is no shared pointer left pointing to us, i.e. nobody can enqueue
+            // and run() is not running (it is bound weakly).
+            // ==> We are the single consumer, and no producer is in the middle of an enqueue.
+            std::vector<std::unique_ptr<TaskNode>> tasks;
+            while (TaskNode* task = dequeue()) {
+                tasks.emplace_back(task);
+            }
+            if (m_guaranteeToRun && !tasks.empty()) {
+                auto runTasks = [tasks{std::move(tasks)}]() {
+                    for (const std::unique_ptr<TaskNode>& task : tasks) {
+                        try {
+                            task->run();
+                        } catch (const std::exception& e) {
+                            KARABO_LOG_FRAMEWORK_ERROR << "Caught exception in method posted from destructor: "
+                                                       << e.what();
                         }
-                    };
-                    // Do not block the destructor and also ensure that tasks run in a thread of the given io_context
-                    // (destructor might be called in a 'foreign' thread)
-                    boost::asio::post(*m_ioContext, runTasks);
-                }
+                    }
+                };
+                // Do not block the destructor and also ensure that tasks run in a thread of the given io_context
+                // (destructor might be called in a 'foreign' thread)
+                boost::asio::post(*m_ioContext, std::move(runTasks));
             }
         }
 
@@ -106,18 +125,12 @@ namespace karabo {
         }
 
         void Strand::post(const std::function<void()>& handler) {
-            std::lock_guard<std::mutex> lock(m_tasksMutex);
-            m_tasks.push(handler);
-
-            startRunningIfNeeded(); // needs mutex to be locked!
+            enqueue(new Task<std::function<void()>>(handler));
         }
 
 
         void Strand::post(std::function<void()>&& handler) {
-            std::lock_guard<std::mutex> lock(m_tasksMutex);
-            m_tasks.push(std::move(handler)); // actually forward the rvalue-ness
-
-            startRunningIfNeeded(); // needs mutex to be locked!
+            enqueue(new Task<std::function<void()>>(std::move(handler))); // actually forward the rvalue-ness
         }
 
 
@@ -126,10 +139,14 @@ namespace karabo {
         }
 
 
-        void Strand::startRunningIfNeeded() {
-            // We rely on being called under protection of m_tasksMutex
-            if (!m_tasksRunning) {
-                m_tasksRunning = true;
+        void Strand::enqueue(TaskNode* task) {
+            // Count before the task is reachable by run(): Otherwise run() could take it before it is counted and
+            // m_numTasks could drop to zero (and a second run() be posted) while the first run() is still active.
+            const size_t numBefore = m_numTasks.fetch_add(1ul, std::memory_order_acq_rel);
+            push(task);
+
+            if (numBefore == 0ul) {
+                // Nothing was running, so start.
                 // Instead of bind_weak to 'this' we could std::bind to 'shared_from_this()'.
                 // The difference would only be that in the latter 'run' (and thus the tasks to be executed
                 // sequentially) would be executed even if all other shared pointers to it are reset between
@@ -139,34 +156,70 @@ namespace karabo {
         }
 
 
+        void Strand::push(TaskNode* node) {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            TaskNode* previous = m_head.exchange(node, std::memory_order_acq_rel);
+            // Between the exchange and this store the consumer cannot reach 'node' yet - dequeue handles that
+            previous->next.store(node, std::memory_order_release);
+        }
+
+
+        Strand::TaskNode* Strand::dequeue() {
+            TaskNode* tail = m_tail;
+            TaskNode* next = tail->next.load(std::memory_order_acquire);
+            if (tail == &m_stub) {
+                if (!next) return nullptr; // empty
+                // Skip the stub
+                m_tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+            if (next) {
+                m_tail = next;
+                return tail;
+            }
+            // 'tail' is the last linked node - but is it the last one enqueued?
+            if (tail != m_head.load(std::memory_order_acquire)) {
+                return nullptr; // a producer has exchanged m_head, but not yet linked its node
+            }
+            // Put the stub behind 'tail' to be able to take 'tail' out
+            push(&m_stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next) {
+                m_tail = next;
+                return tail;
+            }
+            return nullptr;
+        }
+
+
         void Strand::run() {
-            std::function<void()> nextTask;
-            unsigned int counter = 0;
-            while (++counter <= m_maxInARow) {
-                {
-                    std::lock_guard<std::mutex> lock(m_tasksMutex);
-                    if (m_tasks.empty()) {
-                        m_tasksRunning = false;
-                        // Nothing else to do, so stop running
-                        return;
-                    } else {
-                        // Get oldest handler - move it to avoid a copy:
-                        nextTask = std::move(m_tasks.front());
-                        // Removes the object from queue (it is in undefined state after std::move):
-                        m_tasks.pop();
-                    }
+            const bool timeLimited = (m_maxInARow > 1u && m_maxTimeInARow > 0u);
+            const auto start = (timeLimited ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point());
+            size_t numDone = 0ul;
+            while (numDone < m_maxInARow) {
+                std::unique_ptr<TaskNode> task(dequeue());
+                if (!task) {
+                    // Either all done or a producer is in the middle of push - m_numTasks tells
+                    break;
                 }
-                // Actually run the task without lock
+                ++numDone;
                 // Catch exceptions, otherwise this Strand would completely stop functioning:
-                // run not posted anymore, but m_tasksRunning still true.
+                // run not posted anymore, but m_numTasks not zero.
                 try {
-                    nextTask();
+                    task->run();
                 } catch (const std::exception& e) {
                     KARABO_LOG_FRAMEWORK_ERROR << "Caught exception in posted method: " << e.what();
                 }
+                if (timeLimited &&
+                    std::chrono::steady_clock::now() - start >= std::chrono::microseconds(m_maxTimeInARow)) {
+                    break;
+                }
+            }
+            if (m_numTasks.fetch_sub(numDone, std::memory_order_acq_rel) != numDone) {
+                // More tasks enqueued: Repost to eventually run next task - see comment in enqueue about bind_weak.
+                boost::asio::post(*m_ioContext, karabo::util::bind_weak(&Strand::run, this));
             }
-            // Repost to eventually run next task - see comment in startRunningIfNeeded about use of bind_weak.
-            boost::asio::post(*m_ioContext, karabo::util::bind_weak(&Strand::run, this));
         }
 
 
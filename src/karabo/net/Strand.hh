@@ -23,10 +23,10 @@
  *
  */
 
+#include <atomic>
 #include <boost/asio/io_context.hpp>
 #include <functional>
-#include <mutex>
-#include <queue>
+#include <type_traits>
 
 #include "karabo/data/types/ClassInfo.hh"
 #include "karabo/data/types/Hash.hh"
@@ -50,9 +50,11 @@ namespace karabo {
          * - has a more restrictive wrap:  would be useful to support more, but a proper implementation would also
          *                                 need dispatch
          *
-         * Every handler posted will be put into a FIFO queue and the FIFO will be emptied in the background
+         * Every handler posted will be put into a lock-free FIFO queue and the FIFO will be emptied in the background
          * by posting the handlers to the given boost::asio::io_context (either from net::EventLoop, passed in
-         * constructor, or defined by setContext(..)).
+         * constructor, or defined by setContext(..)). To move a Strand off the central io_context of a sharded
+         * event loop, pass or set net::EventLoop::getShardIOService(). Do that only if the handlers do not block
+         * waiting for other work on the same shard.
          *
          * NOTE:
          * Do not create a Strand on the stack, but do it on the heap using the Configurator:
@@ -126,6 +128,20 @@ namespace karabo {
              */
             void post(std::function<void()>&& handler);
 
+            /**
+             * Post a handler to the io_context with the guarantee that it is not executed before any other handler
+             * posted before has finished.
+             *
+             * Same as the std::function overloads, but the handler (e.g. a lambda) is stored directly in the
+             * queue, avoiding the allocation a std::function may need.
+             *
+             * @param handler callable without arguments - will be moved if an r-value, copied otherwise
+             */
+            template <class Handler>
+            void post(Handler&& handler) {
+                enqueue(new Task<std::decay_t<Handler>>(std::forward<Handler>(handler)));
+            }
+
             /**
              * This function is used to create a new handler function object that, when invoked,
              * will pass the wrapped handler to the Strand's post function (instead of using dispatch
@@ -159,21 +175,54 @@ namespace karabo {
             }
 
            private:
-            /// Helper for post - to be called under protection of m_tasksMutex!
-            void startRunningIfNeeded();
+            /// Node of the task queue, the handler is stored in the node of derived type Task
+            struct TaskNode {
+                std::atomic<TaskNode*> next{nullptr};
+
+                virtual ~TaskNode() = default;
+                virtual void run() {}
+            };
+
+            template <class Handler>
+            struct Task : public TaskNode {
+                template <class H>
+                explicit Task(H&& h) : handler(std::forward<H>(h)) {}
+
+                void run() override {
+                    handler();
+                }
+
+                Handler handler;
+            };
+
+            /// Append task to the queue and start running if needed - any thread
+            void enqueue(TaskNode* task);
+
+            /// Link node at the head of the queue - any thread
+            void push(TaskNode* node);
+
+            /// Take oldest task from the queue, nullptr if none (or if a producer has not finished its enqueue yet).
+            /// Only to be called by the single consumer, i.e. in run() or in the destructor.
+            TaskNode* dequeue();
 
-            /// Helper to run one task after another until tasks queue is empty
+            /// Helper to run one task after another until tasks queue is empty (or maximum per run reached)
             void run();
 
             void postWrapped(std::function<void()> handler);
 
             boost::asio::io_context* m_ioContext; // pointer to be able to re-assign it
 
-            std::mutex m_tasksMutex; // to protect both, m_tasksRunning and m_tasks
-            bool m_tasksRunning;
-            std::queue<std::function<void()> > m_tasks;
+            // Intrusive multi producer, single consumer queue (D. Vyukov): Producers exchange m_head, the consumer
+            // follows the 'next' pointers from m_tail. m_stub keeps the queue non-empty.
+            std::atomic<TaskNode*> m_head;
+            TaskNode* m_tail;
+            TaskNode m_stub;
+            // Number of tasks enqueued but not yet run - run() is posted when that leaves 0 and reposts itself
+            // as long as it does not drop to 0
+            std::atomic<size_t> m_numTasks;
 
             unsigned int m_maxInARow;
+            const unsigned int m_maxTimeInARow; // microseconds
             const bool m_guaranteeToRun;
         };
 
@@ -18,6 +18,7 @@
 #include "TcpChannel.hh"
 
 #include <assert.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h> // Linux...
 
 #include <boost/algorithm/string.hpp>
@@ -34,6 +35,7 @@
 #include "Channel.hh"
 #include "EventLoop.hh"
 #include "karabo/data/io/HashBinarySerializer.hh"
+#include "karabo/data/types/BufferPool.hh"
 #include "karabo/data/types/Hash.hh"
 
 using std::placeholders::_1;
@@ -48,6 +50,14 @@ namespace karabo {
         using namespace karabo::util;
 
         const size_t kDefaultQueueCapacity = 5000; // JW: Moved from Queue.h
+        // Alignment of each bulk data buffer inside a pooled receive slab (cache line, good for SIMD loads)
+        const size_t kSlabAlignment = 64;
+
+        namespace {
+            size_t alignSlabOffset(size_t offset) {
+                return (offset + kSlabAlignment - 1) & ~(kSlabAlignment - 1);
+            }
+        } // namespace
 
 
         karabo::data::Hash TcpChannel::getChannelInfo(const std::shared_ptr<karabo::net::TcpChannel>& tcpChannel) {
@@ -63,8 +73,9 @@ namespace karabo {
               m_sizeofLength(connection->getSizeofLength()),
               m_lengthIsText(connection->lengthIsText()),
               m_manageAsyncData(connection->m_manageAsyncData),
+              m_pooledReceive(connection->m_pooledReceive),
               m_keepAliveSettings(connection->m_keepAliveSettings),
-              m_socket(EventLoop::getIOService()),
+              m_socket(EventLoop::getShardIOService()),
               m_activeHandler(TcpChannel::NONE),
               m_readHeaderFirst(false),
               m_inboundData(new std::vector<char>()),
@@ -609,10 +620,10 @@ namespace karabo {
                         this->prepareHashFromHeader(*m_inHashHeader);
                         if (m_inHashHeader->has("_bufferSetLayout_")) {
                             // This protocol for karabo 2.2.4 and later : c++ and bound python
-                            std::vector<karabo::data::BufferSet::Pointer> buffers;
-
-                            for (const karabo::data::Hash& layout :
-                                 m_inHashHeader->get<std::vector<karabo::data::Hash>>("_bufferSetLayout_")) {
+                            const auto& layouts =
+                                  m_inHashHeader->get<std::vector<karabo::data::Hash>>("_bufferSetLayout_");
+                            size_t slabSize = 0;
+                            for (const karabo::data::Hash& layout : layouts) {
                                 if (!layout.has("sizes") || !layout.has("types")) {
                                     throw KARABO_LOGIC_EXCEPTION("Pipeline Protocol violation!");
                                 }
@@ -621,8 +632,38 @@ namespace karabo {
                                 if (sizes.size() != types.size()) {
                                     throw KARABO_LOGIC_EXCEPTION("Pipeline Protocol violation!");
                                 }
+                                if (m_pooledReceive) {
+                                    for (size_t ii = 0; ii < sizes.size(); ii++) {
+                                        if (types[ii] == karabo::data::BufferSet::NO_COPY_BYTEARRAY_CONTENTS) {
+                                            slabSize = alignSlabOffset(slabSize) + sizes[ii];
+                                        }
+                                    }
+                                }
+                            }
+                            // In pooled mode, all bulk data is read into slices of one uninitialised pool buffer
+                            // instead of allocating a buffer for each of them. Each slice starts at an offset aligned
+                            // to kSlabAlignment, so NDArray data is as aligned as if it had its own buffer.
+                            std::shared_ptr<char> slab;
+                            if (slabSize > 0) slab = karabo::data::BufferPool::allocate(slabSize);
+                            size_t slabOffset = 0;
+
+                            std::vector<karabo::data::BufferSet::Pointer> buffers;
+                            buffers.reserve(layouts.size());
+                            for (const karabo::data::Hash& layout : layouts) {
+                                const auto& sizes = layout.get<vector<unsigned int>>("sizes");
+                                const auto& types = layout.get<vector<int>>("types");
                                 karabo::data::BufferSet::Pointer buffer(new karabo::data::BufferSet(false));
-                                for (size_t ii = 0; ii < sizes.size(); ii++) buffer->add(sizes[ii], types[ii]);
+                                for (size_t ii = 0; ii < sizes.size(); ii++) {
+                                    if (slab && types[ii] == karabo::data::BufferSet::NO_COPY_BYTEARRAY_CONTENTS) {
+                                        slabOffset = alignSlabOffset(slabOffset);
+                                        // Aliasing constructor: the slice keeps the whole slab alive
+                                        buffer->add(std::make_pair(std::shared_ptr<char>(slab, slab.get() + slabOffset),
+                                                                   static_cast<size_t>(sizes[ii])));
+                                        slabOffset += sizes[ii];
+                                    } else {
+                                        buffer->add(sizes[ii], types[ii]);
+                                    }
+                                }
                                 buffers.push_back(buffer);
                             }
                             this->readAsyncVectorBufferSetPointerImpl(
@@ -1376,6 +1417,19 @@ namespace karabo {
         }
 
 
+        unsigned int TcpChannel::roundTripTime() {
+            std::lock_guard<std::mutex> lock(m_socketMutex);
+            if (!m_socket.is_open()) return 0u;
+            // Linux only, as the keep-alive settings
+            struct tcp_info info;
+            socklen_t len = sizeof(info);
+            if (getsockopt(m_socket.native_handle(), SOL_TCP, TCP_INFO, &info, &len)) {
+                return 0u;
+            }
+            return info.tcpi_rtt;
+        }
+
+
         void TcpChannel::close() {
             std::lock_guard<std::mutex> lock(m_socketMutex);
             if (m_socket.is_open()) m_socket.cancel();
@@ -1458,7 +1512,7 @@ namespace karabo {
 
             if (!m_writeInProgress) {
                 m_writeInProgress = true;
-                boost::asio::post(EventLoop::getIOService(), bind_weak(&TcpChannel::doWrite, this));
+                boost::asio::post(m_socket.get_executor(), bind_weak(&TcpChannel::doWrite, this));
             }
         }
 
@@ -62,6 +62,7 @@ namespace karabo {
             const size_t m_sizeofLength;
             const bool m_lengthIsText;
             const bool m_manageAsyncData;
+            const bool m_pooledReceive;
             karabo::data::Hash m_keepAliveSettings;
             mutable std::mutex m_socketMutex;
             boost::asio::ip::tcp::socket m_socket;
@@ -312,6 +313,8 @@ namespace karabo {
 
             virtual size_t dataQuantityWritten();
 
+            unsigned int roundTripTime() override;
+
             virtual void close();
 
             virtual bool isOpen();
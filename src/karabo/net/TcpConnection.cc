@@ -119,6 +119,20 @@ namespace karabo {
                   .expertAccess()
                   .commit();
 
+            BOOL_ELEMENT(expected)
+                  .key("pooledReceive")
+                  .displayedName("Pooled Receive")
+                  .description(
+                        "If set to true, the bulk data (e.g. NDArray contents) of each message received as vector of "
+                        "BufferSets is read into a single uninitialised buffer. The BufferSets point into that "
+                        "buffer, which goes back to the BufferPool (if enabled by the server's 'bufferPoolSize') "
+                        "once all data is released.")
+                  .assignmentOptional()
+                  .defaultValue(false)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
             NODE_ELEMENT(expected).key("keepalive").displayedName("Tcp Keep Alive").expertAccess().commit();
 
             BOOL_ELEMENT(expected)
@@ -184,6 +198,7 @@ namespace karabo {
             input.get("sizeofLength", m_sizeofLength);
             input.get("messageTagIsText", m_lengthIsTextFlag);
             input.get("manageAsyncData", m_manageAsyncData);
+            input.get("pooledReceive", m_pooledReceive);
         }
 
 
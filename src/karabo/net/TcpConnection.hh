@@ -118,6 +118,7 @@ namespace karabo {
             unsigned int m_sizeofLength;
             bool m_lengthIsTextFlag;
             bool m_manageAsyncData;
+            bool m_pooledReceive;
             const karabo::data::Hash m_keepAliveSettings;
         };
     } // namespace net
@@ -0,0 +1,210 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TimerWheel.hh"
+
+#include <algorithm>
+#include <boost/asio/post.hpp>
+
+#include "karabo/data/types/Exception.hh"
+#include "karabo/util/MetaTools.hh" // for bind_weak
+
+namespace karabo {
+    namespace net {
+
+        TimerWheel::TimerWheel(boost::asio::io_context& ioContext, std::chrono::milliseconds tick, size_t numBuckets)
+            : m_tick(tick),
+              m_numBuckets(numBuckets),
+              m_timer(ioContext),
+              m_timerRunning(false),
+              m_armedTick(0ull),
+              m_generation(0ull),
+              m_startTime(std::chrono::steady_clock::now()),
+              m_currentTick(0ull),
+              m_lastId(0ull),
+              m_levelSizes{} {
+            if (m_tick.count() <= 0 || numBuckets < 2) {
+                throw KARABO_PARAMETER_EXCEPTION("TimerWheel needs positive tick and at least two buckets");
+            }
+            for (std::vector<std::vector<Id>>& level : m_levels) {
+                level.resize(numBuckets);
+            }
+        }
+
+
+        TimerWheel::~TimerWheel() {
+            m_timer.cancel();
+        }
+
+
+        TimerWheel::Id TimerWheel::schedule(std::chrono::milliseconds delay, std::function<void()> handler) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto now = std::chrono::steady_clock::now();
+            if (!m_timerRunning) {
+                // Keep tick counting continuous, but let the current tick end now
+                m_startTime = now - m_currentTick * m_tick;
+            }
+            // Tick n is processed at m_startTime + n * m_tick - round up to never call the handler too early
+            const auto dueTime = (now - m_startTime) + std::max(delay, std::chrono::milliseconds(0));
+            unsigned long long dueTick = (dueTime + m_tick - std::chrono::nanoseconds(1)) / m_tick;
+            dueTick = std::max(dueTick, m_currentTick + 1ull);
+
+            const Id id = ++m_lastId;
+            m_entries.emplace(id, Entry{dueTick, std::move(handler)});
+            const unsigned long long processTick = insert(id, dueTick);
+            if (!m_timerRunning) {
+                startTimer();
+            } else if (processTick < m_armedTick) {
+                armTimer(processTick);
+            }
+            return id;
+        }
+
+
+        bool TimerWheel::cancel(Id id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Id stays in its bucket until that is processed
+            return (m_entries.erase(id) > 0);
+        }
+
+
+        size_t TimerWheel::size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_entries.size();
+        }
+
+
+        unsigned long long TimerWheel::insert(Id id, unsigned long long dueTick) {
+            // Find the lowest level whose turn covers the due tick, i.e. level l if
+            // delta < numBuckets^(l+1), where one bucket of level l spans numBuckets^l ticks
+            const unsigned long long delta = dueTick - m_currentTick; // always > 0
+            size_t level = 0;
+            unsigned long long span = 1ull;
+            while (level + 1 < numLevels && delta >= span * m_numBuckets) {
+                span *= m_numBuckets;
+                ++level;
+            }
+            // Beyond the top level: park in its farthest bucket, the id is re-inserted when that gets cascaded
+            const unsigned long long tick = std::min(dueTick, m_currentTick + span * (m_numBuckets - 1ull));
+            m_levels[level][(tick / span) % m_numBuckets].push_back(id);
+            ++m_levelSizes[level];
+            return (tick / span) * span; // first tick covered by the bucket, i.e. when it is processed
+        }
+
+
+        void TimerWheel::processNextTick(std::vector<std::function<void()>>& dueHandlers) {
+            const unsigned long long tick = ++m_currentTick;
+
+            // Cascade from top to bottom: entries move down at most one level per cascade,
+            // but a bucket of level l is due exactly when one of level l - 1 starts
+            unsigned long long span = 1ull;
+            for (size_t level = 1; level < numLevels; ++level) span *= m_numBuckets;
+            for (size_t level = numLevels - 1; level > 0; --level, span /= m_numBuckets) {
+                if (tick % span != 0ull || m_levelSizes[level] == 0ul) continue;
+                std::vector<Id> bucket;
+                bucket.swap(m_levels[level][(tick / span) % m_numBuckets]);
+                m_levelSizes[level] -= bucket.size();
+                for (const Id id : bucket) {
+                    auto it = m_entries.find(id);
+                    if (it == m_entries.end()) continue; // cancelled
+                    if (it->second.dueTick <= tick) {
+                        // A due tick that is a multiple of the span cannot go down further
+                        dueHandlers.push_back(std::move(it->second.handler));
+                        m_entries.erase(it);
+                    } else {
+                        insert(id, it->second.dueTick);
+                    }
+                }
+            }
+
+            std::vector<Id>& bucket = m_levels[0][tick % m_numBuckets];
+            if (bucket.empty()) return;
+            m_levelSizes[0] -= bucket.size();
+            for (const Id id : bucket) {
+                auto it = m_entries.find(id);
+                if (it == m_entries.end()) continue; // cancelled
+                dueHandlers.push_back(std::move(it->second.handler));
+                m_entries.erase(it);
+            }
+            bucket.clear();
+        }
+
+
+        void TimerWheel::startTimer() {
+            // Wake up for the next non-empty bucket of level 0 or, if higher levels have ids, the next cascade.
+            // Within one turn of level 0 there is always one of these.
+            const bool mayCascade = std::any_of(m_levelSizes + 1, m_levelSizes + numLevels,
+                                                [](size_t levelSize) { return levelSize > 0ul; });
+            unsigned long long tick = m_currentTick + 1ull;
+            for (; tick < m_currentTick + m_numBuckets; ++tick) {
+                if ((mayCascade && tick % m_numBuckets == 0ull) || !m_levels[0][tick % m_numBuckets].empty()) {
+                    break;
+                }
+            }
+            armTimer(tick);
+        }
+
+
+        void TimerWheel::armTimer(unsigned long long tick) {
+            // Requires m_mutex to be locked
+            m_timerRunning = true;
+            m_armedTick = tick;
+            // If re-armed, the callback for the previous expiry may already be on its way - it will be ignored
+            // because of its outdated generation
+            m_timer.expires_at(m_startTime + tick * m_tick);
+            m_timer.async_wait(util::bind_weak(&TimerWheel::onTick, this, std::placeholders::_1, ++m_generation));
+        }
+
+
+        void TimerWheel::onTick(const boost::system::error_code& ec, unsigned long long generation) {
+            if (ec) return;
+
+            std::vector<std::function<void()>> dueHandlers;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (generation != m_generation) return;
+
+                // The timer never expires early. If the event loop was late, catch up tick by tick - ticks are
+                // cheap if their buckets are empty and ticks are not needed at all if there is nothing left.
+                const unsigned long long nowTick =
+                      std::max<unsigned long long>((std::chrono::steady_clock::now() - m_startTime) / m_tick,
+                                                   m_armedTick);
+                while (m_currentTick < nowTick && !m_entries.empty()) {
+                    processNextTick(dueHandlers);
+                }
+                if (m_entries.empty()) {
+                    // Drop remaining ids of cancelled entries - they would otherwise be processed after the next start
+                    for (size_t level = 0; level < numLevels; ++level) {
+                        if (m_levelSizes[level] == 0ul) continue;
+                        for (std::vector<Id>& bucket : m_levels[level]) bucket.clear();
+                        m_levelSizes[level] = 0ul;
+                    }
+                    m_currentTick = nowTick;
+                    m_timerRunning = false;
+                } else {
+                    startTimer();
+                }
+            }
+
+            // Post outside the lock and in order
+            for (std::function<void()>& handler : dueHandlers) {
+                boost::asio::post(m_timer.get_executor(), std::move(handler));
+            }
+        }
+    } // namespace net
+} // namespace karabo
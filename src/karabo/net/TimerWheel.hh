@@ -0,0 +1,152 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_NET_TIMERWHEEL_HH
+#define KARABO_NET_TIMERWHEEL_HH
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "karabo/data/types/ClassInfo.hh"
+
+namespace karabo {
+    namespace net {
+
+        /**
+         * @class TimerWheel
+         * @brief Many timeouts with a single asio timer
+         *
+         * A hierarchical hashed timing wheel: Level 0 is a ring of buckets of one tick each, each higher level is a
+         * ring of buckets that span a full turn of the level below. A handler is put into the lowest level whose
+         * turn covers its due time. When the wheel reaches a bucket of a higher level, its handlers are moved
+         * down ("cascaded") to the level below, so each handler is touched at most once per level.
+         * Scheduling and cancelling are O(1), so the wheel is meant for many timeouts of which most are cancelled
+         * before they expire (e.g. request timeouts).
+         *
+         * A single steady_timer runs while handlers are scheduled. It only wakes up for ticks with a non-empty
+         * level 0 bucket or when a higher level bucket has to be cascaded.
+         * Due handlers are posted to the io_context, at most one tick later than requested. Handlers due in the
+         * same tick are posted in the order they were scheduled.
+         *
+         * NOTE:
+         * Create the TimerWheel on the heap as a shared_ptr: The internal timer is bound weakly to the wheel.
+         */
+        class TimerWheel : public std::enable_shared_from_this<TimerWheel> {
+           public:
+            KARABO_CLASSINFO(TimerWheel, "TimerWheel", "1.0")
+
+            /// Identifies a scheduled handler, never 0
+            typedef unsigned long long Id;
+
+            /// Number of levels: with 512 buckets per level, the wheel covers 512^4 ticks
+            static constexpr size_t numLevels = 4;
+
+            /**
+             * Construct a TimerWheel
+             *
+             * @param ioContext the context on which handlers are called
+             * @param tick granularity of the wheel
+             * @param numBuckets number of buckets per level, i.e. tick * numBuckets is the duration of one turn of
+             *                   level 0 (at least 2)
+             */
+            explicit TimerWheel(boost::asio::io_context& ioContext,
+                                std::chrono::milliseconds tick = std::chrono::milliseconds(10),
+                                size_t numBuckets = 512);
+
+            TimerWheel(const TimerWheel&) = delete;
+            TimerWheel& operator=(const TimerWheel&) = delete;
+
+            virtual ~TimerWheel();
+
+            /**
+             * Schedule a handler to be called after the given delay.
+             *
+             * @param delay time until handler is called, rounded up to full ticks
+             * @param handler a function without arguments
+             * @return id needed to cancel the handler
+             */
+            Id schedule(std::chrono::milliseconds delay, std::function<void()> handler);
+
+            /**
+             * Cancel a scheduled handler.
+             *
+             * @param id as returned by schedule
+             * @return true if the handler was cancelled, false if it is already posted (or unknown)
+             */
+            bool cancel(Id id);
+
+            /**
+             * Number of handlers scheduled but not yet posted or cancelled
+             */
+            size_t size() const;
+
+           private:
+            /**
+             * Put id into the bucket where it has to go for its due tick.
+             * Returns the tick at which that bucket is processed.
+             * Requires m_mutex to be locked.
+             */
+            unsigned long long insert(Id id, unsigned long long dueTick);
+
+            /**
+             * Advance m_currentTick by one: cascade higher level buckets and collect the due handlers.
+             * Requires m_mutex to be locked.
+             */
+            void processNextTick(std::vector<std::function<void()>>& dueHandlers);
+
+            /**
+             * (Re-)start the timer for the next tick at which there is something to do.
+             * Requires m_mutex to be locked.
+             */
+            void startTimer();
+
+            void armTimer(unsigned long long tick);
+
+            void onTick(const boost::system::error_code& ec, unsigned long long generation);
+
+            struct Entry {
+                unsigned long long dueTick;
+                std::function<void()> handler;
+            };
+
+            const std::chrono::milliseconds m_tick;
+            const size_t m_numBuckets;
+            boost::asio::steady_timer m_timer;
+
+            mutable std::mutex m_mutex;
+            bool m_timerRunning;
+            unsigned long long m_armedTick;  // tick the timer is armed for if m_timerRunning
+            unsigned long long m_generation; // to identify outdated timer callbacks after re-arming
+            std::chrono::steady_clock::time_point m_startTime; // time of m_currentTick == 0
+            unsigned long long m_currentTick;                  // all buckets up to this tick are processed
+            Id m_lastId;
+            // Buckets may contain ids of cancelled entries, skipped when processed
+            std::vector<std::vector<Id>> m_levels[numLevels];
+            size_t m_levelSizes[numLevels]; // number of ids in the buckets of each level
+            std::unordered_map<Id, Entry> m_entries;
+        };
+    } // namespace net
+} // namespace karabo
+
+#endif /* KARABO_NET_TIMERWHEEL_HH */
@@ -0,0 +1,91 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TimeReference_Test.hh"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "karabo/core/TimeReference.hh"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimeReference_Test);
+
+using karabo::core::TimeReference;
+
+
+TimeReference_Test::TimeReference_Test() {}
+
+
+TimeReference_Test::~TimeReference_Test() {}
+
+
+void TimeReference_Test::testSetGet() {
+    TimeReference ref;
+    TimeReference::Snapshot snap = ref.get();
+    CPPUNIT_ASSERT_EQUAL(0ull, snap.id);
+    CPPUNIT_ASSERT_EQUAL(0ull, snap.sec);
+    CPPUNIT_ASSERT_EQUAL(0ull, snap.frac);
+    CPPUNIT_ASSERT_EQUAL(0ull, snap.period); // i.e. no time information yet
+
+    ref.set(1000ull, 1559600000ull, 123456789ull, 100000ull);
+    snap = ref.get();
+    CPPUNIT_ASSERT_EQUAL(1000ull, snap.id);
+    CPPUNIT_ASSERT_EQUAL(1559600000ull, snap.sec);
+    CPPUNIT_ASSERT_EQUAL(123456789ull, snap.frac);
+    CPPUNIT_ASSERT_EQUAL(100000ull, snap.period);
+}
+
+
+void TimeReference_Test::testConcurrentAccess() {
+    // Writers set values that are related to each other, readers must never see a mix of two updates
+    TimeReference ref;
+    ref.set(1ull, 2ull, 3ull, 4ull);
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned int> numBad(0u);
+    std::atomic<unsigned long long> numReads(0ull);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&ref, &stop, &numBad, &numReads]() {
+            while (!stop) {
+                const TimeReference::Snapshot snap = ref.get();
+                if (snap.sec != 2ull * snap.id || snap.frac != 3ull * snap.id || snap.period != 4ull * snap.id) {
+                    ++numBad;
+                }
+                ++numReads;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (unsigned long long w = 0; w < 2ull; ++w) {
+        writers.emplace_back([&ref, w]() {
+            for (unsigned long long id = 1ull + w; id < 200000ull; id += 2ull) {
+                ref.set(id, 2ull * id, 3ull * id, 4ull * id);
+            }
+        });
+    }
+    for (std::thread& t : writers) t.join();
+    stop = true;
+    for (std::thread& t : readers) t.join();
+
+    CPPUNIT_ASSERT_EQUAL(0u, numBad.load());
+    CPPUNIT_ASSERT(numReads > 0ull);
+    const TimeReference::Snapshot snap = ref.get();
+    CPPUNIT_ASSERT(snap.id >= 199998ull);
+}
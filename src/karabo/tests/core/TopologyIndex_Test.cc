@@ -0,0 +1,108 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TopologyIndex_Test.hh"
+
+#include <string>
+#include <vector>
+
+#include "karabo/core/TopologyIndex.hh"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TopologyIndex_Test);
+
+using karabo::core::TopologyIndex;
+using karabo::data::Hash;
+using std::string;
+using std::vector;
+
+
+namespace {
+    Hash::Attributes info(const string& serverId, const string& classId, const string& host) {
+        Hash::Attributes attrs;
+        attrs.set("serverId", serverId);
+        if (!classId.empty()) attrs.set("classId", classId);
+        attrs.set("host", host);
+        attrs.set("heartbeatInterval", 20); // not a string, ignored
+        return attrs;
+    }
+} // namespace
+
+
+TopologyIndex_Test::TopologyIndex_Test() {}
+
+
+TopologyIndex_Test::~TopologyIndex_Test() {}
+
+
+void TopologyIndex_Test::testInsertErase() {
+    TopologyIndex index;
+    CPPUNIT_ASSERT_EQUAL(0ul, index.size());
+    CPPUNIT_ASSERT_EQUAL(0ull, index.getVersion());
+    CPPUNIT_ASSERT_EQUAL(string(), index.getType("dev1"));
+
+    index.insert("server1", "server", info("server1", "", "hostA"));
+    index.insert("dev2", "device", info("server1", "MotorClass", "hostA"));
+    index.insert("dev1", "device", info("server1", "CameraClass", "hostA"));
+    index.insert("dev3", "device", info("server2", "MotorClass", "hostB"));
+    CPPUNIT_ASSERT_EQUAL(4ul, index.size());
+    CPPUNIT_ASSERT_EQUAL(4ull, index.getVersion());
+
+    CPPUNIT_ASSERT_EQUAL(string("server"), index.getType("server1"));
+    CPPUNIT_ASSERT_EQUAL(string("device"), index.getType("dev1"));
+    CPPUNIT_ASSERT(index.getByType("server") == vector<string>({"server1"}));
+    CPPUNIT_ASSERT(index.getByType("device") == vector<string>({"dev1", "dev2", "dev3"}));
+    CPPUNIT_ASSERT(index.getByType("client").empty());
+    CPPUNIT_ASSERT(index.getByServer("server1") == vector<string>({"dev1", "dev2", "server1"}));
+    CPPUNIT_ASSERT(index.getByClass("MotorClass") == vector<string>({"dev2", "dev3"}));
+    CPPUNIT_ASSERT(index.getByClass("").empty()); // missing attributes are not indexed
+    CPPUNIT_ASSERT(index.getByHost("hostB") == vector<string>({"dev3"}));
+
+    CPPUNIT_ASSERT(index.erase("dev2"));
+    CPPUNIT_ASSERT(!index.erase("dev2"));
+    CPPUNIT_ASSERT_EQUAL(5ull, index.getVersion()); // failed erase does not count
+    CPPUNIT_ASSERT_EQUAL(string(), index.getType("dev2"));
+    CPPUNIT_ASSERT(index.getByServer("server1") == vector<string>({"dev1", "server1"}));
+    CPPUNIT_ASSERT(index.getByClass("MotorClass") == vector<string>({"dev3"}));
+
+    index.clear();
+    CPPUNIT_ASSERT_EQUAL(0ul, index.size());
+    CPPUNIT_ASSERT_EQUAL(6ull, index.getVersion());
+    CPPUNIT_ASSERT(index.getByType("device").empty());
+    CPPUNIT_ASSERT(index.getByHost("hostA").empty());
+}
+
+
+void TopologyIndex_Test::testUpdate() {
+    TopologyIndex index;
+    index.insert("dev1", "device", info("server1", "MotorClass", "hostA"));
+    // Restarted elsewhere - old secondary entries must be gone
+    index.insert("dev1", "device", info("server2", "MotorClass", "hostB"));
+    CPPUNIT_ASSERT_EQUAL(1ul, index.size());
+    CPPUNIT_ASSERT_EQUAL(2ull, index.getVersion());
+    CPPUNIT_ASSERT(index.getByServer("server1").empty());
+    CPPUNIT_ASSERT(index.getByHost("hostA").empty());
+    CPPUNIT_ASSERT(index.getByServer("server2") == vector<string>({"dev1"}));
+    CPPUNIT_ASSERT(index.getByHost("hostB") == vector<string>({"dev1"}));
+    CPPUNIT_ASSERT(index.getByClass("MotorClass") == vector<string>({"dev1"}));
+
+    // Type may change as well
+    index.insert("dev1", "macro", info("server2", "MotorClass", "hostB"));
+    CPPUNIT_ASSERT_EQUAL(string("macro"), index.getType("dev1"));
+    CPPUNIT_ASSERT(index.getByType("device").empty());
+    CPPUNIT_ASSERT(index.getByType("macro") == vector<string>({"dev1"}));
+}
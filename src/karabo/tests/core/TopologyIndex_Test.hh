@@ -0,0 +1,39 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef TOPOLOGYINDEX_TEST_HH
+#define TOPOLOGYINDEX_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TopologyIndex_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TopologyIndex_Test);
+    CPPUNIT_TEST(testInsertErase);
+    CPPUNIT_TEST(testUpdate);
+    CPPUNIT_TEST_SUITE_END();
+
+   public:
+    TopologyIndex_Test();
+    virtual ~TopologyIndex_Test();
+
+   private:
+    void testInsertErase();
+    void testUpdate();
+};
+
+#endif /* TOPOLOGYINDEX_TEST_HH */
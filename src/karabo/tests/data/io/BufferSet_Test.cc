@@ -27,7 +27,10 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/smart_ptr/make_shared_array.hpp>
 
+#include "karabo/data/io/BinarySerializer.hh"
 #include "karabo/data/io/BufferSet.hh"
+#include "karabo/data/types/Hash.hh"
+#include "karabo/data/types/NDArray.hh"
 
 using karabo::data::BufferSet;
 
@@ -111,3 +114,89 @@ void BufferSet_Test::testEmplaceAppend() {
     CPPUNIT_ASSERT_EQUAL(3 * expectedNumBuff, boostBuffers.size());
     boostBuffers.clear();
 }
+
+
+void BufferSet_Test::testAddSlices() {
+    // Two slices of one slab, interleaved with COPY buffers - as TcpChannel does it when receiving into pooled memory
+    const size_t sliceSize = 64u;
+    std::shared_ptr<char> slab(new char[2 * sliceSize], std::default_delete<char[]>());
+
+    BufferSet buffers(false);
+    buffers.add(10u, BufferSet::COPY); // replaces the empty first buffer
+    buffers.add(karabo::data::ByteArray(std::shared_ptr<char>(slab, slab.get()), sliceSize));
+    buffers.add(20u, BufferSet::COPY);
+    buffers.add(karabo::data::ByteArray(std::shared_ptr<char>(slab, slab.get() + sliceSize), sliceSize));
+
+    CPPUNIT_ASSERT_EQUAL(4ul, buffers.sizes().size());
+    CPPUNIT_ASSERT_EQUAL(30u + 2 * sliceSize, buffers.totalSize());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(BufferSet::NO_COPY_BYTEARRAY_CONTENTS), buffers.types()[3]);
+    CPPUNIT_ASSERT_EQUAL(3l, slab.use_count());
+
+    // The slices point into the slab
+    std::vector<boost::asio::mutable_buffer> boostBuffers;
+    buffers.appendTo(boostBuffers);
+    CPPUNIT_ASSERT_EQUAL(4ul, boostBuffers.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<void*>(slab.get()), boostBuffers[1].data());
+    CPPUNIT_ASSERT_EQUAL(static_cast<void*>(slab.get() + sliceSize), boostBuffers[3].data());
+
+    // ByteArrays taken out share ownership of the slab
+    buffers.rewind();
+    CPPUNIT_ASSERT(buffers.next());
+    const karabo::data::ByteArray array = buffers.currentAsByteArray();
+    CPPUNIT_ASSERT_EQUAL(slab.get(), array.first.get());
+    buffers.clear();
+    CPPUNIT_ASSERT_EQUAL(2l, slab.use_count());
+}
+
+
+void BufferSet_Test::testCopyWithoutInsert() {
+    using karabo::data::ByteArray;
+    using karabo::data::Hash;
+    using karabo::data::NDArray;
+    // Serialise a Hash with a big, an empty and a small array, the big one also being the last data
+    std::vector<int> big(1000);
+    for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<int>(i);
+    const std::vector<short> small(3, 42);
+    Hash h("small", NDArray(small.data(), small.size()), "empty", NDArray(static_cast<const short*>(nullptr), 0ul),
+           "str", "abc", "big", NDArray(big.data(), big.size()));
+    auto serializer = karabo::data::BinarySerializer<Hash>::create("Bin");
+    BufferSet buffers(false);
+    serializer->save(h, buffers);
+
+    // Leave out the big array
+    std::vector<std::pair<size_t, ByteArray>> leftOut;
+    BufferSet::Pointer light = buffers.copyWithout([&leftOut](size_t position, const ByteArray& array) {
+        if (array.second < 1000ul) return false;
+        leftOut.push_back(std::make_pair(position, array));
+        return true;
+    });
+    CPPUNIT_ASSERT_EQUAL(1ul, leftOut.size());
+    CPPUNIT_ASSERT_EQUAL(1000ul * sizeof(int), leftOut[0].second.second);
+    CPPUNIT_ASSERT_EQUAL(buffers.totalSize() - 1000ul * sizeof(int), light->totalSize());
+
+    // Mimic receiving the remaining buffers as TcpChannel does, i.e. dropping some empty ones
+    BufferSet received(false);
+    const std::vector<unsigned int> sizes = light->sizes();
+    const std::vector<int> types = light->types();
+    for (size_t i = 0; i < sizes.size(); ++i) received.add(sizes[i], types[i]);
+    std::vector<boost::asio::const_buffer> source;
+    light->appendTo(source);
+    std::vector<boost::asio::mutable_buffer> target;
+    received.appendTo(target);
+    CPPUNIT_ASSERT_EQUAL(source.size(), target.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+        std::memcpy(target[i].data(), source[i].data(), source[i].size());
+    }
+
+    // Put back and check that all is restored
+    for (const auto& positionArray : leftOut) received.insert(positionArray.first, positionArray.second);
+    Hash h2;
+    serializer->load(h2, received);
+    CPPUNIT_ASSERT_MESSAGE(karabo::data::toString(h2), h2.fullyEquals(h));
+    const NDArray& bigArray = h2.get<NDArray>("big");
+    CPPUNIT_ASSERT_EQUAL(1000ul, bigArray.size());
+    CPPUNIT_ASSERT_EQUAL(big.back(), bigArray.getData<int>()[999]);
+    // No copy of the inserted array
+    CPPUNIT_ASSERT_EQUAL(static_cast<const void*>(leftOut[0].second.first.get()),
+                         static_cast<const void*>(bigArray.getData<int>()));
+}
@@ -30,6 +30,8 @@
 class BufferSet_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE(BufferSet_Test);
     CPPUNIT_TEST(testEmplaceAppend);
+    CPPUNIT_TEST(testAddSlices);
+    CPPUNIT_TEST(testCopyWithoutInsert);
     CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -40,6 +42,8 @@ class BufferSet_Test : public CPPUNIT_NS::TestFixture {
 
    private:
     void testEmplaceAppend();
+    void testAddSlices();
+    void testCopyWithoutInsert();
 };
 
 #endif /* BUFFERSET_TEST_HH */
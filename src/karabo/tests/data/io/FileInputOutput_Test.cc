@@ -25,12 +25,14 @@
 #include "FileInputOutput_Test.hh"
 
 #include <filesystem>
+#include <limits>
 #include <karabo/data/schema/NodeElement.hh>
 #include <karabo/data/schema/VectorElement.hh>
 #include <karabo/data/types/Hash.hh>
 #include <karabo/util/TimeProfiler.hh>
 
 #include "TestPathSetup.hh"
+#include "karabo/data/io/BinaryFileIndex.hh"
 #include "karabo/data/io/FileTools.hh"
 
 using namespace std;
@@ -565,3 +567,82 @@ void FileInputOutput_Test::readSequenceFromBinaryFile() {
         CPPUNIT_ASSERT(karabo::data::similar(h1, m_rootedHash));
     }
 }
+
+
+void FileInputOutput_Test::writeIndexedBinaryFile() {
+    Output<Hash>::Pointer out = Output<Hash>::create(
+          "BinaryFile", Hash("filename", resourcePath("indexfile1.bin"), "enableAppendMode", true, "recordIndex", true));
+    for (int i = 0; i < 10; ++i) {
+        Hash h(m_rootedHash);
+        h.set("record", i);
+        out->write(h);
+    }
+    out->update(); // writes the index
+
+    // Continue the file in another output
+    out = Output<Hash>::create("BinaryFile", Hash("filename", resourcePath("indexfile1.bin"), "writeMode", "append",
+                                                  "recordIndex", true));
+    for (int i = 10; i < 15; ++i) {
+        Hash h(m_rootedHash);
+        h.set("record", i);
+        out->write(h);
+    }
+
+    out.reset(); // writes the index
+
+    // Appending requires an index
+    CPPUNIT_ASSERT_THROW(
+          Output<Hash>::create("BinaryFile", Hash("filename", resourcePath("indexfile2.bin"), "writeMode", "append")),
+          karabo::data::ParameterException);
+    out = Output<Hash>::create("BinaryFile", Hash("filename", resourcePath("seqfile1.bin"), "writeMode", "append",
+                                                  "recordIndex", true));
+    CPPUNIT_ASSERT_THROW(out->write(m_rootedHash), karabo::data::IOException);
+}
+
+
+void FileInputOutput_Test::readIndexedBinaryFile() {
+    // Reading all at once
+    Input<Hash>::Pointer in = Input<Hash>::create("BinaryFile", Hash("filename", resourcePath("indexfile1.bin")));
+    CPPUNIT_ASSERT_EQUAL(15ul, in->size());
+    Hash h;
+    for (size_t i = 0; i < in->size(); ++i) {
+        in->read(h, i);
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), h.get<int>("record"));
+        h.erase("record");
+        CPPUNIT_ASSERT(karabo::data::similar(h, m_rootedHash));
+    }
+
+    // Memory mapped, with and without prefetching, also reading backwards
+    for (unsigned int prefetch : {0u, 3u}) {
+        in = Input<Hash>::create("BinaryFile", Hash("filename", resourcePath("indexfile1.bin"), "memoryMapped", true,
+                                                    "prefetch", prefetch));
+        CPPUNIT_ASSERT_EQUAL(15ul, in->size());
+        for (size_t i = 0; i < in->size(); ++i) {
+            in->read(h, i);
+            CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), h.get<int>("record"));
+        }
+        in->read(h, 4);
+        CPPUNIT_ASSERT_EQUAL(4, h.get<int>("record"));
+        CPPUNIT_ASSERT_THROW(in->read(h, 15), karabo::data::ParameterException);
+    }
+
+    // A trailer whose dataEnd would wrap around when adding the index size is no valid index
+    std::vector<char> garbage(7, 'x');
+    const unsigned long long badDataEnd = std::numeric_limits<unsigned long long>::max();
+    const unsigned long long oneRecord = 1ull;
+    garbage.insert(garbage.end(), reinterpret_cast<const char*>(&badDataEnd),
+                   reinterpret_cast<const char*>(&badDataEnd) + sizeof(badDataEnd));
+    garbage.insert(garbage.end(), reinterpret_cast<const char*>(&oneRecord),
+                   reinterpret_cast<const char*>(&oneRecord) + sizeof(oneRecord));
+    garbage.insert(garbage.end(), {'K', 'R', 'B', 'I', 'N', 'D', 'E', 'X'});
+    std::vector<unsigned long long> offsets;
+    unsigned long long dataEnd = 0ull;
+    CPPUNIT_ASSERT(!readBinaryFileIndex(garbage.data(), garbage.size(), offsets, dataEnd));
+
+    // Memory mapped file without index: records are found by scanning
+    in = Input<Hash>::create("BinaryFile",
+                             Hash("filename", resourcePath("file1.bin"), "format", "Bin", "memoryMapped", true));
+    CPPUNIT_ASSERT_EQUAL(1ul, in->size());
+    in->read(h);
+    CPPUNIT_ASSERT(karabo::data::similar(h, m_rootedHash));
+}
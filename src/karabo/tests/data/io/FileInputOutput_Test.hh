@@ -44,6 +44,8 @@ class FileInputOutput_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(readBinarySchema);
     CPPUNIT_TEST(writeSequenceToBinaryFile);
     CPPUNIT_TEST(readSequenceFromBinaryFile);
+    CPPUNIT_TEST(writeIndexedBinaryFile);
+    CPPUNIT_TEST(readIndexedBinaryFile);
     CPPUNIT_TEST_SUITE_END();
 
 
@@ -73,6 +75,8 @@ class FileInputOutput_Test : public CPPUNIT_NS::TestFixture {
     void readBinarySchema();
     void writeSequenceToBinaryFile();
     void readSequenceFromBinaryFile();
+    void writeIndexedBinaryFile();
+    void readIndexedBinaryFile();
 };
 
 #endif /* FILEINPUTOUTPUT_TEST_HH */
@@ -0,0 +1,120 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "BufferPool_Test.hh"
+
+#include <cstring>
+
+#include "karabo/data/types/BufferPool.hh"
+#include "karabo/data/types/NDArray.hh"
+
+using namespace karabo::data;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BufferPool_Test);
+
+
+void BufferPool_Test::setUp() {
+    BufferPool::setMaxResidentBytes(64ul * 1024ul * 1024ul);
+    BufferPool::clear();
+}
+
+
+void BufferPool_Test::tearDown() {
+    BufferPool::setMaxResidentBytes(0ul); // the default
+}
+
+
+void BufferPool_Test::testReuse() {
+    const Hash stats0 = BufferPool::getStatistics();
+    const unsigned long long hits0 = stats0.get<unsigned long long>("hits");
+    const unsigned long long misses0 = stats0.get<unsigned long long>("misses");
+    CPPUNIT_ASSERT_EQUAL(0ull, stats0.get<unsigned long long>("residentBytes"));
+
+    const char* address = nullptr;
+    {
+        std::shared_ptr<char> buffer = BufferPool::allocate(100000ul);
+        address = buffer.get();
+        std::memset(buffer.get(), 42, 100000ul); // writable
+        std::shared_ptr<char> copy(buffer);
+    } // last reference gone - back to pool
+    Hash stats = BufferPool::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(misses0 + 1ull, stats.get<unsigned long long>("misses"));
+    CPPUNIT_ASSERT_EQUAL(1ull, stats.get<unsigned long long>("residentBuffers"));
+    CPPUNIT_ASSERT_EQUAL(114688ull, stats.get<unsigned long long>("residentBytes")); // 1.75 * 2^16
+
+    // Same size class is served from the pool
+    std::shared_ptr<char> buffer = BufferPool::allocate(110000ul);
+    CPPUNIT_ASSERT_EQUAL(address, static_cast<const char*>(buffer.get()));
+    stats = BufferPool::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(hits0 + 1ull, stats.get<unsigned long long>("hits"));
+    CPPUNIT_ASSERT_EQUAL(0ull, stats.get<unsigned long long>("residentBytes"));
+
+    // Huge page sized buffers
+    {
+        std::shared_ptr<char> big = BufferPool::allocate(3ul * 1024ul * 1024ul);
+        big.get()[3ul * 1024ul * 1024ul - 1ul] = 1;
+    }
+    CPPUNIT_ASSERT_EQUAL(3145728ull, BufferPool::getStatistics().get<unsigned long long>("residentBytes"));
+
+    // NDArray data is drawn from the pool
+    {
+        NDArray array(Dims(1024, 1536), static_cast<unsigned short>(7));
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(7), array.getData<unsigned short>()[1024 * 1536 - 1]);
+    }
+    CPPUNIT_ASSERT_EQUAL(3145728ull, BufferPool::getStatistics().get<unsigned long long>("residentBytes"));
+    CPPUNIT_ASSERT_EQUAL(hits0 + 2ull, BufferPool::getStatistics().get<unsigned long long>("hits"));
+
+    // Small buffers are not pooled
+    { std::shared_ptr<char> small = BufferPool::allocate(100ul); }
+    stats = BufferPool::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(hits0 + 2ull, stats.get<unsigned long long>("hits"));
+    CPPUNIT_ASSERT_EQUAL(misses0 + 2ull, stats.get<unsigned long long>("misses"));
+}
+
+
+void BufferPool_Test::testLimit() {
+    const size_t maxBytes = BufferPool::getMaxResidentBytes();
+    BufferPool::setMaxResidentBytes(20000ul);
+    {
+        std::shared_ptr<char> b1 = BufferPool::allocate(16384ul);
+        std::shared_ptr<char> b2 = BufferPool::allocate(16384ul);
+    }
+    // Only one fits below the limit
+    CPPUNIT_ASSERT_EQUAL(16384ull, BufferPool::getStatistics().get<unsigned long long>("residentBytes"));
+
+    BufferPool::setMaxResidentBytes(0ul);
+    CPPUNIT_ASSERT_EQUAL(0ull, BufferPool::getStatistics().get<unsigned long long>("residentBytes"));
+    { std::shared_ptr<char> b = BufferPool::allocate(16384ul); }
+    CPPUNIT_ASSERT_EQUAL(0ull, BufferPool::getStatistics().get<unsigned long long>("residentBuffers"));
+
+    BufferPool::setMaxResidentBytes(maxBytes);
+}
+
+
+void BufferPool_Test::testDisabled() {
+    BufferPool::setMaxResidentBytes(0ul);
+    const Hash stats0 = BufferPool::getStatistics();
+    {
+        std::shared_ptr<char> buffer = BufferPool::allocate(100000ul);
+        std::memset(buffer.get(), 42, 100000ul);
+    }
+    const Hash stats = BufferPool::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ull, stats.get<unsigned long long>("residentBytes"));
+    CPPUNIT_ASSERT_EQUAL(stats0.get<unsigned long long>("hits"), stats.get<unsigned long long>("hits"));
+    CPPUNIT_ASSERT_EQUAL(stats0.get<unsigned long long>("misses"), stats.get<unsigned long long>("misses"));
+}
@@ -1466,6 +1466,55 @@ void Hash_Test::testGetPaths() {
 }
 
 
+void Hash_Test::testForEachLeaf() {
+    Hash h;
+    h.set("a", 1);
+    h.set("b.c", "foo");
+    h.set("array", NDArray(Dims(10, 10)));
+    std::vector<Hash> vh;
+    vh.push_back(Hash("a.b", 123));
+    vh.push_back(Hash());
+    h.set("vector.hash.one", vh);
+    h.set("table", std::vector<Hash>(2, Hash("x", 1.)));
+    h.set("empty.vector.hash", std::vector<Hash>());
+    h.set("empty.hash", Hash());
+
+    {
+        // Iterate into all vectors of Hashes - in contrast to getPaths, empty Hashes do not show up
+        std::vector<std::string> paths;
+        std::vector<const Hash::Node*> nodes;
+        h.forEachLeaf([&paths, &nodes](const std::string& path, const Hash::Node& node) {
+            paths.push_back(path);
+            nodes.push_back(&node);
+        });
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(toString(paths), 6ul, paths.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("a"), paths[0]);
+        CPPUNIT_ASSERT_EQUAL(std::string("b.c"), paths[1]);
+        CPPUNIT_ASSERT_EQUAL(std::string("array"), paths[2]);
+        CPPUNIT_ASSERT_EQUAL(std::string("vector.hash.one[0].a.b"), paths[3]);
+        CPPUNIT_ASSERT_EQUAL(std::string("table[0].x"), paths[4]);
+        CPPUNIT_ASSERT_EQUAL(std::string("table[1].x"), paths[5]);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(paths[i], static_cast<const Hash::Node*>(&h.getNode(paths[i])), nodes[i]);
+        }
+    }
+    {
+        // Treat "table" as a leaf and use another separator
+        std::vector<std::string> paths;
+        h.forEachLeaf([&paths](const std::string& path, const Hash::Node&) { paths.push_back(path); },
+                      [](const std::string& path, const Hash::Node& node) {
+                          CPPUNIT_ASSERT(node.is<std::vector<Hash>>());
+                          return path == "table";
+                      },
+                      '/');
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(toString(paths), 5ul, paths.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("b/c"), paths[1]);
+        CPPUNIT_ASSERT_EQUAL(std::string("vector/hash/one[0]/a/b"), paths[3]);
+        CPPUNIT_ASSERT_EQUAL(std::string("table"), paths[4]);
+    }
+}
+
+
 void Hash_Test::testMerge() {
     Hash h1("a", 1, "b", 2, "c.b[0].g", 3, "c.c[0].d", 4, "c.c[1]", Hash("a.b.c", 6), "d.e", 7
             //,"f.g", 99 // can only set 6 keys in constructor...
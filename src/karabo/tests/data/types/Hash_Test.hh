@@ -42,6 +42,7 @@ class Hash_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testIteration);
     CPPUNIT_TEST(testAttributes);
     CPPUNIT_TEST(testGetPaths);
+    CPPUNIT_TEST(testForEachLeaf);
     CPPUNIT_TEST(testMerge);
     CPPUNIT_TEST(testSubtract);
     CPPUNIT_TEST(testErase);
@@ -72,6 +73,7 @@ class Hash_Test : public CPPUNIT_NS::TestFixture {
     void testFind();
     void testAttributes();
     void testGetPaths();
+    void testForEachLeaf();
     void testIteration();
     void testMerge();
     void testSubtract();
@@ -1096,6 +1096,23 @@ void Amqp_Test::testHashClient() {
     net::AmqpHashClient::Pointer alice(
           net::AmqpHashClient::create(connection, prefix + "alice", AMQP::Table(), aliceRead, aliceError));
 
+    // And carol who receives the same messages, but wants to deserialise the body only on demand
+    auto carolBody = std::make_shared<std::promise<net::LazyHashBody::Pointer>>();
+    auto carolBodyFut = carolBody->get_future();
+    net::AmqpHashClient::LazyReadHandler carolRead = [carolBody](const data::Hash::Pointer& h,
+                                                                 const net::LazyHashBody::Pointer& b,
+                                                                 const std::string&, const std::string&) {
+        if (h->has("headerLine")) carolBody->set_value(b); // ignore the undeserialisable message below
+    };
+    net::AmqpHashClient::Pointer carol(net::AmqpHashClient::create(connection, prefix + "carol", AMQP::Table(),
+                                                                   carolRead, [](const std::string&) {}));
+    auto carolSubDone = std::make_shared<std::promise<boost::system::error_code>>();
+    auto carolSubFut = carolSubDone->get_future();
+    carol->asyncSubscribe(prefix + "hashExchange", "alice",
+                          [carolSubDone](const boost::system::error_code ec) { carolSubDone->set_value(ec); });
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, carolSubFut.wait_for(m_timeout));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(boost::system::errc::success), carolSubFut.get().value());
+
     auto aliceSubDone = std::make_shared<std::promise<boost::system::error_code>>();
     auto aliceSubFut = aliceSubDone->get_future();
     alice->asyncSubscribe(prefix + "hashExchange", "alice",
@@ -1134,6 +1151,11 @@ void Amqp_Test::testHashClient() {
     CPPUNIT_ASSERT_EQUAL(std::string("the answer is"), readBody->get<std::string>("a1"));
     CPPUNIT_ASSERT_EQUAL(42, readBody->get<int>("a2"));
 
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, carolBodyFut.wait_for(m_timeout));
+    net::LazyHashBody::Pointer lazyBody = carolBodyFut.get();
+    CPPUNIT_ASSERT(!lazyBody->isDeserialized());
+    CPPUNIT_ASSERT_EQUAL(*sentBody, *lazyBody->get());
+
     // Test sending something that fails (e.g. cannot be deserialised)
     // Create a rawbob to send binary data - no need for a read handler
     net::AmqpClient::Pointer rawBob(std::make_shared<net::AmqpClient>(connection, prefix + "rawbob", AMQP::Table(),
@@ -1151,3 +1173,34 @@ void Amqp_Test::testHashClient() {
 
     karabo::net::EventLoop::stop();
 }
+
+
+void Amqp_Test::testLazyHashBody() {
+    // No broker needed: create the serialised message as AmqpHashClient::asyncPublish does
+    auto serializer = data::BinarySerializer<data::Hash>::create("Bin");
+    const data::Hash header("signalInstanceId", "bob");
+    const data::Hash body("a1", "the answer is", "a2", 42);
+    auto message = std::make_shared<std::vector<char>>();
+    serializer->save2(header, *message);
+    const size_t headerSize = message->size();
+    serializer->save2(body, *message);
+
+    net::LazyHashBody lazyBody(message, headerSize, serializer);
+    CPPUNIT_ASSERT_EQUAL(message->size() - headerSize, lazyBody.size());
+    CPPUNIT_ASSERT(message->data() + headerSize == lazyBody.data());
+    CPPUNIT_ASSERT_EQUAL(message.get(), lazyBody.message().get());
+    CPPUNIT_ASSERT(!lazyBody.isDeserialized());
+
+    const data::Hash::Pointer deserialized = lazyBody.get();
+    CPPUNIT_ASSERT(lazyBody.isDeserialized());
+    CPPUNIT_ASSERT_EQUAL(body, *deserialized);
+    CPPUNIT_ASSERT_EQUAL(deserialized.get(), lazyBody.get().get()); // deserialised only once
+
+    // Corrupt body: error only when asking for the body
+    auto corrupt = std::make_shared<std::vector<char>>(*message);
+    corrupt->resize(headerSize + 5);
+    net::LazyHashBody corruptBody(corrupt, headerSize, serializer);
+    CPPUNIT_ASSERT_EQUAL(5ul, corruptBody.size());
+    CPPUNIT_ASSERT_THROW(corruptBody.get(), std::exception);
+    CPPUNIT_ASSERT(!corruptBody.isDeserialized());
+}
@@ -41,6 +41,7 @@ class Amqp_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testClientUnsubscribeAll);
     CPPUNIT_TEST(testClientTooBigMessage);
     CPPUNIT_TEST(testHashClient);
+    CPPUNIT_TEST(testLazyHashBody);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -61,6 +62,7 @@ class Amqp_Test : public CPPUNIT_NS::TestFixture {
     void testClientUnsubscribeAll();
     void testClientTooBigMessage();
     void testHashClient();
+    void testLazyHashBody();
 };
 
 #endif /* KARABO_AMQP_TEST_HH */
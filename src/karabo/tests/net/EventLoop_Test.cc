@@ -191,6 +191,25 @@ void EventLoop_Test::testPost() {
         CPPUNIT_ASSERT_EQUAL(0ull, period.getTotalSeconds());                           // less than a full second
         CPPUNIT_ASSERT_GREATEREQUAL(100ull, period.getFractions(TIME_UNITS::MILLISEC)); // at least 100 milliseconds
     }
+
+    // Post with a delay an lvalue functor and a move-only one
+    {
+        auto promise = std::make_shared<std::promise<bool>>();
+        auto future = promise->get_future();
+        auto func = [promise]() { promise->set_value(true); };
+        EventLoop::post(func, 10);
+
+        std::promise<int> movedPromise;
+        std::future<int> movedFuture = movedPromise.get_future();
+        auto moveOnlyFunc = [p = std::move(movedPromise)]() mutable { p.set_value(42); };
+        EventLoop::post(std::move(moveOnlyFunc), 20);
+        EventLoop::run();
+
+        CPPUNIT_ASSERT_EQUAL(std::future_status::ready, future.wait_for(milliseconds(2000)));
+        CPPUNIT_ASSERT(future.get());
+        CPPUNIT_ASSERT_EQUAL(std::future_status::ready, movedFuture.wait_for(milliseconds(2000)));
+        CPPUNIT_ASSERT_EQUAL(42, movedFuture.get());
+    }
 }
 
 void EventLoop_Test::testAddThreadDirectly() {
@@ -318,3 +337,25 @@ std::vector<std::string> EventLoop_Test::splitByPattern(std::string_view source,
     if (!tail.empty()) output.push_back(tail);
     return output;
 }
+
+
+void EventLoop_Test::testStatistics() {
+    // Not sharded: the shard io_context is the central one
+    // (Sharding is not tested here since it can be done only once per process.)
+    CPPUNIT_ASSERT_EQUAL(0ul, EventLoop::getNumberOfShards());
+    CPPUNIT_ASSERT_EQUAL(&EventLoop::getIOService(), &EventLoop::getShardIOService());
+
+    EventLoop::setLatencyProbeInterval(10u);
+    std::jthread t(std::bind(&EventLoop::work));
+    std::this_thread::sleep_for(milliseconds(200)); // enough for a few probes
+
+    const Hash stats = EventLoop::getStatistics();
+    EventLoop::stop();
+    t.join();
+    EventLoop::setLatencyProbeInterval(1000u);
+
+    CPPUNIT_ASSERT_MESSAGE(toString(stats), stats.get<unsigned long long>("latency.samples") > 0ull);
+    CPPUNIT_ASSERT_MESSAGE(toString(stats),
+                           stats.get<unsigned long long>("latency.max") >= stats.get<unsigned long long>("latency.mean"));
+    CPPUNIT_ASSERT(stats.get<std::vector<Hash>>("shards").empty());
+}
@@ -43,6 +43,7 @@ class EventLoop_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testAddThreadDirectly);
     CPPUNIT_TEST(testExceptionTrace);
     CPPUNIT_TEST(testImmediateStop);
+    CPPUNIT_TEST(testStatistics);
     CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -60,6 +61,7 @@ class EventLoop_Test : public CPPUNIT_NS::TestFixture {
     void testAddThreadDirectly();
     void testExceptionTrace();
     void testImmediateStop();
+    void testStatistics();
     std::vector<std::string> splitByPattern(std::string_view src, std::string_view pattern);
 };
 
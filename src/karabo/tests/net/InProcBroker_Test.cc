@@ -0,0 +1,309 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "InProcBroker_Test.hh"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "karabo/data/types/Hash.hh"
+#include "karabo/net/Broker.hh"
+#include "karabo/net/EventLoop.hh"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InProcBroker_Test);
+
+using namespace karabo::data;
+using namespace karabo::net;
+using std::string;
+using std::vector;
+
+
+namespace {
+
+    /// Collects what a broker reads
+    struct Received {
+        struct Message {
+            string slot;
+            bool isBroadcast;
+            Hash::Pointer header;
+            Hash::Pointer body;
+        };
+
+        void operator()(const string& slot, bool isBroadcast, Hash::Pointer header, Hash::Pointer body) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(Message{slot, isBroadcast, header, body});
+        }
+
+        /// Wait until at least n messages have arrived (or timeout) and return how many
+        size_t waitFor(size_t n) {
+            for (int i = 0; i < 1000; ++i) {
+                if (size() >= n) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            return size();
+        }
+
+        size_t size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return messages.size();
+        }
+
+        std::mutex mutex;
+        vector<Message> messages;
+    };
+
+
+    Broker::Pointer createBroker(const string& instanceId, const string& url = "inproc://test") {
+        const Hash config("brokers", vector<string>({url}), "domain", "InProcBroker_Test", "instanceId", instanceId);
+        Broker::Pointer broker = Configurator<Broker>::create("inproc", config);
+        broker->connect();
+        return broker;
+    }
+
+
+    void startReading(const Broker::Pointer& broker, const std::shared_ptr<Received>& received) {
+        broker->startReading([received](const string& slot, bool isBroadcast, Hash::Pointer header,
+                                        Hash::Pointer body) { (*received)(slot, isBroadcast, header, body); });
+    }
+} // namespace
+
+
+InProcBroker_Test::InProcBroker_Test() {}
+
+
+InProcBroker_Test::~InProcBroker_Test() {}
+
+
+void InProcBroker_Test::setUp() {
+    auto prom = std::promise<void>();
+    auto fut = prom.get_future();
+    m_thread = std::make_shared<std::jthread>([&prom]() {
+        // postpone promise setting until EventLoop is activated
+        boost::asio::post(EventLoop::getIOService(), [&prom]() { prom.set_value(); });
+        EventLoop::work();
+    });
+    fut.get(); // block here until promise is set
+}
+
+
+void InProcBroker_Test::tearDown() {
+    EventLoop::stop();
+    m_thread->join();
+    m_thread.reset();
+}
+
+
+void InProcBroker_Test::testConnectDisconnect() {
+    Broker::Pointer broker = Configurator<Broker>::create(
+          "inproc", Hash("brokers", vector<string>({"inproc://test"}), "domain", "dom", "instanceId", "alice"));
+    CPPUNIT_ASSERT(!broker->isConnected());
+    CPPUNIT_ASSERT_THROW(broker->startReading(consumer::MessageHandler()), karabo::data::LogicException);
+
+    broker->connect();
+    CPPUNIT_ASSERT(broker->isConnected());
+    CPPUNIT_ASSERT_EQUAL(string("inproc"), broker->getBrokerType());
+    CPPUNIT_ASSERT_EQUAL(string("inproc://test"), broker->getBrokerUrl());
+    CPPUNIT_ASSERT_EQUAL(string("alice"), broker->getInstanceId());
+    CPPUNIT_ASSERT_EQUAL(string("dom"), broker->getDomain());
+
+    Broker::Pointer other = broker->clone("bob");
+    CPPUNIT_ASSERT_EQUAL(string("bob"), other->getInstanceId());
+    CPPUNIT_ASSERT(!other->isConnected());
+    other->connect();
+    CPPUNIT_ASSERT(other->isConnected());
+    CPPUNIT_ASSERT_EQUAL(broker->getBrokerUrl(), other->getBrokerUrl());
+    CPPUNIT_ASSERT_EQUAL(broker->getDomain(), other->getDomain());
+
+    broker->disconnect();
+    CPPUNIT_ASSERT(!broker->isConnected());
+    other->disconnect();
+    CPPUNIT_ASSERT(!other->isConnected());
+}
+
+
+void InProcBroker_Test::testOneToOne() {
+    Broker::Pointer alice = createBroker("alice");
+    Broker::Pointer bob = createBroker("bob");
+    Broker::Pointer bobElsewhere = createBroker("bob", "inproc://elsewhere");
+    auto bobReceived = std::make_shared<Received>();
+    auto elsewhereReceived = std::make_shared<Received>();
+    startReading(bob, bobReceived);
+    startReading(bobElsewhere, elsewhereReceived);
+
+    // Many messages arrive in order, each with its own copy of header and body
+    const int numMessages = 1000;
+    auto header = std::make_shared<Hash>("signalInstanceId", "alice");
+    auto body = std::make_shared<Hash>("a1", 0);
+    for (int i = 0; i < numMessages; ++i) {
+        body->set("a1", i);
+        alice->sendOneToOne("bob", "slotCount", header, body);
+    }
+    alice->sendOneToOne("nobody", "slotCount", header, body); // silently lost
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numMessages), bobReceived->waitFor(numMessages));
+    for (int i = 0; i < numMessages; ++i) {
+        const Received::Message& msg = bobReceived->messages[i];
+        CPPUNIT_ASSERT_EQUAL(string("slotCount"), msg.slot);
+        CPPUNIT_ASSERT(!msg.isBroadcast);
+        CPPUNIT_ASSERT(msg.header != header);
+        CPPUNIT_ASSERT_EQUAL(string("alice"), msg.header->get<string>("signalInstanceId"));
+        CPPUNIT_ASSERT_EQUAL(i, msg.body->get<int>("a1"));
+    }
+    // Another url is another hub
+    CPPUNIT_ASSERT_EQUAL(0ul, elsewhereReceived->size());
+
+    // After stopReading, nothing arrives anymore
+    bob->stopReading();
+    alice->sendOneToOne("bob", "slotCount", header, body);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numMessages), bobReceived->size());
+}
+
+
+void InProcBroker_Test::testSignals() {
+    Broker::Pointer alice = createBroker("alice");
+    Broker::Pointer bob = createBroker("bob");
+    auto bobReceived = std::make_shared<Received>();
+    startReading(bob, bobReceived);
+    auto header = std::make_shared<Hash>();
+    auto body = std::make_shared<Hash>("a1", 42);
+
+    // Not subscribed yet
+    alice->sendSignal("signalA", header, body);
+
+    CPPUNIT_ASSERT(!bob->subscribeToRemoteSignal("slotA", "alice", "signalA"));
+    std::promise<boost::system::error_code> subscribed;
+    auto fut = subscribed.get_future();
+    bob->subscribeToRemoteSignalAsync("slotB", "alice", "signalA",
+                                      [&subscribed](const boost::system::error_code& ec) { subscribed.set_value(ec); });
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, fut.wait_for(std::chrono::seconds(5)));
+    CPPUNIT_ASSERT(!fut.get());
+
+    // One signal calls both slots
+    alice->sendSignal("signalA", header, body);
+    alice->sendSignal("signalOther", header, body);
+    CPPUNIT_ASSERT_EQUAL(2ul, bobReceived->waitFor(2ul));
+    CPPUNIT_ASSERT_EQUAL(string("slotA"), bobReceived->messages[0].slot);
+    CPPUNIT_ASSERT_EQUAL(string("slotB"), bobReceived->messages[1].slot);
+    CPPUNIT_ASSERT(!bobReceived->messages[0].isBroadcast);
+    CPPUNIT_ASSERT_EQUAL(42, bobReceived->messages[1].body->get<int>("a1"));
+
+    // Only the remaining slot after unsubscription
+    CPPUNIT_ASSERT(!bob->unsubscribeFromRemoteSignal("slotA", "alice", "signalA"));
+    alice->sendSignal("signalA", header, body);
+    CPPUNIT_ASSERT_EQUAL(3ul, bobReceived->waitFor(3ul));
+    CPPUNIT_ASSERT_EQUAL(string("slotB"), bobReceived->messages[2].slot);
+
+    // Nothing after last unsubscription
+    CPPUNIT_ASSERT(!bob->unsubscribeFromRemoteSignal("slotB", "alice", "signalA"));
+    alice->sendSignal("signalA", header, body);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CPPUNIT_ASSERT_EQUAL(3ul, bobReceived->size());
+
+    // Not connected
+    Broker::Pointer carol = Configurator<Broker>::create("inproc", Hash("instanceId", "carol"));
+    CPPUNIT_ASSERT(carol->subscribeToRemoteSignal("slotA", "alice", "signalA"));
+    CPPUNIT_ASSERT_THROW(carol->sendSignal("signalA", header, body), karabo::data::NetworkException);
+}
+
+
+void InProcBroker_Test::testBroadcasts() {
+    Broker::Pointer alice = createBroker("alice");
+    Broker::Pointer bob = createBroker("bob");
+    Broker::Pointer carol = createBroker("carol");
+    carol->setConsumeBroadcasts(false);
+    auto aliceReceived = std::make_shared<Received>();
+    auto bobReceived = std::make_shared<Received>();
+    auto carolReceived = std::make_shared<Received>();
+    startReading(alice, aliceReceived);
+    startReading(bob, bobReceived);
+    startReading(carol, carolReceived);
+    CPPUNIT_ASSERT_NO_THROW(carol->startReadingHeartbeats());
+    Broker::Pointer notReading = createBroker("dave");
+    CPPUNIT_ASSERT_THROW(notReading->startReadingHeartbeats(), karabo::data::LogicException);
+
+    auto header = std::make_shared<Hash>();
+    auto body = std::make_shared<Hash>();
+    CPPUNIT_ASSERT_THROW(alice->sendBroadcast("slotNotBroadcast", header, body), karabo::data::ParameterException);
+
+    // Broadcasts reach sender as well, but not carol who does not consume them - heartbeats only carol
+    alice->sendBroadcast("slotInstanceNew", header, body);
+    alice->sendBroadcast("slotHeartbeat", header, body);
+    CPPUNIT_ASSERT_EQUAL(1ul, aliceReceived->waitFor(1ul));
+    CPPUNIT_ASSERT_EQUAL(1ul, bobReceived->waitFor(1ul));
+    CPPUNIT_ASSERT_EQUAL(1ul, carolReceived->waitFor(1ul));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CPPUNIT_ASSERT_EQUAL(1ul, aliceReceived->size());
+    CPPUNIT_ASSERT_EQUAL(1ul, bobReceived->size());
+    CPPUNIT_ASSERT_EQUAL(1ul, carolReceived->size());
+    CPPUNIT_ASSERT_EQUAL(string("slotInstanceNew"), aliceReceived->messages[0].slot);
+    CPPUNIT_ASSERT(aliceReceived->messages[0].isBroadcast);
+    CPPUNIT_ASSERT_EQUAL(string("slotInstanceNew"), bobReceived->messages[0].slot);
+    CPPUNIT_ASSERT_EQUAL(string("slotHeartbeat"), carolReceived->messages[0].slot);
+    CPPUNIT_ASSERT(carolReceived->messages[0].isBroadcast);
+
+    // A destructed broker is not reached anymore
+    bob.reset();
+    CPPUNIT_ASSERT_NO_THROW(alice->sendBroadcast("slotInstanceGone", header, body));
+    CPPUNIT_ASSERT_EQUAL(2ul, aliceReceived->waitFor(2ul));
+}
+
+
+void InProcBroker_Test::testCallsFromReadHandler() {
+    Broker::Pointer alice = createBroker("alice");
+    Broker::Pointer bob = createBroker("bob");
+    auto bobReceived = std::make_shared<Received>();
+    auto done = std::make_shared<std::promise<boost::system::error_code>>();
+    auto fut = done->get_future();
+    // The synchronous methods must not wait for the strand that runs the read handler
+    bob->startReading([weakBob{std::weak_ptr<Broker>(bob)}, bobReceived, done](
+                            const string& slot, bool isBroadcast, Hash::Pointer header, Hash::Pointer body) {
+        (*bobReceived)(slot, isBroadcast, header, body);
+        Broker::Pointer self = weakBob.lock();
+        if (!self) return;
+        if (slot == "slotSubscribe") {
+            self->startReadingHeartbeats();
+            done->set_value(self->subscribeToRemoteSignal("slotA", "alice", "signalA"));
+        } else if (slot == "slotUnsubscribe") {
+            done->set_value(self->unsubscribeFromRemoteSignal("slotA", "alice", "signalA"));
+        }
+    });
+
+    auto header = std::make_shared<Hash>();
+    auto body = std::make_shared<Hash>();
+    alice->sendOneToOne("bob", "slotSubscribe", header, body);
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, fut.wait_for(std::chrono::seconds(5)));
+    CPPUNIT_ASSERT(!fut.get());
+
+    alice->sendSignal("signalA", header, body);
+    alice->sendBroadcast("slotHeartbeat", header, body);
+    CPPUNIT_ASSERT_EQUAL(3ul, bobReceived->waitFor(3ul));
+    CPPUNIT_ASSERT_EQUAL(string("slotA"), bobReceived->messages[1].slot);
+    CPPUNIT_ASSERT_EQUAL(string("slotHeartbeat"), bobReceived->messages[2].slot);
+
+    *done = std::promise<boost::system::error_code>();
+    fut = done->get_future();
+    alice->sendOneToOne("bob", "slotUnsubscribe", header, body);
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, fut.wait_for(std::chrono::seconds(5)));
+    CPPUNIT_ASSERT(!fut.get());
+    alice->sendSignal("signalA", header, body);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CPPUNIT_ASSERT_EQUAL(4ul, bobReceived->size());
+}
@@ -0,0 +1,53 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef INPROCBROKER_TEST_HH
+#define INPROCBROKER_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+#include <thread>
+
+class InProcBroker_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(InProcBroker_Test);
+    CPPUNIT_TEST(testConnectDisconnect);
+    CPPUNIT_TEST(testOneToOne);
+    CPPUNIT_TEST(testSignals);
+    CPPUNIT_TEST(testBroadcasts);
+    CPPUNIT_TEST(testCallsFromReadHandler);
+    CPPUNIT_TEST_SUITE_END();
+
+   public:
+    InProcBroker_Test();
+    virtual ~InProcBroker_Test();
+    void setUp();
+    void tearDown();
+
+   private:
+    void testConnectDisconnect();
+    void testOneToOne();
+    void testSignals();
+    void testBroadcasts();
+    /// (Un)subscribing and starting to read heartbeats from within the read handler must not block
+    void testCallsFromReadHandler();
+
+    std::shared_ptr<std::jthread> m_thread;
+};
+
+#endif /* INPROCBROKER_TEST_HH */
@@ -23,8 +23,11 @@
  */
 #include "karabo/net/Strand.hh"
 
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <thread>
+#include <vector>
 
 #include "Strand_Test.hh"
 #include "boost/asio/deadline_timer.hpp"
@@ -253,3 +256,48 @@ void Strand_Test::testMaxInARow() {
     // std::clog << "\nBefore to end many: " << static_cast<double>(doneManyStamp - beforePost) << " s" << std::endl;
     // std::clog << "Before to end    1: " << static_cast<double>(done1Stamp - beforePost) << " s" << std::endl;
 }
+
+
+void Strand_Test::testThroughput() {
+    // Several threads post concurrently small handlers (lambdas stored directly in the Strand's lock-free queue).
+    // All have to run, one after another.
+    constexpr unsigned int numProducers = 4;
+    constexpr unsigned int numPostsPerProducer = 50'000;
+    constexpr unsigned int numPosts = numProducers * numPostsPerProducer;
+
+    for (const unsigned int maxInARow : {1u, 100u}) {
+        auto strand = Configurator<Strand>::create("Strand", Hash("maxInARow", maxInARow));
+
+        std::atomic<int> numRunning(0);
+        std::atomic<bool> concurrent(false);
+        unsigned int counter = 0; // no need to protect if handlers run sequentially
+        std::promise<void> promise;
+        auto future = promise.get_future();
+        auto handler = [&numRunning, &concurrent, &counter, &promise]() {
+            if (++numRunning != 1) concurrent = true;
+            const bool last = (++counter == numPosts);
+            --numRunning;
+            if (last) promise.set_value(); // last action: the test may go out of scope
+        };
+
+        const auto start = steady_clock::now();
+        {
+            std::vector<std::jthread> producers;
+            for (unsigned int i = 0; i < numProducers; ++i) {
+                producers.emplace_back([&strand, handler]() {
+                    for (unsigned int j = 0; j < numPostsPerProducer; ++j) {
+                        strand->post(handler);
+                    }
+                });
+            }
+        } // joins producers
+
+        CPPUNIT_ASSERT_EQUAL(std::future_status::ready, future.wait_for(10s));
+        const duration<double> runTime = steady_clock::now() - start;
+
+        CPPUNIT_ASSERT(!concurrent);
+        CPPUNIT_ASSERT_EQUAL(numPosts, counter);
+        std::clog << "\nStrand throughput, maxInARow " << maxInARow << ": " << numPosts / runTime.count()
+                  << " handlers/s" << std::flush;
+    }
+}
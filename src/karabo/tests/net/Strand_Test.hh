@@ -36,6 +36,7 @@ class Strand_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testThrowing);
     CPPUNIT_TEST(testStrandDies);
     CPPUNIT_TEST(testMaxInARow);
+    CPPUNIT_TEST(testThroughput);
     CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -53,6 +54,8 @@ class Strand_Test : public CPPUNIT_NS::TestFixture {
 
     void testMaxInARow();
 
+    void testThroughput();
+
     std::shared_ptr<std::jthread> m_thread;
     const unsigned int m_nThreadsInPool;
 };
@@ -928,6 +928,12 @@ void TcpNetworking_Test::testClientServer() {
 
 
 void TcpNetworking_Test::testBufferSet() {
+    testBufferSet(false);
+    testBufferSet(true);
+}
+
+
+void TcpNetworking_Test::testBufferSet(bool pooledReceive) {
     using namespace karabo::data;
     using namespace karabo::net;
 
@@ -951,7 +957,8 @@ void TcpNetworking_Test::testBufferSet() {
     CPPUNIT_ASSERT(serverPort != 0);
 
     // Create client, connect to server and validate connection from server side
-    Connection::Pointer clientConn = Connection::create("Tcp", Hash("type", "client", "port", serverPort));
+    Connection::Pointer clientConn =
+          Connection::create("Tcp", Hash("type", "client", "port", serverPort, "pooledReceive", pooledReceive));
     Channel::Pointer clientChannel = clientConn->start();
 
     int timeout = 10000;
@@ -1029,6 +1036,12 @@ void TcpNetworking_Test::testBufferSet() {
             const NDArray& arr = dataRead.get<NDArray>(key);
             CPPUNIT_ASSERT_EQUAL(1ul, arr.size());
             CPPUNIT_ASSERT_EQUAL(i, arr.getData<int>()[0]);
+            if (pooledReceive && i > 0) {
+                // All array data of a message is received into one buffer, each array at a 64 byte aligned offset
+                const NDArray& previous = dataRead.get<NDArray>(toString(i - 1));
+                CPPUNIT_ASSERT_EQUAL(reinterpret_cast<const char*>(previous.getData<int>()) + 64,
+                                     reinterpret_cast<const char*>(arr.getData<int>()));
+            }
         }
         dataRead.clear();
         serializer->load(dataRead, *(receivedBuffers[1]));
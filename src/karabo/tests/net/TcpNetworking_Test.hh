@@ -63,6 +63,7 @@ class TcpNetworking_Test : public CPPUNIT_NS::TestFixture {
     void testWriteAsync();
 
     void testBufferSet();
+    void testBufferSet(bool pooledReceive);
 
     void testConsumeBytesAfterReadUntil();
 
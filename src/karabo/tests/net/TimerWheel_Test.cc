@@ -0,0 +1,197 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TimerWheel_Test.hh"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include "karabo/net/EventLoop.hh"
+#include "karabo/net/TimerWheel.hh"
+
+using namespace std::chrono;
+using namespace std::literals::chrono_literals;
+using karabo::net::EventLoop;
+using karabo::net::TimerWheel;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimerWheel_Test);
+
+
+TimerWheel_Test::TimerWheel_Test() {}
+
+
+TimerWheel_Test::~TimerWheel_Test() {}
+
+
+void TimerWheel_Test::setUp() {
+    m_thread = std::make_shared<std::jthread>(EventLoop::work);
+    EventLoop::addThread(2);
+}
+
+
+void TimerWheel_Test::tearDown() {
+    EventLoop::stop();
+    m_thread->join();
+    m_thread.reset();
+}
+
+
+void TimerWheel_Test::testSchedule() {
+    auto wheel = std::make_shared<TimerWheel>(EventLoop::getIOService(), 5ms, 16);
+
+    // Schedule in reverse order of expiration, handlers must be called in order and never too early
+    const int numHandlers = 10;
+    std::mutex mutex;
+    std::vector<int> calledOrder;
+    std::vector<std::promise<steady_clock::time_point>> promises(numHandlers);
+    const auto start = steady_clock::now();
+    for (int i = numHandlers - 1; i >= 0; --i) {
+        wheel->schedule(milliseconds(20 * i), [i, &mutex, &calledOrder, &promises]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                calledOrder.push_back(i);
+            }
+            promises[i].set_value(steady_clock::now());
+        });
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numHandlers), wheel->size());
+
+    for (int i = 0; i < numHandlers; ++i) {
+        auto fut = promises[i].get_future();
+        CPPUNIT_ASSERT_EQUAL(std::future_status::ready, fut.wait_for(2s));
+        const auto calledAfter = fut.get() - start;
+        CPPUNIT_ASSERT_MESSAGE(std::to_string(i) + " called too early: " +
+                                     std::to_string(duration_cast<microseconds>(calledAfter).count()) + " us",
+                               calledAfter >= milliseconds(20 * i));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numHandlers), calledOrder.size());
+    for (int i = 0; i < numHandlers; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, calledOrder[i]);
+    }
+    CPPUNIT_ASSERT_EQUAL(0ul, wheel->size());
+}
+
+
+void TimerWheel_Test::testCancel() {
+    auto wheel = std::make_shared<TimerWheel>(EventLoop::getIOService(), 5ms, 16);
+
+    std::atomic<int> numCalled(0);
+    std::vector<TimerWheel::Id> ids;
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(wheel->schedule(milliseconds(i % 100), [&numCalled]() { ++numCalled; }));
+    }
+    // Cancel all with odd index
+    for (size_t i = 1; i < ids.size(); i += 2) {
+        CPPUNIT_ASSERT(wheel->cancel(ids[i]));
+    }
+    CPPUNIT_ASSERT_EQUAL(500ul, wheel->size());
+    CPPUNIT_ASSERT(!wheel->cancel(ids[1])); // already cancelled
+
+    std::promise<void> lastCalled;
+    const TimerWheel::Id lastId = wheel->schedule(150ms, [&lastCalled]() { lastCalled.set_value(); });
+    auto fut = lastCalled.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, fut.wait_for(2s));
+    CPPUNIT_ASSERT_EQUAL(500, numCalled.load());
+    CPPUNIT_ASSERT(!wheel->cancel(lastId)); // already called
+    CPPUNIT_ASSERT(!wheel->cancel(ids[0]));
+    CPPUNIT_ASSERT_EQUAL(0ul, wheel->size());
+}
+
+
+void TimerWheel_Test::testLongDelay() {
+    // Delays of several turns of the wheel (here 4 * 5 ms)
+    auto wheel = std::make_shared<TimerWheel>(EventLoop::getIOService(), 5ms, 4);
+
+    std::promise<steady_clock::time_point> promiseShort;
+    std::promise<steady_clock::time_point> promiseLong;
+    const auto start = steady_clock::now();
+    wheel->schedule(3ms, [&promiseShort]() { promiseShort.set_value(steady_clock::now()); });
+    wheel->schedule(203ms, [&promiseLong]() { promiseLong.set_value(steady_clock::now()); });
+
+    auto futShort = promiseShort.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, futShort.wait_for(2s));
+    CPPUNIT_ASSERT(futShort.get() - start >= 3ms);
+    CPPUNIT_ASSERT_EQUAL(1ul, wheel->size());
+
+    auto futLong = promiseLong.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, futLong.wait_for(2s));
+    CPPUNIT_ASSERT(futLong.get() - start >= 203ms);
+
+    // Wheel is idle now, but can be restarted
+    std::promise<void> promiseAgain;
+    wheel->schedule(10ms, [&promiseAgain]() { promiseAgain.set_value(); });
+    auto futAgain = promiseAgain.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, futAgain.wait_for(2s));
+}
+
+
+void TimerWheel_Test::testWheelDies() {
+    std::atomic<bool> called(false);
+    {
+        auto wheel = std::make_shared<TimerWheel>(EventLoop::getIOService(), 5ms, 16);
+        wheel->schedule(20ms, [&called]() { called = true; });
+    }
+    std::this_thread::sleep_for(100ms);
+    CPPUNIT_ASSERT(!called);
+}
+
+
+void TimerWheel_Test::testCascade() {
+    // Tiny wheel: 4 buckets per level, i.e. levels cover 4, 16, 64 and 256 ticks of 1 ms.
+    // Delays are spread over all levels and beyond the top level, some are cancelled.
+    auto wheel = std::make_shared<TimerWheel>(EventLoop::getIOService(), 1ms, 4);
+
+    const int numHandlers = 200;
+    std::mutex mutex;
+    int numCalled = 0;
+    int numEarly = 0;
+    std::promise<void> allCalled;
+    const auto start = steady_clock::now();
+    std::vector<TimerWheel::Id> ids;
+    for (int i = 0; i < numHandlers; ++i) {
+        const milliseconds delay((i * 37) % 400); // up to 399 ms, i.e. beyond the 256 ms of the top level
+        ids.push_back(wheel->schedule(delay, [delay, start, &mutex, &numCalled, &numEarly, &allCalled]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (steady_clock::now() - start < delay) ++numEarly;
+            if (++numCalled == numHandlers / 2) allCalled.set_value();
+        }));
+    }
+    for (int i = 0; i < numHandlers; i += 2) {
+        CPPUNIT_ASSERT(wheel->cancel(ids[i]));
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numHandlers / 2), wheel->size());
+
+    // A short delay scheduled later must not wait for the far ones
+    std::promise<steady_clock::time_point> promiseShort;
+    const auto shortStart = steady_clock::now();
+    wheel->schedule(2ms, [&promiseShort]() { promiseShort.set_value(steady_clock::now()); });
+    auto futShort = promiseShort.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, futShort.wait_for(2s));
+    CPPUNIT_ASSERT(futShort.get() - shortStart < 100ms);
+
+    auto fut = allCalled.get_future();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, fut.wait_for(5s));
+    std::this_thread::sleep_for(20ms); // nothing else should come
+    std::lock_guard<std::mutex> lock(mutex);
+    CPPUNIT_ASSERT_EQUAL(numHandlers / 2, numCalled);
+    CPPUNIT_ASSERT_EQUAL(0, numEarly);
+    CPPUNIT_ASSERT_EQUAL(0ul, wheel->size());
+}
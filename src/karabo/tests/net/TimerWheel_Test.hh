@@ -0,0 +1,56 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef TIMERWHEEL_TEST_HH
+#define TIMERWHEEL_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+#include <thread>
+
+class TimerWheel_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TimerWheel_Test);
+    CPPUNIT_TEST(testSchedule);
+    CPPUNIT_TEST(testCancel);
+    CPPUNIT_TEST(testLongDelay);
+    CPPUNIT_TEST(testWheelDies);
+    CPPUNIT_TEST(testCascade);
+    CPPUNIT_TEST_SUITE_END();
+
+   public:
+    TimerWheel_Test();
+    virtual ~TimerWheel_Test();
+    void setUp();
+    void tearDown();
+
+   private:
+    void testSchedule();
+
+    void testCancel();
+
+    void testLongDelay();
+
+    void testWheelDies();
+
+    void testCascade();
+
+    std::shared_ptr<std::jthread> m_thread;
+};
+
+#endif /* TIMERWHEEL_TEST_HH */
@@ -0,0 +1,286 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "ColumnArchive_Test.hh"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <karabo/util/ColumnArchive.hh>
+#include <limits>
+
+#include "karabo/data/types/Exception.hh"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ColumnArchive_Test);
+
+using karabo::data::Epochstamp;
+using karabo::data::Hash;
+using karabo::data::TimeId;
+using karabo::data::Timestamp;
+using karabo::data::Types;
+using karabo::util::ColumnArchiveReader;
+using karabo::util::ColumnArchiveWriter;
+using karabo::util::ColumnBlock;
+using karabo::util::ColumnBlockSummary;
+using karabo::util::ColumnValueKind;
+
+
+void ColumnArchive_Test::testBlockRoundTrip() {
+    const long long t0 = 1700000000123456ll;
+
+    // Integers, including extreme values that make the deltas overflow
+    ColumnBlock block;
+    block.kind = ColumnValueKind::INTEGER;
+    block.type = "INT64";
+    const std::vector<long long> integers{0ll, -1ll, 42ll, std::numeric_limits<long long>::max(),
+                                          std::numeric_limits<long long>::min(), 7ll};
+    for (size_t i = 0; i < integers.size(); ++i) {
+        block.times.push_back(t0 + 100000ll * i + (i % 2)); // 10 Hz with jitter
+        block.trainIds.push_back(1000ull + i);
+        block.logins.push_back(i == 2 ? 1 : 0);
+        block.integers.push_back(integers[i]);
+    }
+    std::string encoded;
+    ColumnBlockSummary summary;
+    block.encode(encoded, summary);
+    CPPUNIT_ASSERT_EQUAL(6u, summary.numRecords);
+    CPPUNIT_ASSERT_EQUAL(1u, summary.numLogins);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(encoded.size()), summary.size);
+    CPPUNIT_ASSERT_EQUAL(t0, summary.minTime);
+    CPPUNIT_ASSERT_EQUAL(t0 + 500001ll, summary.maxTime);
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<long long>::min(), static_cast<long long>(summary.minValue));
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<long long>::max(), static_cast<long long>(summary.maxValue));
+    CPPUNIT_ASSERT_EQUAL(1004ull, summary.minValueTrainId);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(Types::INT64), summary.type);
+
+    ColumnBlock decoded;
+    decoded.decode(encoded.data(), encoded.size());
+    CPPUNIT_ASSERT(decoded.kind == ColumnValueKind::INTEGER);
+    CPPUNIT_ASSERT_EQUAL(block.type, decoded.type);
+    CPPUNIT_ASSERT(block.times == decoded.times);
+    CPPUNIT_ASSERT(block.trainIds == decoded.trainIds);
+    CPPUNIT_ASSERT(block.logins == decoded.logins);
+    CPPUNIT_ASSERT(block.integers == decoded.integers);
+
+    // Floating point, including equal consecutive values and special values
+    block.clear();
+    block.kind = ColumnValueKind::FLOATING;
+    block.type = "DOUBLE";
+    const std::vector<double> floats{1.5, 1.5, -0.0, 3.14159, std::numeric_limits<double>::infinity(), 1.e-300};
+    for (size_t i = 0; i < floats.size(); ++i) {
+        block.times.push_back(t0 + i);
+        block.trainIds.push_back(0ull);
+        block.logins.push_back(0);
+        block.floats.push_back(floats[i]);
+    }
+    block.encode(encoded, summary);
+    decoded.decode(encoded.data(), encoded.size());
+    CPPUNIT_ASSERT(decoded.kind == ColumnValueKind::FLOATING);
+    CPPUNIT_ASSERT_EQUAL(floats.size(), decoded.floats.size());
+    for (size_t i = 0; i < floats.size(); ++i) {
+        // bitwise comparison to catch also -0.
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(std::to_string(i), 0, std::memcmp(&floats[i], &decoded.floats[i], sizeof(double)));
+    }
+    double minValue, maxValue;
+    std::memcpy(&minValue, &summary.minValue, sizeof(double));
+    std::memcpy(&maxValue, &summary.maxValue, sizeof(double));
+    CPPUNIT_ASSERT_EQUAL(-0.0, minValue);
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<double>::infinity(), maxValue);
+
+    // Text, with repetitions that end up in the dictionary only once
+    block.clear();
+    block.kind = ColumnValueKind::TEXT;
+    block.type = "STRING";
+    const std::vector<std::string> texts{"ON", "MOVING", "ON", "", "ON", "MOVING"};
+    for (size_t i = 0; i < texts.size(); ++i) {
+        block.times.push_back(t0 + 1000000ll * i);
+        block.trainIds.push_back(0ull);
+        block.logins.push_back(i == 0 ? 1 : 0);
+        block.texts.push_back(texts[i]);
+    }
+    block.encode(encoded, summary);
+    decoded.decode(encoded.data(), encoded.size());
+    CPPUNIT_ASSERT(decoded.kind == ColumnValueKind::TEXT);
+    CPPUNIT_ASSERT(block.texts == decoded.texts);
+    CPPUNIT_ASSERT(block.logins == decoded.logins);
+}
+
+
+void ColumnArchive_Test::testCorruptedBlock() {
+    ColumnBlock block;
+    block.kind = ColumnValueKind::TEXT;
+    block.type = "STRING";
+    for (int i = 0; i < 10; ++i) {
+        block.times.push_back(i);
+        block.trainIds.push_back(i);
+        block.logins.push_back(0);
+        block.texts.push_back(std::string(i, 'a'));
+    }
+    std::string encoded;
+    ColumnBlockSummary summary;
+    block.encode(encoded, summary);
+
+    ColumnBlock decoded;
+    // Truncated data
+    CPPUNIT_ASSERT_THROW(decoded.decode(encoded.data(), encoded.size() / 2), karabo::data::IOException);
+    // Bad magic marker
+    std::string bad(encoded);
+    bad[0] = 'X';
+    CPPUNIT_ASSERT_THROW(decoded.decode(bad.data(), bad.size()), karabo::data::IOException);
+}
+
+
+void ColumnArchive_Test::testWriterReader() {
+    const std::string directory("columnArchiveTest");
+    std::filesystem::remove_all(directory);
+    {
+        ColumnArchiveWriter writer(directory, 3); // small blocks to get several of them
+        Hash config("int32", 0, "float", 0.f, "string", std::string(), "node.bool", false);
+        for (int i = 0; i < 7; ++i) {
+            const Timestamp stamp(Epochstamp(1700000000ull + i, 0ull), TimeId(100ull + i));
+            config.set("int32", -i);
+            config.set("float", 0.5f * i);
+            config.set("node.bool", i % 2 == 0);
+            config.set("string", (i < 4 ? "INIT" : "ON"));
+            for (const char* path : {"int32", "float", "node.bool", "string"}) {
+                const Hash::Node& node = config.getNode(path);
+                writer.append(path, stamp, node, Types::to<karabo::data::ToLiteral>(node.getType()),
+                              node.getValueAs<std::string>(), i == 0);
+            }
+        }
+        // 7 updates with blocks of 3: the last one is stored as pending on flush
+        writer.flush();
+    }
+
+    ColumnArchiveReader reader(directory, "int32");
+    CPPUNIT_ASSERT(reader.exists());
+    CPPUNIT_ASSERT(!ColumnArchiveReader(directory, "notThere").exists());
+    const std::vector<ColumnBlockSummary>& summaries = reader.summaries();
+    CPPUNIT_ASSERT_EQUAL(3ul, summaries.size());
+    CPPUNIT_ASSERT_EQUAL(3u, summaries[0].numRecords);
+    CPPUNIT_ASSERT_EQUAL(1u, summaries[0].numLogins);
+    CPPUNIT_ASSERT_EQUAL(1u, summaries[2].numRecords);
+    CPPUNIT_ASSERT_EQUAL(ColumnBlockSummary::PENDING, summaries[2].offset);
+    CPPUNIT_ASSERT(summaries[1].offset != ColumnBlockSummary::PENDING);
+    CPPUNIT_ASSERT_EQUAL(-5ll, static_cast<long long>(summaries[1].minValue));
+    CPPUNIT_ASSERT_EQUAL(105ull, summaries[1].minValueTrainId);
+
+    ColumnBlock block;
+    reader.read(summaries[1], block);
+    CPPUNIT_ASSERT_EQUAL(3ul, block.size());
+    CPPUNIT_ASSERT_EQUAL(-3ll, block.integers[0]);
+    CPPUNIT_ASSERT_EQUAL(karabo::util::toColumnTime(Epochstamp(1700000003ull, 0ull)), block.times[0]);
+
+    Hash h;
+    Hash::Node& node = karabo::util::setColumnValue(h, "v", Types::INT32, block.integers[2]);
+    CPPUNIT_ASSERT_EQUAL(Types::INT32, node.getType());
+    CPPUNIT_ASSERT_EQUAL(-5, h.get<int>("v"));
+
+    ColumnArchiveReader boolReader(directory, "node.bool");
+    CPPUNIT_ASSERT_EQUAL(3ul, boolReader.summaries().size());
+    boolReader.read(boolReader.summaries()[0], block);
+    CPPUNIT_ASSERT(block.kind == ColumnValueKind::INTEGER);
+    CPPUNIT_ASSERT_EQUAL(std::string("BOOL"), block.type);
+
+    ColumnArchiveReader stringReader(directory, "string");
+    stringReader.read(stringReader.summaries()[1], block);
+    CPPUNIT_ASSERT(block.kind == ColumnValueKind::TEXT);
+    CPPUNIT_ASSERT_EQUAL(std::string("INIT"), block.texts[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("ON"), block.texts[1]);
+
+    ColumnArchiveReader floatReader(directory, "float");
+    floatReader.read(floatReader.summaries()[2], block);
+    CPPUNIT_ASSERT(block.kind == ColumnValueKind::FLOATING);
+    CPPUNIT_ASSERT_EQUAL(3., block.floats[0]);
+
+    // A new writer continues the pending block, so blocks keep their size
+    {
+        ColumnArchiveWriter writer(directory, 3);
+        Hash config("int32", 0);
+        for (int i = 7; i < 9; ++i) {
+            config.set("int32", -i);
+            writer.append("int32", Timestamp(Epochstamp(1700000000ull + i, 0ull), TimeId(100ull + i)),
+                          config.getNode("int32"), "INT32", std::to_string(-i), false);
+        }
+        // Block is written, but not yet flushed: the pending file is outdated and must be ignored
+        ColumnArchiveReader notFlushedReader(directory, "int32");
+        CPPUNIT_ASSERT_EQUAL(3ul, notFlushedReader.summaries().size());
+        CPPUNIT_ASSERT(notFlushedReader.summaries()[2].offset != ColumnBlockSummary::PENDING);
+        CPPUNIT_ASSERT_EQUAL(3u, notFlushedReader.summaries()[2].numRecords);
+        notFlushedReader.read(notFlushedReader.summaries()[2], block);
+        CPPUNIT_ASSERT_EQUAL(-6ll, block.integers[0]);
+        CPPUNIT_ASSERT_EQUAL(-8ll, block.integers[2]);
+        writer.flush();
+    }
+    ColumnArchiveReader continuedReader(directory, "int32");
+    CPPUNIT_ASSERT_EQUAL(3ul, continuedReader.summaries().size());
+    CPPUNIT_ASSERT_EQUAL(-8ll, static_cast<long long>(continuedReader.summaries()[2].minValue));
+    // The other properties are still pending
+    ColumnArchiveReader continuedFloatReader(directory, "float");
+    CPPUNIT_ASSERT_EQUAL(3ul, continuedFloatReader.summaries().size());
+    CPPUNIT_ASSERT_EQUAL(ColumnBlockSummary::PENDING, continuedFloatReader.summaries()[2].offset);
+
+    std::filesystem::remove_all(directory);
+}
+
+
+void ColumnArchive_Test::testFileFormat() {
+    const std::string directory("columnArchiveFormatTest");
+    std::filesystem::remove_all(directory);
+    const Hash config("uint16", static_cast<unsigned short>(0x0102));
+    {
+        ColumnArchiveWriter writer(directory, 2);
+        for (unsigned long long i = 0; i < 2; ++i) {
+            writer.append("uint16", Timestamp(Epochstamp(1ull, 0ull), TimeId(i)), config.getNode("uint16"), "UINT16",
+                          "258", false);
+        }
+    }
+
+    // Files start with a marker and the little endian format version, summaries are little endian
+    std::ifstream index(directory + "/uint16.cidx", std::ios::in | std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(index)), std::istreambuf_iterator<char>());
+    CPPUNIT_ASSERT_EQUAL(8ul + 88ul, content.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("KCIX\x01\x00\x00\x00", 8), content.substr(0, 8));
+    // minTime and maxTime are 1 s, i.e. 1000000 = 0x0F4240 microseconds
+    CPPUNIT_ASSERT_EQUAL(std::string("\x40\x42\x0F\x00\x00\x00\x00\x00", 8), content.substr(8, 8));
+    // offset of the first block is behind the header of the data file
+    CPPUNIT_ASSERT_EQUAL(std::string("\x08\x00\x00\x00\x00\x00\x00\x00", 8), content.substr(24, 8));
+    // minValue and maxValue
+    CPPUNIT_ASSERT_EQUAL(std::string("\x02\x01\x00\x00\x00\x00\x00\x00", 8), content.substr(32, 8));
+
+    std::ifstream data(directory + "/uint16.col", std::ios::in | std::ios::binary);
+    char header[8];
+    CPPUNIT_ASSERT(data.read(header, sizeof(header)));
+    CPPUNIT_ASSERT_EQUAL(std::string("KCOL\x01\x00\x00\x00", 8), std::string(header, sizeof(header)));
+
+    // Files of other versions are refused by reader and writer
+    {
+        std::fstream modify(directory + "/uint16.cidx", std::ios::in | std::ios::out | std::ios::binary);
+        modify.seekp(4);
+        modify.put('\x02');
+    }
+    ColumnArchiveReader reader(directory, "uint16");
+    CPPUNIT_ASSERT_THROW(reader.summaries(), karabo::data::IOException);
+    ColumnArchiveWriter writer(directory, 2);
+    CPPUNIT_ASSERT_THROW(writer.append("uint16", Timestamp(Epochstamp(2ull, 0ull), TimeId(2ull)),
+                                       config.getNode("uint16"), "UINT16", "258", false),
+                         karabo::data::IOException);
+
+    std::filesystem::remove_all(directory);
+}
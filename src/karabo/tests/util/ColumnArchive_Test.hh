@@ -0,0 +1,51 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef COLUMNARCHIVE_TEST_HH
+#define COLUMNARCHIVE_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ColumnArchive_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(ColumnArchive_Test);
+
+    CPPUNIT_TEST(testBlockRoundTrip);
+    CPPUNIT_TEST(testCorruptedBlock);
+    CPPUNIT_TEST(testWriterReader);
+    CPPUNIT_TEST(testFileFormat);
+
+    CPPUNIT_TEST_SUITE_END();
+
+   public:
+    ColumnArchive_Test() = default;
+    virtual ~ColumnArchive_Test() = default;
+
+   private:
+    /// Encode and decode blocks of all value kinds, checking also the summary
+    void testBlockRoundTrip();
+
+    void testCorruptedBlock();
+
+    /// Write via ColumnArchiveWriter and read back via ColumnArchiveReader
+    void testWriterReader();
+
+    /// Check the little endian file format and that other versions are refused
+    void testFileFormat();
+};
+
+#endif /* COLUMNARCHIVE_TEST_HH */
@@ -0,0 +1,147 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "ImageReduction_Test.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <jpeglib.h>
+
+#include "karabo/data/types/NDArray.hh"
+#include "karabo/xms/ImageReduction.hh"
+
+using namespace karabo::data;
+using namespace karabo::xms;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ImageReduction_Test);
+
+namespace {
+    /// Decode the JPEG data of 'image' with libjpeg, return pixels row by row, channels interleaved
+    std::vector<unsigned char> decodeJpeg(const ImageData& image, unsigned int& width, unsigned int& height,
+                                          unsigned int& channels) {
+        const NDArray& data = image.getData();
+        jpeg_decompress_struct cinfo;
+        jpeg_error_mgr jerr;
+        cinfo.err = jpeg_std_error(&jerr);
+        jpeg_create_decompress(&cinfo);
+        jpeg_mem_src(&cinfo, data.getData<unsigned char>(), data.byteSize());
+        jpeg_read_header(&cinfo, TRUE);
+        jpeg_start_decompress(&cinfo);
+        width = cinfo.output_width;
+        height = cinfo.output_height;
+        channels = cinfo.output_components;
+        std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * channels);
+        while (cinfo.output_scanline < cinfo.output_height) {
+            JSAMPROW row = pixels.data() + static_cast<size_t>(cinfo.output_scanline) * width * channels;
+            jpeg_read_scanlines(&cinfo, &row, 1);
+        }
+        jpeg_finish_decompress(&cinfo);
+        jpeg_destroy_decompress(&cinfo);
+        return pixels;
+    }
+} // namespace
+
+
+void ImageReduction_Test::testTo8Bit() {
+    const std::vector<unsigned short> pixels({0, 15, 16, 4095, 1000, 65535});
+    const ImageData image(NDArray(pixels.data(), pixels.size(), Dims(2, 3)), Encoding::GRAY, 12);
+    ImageReduction reduction;
+    reduction.to8Bit = true;
+
+    const ImageData result = reduceImage(image, reduction);
+    CPPUNIT_ASSERT_EQUAL(Types::UINT8, result.getDataType());
+    CPPUNIT_ASSERT_EQUAL(8, result.getBitsPerPixel());
+    CPPUNIT_ASSERT(Dims(2, 3) == result.getDimensions());
+    const unsigned char* scaled = result.getData().getData<unsigned char>();
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(scaled[1]));   // 15 >> 4
+    CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(scaled[2]));   // 16 >> 4
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(scaled[3])); // 4095 >> 4
+    CPPUNIT_ASSERT_EQUAL(62, static_cast<int>(scaled[4]));  // 1000 >> 4
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(scaled[5])); // beyond 12 bits - saturated
+
+    // Floating point data cannot be scaled
+    const std::vector<float> floats(6, 1.f);
+    const ImageData floatImage(NDArray(floats.data(), floats.size(), Dims(2, 3)));
+    CPPUNIT_ASSERT_EQUAL(Types::FLOAT, reduceImage(floatImage, reduction).getDataType());
+}
+
+
+void ImageReduction_Test::testJpeg() {
+    std::vector<unsigned short> pixels(100 * 60);
+    for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = (i % 100) * 40;
+    const ImageData image(NDArray(pixels.data(), pixels.size(), Dims(60, 100)), Encoding::GRAY, 12);
+
+    ImageReduction reduction(ImageReduction::fromHash(Hash("jpegQuality", 80)));
+    // No compression of 16 bit data
+    CPPUNIT_ASSERT(reduceImage(image, reduction).getEncoding() == Encoding::GRAY);
+
+    reduction = ImageReduction::fromHash(Hash("jpegQuality", 80, "to8Bit", true));
+    ImageData result = reduceImage(image, reduction);
+    CPPUNIT_ASSERT(result.getEncoding() == Encoding::JPEG);
+    CPPUNIT_ASSERT(Dims(60, 100) == result.getDimensions());
+    CPPUNIT_ASSERT(result.getData().size() < pixels.size());
+
+    // libjpeg reads it back close to the 8 bit values
+    unsigned int width = 0u, height = 0u, channels = 0u;
+    std::vector<unsigned char> decoded = decodeJpeg(result, width, height, channels);
+    CPPUNIT_ASSERT_EQUAL(100u, width);
+    CPPUNIT_ASSERT_EQUAL(60u, height);
+    CPPUNIT_ASSERT_EQUAL(1u, channels);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        const int expected = pixels[i] >> 4;
+        CPPUNIT_ASSERT_MESSAGE(std::to_string(i), std::abs(decoded[i] - expected) <= 8);
+    }
+
+    // BGRA: JPEG gets the colour channels in RGB order, alpha is dropped
+    std::vector<unsigned char> bgra(16 * 24 * 4);
+    for (size_t i = 0; i < bgra.size(); i += 4) {
+        bgra[i] = 200;    // blue
+        bgra[i + 1] = 20; // green
+        bgra[i + 2] = 90; // red
+        bgra[i + 3] = 255;
+    }
+    result = reduceImage(ImageData(NDArray(bgra.data(), bgra.size(), Dims(16, 24, 4)), Encoding::BGRA), reduction);
+    CPPUNIT_ASSERT(result.getEncoding() == Encoding::JPEG);
+    CPPUNIT_ASSERT(Dims(16, 24, 3) == result.getDimensions());
+    decoded = decodeJpeg(result, width, height, channels);
+    CPPUNIT_ASSERT_EQUAL(24u, width);
+    CPPUNIT_ASSERT_EQUAL(16u, height);
+    CPPUNIT_ASSERT_EQUAL(3u, channels);
+    CPPUNIT_ASSERT(std::abs(decoded[0] - 90) <= 4);
+    CPPUNIT_ASSERT(std::abs(decoded[1] - 20) <= 4);
+    CPPUNIT_ASSERT(std::abs(decoded[2] - 200) <= 4);
+
+    CPPUNIT_ASSERT_THROW(ImageReduction::fromHash(Hash("jpegQuality", 101)), karabo::data::ParameterException);
+    CPPUNIT_ASSERT_THROW(encodeJpeg(bgra.data(), 10, 10, 4, 80), karabo::data::ParameterException);
+    CPPUNIT_ASSERT_THROW(encodeJpeg(bgra.data(), 0, 10, 1, 80), karabo::data::ParameterException);
+}
+
+
+void ImageReduction_Test::testReduceImages() {
+    const std::vector<unsigned short> pixels(64 * 64, 4000);
+    const ImageData image(NDArray(pixels.data(), pixels.size(), Dims(64, 64)), Encoding::GRAY, 12);
+    Hash data("a.image", image, "a.b.image", image, "a.c", NDArray(pixels.data(), pixels.size()), "d", 42);
+
+    ImageReduction reduction;
+    reduction.to8Bit = true;
+    CPPUNIT_ASSERT_EQUAL(2ul, reduceImages(data, reduction));
+    CPPUNIT_ASSERT_EQUAL(Types::UINT8, data.get<ImageData>("a.image").getDataType());
+    CPPUNIT_ASSERT_EQUAL(Types::UINT8, data.get<ImageData>("a.b.image").getDataType());
+    CPPUNIT_ASSERT_EQUAL(Types::UINT16, data.get<NDArray>("a.c").getType()); // only images are touched
+    CPPUNIT_ASSERT_EQUAL(42, data.get<int>("d"));
+}
@@ -0,0 +1,37 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef IMAGEREDUCTION_TEST_HH
+#define IMAGEREDUCTION_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ImageReduction_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(ImageReduction_Test);
+    CPPUNIT_TEST(testTo8Bit);
+    CPPUNIT_TEST(testJpeg);
+    CPPUNIT_TEST(testReduceImages);
+    CPPUNIT_TEST_SUITE_END();
+
+   private:
+    void testTo8Bit();
+    void testJpeg();
+    void testReduceImages();
+};
+
+#endif /* IMAGEREDUCTION_TEST_HH */
@@ -35,8 +35,11 @@
 
 #include "karabo/data/schema/Configurator.hh"
 #include "karabo/data/schema/SimpleElement.hh"
+#include "karabo/data/schema/Validator.hh"
 #include "karabo/data/schema/VectorElement.hh"
 #include "karabo/data/time/Epochstamp.hh"
+#include "karabo/data/time/TimeId.hh"
+#include "karabo/data/time/Timestamp.hh"
 #include "karabo/data/types/Hash.hh"
 #include "karabo/data/types/NDArray.hh"
 #include "karabo/data/types/Schema.hh"
@@ -57,6 +60,7 @@ using data::INT32_ELEMENT;
 using data::NDArray;
 using data::Schema;
 using data::STRING_ELEMENT;
+using data::Validator;
 using data::VECTOR_INT32_ELEMENT;
 using xms::InputChannel;
 using xms::OUTPUT_CHANNEL_ELEMENT;
@@ -955,6 +959,404 @@ void InputOutputChannel_Test::testWriteUpdateFlags() {
     }
 }
 
+void InputOutputChannel_Test::testCreditWindow() {
+    // 1 is the old one-chunk-in-flight protocol, 0 adapts to the round trip time
+    for (unsigned int creditWindow : {1u, 4u, 0u}) {
+        testCreditWindow(creditWindow, "remote");
+        testCreditWindow(creditWindow, "local");
+    }
+}
+
+
+void InputOutputChannel_Test::testCreditWindow(unsigned int creditWindow, const std::string& memoryLocation) {
+    std::clog << " " << creditWindow << " '" << memoryLocation << "'" << std::flush;
+    constexpr int numToSend = 200;
+
+    OutputChannel::Pointer output = Configurator<OutputChannel>::create("OutputChannel", Hash(), 0);
+    output->setInstanceIdAndName("outputChannel", "output");
+    output->initialize(); // needed due to int == 0 argument above
+    Hash outputInfo(output->getInformation());
+    CPPUNIT_ASSERT(outputInfo.has("creditFlowControl"));
+    CPPUNIT_ASSERT(outputInfo.get<bool>("creditFlowControl"));
+
+    // Input that must not miss anything, but is a bit slow
+    const std::string outputChannelId(output->getInstanceId() + ":output");
+    const Hash cfg("connectedOutputChannels", std::vector<std::string>(1, outputChannelId), "onSlowness", "wait",
+                   "creditWindow", creditWindow);
+    InputChannel::Pointer input = Configurator<InputChannel>::create("InputChannel", cfg);
+    input->setInstanceId("inputChannel");
+    std::vector<int> received;
+    input->registerDataHandler([&received](const Hash& data, const InputChannel::MetaData& meta) {
+        received.push_back(data.get<int>("i"));
+        std::this_thread::sleep_for(100us);
+    });
+    std::promise<void> eosPromise;
+    auto eosFuture = eosPromise.get_future();
+    input->registerEndOfStreamEventHandler([&eosPromise](const InputChannel::Pointer&) { eosPromise.set_value(); });
+
+    outputInfo.set("outputChannelString", outputChannelId);
+    outputInfo.set("memoryLocation", memoryLocation);
+    input->connect(outputInfo);
+    int timeout = 1000;
+    while (timeout > 0) {
+        if (output->hasRegisteredCopyInputChannel("inputChannel")) break;
+        timeout -= 2;
+        std::this_thread::sleep_for(2ms);
+    }
+    CPPUNIT_ASSERT_GREATEREQUAL(0, timeout);
+
+    for (int i = 0; i < numToSend; ++i) {
+        output->write(Hash("i", i));
+        output->update();
+    }
+    output->signalEndOfStream();
+
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, eosFuture.wait_for(10s));
+    // Nothing lost, nothing duplicated, order kept
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numToSend), received.size());
+    for (int i = 0; i < numToSend; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, received[i]);
+    }
+}
+
+
+void InputOutputChannel_Test::testSharedMemory() {
+    // 0 means tcp only, 1 MB is too small to hold all arrays that the receiver keeps, so tcp is used as fallback
+    for (unsigned int sharedMemorySize : {0u, 1u}) {
+        testSharedMemory(sharedMemorySize);
+    }
+}
+
+
+void InputOutputChannel_Test::testSharedMemory(unsigned int sharedMemorySize) {
+    std::clog << " " << sharedMemorySize << " MB" << std::flush;
+    constexpr int numToSend = 50;
+    constexpr size_t bigSize = 10000ul; // 40 kB - larger than the shared memory threshold
+    constexpr size_t smallSize = 10ul; // 40 bytes - sent over tcp anyway
+
+    OutputChannel::Pointer output = Configurator<OutputChannel>::create("OutputChannel", Hash(), 0);
+    output->setInstanceIdAndName("outputChannel", "output");
+    output->initialize(); // needed due to int == 0 argument above
+    Hash outputInfo(output->getInformation());
+    CPPUNIT_ASSERT(outputInfo.has("sharedMemory"));
+    CPPUNIT_ASSERT(outputInfo.get<bool>("sharedMemory"));
+
+    const std::string outputChannelId(output->getInstanceId() + ":output");
+    const Hash cfg("connectedOutputChannels", std::vector<std::string>(1, outputChannelId), "onSlowness", "wait",
+                   "sharedMemorySize", sharedMemorySize);
+    InputChannel::Pointer input = Configurator<InputChannel>::create("InputChannel", cfg);
+    input->setInstanceId("inputChannel");
+    // Keep all arrays: that blocks their memory in the ring
+    std::vector<NDArray> bigs;
+    std::vector<NDArray> smalls;
+    input->registerDataHandler([&bigs, &smalls](const Hash& data, const InputChannel::MetaData& meta) {
+        bigs.push_back(data.get<NDArray>("big"));
+        smalls.push_back(data.get<NDArray>("small"));
+    });
+    std::promise<void> eosPromise;
+    auto eosFuture = eosPromise.get_future();
+    input->registerEndOfStreamEventHandler([&eosPromise](const InputChannel::Pointer&) { eosPromise.set_value(); });
+
+    // Same process, but pretend not to be
+    outputInfo.set("outputChannelString", outputChannelId);
+    outputInfo.set("memoryLocation", "remote");
+    input->connect(outputInfo);
+    int timeout = 1000;
+    while (timeout > 0) {
+        if (output->hasRegisteredCopyInputChannel("inputChannel")) break;
+        timeout -= 2;
+        std::this_thread::sleep_for(2ms);
+    }
+    CPPUNIT_ASSERT_GREATEREQUAL(0, timeout);
+
+    for (int i = 0; i < numToSend; ++i) {
+        const std::vector<int> big(bigSize, i);
+        const std::vector<int> small(smallSize, -i);
+        output->write(Hash("big", NDArray(big.data(), big.size()), "small", NDArray(small.data(), small.size())));
+        output->update();
+    }
+    output->signalEndOfStream();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, eosFuture.wait_for(10s));
+
+    // Data has to stay valid even after the channels are gone
+    input.reset();
+    output.reset();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numToSend), bigs.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numToSend), smalls.size());
+    for (int i = 0; i < numToSend; ++i) {
+        CPPUNIT_ASSERT_EQUAL(bigSize, bigs[i].size());
+        const int* bigData = bigs[i].getData<int>();
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(karabo::data::toString(i), i, bigData[0]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(karabo::data::toString(i), i, bigData[bigSize - 1]);
+        CPPUNIT_ASSERT_EQUAL(smallSize, smalls[i].size());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(karabo::data::toString(i), -i, smalls[i].getData<int>()[smallSize - 1]);
+    }
+}
+
+
+void InputOutputChannel_Test::testTrainAlignment() {
+    OutputChannel::Pointer output = Configurator<OutputChannel>::create("OutputChannel", Hash(), 0);
+    output->setInstanceIdAndName("outputChannel", "output");
+    output->initialize(); // needed due to int == 0 argument above
+
+    const std::string outputChannelId(output->getInstanceId() + ":output");
+    const Hash cfg("connectedOutputChannels", std::vector<std::string>(1, outputChannelId), "onSlowness", "wait",
+                   "alignedSources", std::vector<std::string>({"a", "b"}), "onIncompleteTrain", "deliver");
+    InputChannel::Pointer input = Configurator<InputChannel>::create("InputChannel", cfg);
+    input->setInstanceId("inputChannel");
+    std::vector<InputChannel::TrainData> trains;
+    input->registerTrainHandler([&trains](const InputChannel::TrainData& train) { trains.push_back(train); });
+    std::promise<void> eosPromise;
+    auto eosFuture = eosPromise.get_future();
+    input->registerEndOfStreamEventHandler([&eosPromise](const InputChannel::Pointer&) { eosPromise.set_value(); });
+
+    Hash outputInfo(output->getInformation());
+    outputInfo.set("outputChannelString", outputChannelId);
+    outputInfo.set("memoryLocation", "local");
+    input->connect(outputInfo);
+    int timeout = 1000;
+    while (timeout > 0) {
+        if (output->hasRegisteredCopyInputChannel("inputChannel")) break;
+        timeout -= 2;
+        std::this_thread::sleep_for(2ms);
+    }
+    CPPUNIT_ASSERT_GREATEREQUAL(0, timeout);
+
+    // Source "b" is one train behind and misses train 3, source "c" is not aligned
+    auto meta = [](const std::string& source, unsigned long long trainId) {
+        return OutputChannel::MetaData(source, data::Timestamp(Epochstamp(), data::TimeId(trainId)));
+    };
+    output->write(Hash("a", 1), meta("a", 1ull));
+    output->update();
+    for (unsigned long long trainId = 2ull; trainId <= 5ull; ++trainId) {
+        output->write(Hash("a", static_cast<int>(trainId)), meta("a", trainId));
+        if (trainId != 4ull) output->write(Hash("b", static_cast<int>(trainId - 1ull)), meta("b", trainId - 1ull));
+        output->write(Hash("c", 0), meta("c", trainId));
+        output->update();
+    }
+    output->signalEndOfStream();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, eosFuture.wait_for(10s));
+
+    // Trains 1, 2 and 4 are complete, 3 is not (b missing) and 5 is flushed by end-of-stream
+    CPPUNIT_ASSERT_EQUAL(5ul, trains.size());
+    for (unsigned long long trainId = 1ull; trainId <= 5ull; ++trainId) {
+        const InputChannel::TrainData& train = trains[trainId - 1ull];
+        CPPUNIT_ASSERT_EQUAL(trainId, train.trainId);
+        const bool complete = (trainId != 3ull && trainId != 5ull);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(data::toString(trainId), complete, train.complete);
+        CPPUNIT_ASSERT_EQUAL(complete ? 2ul : 1ul, train.sources.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(trainId), train.sources.at("a").first->get<int>("a"));
+        CPPUNIT_ASSERT_EQUAL(trainId, train.sources.at("a").second.getTimestamp().getTid());
+    }
+    const Hash stats(input->getTrainAlignmentStatistics());
+    CPPUNIT_ASSERT_EQUAL(3ull, stats.get<unsigned long long>("complete"));
+    CPPUNIT_ASSERT_EQUAL(2ull, stats.get<unsigned long long>("incomplete"));
+    CPPUNIT_ASSERT_EQUAL(0ull, stats.get<unsigned long long>("late"));
+}
+
+
+void InputOutputChannel_Test::testStickyDistribution() {
+    const Hash outputCfg("noInputShared", "wait", "sharedDistribution", "stickySource");
+    OutputChannel::Pointer output = Configurator<OutputChannel>::create("OutputChannel", outputCfg, 0);
+    output->setInstanceIdAndName("outputChannel", "output");
+    output->initialize(); // needed due to int == 0 argument above
+    const std::string outputChannelId(output->getInstanceId() + ":output");
+    Hash outputInfo(output->getInformation());
+    outputInfo.set("outputChannelString", outputChannelId);
+    outputInfo.set("memoryLocation", "local");
+
+    // Three shared inputs that record which sources they receive
+    constexpr size_t numInputs = 3;
+    std::mutex receivedMutex;
+    std::vector<std::map<std::string, int>> received(numInputs); // source and how often
+    std::vector<InputChannel::Pointer> inputs;
+    for (size_t i = 0; i < numInputs; ++i) {
+        const Hash cfg("connectedOutputChannels", std::vector<std::string>(1, outputChannelId), "dataDistribution",
+                       "shared");
+        inputs.push_back(Configurator<InputChannel>::create("InputChannel", cfg));
+        inputs.back()->setInstanceId("sticky" + data::toString(i));
+        inputs.back()->registerDataHandler(
+              [i, &received, &receivedMutex](const Hash& data, const InputChannel::MetaData& meta) {
+                  std::lock_guard<std::mutex> lock(receivedMutex);
+                  ++received[i][meta.getSource()];
+              });
+        inputs.back()->connect(outputInfo);
+    }
+    int timeout = 1000;
+    while (timeout > 0) {
+        size_t nRegistered = 0;
+        for (const InputChannel::Pointer& input : inputs) {
+            nRegistered += output->hasRegisteredSharedInputChannel(input->getInstanceId());
+        }
+        if (nRegistered == numInputs) break;
+        timeout -= 2;
+        std::this_thread::sleep_for(2ms);
+    }
+    CPPUNIT_ASSERT_GREATEREQUAL(0, timeout);
+
+    // Send data of some sources a few times and wait until all is received
+    constexpr int numSources = 12;
+    constexpr int numRounds = 4;
+    auto sendAndCount = [&]() {
+        for (int round = 0; round < numRounds; ++round) {
+            for (int source = 0; source < numSources; ++source) {
+                const OutputChannel::MetaData meta("s" + data::toString(source), data::Timestamp());
+                output->write(Hash("round", round), meta);
+                output->update();
+            }
+        }
+        int total = 0;
+        for (int i = 0; i < 1000 && total < numSources * numRounds; ++i) {
+            std::this_thread::sleep_for(5ms);
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            total = 0;
+            for (const auto& sources : received) {
+                for (const auto& sourceCount : sources) total += sourceCount.second;
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(numSources * numRounds, total);
+    };
+    sendAndCount();
+
+    // Each source went completely to one input
+    std::map<std::string, size_t> sourceToInput;
+    for (size_t i = 0; i < numInputs; ++i) {
+        for (const auto& sourceCount : received[i]) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(sourceCount.first, numRounds, sourceCount.second);
+            CPPUNIT_ASSERT_MESSAGE(sourceCount.first, sourceToInput.insert({sourceCount.first, i}).second);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numSources), sourceToInput.size());
+
+    // One input leaves: only its sources move
+    inputs.back()->disconnect(outputChannelId);
+    timeout = 1000;
+    while (timeout > 0 && output->hasRegisteredSharedInputChannel(inputs.back()->getInstanceId())) {
+        timeout -= 2;
+        std::this_thread::sleep_for(2ms);
+    }
+    CPPUNIT_ASSERT_GREATEREQUAL(0, timeout);
+    for (auto& sources : received) sources.clear();
+    sendAndCount();
+    CPPUNIT_ASSERT(received.back().empty());
+    for (size_t i = 0; i + 1 < numInputs; ++i) {
+        for (const auto& sourceCount : received[i]) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(sourceCount.first, numRounds, sourceCount.second);
+            const size_t before = sourceToInput[sourceCount.first];
+            CPPUNIT_ASSERT_MESSAGE(sourceCount.first, before == i || before == numInputs - 1);
+        }
+    }
+}
+
+
+void InputOutputChannel_Test::testCompression() {
+    constexpr int numToSend = 20;
+    constexpr size_t bigSize = 100000ul; // 400 kB - larger than the compression threshold
+    constexpr size_t smallSize = 10ul;   // 40 bytes - never compressed
+
+    OutputChannel::Pointer output = Configurator<OutputChannel>::create(
+          "OutputChannel", Hash("compression", "always", "compressionShuffle", 4u, "updatePeriod", 1), 0);
+    output->setInstanceIdAndName("outputChannel", "output");
+    output->initialize(); // needed due to int == 0 argument above
+    std::mutex statisticsMutex;
+    std::vector<Hash> connections;
+    std::vector<float> ratios;
+    std::vector<unsigned long long> times;
+    output->registerShowConnectionsHandler([&](const std::vector<Hash>& table) {
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        connections = table;
+    });
+    output->registerShowCompressionStatisticsHandler(
+          [&](const std::vector<float>& ratio, const std::vector<unsigned long long>& time) {
+              std::lock_guard<std::mutex> lock(statisticsMutex);
+              ratios = ratio;
+              times = time;
+          });
+
+    const std::string outputChannelId(output->getInstanceId() + ":output");
+    const Hash cfg("connectedOutputChannels", std::vector<std::string>(1, outputChannelId), "onSlowness", "wait");
+    InputChannel::Pointer input = Configurator<InputChannel>::create("InputChannel", cfg);
+    input->setInstanceId("inputChannel");
+    std::vector<NDArray> bigs;
+    std::vector<NDArray> smalls;
+    input->registerDataHandler([&bigs, &smalls](const Hash& data, const InputChannel::MetaData& meta) {
+        bigs.push_back(data.get<NDArray>("big"));
+        smalls.push_back(data.get<NDArray>("small"));
+    });
+    std::promise<void> eosPromise;
+    auto eosFuture = eosPromise.get_future();
+    input->registerEndOfStreamEventHandler([&eosPromise](const InputChannel::Pointer&) { eosPromise.set_value(); });
+
+    // Same process, but pretend not to be - "always" compresses also within a host
+    Hash outputInfo(output->getInformation());
+    outputInfo.set("outputChannelString", outputChannelId);
+    outputInfo.set("memoryLocation", "remote");
+    input->connect(outputInfo);
+    int timeout = 1000;
+    while (timeout > 0) {
+        if (output->hasRegisteredCopyInputChannel("inputChannel")) break;
+        timeout -= 2;
+        std::this_thread::sleep_for(2ms);
+    }
+    CPPUNIT_ASSERT_GREATEREQUAL(0, timeout);
+    {
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        CPPUNIT_ASSERT_EQUAL(1ul, connections.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("lz4, shuffle 4"), connections[0].get<std::string>("compression"));
+        // The table ends up in a device property: it must validate the way Device::set validates it
+        CPPUNIT_ASSERT(!connections[0].has("compressionStatistics"));
+        Schema deviceSchema;
+        OUTPUT_CHANNEL_ELEMENT(deviceSchema).key("output").commit();
+        const Validator::ValidationRules rules(false, true, false, true, true);
+        Validator validator(rules);
+        Hash validated;
+        const std::pair<bool, std::string> result =
+              validator.validate(deviceSchema, Hash("output.connections", connections), validated, data::Timestamp());
+        CPPUNIT_ASSERT_MESSAGE(result.second, result.first);
+    }
+
+    for (int i = 0; i < numToSend; ++i) {
+        std::vector<int> big(bigSize);
+        for (size_t j = 0; j < bigSize; ++j) big[j] = i * 1000 + static_cast<int>(j % 1000ul);
+        const std::vector<int> small(smallSize, -i);
+        output->write(Hash("big", NDArray(big.data(), big.size()), "small", NDArray(small.data(), small.size())));
+        output->update();
+    }
+    output->signalEndOfStream();
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, eosFuture.wait_for(10s));
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numToSend), bigs.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numToSend), smalls.size());
+    for (int i = 0; i < numToSend; ++i) {
+        CPPUNIT_ASSERT_EQUAL(bigSize, bigs[i].size());
+        const int* bigData = bigs[i].getData<int>();
+        for (size_t j = 0; j < bigSize; ++j) {
+            if (bigData[j] != i * 1000 + static_cast<int>(j % 1000ul)) {
+                CPPUNIT_FAIL("Wrong value at " + karabo::data::toString(j) + " of array " + karabo::data::toString(i));
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(smallSize, smalls[i].size());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(karabo::data::toString(i), -i, smalls[i].getData<int>()[smallSize - 1]);
+    }
+
+    // Statistics arrive with the update period
+    timeout = 3000;
+    while (timeout > 0) {
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            if (!ratios.empty() && ratios[0] > 0.f) break;
+        }
+        timeout -= 10;
+        std::this_thread::sleep_for(10ms);
+    }
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    CPPUNIT_ASSERT_EQUAL(1ul, ratios.size());
+    CPPUNIT_ASSERT_MESSAGE(karabo::data::toString(ratios[0]), ratios[0] > 10.f);
+    CPPUNIT_ASSERT_EQUAL(1ul, times.size());
+    CPPUNIT_ASSERT(times[0] > 0ull);
+}
+
+
 void InputOutputChannel_Test::testAsyncUpdate1a1() {
     testAsyncUpdate("drop", "copy", "local", false);
 }
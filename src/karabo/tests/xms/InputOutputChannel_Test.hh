@@ -39,6 +39,11 @@ class InputOutputChannel_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testSchemaValidation);
     CPPUNIT_TEST(testConnectHandler);
     CPPUNIT_TEST(testWriteUpdateFlags);
+    CPPUNIT_TEST(testCreditWindow);
+    CPPUNIT_TEST(testSharedMemory);
+    CPPUNIT_TEST(testTrainAlignment);
+    CPPUNIT_TEST(testStickyDistribution);
+    CPPUNIT_TEST(testCompression);
     CPPUNIT_TEST(testAsyncUpdate1a1);
     CPPUNIT_TEST(testAsyncUpdate1a2);
     CPPUNIT_TEST(testAsyncUpdate1b0);
@@ -79,6 +84,13 @@ class InputOutputChannel_Test : public CPPUNIT_NS::TestFixture {
     void testSchemaValidation();
     void testConnectHandler();
     void testWriteUpdateFlags();
+    void testCreditWindow();
+    void testCreditWindow(unsigned int creditWindow, const std::string& memoryLocation);
+    void testSharedMemory();
+    void testSharedMemory(unsigned int sharedMemorySize);
+    void testTrainAlignment();
+    void testStickyDistribution();
+    void testCompression();
     void testAsyncUpdate1a1();
     void testAsyncUpdate1a2();
     void testAsyncUpdate1b0();
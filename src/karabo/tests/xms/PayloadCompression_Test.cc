@@ -0,0 +1,223 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "PayloadCompression_Test.hh"
+
+#include <algorithm>
+#include <boost/asio/buffer.hpp>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "karabo/data/io/BinarySerializer.hh"
+#include "karabo/data/io/BufferSet.hh"
+#include "karabo/data/types/Exception.hh"
+#include "karabo/data/types/Hash.hh"
+#include "karabo/data/types/NDArray.hh"
+#include "karabo/xms/PayloadCompression.hh"
+
+using karabo::data::BufferSet;
+using karabo::data::Hash;
+using karabo::data::NDArray;
+using namespace karabo::xms;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PayloadCompression_Test);
+
+namespace {
+    // Compress and decompress, return compressed size
+    size_t roundTrip(const std::vector<char>& input) {
+        std::vector<char> compressed(lz4CompressBound(input.size()));
+        const size_t size = lz4Compress(input.data(), input.size(), compressed.data());
+        CPPUNIT_ASSERT(size <= compressed.size());
+        std::vector<char> output(input.size());
+        lz4Decompress(compressed.data(), size, output.data(), output.size());
+        CPPUNIT_ASSERT(input == output);
+        return size;
+    }
+} // namespace
+
+
+void PayloadCompression_Test::testLz4() {
+    // Too short for any match
+    CPPUNIT_ASSERT_EQUAL(1ul, roundTrip(std::vector<char>()));
+    CPPUNIT_ASSERT_EQUAL(6ul, roundTrip(std::vector<char>(5, 'a')));
+
+    // Repetitions, including long literal and match lengths
+    const std::string text("The quick brown fox jumps over the lazy dog. ");
+    std::vector<char> repeated;
+    for (int i = 0; i < 1000; ++i) repeated.insert(repeated.end(), text.begin(), text.end());
+    CPPUNIT_ASSERT(roundTrip(repeated) < repeated.size() / 100ul);
+    CPPUNIT_ASSERT(roundTrip(std::vector<char>(100000ul, '\0')) < 500ul);
+
+    // Random data does not compress, but must survive
+    std::mt19937 generator(42u);
+    std::vector<char> random(200000ul);
+    for (char& c : random) c = static_cast<char>(generator());
+    CPPUNIT_ASSERT(roundTrip(random) > random.size());
+
+    // Mixture, with matches farther apart than the maximum offset
+    std::vector<char> mixed(random.begin(), random.begin() + 70000);
+    mixed.insert(mixed.end(), repeated.begin(), repeated.end());
+    mixed.insert(mixed.end(), random.begin(), random.begin() + 70000);
+    CPPUNIT_ASSERT(roundTrip(mixed) < 150000ul);
+}
+
+
+void PayloadCompression_Test::testCorrupt() {
+    std::vector<char> input(10000ul);
+    for (size_t i = 0; i < input.size(); ++i) input[i] = static_cast<char>(i % 7);
+    std::vector<char> compressed(lz4CompressBound(input.size()));
+    const size_t size = lz4Compress(input.data(), input.size(), compressed.data());
+    std::vector<char> output(input.size());
+
+    // Output size has to match exactly
+    CPPUNIT_ASSERT_THROW(lz4Decompress(compressed.data(), size, output.data(), output.size() - 1ul),
+                         karabo::data::IOException);
+    output.resize(input.size() + 1ul);
+    CPPUNIT_ASSERT_THROW(lz4Decompress(compressed.data(), size, output.data(), output.size()),
+                         karabo::data::IOException);
+    // Truncated input
+    output.resize(input.size());
+    CPPUNIT_ASSERT_THROW(lz4Decompress(compressed.data(), size - 1ul, output.data(), output.size()),
+                         karabo::data::IOException);
+    // Offset pointing before the start
+    const char invalid[] = {0x10, 'a', 0x10, 0x00};
+    CPPUNIT_ASSERT_THROW(lz4Decompress(invalid, sizeof(invalid), output.data(), 5ul), karabo::data::IOException);
+
+    // Damaged blocks as they might come from the network are rejected or decompress to wrong data,
+    // but nothing is ever written beyond the output size
+    std::mt19937 generator(3u);
+    std::vector<char> guarded(input.size() + 64ul, 'G');
+    auto guardIntact = [&guarded, &input]() {
+        return std::all_of(guarded.begin() + input.size(), guarded.end(), [](char c) { return c == 'G'; });
+    };
+    for (int i = 0; i < 1000; ++i) {
+        std::vector<char> damaged(compressed.begin(), compressed.begin() + size);
+        damaged[generator() % size] ^= static_cast<char>(1u + generator() % 255u);
+        try {
+            lz4Decompress(damaged.data(), damaged.size(), guarded.data(), input.size());
+        } catch (const karabo::data::IOException&) {
+        }
+        CPPUNIT_ASSERT(guardIntact());
+    }
+    std::vector<char> garbage(2000ul);
+    for (int i = 0; i < 100; ++i) {
+        for (char& c : garbage) c = static_cast<char>(generator());
+        try {
+            lz4Decompress(garbage.data(), garbage.size(), guarded.data(), input.size());
+        } catch (const karabo::data::IOException&) {
+        }
+        CPPUNIT_ASSERT(guardIntact());
+    }
+}
+
+
+void PayloadCompression_Test::testShuffle() {
+    const char src[] = {0, 1, 2, 10, 11, 12, 20, 21, 22, 30, 31, 32, 99}; // 4 elements of 3 bytes and one more
+    const char expected[] = {0, 10, 20, 30, 1, 11, 21, 31, 2, 12, 22, 32, 99};
+    char shuffled[sizeof(src)];
+    byteShuffle(src, sizeof(src), 3ul, shuffled);
+    CPPUNIT_ASSERT_EQUAL(0, std::memcmp(expected, shuffled, sizeof(src)));
+    char back[sizeof(src)];
+    byteUnshuffle(shuffled, sizeof(src), 3ul, back);
+    CPPUNIT_ASSERT_EQUAL(0, std::memcmp(src, back, sizeof(src)));
+
+    // Slowly varying 16 bit values compress much better when shuffled
+    std::vector<unsigned short> values(50000ul);
+    std::mt19937 generator(7u);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = 1000u + (i / 10u) % 200u + generator() % 4u;
+    const char* raw = reinterpret_cast<const char*>(values.data());
+    const size_t nBytes = values.size() * sizeof(unsigned short);
+    std::vector<char> shuffledValues(nBytes);
+    byteShuffle(raw, nBytes, sizeof(unsigned short), shuffledValues.data());
+    std::vector<char> compressed(lz4CompressBound(nBytes));
+    const size_t plainSize = lz4Compress(raw, nBytes, compressed.data());
+    const size_t shuffledSize = lz4Compress(shuffledValues.data(), nBytes, compressed.data());
+    CPPUNIT_ASSERT_MESSAGE(std::to_string(shuffledSize) + " vs " + std::to_string(plainSize),
+                           shuffledSize < plainSize);
+}
+
+
+void PayloadCompression_Test::testBuffers() {
+    auto serializer = karabo::data::BinarySerializer<Hash>::create("Bin");
+    // Two items: one with a compressible and an incompressible array, one with only small data
+    std::vector<int> ramp(100000ul);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = static_cast<int>(i / 100ul);
+    std::vector<char> noise(50000ul);
+    std::mt19937 generator(1u);
+    for (char& c : noise) c = static_cast<char>(generator());
+    const Hash h1("ramp", NDArray(ramp.data(), ramp.size()), "noise", NDArray(noise.data(), noise.size()));
+    const Hash h2("small", NDArray(ramp.data(), 10ul), "str", "abc");
+    std::vector<BufferSet::Pointer> data;
+    for (const Hash* h : {&h1, &h2}) {
+        data.push_back(BufferSet::Pointer(new BufferSet(false)));
+        serializer->save(*h, *data.back());
+    }
+    const size_t originalSize = data[0]->totalSize();
+    const BufferSet::Pointer unchanged = data[1];
+
+    for (unsigned int typeSize : {1u, 4u}) {
+        std::vector<BufferSet::Pointer> sent(data);
+        Hash header("sourceInfo", std::vector<Hash>());
+        CompressionStatistics statistics;
+        compressBuffers(sent, header, 1024ul, typeSize, statistics);
+
+        CPPUNIT_ASSERT(header.has("compression"));
+        const Hash& compression = header.get<Hash>("compression");
+        CPPUNIT_ASSERT_EQUAL(typeSize, compression.get<unsigned int>("typeSize"));
+        CPPUNIT_ASSERT_EQUAL(1ul, compression.get<std::vector<unsigned int>>("item").size()); // ramp only
+        CPPUNIT_ASSERT_EQUAL(ramp.size() * sizeof(int),
+                             compression.get<std::vector<unsigned long long>>("size")[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long long>(ramp.size() * sizeof(int) + noise.size()),
+                             statistics.rawBytes.load());
+        CPPUNIT_ASSERT(statistics.ratio() > 2.f);
+        CPPUNIT_ASSERT(sent[0]->totalSize() < originalSize / 2ul);
+        CPPUNIT_ASSERT_EQUAL(unchanged, sent[1]); // nothing to compress
+
+        // Mimic receiving as TcpChannel does
+        std::vector<BufferSet::Pointer> received;
+        for (const BufferSet::Pointer& buffers : sent) {
+            received.push_back(BufferSet::Pointer(new BufferSet(false)));
+            const std::vector<unsigned int> sizes = buffers->sizes();
+            const std::vector<int> types = buffers->types();
+            for (size_t i = 0; i < sizes.size(); ++i) received.back()->add(sizes[i], types[i]);
+            std::vector<boost::asio::const_buffer> source;
+            buffers->appendTo(source);
+            std::vector<boost::asio::mutable_buffer> target;
+            received.back()->appendTo(target);
+            CPPUNIT_ASSERT_EQUAL(source.size(), target.size());
+            for (size_t i = 0; i < source.size(); ++i) {
+                std::memcpy(target[i].data(), source[i].data(), source[i].size());
+            }
+        }
+
+        const std::vector<BufferSet::Pointer> restored = decompressBuffers(compression, received);
+        CPPUNIT_ASSERT_EQUAL(2ul, restored.size());
+        Hash restored1, restored2;
+        serializer->load(restored1, *restored[0]);
+        CPPUNIT_ASSERT_MESSAGE(karabo::data::toString(restored1), restored1.fullyEquals(h1));
+        serializer->load(restored2, *restored[1]);
+        CPPUNIT_ASSERT(restored2.fullyEquals(h2));
+
+        // Description that does not fit to the data
+        Hash wrong(compression);
+        wrong.set("item", std::vector<unsigned int>(1, 2u));
+        CPPUNIT_ASSERT_THROW(decompressBuffers(wrong, received), karabo::data::LogicException);
+    }
+}
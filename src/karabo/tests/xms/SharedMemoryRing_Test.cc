@@ -0,0 +1,134 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "SharedMemoryRing_Test.hh"
+
+#include <cstring>
+#include <vector>
+
+#include "karabo/data/types/Exception.hh"
+#include "karabo/xms/SharedMemoryRing.hh"
+
+using karabo::xms::SharedMemoryRing;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedMemoryRing_Test);
+
+
+void SharedMemoryRing_Test::testAttach() {
+    SharedMemoryRing::Pointer creator = SharedMemoryRing::create(1000ul);
+    CPPUNIT_ASSERT_EQUAL(1024ul, creator->capacity()); // rounded up to multiple of 64
+    CPPUNIT_ASSERT_EQUAL(0ul, creator->getName().find("/karabo-pipeline-"));
+
+    // Wrong nonce is refused
+    CPPUNIT_ASSERT_THROW(SharedMemoryRing::attach(creator->getName(), creator->getNonce() + 1ull),
+                         karabo::data::IOException);
+
+    SharedMemoryRing::Pointer other = SharedMemoryRing::attach(creator->getName(), creator->getNonce());
+    CPPUNIT_ASSERT_EQUAL(creator->capacity(), other->capacity());
+    CPPUNIT_ASSERT_EQUAL(creator->getNonce(), other->getNonce());
+
+    // After unlinking, no further attaching - but the existing mappings are still connected
+    other->unlink();
+    CPPUNIT_ASSERT_THROW(SharedMemoryRing::attach(creator->getName(), creator->getNonce()), karabo::data::IOException);
+    const char data[] = "Hello";
+    unsigned long long offset = 0ull;
+    CPPUNIT_ASSERT(other->write(data, sizeof(data), offset));
+    std::shared_ptr<char> read = creator->read(offset, sizeof(data));
+    CPPUNIT_ASSERT_EQUAL(std::string(data), std::string(read.get()));
+
+    // Non existing ring
+    CPPUNIT_ASSERT_THROW(SharedMemoryRing::attach("/karabo-pipeline-not-there", 0ull), karabo::data::IOException);
+}
+
+
+void SharedMemoryRing_Test::testWriteRead() {
+    SharedMemoryRing::Pointer reader = SharedMemoryRing::create(4ul * 1024ul);
+    SharedMemoryRing::Pointer writer = SharedMemoryRing::attach(reader->getName(), reader->getNonce());
+
+    // Each region needs 64 bytes header, so 1000 bytes take 1088 bytes and only three fit
+    std::vector<char> data(1000ul);
+    std::vector<std::shared_ptr<char>> received;
+    for (char c = 'a'; c < 'd'; ++c) {
+        std::fill(data.begin(), data.end(), c);
+        unsigned long long offset = 0ull;
+        CPPUNIT_ASSERT(writer->write(data.data(), data.size(), offset));
+        received.push_back(reader->read(offset, data.size()));
+    }
+    unsigned long long offset = 0ull;
+    CPPUNIT_ASSERT(!writer->write(data.data(), data.size(), offset));
+    for (size_t i = 0; i < received.size(); ++i) {
+        const std::vector<char> expected(data.size(), static_cast<char>('a' + i));
+        CPPUNIT_ASSERT(std::memcmp(expected.data(), received[i].get(), expected.size()) == 0);
+    }
+
+    // Invalid regions are refused
+    CPPUNIT_ASSERT_THROW(reader->read(1ull, 10ul), karabo::data::IOException);
+    CPPUNIT_ASSERT_THROW(reader->read(64ull, 100000ul), karabo::data::IOException);
+
+    // Releasing the second region does not help since regions are reused in order
+    received[1].reset();
+    CPPUNIT_ASSERT(!writer->write(data.data(), data.size(), offset));
+    // Released region cannot be read again
+    CPPUNIT_ASSERT_THROW(reader->read(64ull + 1088ull, data.size()), karabo::data::IOException);
+
+    // Releasing the first one frees space for another one
+    received[0].reset();
+    CPPUNIT_ASSERT(writer->write(data.data(), data.size(), offset));
+    CPPUNIT_ASSERT_EQUAL(64ull, offset);
+
+    // A region stays valid as long as a pointer to it exists, even if the ring is gone on both sides
+    std::shared_ptr<char> last = reader->read(offset, data.size());
+    writer.reset();
+    reader.reset();
+    CPPUNIT_ASSERT_EQUAL('c', last.get()[data.size() - 1]);
+}
+
+
+void SharedMemoryRing_Test::testWrapAround() {
+    SharedMemoryRing::Pointer reader = SharedMemoryRing::create(10ul * 64ul);
+    SharedMemoryRing::Pointer writer = SharedMemoryRing::attach(reader->getName(), reader->getNonce());
+
+    // Regions of 3 * 64 bytes: three fit, the fourth does not although 64 bytes are left
+    std::vector<char> data(2ul * 64ul, 'x');
+    std::vector<unsigned long long> offsets(3, 0ull);
+    std::vector<std::shared_ptr<char>> received;
+    for (unsigned long long& offset : offsets) {
+        CPPUNIT_ASSERT(writer->write(data.data(), data.size(), offset));
+        received.push_back(reader->read(offset, data.size()));
+    }
+    unsigned long long offset = 0ull;
+    CPPUNIT_ASSERT(!writer->write(data.data(), data.size(), offset));
+
+    // Free the first: wrap around, leaving the last 64 bytes as padding
+    received[0].reset();
+    data.assign(data.size(), 'y');
+    CPPUNIT_ASSERT(writer->write(data.data(), data.size(), offset));
+    CPPUNIT_ASSERT_EQUAL(offsets[0], offset);
+    std::shared_ptr<char> wrapped = reader->read(offset, data.size());
+    CPPUNIT_ASSERT_EQUAL('y', wrapped.get()[0]);
+    CPPUNIT_ASSERT_EQUAL('x', received[1].get()[0]);
+
+    // Free all others: padding is reclaimed as well and the full ring can be used
+    received.clear();
+    std::vector<char> big(9ul * 64ul, 'z');
+    CPPUNIT_ASSERT(!writer->write(big.data(), big.size(), offset)); // 'wrapped' still blocks
+    wrapped.reset();
+    CPPUNIT_ASSERT(writer->write(big.data(), big.size(), offset));
+    CPPUNIT_ASSERT_EQUAL(64ull, offset);
+    CPPUNIT_ASSERT_EQUAL('z', reader->read(offset, big.size()).get()[big.size() - 1]);
+}
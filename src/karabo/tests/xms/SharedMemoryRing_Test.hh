@@ -0,0 +1,37 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef SHAREDMEMORYRING_TEST_HH
+#define SHAREDMEMORYRING_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SharedMemoryRing_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(SharedMemoryRing_Test);
+    CPPUNIT_TEST(testAttach);
+    CPPUNIT_TEST(testWriteRead);
+    CPPUNIT_TEST(testWrapAround);
+    CPPUNIT_TEST_SUITE_END();
+
+   private:
+    void testAttach();
+    void testWriteRead();
+    void testWrapAround();
+};
+
+#endif /* SHAREDMEMORYRING_TEST_HH */
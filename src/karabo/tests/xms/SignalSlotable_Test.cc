@@ -26,6 +26,7 @@
 
 #include <cppunit/TestAssert.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <string>
@@ -315,6 +316,28 @@ void SignalSlotable_Test::_testReceiveAsync() {
     std::this_thread::sleep_for(210ms);
     CPPUNIT_ASSERT_EQUAL(calledErrorHandler, false);
     CPPUNIT_ASSERT_EQUAL(receivedIgnoringReplyValue, true);
+
+    // Many requests in flight at the same time, each reply has to reach its handler, none may time out
+    const int numRequests = 1000;
+    std::atomic<int> numCorrectReplies(0);
+    std::atomic<int> numErrors(0);
+    for (int i = 0; i < numRequests; ++i) {
+        const std::string question("Hello " + std::to_string(i));
+        greeter->request("responder", "slotAnswer", question)
+              .timeout(slotCallTimeout)
+              .receiveAsync<std::string>(
+                    [question, &numCorrectReplies](const std::string& answer) {
+                        if (answer == question + ", world!") ++numCorrectReplies;
+                    },
+                    [&numErrors]() { ++numErrors; });
+    }
+    trials = 500;
+    while (--trials >= 0) {
+        if (numCorrectReplies + numErrors == numRequests) break;
+        std::this_thread::sleep_for(10ms);
+    }
+    CPPUNIT_ASSERT_EQUAL(numRequests, numCorrectReplies.load());
+    CPPUNIT_ASSERT_EQUAL(0, numErrors.load());
 }
 
 
@@ -1285,6 +1308,96 @@ void SignalSlotable_Test::_testAsyncReply() {
 }
 
 
+void SignalSlotable_Test::testCoroutineRequest() {
+    _loopFunction(__FUNCTION__, [this] { this->_testCoroutineRequest(); });
+}
+
+
+void SignalSlotable_Test::_testCoroutineRequest() {
+    auto greeter = std::make_shared<SignalSlotable>("greeter");
+    auto responder = std::make_shared<SignalSlotable>("responder");
+    greeter->start();
+    responder->start();
+
+    // A slot that replies from a coroutine which itself awaits another request
+    responder->registerSlot<std::string>(
+          [&responder](const std::string& q) { responder->reply(q + ", world!"); }, "slotAnswer");
+    SignalSlotable* const resp = responder.get();
+    responder->registerSlot<int>(
+          [resp](int i) {
+              // Coroutine state must be passed as arguments: captures would die with the temporary lambda
+              auto coro = [](SignalSlotable* self, int j) -> boost::asio::awaitable<std::tuple<int, std::string>> {
+                  const std::string answer =
+                        co_await self->request("", "slotAnswer", "Hello").timeout(1000).asyncReceive<std::string>();
+                  co_return std::make_tuple(2 * j, answer);
+              };
+              resp->replyFromCoroutine(coro(resp, i));
+          },
+          "slotCoroAnswer");
+    responder->registerSlot(
+          [resp]() {
+              resp->replyFromCoroutine([]() -> boost::asio::awaitable<int> {
+                  throw KARABO_PARAMETER_EXCEPTION("Coroutine failed");
+                  co_return 0;
+              }());
+          },
+          "slotCoroThrow");
+
+    std::promise<std::tuple<int, std::string>> replyPromise;
+    auto replyFuture = replyPromise.get_future();
+    boost::asio::co_spawn(
+          karabo::net::EventLoop::getIOService(),
+          [greeter]() -> boost::asio::awaitable<std::tuple<int, std::string>> {
+              co_return co_await greeter->request("responder", "slotCoroAnswer", 21)
+                    .timeout(slotCallTimeout)
+                    .asyncReceive<int, std::string>();
+          },
+          [&replyPromise](std::exception_ptr e, std::tuple<int, std::string> result) {
+              if (e) replyPromise.set_exception(e);
+              else replyPromise.set_value(std::move(result));
+          });
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, replyFuture.wait_for(milliseconds(slotCallTimeout)));
+    const auto [number, text] = replyFuture.get();
+    CPPUNIT_ASSERT_EQUAL(42, number);
+    CPPUNIT_ASSERT_EQUAL(std::string("Hello, world!"), text);
+
+    // Exceptions thrown inside the slot coroutine reach the awaiting coroutine as RemoteException
+    std::promise<std::string> errorPromise;
+    auto errorFuture = errorPromise.get_future();
+    boost::asio::co_spawn(
+          karabo::net::EventLoop::getIOService(),
+          [greeter]() -> boost::asio::awaitable<std::string> {
+              try {
+                  co_await greeter->request("responder", "slotCoroThrow").timeout(slotCallTimeout).asyncReceive<int>();
+              } catch (const karabo::data::RemoteException& e) {
+                  co_return std::string(e.what());
+              }
+              co_return std::string("No exception");
+          },
+          [&errorPromise](std::exception_ptr, std::string msg) { errorPromise.set_value(std::move(msg)); });
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, errorFuture.wait_for(milliseconds(slotCallTimeout)));
+    const std::string errorMsg = errorFuture.get();
+    CPPUNIT_ASSERT_MESSAGE(errorMsg, errorMsg.find("Coroutine failed") != std::string::npos);
+
+    // Timeout also ends up as exception in the awaiting coroutine
+    std::promise<bool> timeoutPromise;
+    auto timeoutFuture = timeoutPromise.get_future();
+    boost::asio::co_spawn(
+          karabo::net::EventLoop::getIOService(),
+          [greeter]() -> boost::asio::awaitable<bool> {
+              try {
+                  co_await greeter->request("notThere", "slotAnswer", "Hello").timeout(100).asyncReceive();
+              } catch (const karabo::data::TimeoutException&) {
+                  co_return true;
+              }
+              co_return false;
+          },
+          [&timeoutPromise](std::exception_ptr, bool timedOut) { timeoutPromise.set_value(timedOut); });
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, timeoutFuture.wait_for(milliseconds(slotCallTimeout)));
+    CPPUNIT_ASSERT(timeoutFuture.get());
+}
+
+
 void SignalSlotable_Test::testAutoConnect() {
     _loopFunction(__FUNCTION__, [this] { this->_testAutoConnect(); });
 }
@@ -1460,6 +1573,45 @@ void SignalSlotable_Test::_testAsyncConnectInputChannel() {
 }
 
 
+void SignalSlotable_Test::testInstanceTracking() {
+    _loopFunction(__FUNCTION__, [this] { this->_testInstanceTracking(); });
+}
+
+
+void SignalSlotable_Test::_testInstanceTracking() {
+    auto tracker = std::make_shared<SignalSlotable>("tracker");
+    tracker->start();
+    tracker->trackAllInstances();
+
+    // A second function for the slot is called as well, see testRegisterSlotTwice
+    std::promise<Hash> ghostGone;
+    std::future<Hash> ghostGoneFuture = ghostGone.get_future();
+    std::atomic<bool> beaterGone(false);
+    auto goneHandler = [&ghostGone, &beaterGone](const std::string& instanceId, const Hash& instanceInfo) {
+        if (instanceId == "ghost") ghostGone.set_value(instanceInfo);
+        else if (instanceId == "beater") beaterGone = true;
+    };
+    tracker->registerSlot<std::string, Hash>(goneHandler, "slotInstanceGone");
+
+    // An instance that sends heartbeats stays alive
+    auto beater = std::make_shared<SignalSlotable>("beater", Hash(), 2, Hash("type", "sigslot"));
+    beater->start();
+
+    // An instance that is discovered, but never sends any heartbeat, is gone after 1 * 3 seconds
+    const auto start = steady_clock::now();
+    beater->call("tracker", "slotDiscoverAnswer", "ghost", Hash("type", "fake", "heartbeatInterval", 1));
+    CPPUNIT_ASSERT_EQUAL(std::future_status::ready, ghostGoneFuture.wait_for(6s));
+    CPPUNIT_ASSERT_GREATEREQUAL(2900l, duration_cast<milliseconds>(steady_clock::now() - start).count());
+    CPPUNIT_ASSERT_EQUAL(std::string("fake"), ghostGoneFuture.get().get<std::string>("type"));
+
+    const Hash available(tracker->getAvailableInstances()); // takes 2 seconds
+    CPPUNIT_ASSERT_MESSAGE(toString(available), !available.has("ghost"));
+    CPPUNIT_ASSERT_MESSAGE(toString(available), available.has("beater"));
+    CPPUNIT_ASSERT_GREATER(0, available.get<int>("beater.countdown"));
+    CPPUNIT_ASSERT(!beaterGone);
+}
+
+
 void SignalSlotable_Test::testUuid() {
     // Test idea: The uuids generated by SignalSlotable::generateUUID() have to be unique since they are used as keys
     //            in several containers used for sync. and asyn. communication.
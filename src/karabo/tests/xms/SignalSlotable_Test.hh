@@ -49,9 +49,11 @@ class SignalSlotable_Test : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testDisconnectAsync);
     CPPUNIT_TEST(testDisconnectConnectAsyncStress);
     CPPUNIT_TEST(testAsyncReply);
+    CPPUNIT_TEST(testCoroutineRequest);
     CPPUNIT_TEST(testAutoConnect);
     CPPUNIT_TEST(testRegisterSlotTwice);
     CPPUNIT_TEST(testAsyncConnectInputChannel);
+    CPPUNIT_TEST(testInstanceTracking);
     CPPUNIT_TEST(testUuid);
 
     CPPUNIT_TEST_SUITE_END();
@@ -78,9 +80,11 @@ class SignalSlotable_Test : public CPPUNIT_NS::TestFixture {
     void testDisconnectAsync();
     void testDisconnectConnectAsyncStress();
     void testAsyncReply();
+    void testCoroutineRequest();
     void testAutoConnect();
     void testRegisterSlotTwice();
     void testAsyncConnectInputChannel();
+    void testInstanceTracking();
     void testUuid();
     void _testUniqueInstanceId();
     void _testValidInstanceId();
@@ -95,9 +99,11 @@ class SignalSlotable_Test : public CPPUNIT_NS::TestFixture {
     void _testDisconnectAsync();
     void _testDisconnectConnectAsyncStress();
     void _testAsyncReply();
+    void _testCoroutineRequest();
     void _testAutoConnect();
     void _testRegisterSlotTwice();
     void _testAsyncConnectInputChannel();
+    void _testInstanceTracking();
 
 
     std::string m_karaboBrokerBackup;
@@ -0,0 +1,152 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TrainAligner_Test.hh"
+
+#include "karabo/data/time/Epochstamp.hh"
+#include "karabo/data/time/TimeId.hh"
+#include "karabo/data/time/Timestamp.hh"
+#include "karabo/xms/TrainAligner.hh"
+
+using namespace karabo::data;
+using karabo::xms::TrainAligner;
+using std::chrono::milliseconds;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TrainAligner_Test);
+
+namespace {
+    // Add data for source and train to aligner, data is just the train id
+    void add(TrainAligner& aligner, const std::string& source, unsigned long long trainId,
+             std::vector<TrainAligner::TrainData>& ready) {
+        const TrainAligner::MetaData meta(source, Timestamp(Epochstamp(), TimeId(trainId)));
+        aligner.add(Hash::MakeShared("trainId", trainId), meta, ready);
+    }
+} // namespace
+
+
+void TrainAligner_Test::testComplete() {
+    TrainAligner aligner({"a", "b", "c"}, 4u, milliseconds(0), false);
+    std::vector<TrainAligner::TrainData> ready;
+
+    // Sources interleaved, unknown source ignored
+    add(aligner, "a", 100ull, ready);
+    add(aligner, "b", 101ull, ready);
+    add(aligner, "b", 100ull, ready);
+    add(aligner, "x", 100ull, ready);
+    add(aligner, "a", 101ull, ready);
+    CPPUNIT_ASSERT(ready.empty());
+    add(aligner, "c", 100ull, ready);
+    CPPUNIT_ASSERT_EQUAL(1ul, ready.size());
+    const TrainAligner::TrainData& train = ready[0];
+    CPPUNIT_ASSERT_EQUAL(100ull, train.trainId);
+    CPPUNIT_ASSERT(train.complete);
+    CPPUNIT_ASSERT_EQUAL(3ul, train.sources.size());
+    for (const auto& sourceAndData : train.sources) {
+        CPPUNIT_ASSERT_EQUAL(sourceAndData.first, sourceAndData.second.second.getSource());
+        CPPUNIT_ASSERT_EQUAL(100ull, sourceAndData.second.first->get<unsigned long long>("trainId"));
+    }
+
+    // Data is not copied
+    const Hash::Pointer data = Hash::MakeShared("trainId", 101ull);
+    aligner.add(data, TrainAligner::MetaData("c", Timestamp(Epochstamp(), TimeId(101ull))), ready);
+    CPPUNIT_ASSERT_EQUAL(2ul, ready.size());
+    CPPUNIT_ASSERT_EQUAL(101ull, ready[1].trainId);
+    CPPUNIT_ASSERT_EQUAL(data.get(), ready[1].sources.at("c").first.get());
+
+    const Hash stats = aligner.getStatistics();
+    CPPUNIT_ASSERT_EQUAL(2ull, stats.get<unsigned long long>("complete"));
+    CPPUNIT_ASSERT_EQUAL(0ull, stats.get<unsigned long long>("incomplete"));
+    CPPUNIT_ASSERT_EQUAL(0ull, stats.get<unsigned long long>("late"));
+}
+
+
+void TrainAligner_Test::testIncomplete() {
+    for (bool deliverIncomplete : {false, true}) {
+        TrainAligner aligner({"a", "b"}, 4u, milliseconds(0), deliverIncomplete);
+        std::vector<TrainAligner::TrainData> ready;
+
+        // Source "b" misses train 1 - completion of train 2 gives train 1 up
+        add(aligner, "a", 1ull, ready);
+        add(aligner, "a", 2ull, ready);
+        add(aligner, "b", 2ull, ready);
+        CPPUNIT_ASSERT_EQUAL(deliverIncomplete ? 2ul : 1ul, ready.size());
+        if (deliverIncomplete) {
+            CPPUNIT_ASSERT_EQUAL(1ull, ready[0].trainId);
+            CPPUNIT_ASSERT(!ready[0].complete);
+            CPPUNIT_ASSERT_EQUAL(1ul, ready[0].sources.size());
+            CPPUNIT_ASSERT_EQUAL(1ul, ready[0].sources.count("a"));
+        }
+        CPPUNIT_ASSERT_EQUAL(2ull, ready.back().trainId);
+        CPPUNIT_ASSERT(ready.back().complete);
+
+        // Data for trains already given out (or up) is late
+        ready.clear();
+        add(aligner, "b", 1ull, ready);
+        add(aligner, "a", 2ull, ready);
+        CPPUNIT_ASSERT(ready.empty());
+
+        // End of stream gives up all pending, then train ids may start again
+        add(aligner, "a", 3ull, ready);
+        aligner.flush(ready);
+        CPPUNIT_ASSERT_EQUAL(deliverIncomplete ? 1ul : 0ul, ready.size());
+        ready.clear();
+        add(aligner, "a", 1ull, ready);
+        add(aligner, "b", 1ull, ready);
+        CPPUNIT_ASSERT_EQUAL(1ul, ready.size());
+        CPPUNIT_ASSERT(ready[0].complete);
+
+        const Hash stats = aligner.getStatistics();
+        CPPUNIT_ASSERT_EQUAL(2ull, stats.get<unsigned long long>("complete"));
+        CPPUNIT_ASSERT_EQUAL(2ull, stats.get<unsigned long long>("incomplete"));
+        CPPUNIT_ASSERT_EQUAL(2ull, stats.get<unsigned long long>("late"));
+    }
+}
+
+
+void TrainAligner_Test::testWindowAndTimeout() {
+    TrainAligner aligner({"a", "b"}, 2u, milliseconds(100), true);
+    std::vector<TrainAligner::TrainData> ready;
+    CPPUNIT_ASSERT(aligner.nextExpiry() == std::chrono::steady_clock::time_point::max());
+
+    // Only two trains may be pending
+    const auto before = std::chrono::steady_clock::now();
+    add(aligner, "a", 10ull, ready);
+    add(aligner, "a", 11ull, ready);
+    CPPUNIT_ASSERT(ready.empty());
+    add(aligner, "a", 12ull, ready);
+    CPPUNIT_ASSERT_EQUAL(1ul, ready.size());
+    CPPUNIT_ASSERT_EQUAL(10ull, ready[0].trainId);
+    CPPUNIT_ASSERT(!ready[0].complete);
+
+    // Timeout
+    ready.clear();
+    const auto expiry = aligner.nextExpiry();
+    CPPUNIT_ASSERT(expiry >= before + milliseconds(100));
+    CPPUNIT_ASSERT(expiry <= std::chrono::steady_clock::now() + milliseconds(100));
+    aligner.expire(expiry - milliseconds(1), ready);
+    CPPUNIT_ASSERT(ready.empty());
+    aligner.expire(expiry + milliseconds(1000), ready);
+    CPPUNIT_ASSERT_EQUAL(2ul, ready.size());
+    CPPUNIT_ASSERT_EQUAL(11ull, ready[0].trainId);
+    CPPUNIT_ASSERT_EQUAL(12ull, ready[1].trainId);
+    CPPUNIT_ASSERT(aligner.nextExpiry() == std::chrono::steady_clock::time_point::max());
+
+    const Hash stats = aligner.getStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ull, stats.get<unsigned long long>("complete"));
+    CPPUNIT_ASSERT_EQUAL(3ull, stats.get<unsigned long long>("incomplete"));
+}
@@ -0,0 +1,37 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef TRAINALIGNER_TEST_HH
+#define TRAINALIGNER_TEST_HH
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TrainAligner_Test : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(TrainAligner_Test);
+    CPPUNIT_TEST(testComplete);
+    CPPUNIT_TEST(testIncomplete);
+    CPPUNIT_TEST(testWindowAndTimeout);
+    CPPUNIT_TEST_SUITE_END();
+
+   private:
+    void testComplete();
+    void testIncomplete();
+    void testWindowAndTimeout();
+};
+
+#endif /* TRAINALIGNER_TEST_HH */
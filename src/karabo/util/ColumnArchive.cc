@@ -0,0 +1,801 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "ColumnArchive.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include "karabo/data/types/Exception.hh"
+#include "karabo/data/types/FromLiteral.hh"
+#include "karabo/data/types/StringTools.hh"
+
+namespace karabo {
+    namespace util {
+
+        using karabo::data::Hash;
+        using karabo::data::Types;
+
+        namespace {
+
+            // Markers at the start of blocks and files - in files followed by the format version
+            const char k_blockMagic[4] = {'K', 'C', 'B', '1'};
+            const char k_dataMagic[4] = {'K', 'C', 'O', 'L'};
+            const char k_indexMagic[4] = {'K', 'C', 'I', 'X'};
+            const char k_pendingMagic[4] = {'K', 'C', 'P', 'D'};
+            const unsigned int k_formatVersion = 1u;
+            const size_t k_headerSize = sizeof(k_dataMagic) + sizeof(k_formatVersion);
+            // Size of a ColumnBlockSummary record in the '.cidx' file
+            const size_t k_summarySize = 9 * 8 + 3 * 4 + 4;
+            const char* const k_pendingFile = "pending.cpend";
+
+            void writeVarint(std::string& out, unsigned long long value) {
+                while (value >= 0x80) {
+                    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                    value >>= 7;
+                }
+                out.push_back(static_cast<char>(value));
+            }
+
+            unsigned long long readVarint(const char*& pos, const char* end) {
+                unsigned long long result = 0;
+                for (unsigned int shift = 0; shift < 64; shift += 7) {
+                    if (pos >= end) break;
+                    const unsigned char byte = static_cast<unsigned char>(*pos++);
+                    result |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0) return result;
+                }
+                throw KARABO_IO_EXCEPTION("Corrupted varint in column block");
+            }
+
+            inline unsigned long long zigzag(long long value) {
+                return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+            }
+
+            inline long long unzigzag(unsigned long long value) {
+                return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+            }
+
+            /// Delta-of-delta encoding, efficient for (almost) equidistant sequences like time stamps and train ids
+            template <typename T>
+            void encodeDeltaOfDelta(const std::vector<T>& values, std::string& out) {
+                unsigned long long previous = 0ull;
+                long long previousDelta = 0ll;
+                for (const T value : values) {
+                    const long long delta = static_cast<long long>(static_cast<unsigned long long>(value) - previous);
+                    writeVarint(out, zigzag(delta - previousDelta));
+                    previous = static_cast<unsigned long long>(value);
+                    previousDelta = delta;
+                }
+            }
+
+            template <typename T>
+            void decodeDeltaOfDelta(const char*& pos, const char* end, size_t num, std::vector<T>& values) {
+                values.resize(num);
+                unsigned long long previous = 0ull;
+                long long previousDelta = 0ll;
+                for (size_t i = 0; i < num; ++i) {
+                    previousDelta += unzigzag(readVarint(pos, end));
+                    previous += static_cast<unsigned long long>(previousDelta);
+                    values[i] = static_cast<T>(previous);
+                }
+            }
+
+            /// XOR encoding of doubles: consecutive values of slowly changing properties share most bits
+            void encodeXor(const std::vector<double>& values, std::string& out) {
+                unsigned long long previous = 0ull;
+                for (const double value : values) {
+                    unsigned long long bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    const unsigned long long x = bits ^ previous;
+                    previous = bits;
+                    if (x == 0ull) {
+                        out.push_back(static_cast<char>(0xFF));
+                        continue;
+                    }
+                    const unsigned int leading = __builtin_clzll(x) / 8;
+                    const unsigned int trailing = __builtin_ctzll(x) / 8;
+                    out.push_back(static_cast<char>((leading << 4) | trailing));
+                    for (int iByte = 7 - leading; iByte >= static_cast<int>(trailing); --iByte) {
+                        out.push_back(static_cast<char>((x >> (8 * iByte)) & 0xFF));
+                    }
+                }
+            }
+
+            void decodeXor(const char*& pos, const char* end, size_t num, std::vector<double>& values) {
+                values.resize(num);
+                unsigned long long previous = 0ull;
+                for (size_t i = 0; i < num; ++i) {
+                    if (pos >= end) throw KARABO_IO_EXCEPTION("Corrupted floating point column");
+                    const unsigned char control = static_cast<unsigned char>(*pos++);
+                    unsigned long long x = 0ull;
+                    if (control != 0xFF) {
+                        const int leading = control >> 4;
+                        const int trailing = control & 0x0F;
+                        if (leading + trailing > 7 || pos + (8 - leading - trailing) > end) {
+                            throw KARABO_IO_EXCEPTION("Corrupted floating point column");
+                        }
+                        for (int iByte = 7 - leading; iByte >= trailing; --iByte) {
+                            x |= static_cast<unsigned long long>(static_cast<unsigned char>(*pos++)) << (8 * iByte);
+                        }
+                    }
+                    previous ^= x;
+                    std::memcpy(&values[i], &previous, sizeof(previous));
+                }
+            }
+
+            void encodeDictionary(const std::vector<std::string>& values, std::string& out) {
+                std::unordered_map<std::string, unsigned long long> dictionary;
+                std::vector<const std::string*> ordered;
+                std::vector<unsigned long long> indices;
+                indices.reserve(values.size());
+                for (const std::string& value : values) {
+                    auto insertResult = dictionary.insert(std::make_pair(value, ordered.size()));
+                    if (insertResult.second) ordered.push_back(&value);
+                    indices.push_back(insertResult.first->second);
+                }
+                writeVarint(out, ordered.size());
+                for (const std::string* value : ordered) {
+                    writeVarint(out, value->size());
+                    out.append(*value);
+                }
+                for (const unsigned long long index : indices) writeVarint(out, index);
+            }
+
+            void decodeDictionary(const char*& pos, const char* end, size_t num, std::vector<std::string>& values) {
+                const unsigned long long dictSize = readVarint(pos, end);
+                std::vector<std::string> dictionary;
+                dictionary.reserve(dictSize);
+                for (unsigned long long i = 0; i < dictSize; ++i) {
+                    const unsigned long long len = readVarint(pos, end);
+                    if (pos + len > end) throw KARABO_IO_EXCEPTION("Corrupted text column");
+                    dictionary.emplace_back(pos, len);
+                    pos += len;
+                }
+                values.resize(num);
+                for (size_t i = 0; i < num; ++i) {
+                    const unsigned long long index = readVarint(pos, end);
+                    if (index >= dictionary.size()) throw KARABO_IO_EXCEPTION("Corrupted text column");
+                    values[i] = dictionary[index];
+                }
+            }
+
+            /// Append a length prefixed section
+            void appendSection(std::string& out, const std::string& section) {
+                writeVarint(out, section.size());
+                out.append(section);
+            }
+
+            /// Get the end of a length prefixed section starting at 'pos', moving 'pos' behind the length
+            const char* sectionEnd(const char*& pos, const char* end) {
+                const unsigned long long len = readVarint(pos, end);
+                if (pos + len > end) throw KARABO_IO_EXCEPTION("Corrupted column block section");
+                return pos + len;
+            }
+
+            /// Files are little endian, independent of the platform they are written on
+            template <typename T>
+            void appendLittleEndian(std::string& out, T value) {
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    out.push_back(static_cast<char>((static_cast<unsigned long long>(value) >> (8 * i)) & 0xFF));
+                }
+            }
+
+            template <typename T>
+            T readLittleEndian(const char*& pos) {
+                unsigned long long value = 0ull;
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    value |= static_cast<unsigned long long>(static_cast<unsigned char>(*pos++)) << (8 * i);
+                }
+                return static_cast<T>(value);
+            }
+
+            void appendSummary(std::string& out, const ColumnBlockSummary& summary) {
+                appendLittleEndian(out, summary.minTime);
+                appendLittleEndian(out, summary.maxTime);
+                appendLittleEndian(out, summary.offset);
+                appendLittleEndian(out, summary.minValue);
+                appendLittleEndian(out, summary.maxValue);
+                appendLittleEndian(out, summary.minValueTime);
+                appendLittleEndian(out, summary.maxValueTime);
+                appendLittleEndian(out, summary.minValueTrainId);
+                appendLittleEndian(out, summary.maxValueTrainId);
+                appendLittleEndian(out, summary.size);
+                appendLittleEndian(out, summary.numRecords);
+                appendLittleEndian(out, summary.numLogins);
+                out.push_back(static_cast<char>(summary.kind));
+                out.push_back(static_cast<char>(summary.type));
+                out.append(2, '\0'); // padding
+            }
+
+            /// Read a summary as written by appendSummary, 'pos' must point to at least k_summarySize bytes
+            ColumnBlockSummary readSummary(const char* pos) {
+                ColumnBlockSummary summary;
+                summary.minTime = readLittleEndian<long long>(pos);
+                summary.maxTime = readLittleEndian<long long>(pos);
+                summary.offset = readLittleEndian<unsigned long long>(pos);
+                summary.minValue = readLittleEndian<unsigned long long>(pos);
+                summary.maxValue = readLittleEndian<unsigned long long>(pos);
+                summary.minValueTime = readLittleEndian<long long>(pos);
+                summary.maxValueTime = readLittleEndian<long long>(pos);
+                summary.minValueTrainId = readLittleEndian<unsigned long long>(pos);
+                summary.maxValueTrainId = readLittleEndian<unsigned long long>(pos);
+                summary.size = readLittleEndian<unsigned int>(pos);
+                summary.numRecords = readLittleEndian<unsigned int>(pos);
+                summary.numLogins = readLittleEndian<unsigned int>(pos);
+                summary.kind = static_cast<unsigned char>(*pos++);
+                summary.type = static_cast<unsigned char>(*pos++);
+                return summary;
+            }
+
+            std::string fileHeader(const char (&magic)[4]) {
+                std::string header(magic, sizeof(magic));
+                appendLittleEndian(header, k_formatVersion);
+                return header;
+            }
+
+            /// Check that 'header' (of k_headerSize bytes) is the one of the current format
+            void checkHeader(const char* header, const char (&magic)[4], const std::string& file) {
+                const char* versionPos = header + sizeof(magic);
+                if (std::memcmp(header, magic, sizeof(magic)) != 0 ||
+                    readLittleEndian<unsigned int>(versionPos) != k_formatVersion) {
+                    throw KARABO_IO_EXCEPTION("\"" + file + "\" is not a column archive file of version " +
+                                              karabo::data::toString(k_formatVersion));
+                }
+            }
+
+            /// Read the complete file into 'content', return false if it cannot be opened
+            bool readFile(const std::string& file, std::string& content) {
+                std::ifstream in(file, std::ios::in | std::ios::binary);
+                if (!in.is_open()) return false;
+                content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                return true;
+            }
+
+            /**
+             * Open a column file for appending, creating it with header if needed, and return its size.
+             * A record (of non-zero 'recordSize') that was not completely written by a previous writer is removed.
+             */
+            unsigned long long openColumnFile(const std::string& file, const char (&magic)[4], size_t recordSize,
+                                              std::ofstream& out) {
+                std::error_code ec;
+                const unsigned long long fileSize = std::filesystem::file_size(file, ec);
+                unsigned long long size = (ec ? 0ull : fileSize);
+                if (size < k_headerSize) {
+                    size = 0ull; // also if the header was not completely written
+                } else {
+                    std::ifstream in(file, std::ios::in | std::ios::binary);
+                    char header[k_headerSize];
+                    if (!in.read(header, k_headerSize)) {
+                        throw KARABO_IO_EXCEPTION("Failed to read header of \"" + file + "\"");
+                    }
+                    checkHeader(header, magic, file);
+                    if (recordSize > 0) size -= (size - k_headerSize) % recordSize;
+                }
+                if (!ec && size != fileSize) std::filesystem::resize_file(file, size);
+
+                out.open(file, std::ios::out | std::ios::app | std::ios::binary);
+                if (!out.is_open()) {
+                    throw KARABO_IO_EXCEPTION("Failed to open \"" + file + "\". Check permissions.");
+                }
+                if (size == 0ull) {
+                    const std::string header(fileHeader(magic));
+                    if (!out.write(header.data(), header.size()).flush()) {
+                        throw KARABO_IO_EXCEPTION("Failed to write header to \"" + file + "\"");
+                    }
+                    size = header.size();
+                }
+                return size;
+            }
+
+            /**
+             * Call 'callback(path, numBlocks, summary, data)' for each block in the content of a pending file, i.e.
+             * for the not yet full block of the property 'path' following its 'numBlocks' blocks in the column files.
+             */
+            template <typename Callback>
+            void forEachPending(const std::string& content, const std::string& file, Callback&& callback) {
+                if (content.size() < k_headerSize) {
+                    throw KARABO_IO_EXCEPTION("\"" + file + "\" lacks its header");
+                }
+                checkHeader(content.data(), k_pendingMagic, file);
+                const char* pos = content.data() + k_headerSize;
+                const char* end = content.data() + content.size();
+                while (pos < end) {
+                    const char* pathEnd = sectionEnd(pos, end);
+                    const std::string path(pos, pathEnd);
+                    pos = pathEnd;
+                    const unsigned long long numBlocks = readVarint(pos, end);
+                    if (pos + k_summarySize > end) throw KARABO_IO_EXCEPTION("Corrupted \"" + file + "\"");
+                    const ColumnBlockSummary summary(readSummary(pos));
+                    pos += k_summarySize;
+                    if (pos + summary.size > end) throw KARABO_IO_EXCEPTION("Corrupted \"" + file + "\"");
+                    callback(path, numBlocks, summary, pos);
+                    pos += summary.size;
+                }
+            }
+        } // namespace
+
+
+        ColumnBlockSummary::ColumnBlockSummary()
+            : minTime(0ll),
+              maxTime(0ll),
+              offset(0ull),
+              minValue(0ull),
+              maxValue(0ull),
+              minValueTime(0ll),
+              maxValueTime(0ll),
+              minValueTrainId(0ull),
+              maxValueTrainId(0ull),
+              size(0u),
+              numRecords(0u),
+              numLogins(0u),
+              kind(static_cast<unsigned char>(ColumnValueKind::TEXT)),
+              type(static_cast<unsigned char>(Types::UNKNOWN)),
+              padding{0, 0} {}
+
+
+        ColumnBlock::ColumnBlock() : kind(ColumnValueKind::TEXT) {}
+
+
+        void ColumnBlock::clear() {
+            type.clear();
+            times.clear();
+            trainIds.clear();
+            logins.clear();
+            integers.clear();
+            floats.clear();
+            texts.clear();
+        }
+
+
+        void ColumnBlock::encode(std::string& out, ColumnBlockSummary& summary) const {
+            const size_t num = size();
+            summary = ColumnBlockSummary();
+            summary.numRecords = num;
+            summary.kind = static_cast<unsigned char>(kind);
+            if (kind != ColumnValueKind::TEXT) {
+                summary.type = static_cast<unsigned char>(Types::from<karabo::data::FromLiteral>(type));
+            }
+            if (num == 0) return;
+
+            summary.minTime = summary.maxTime = times[0];
+            for (size_t i = 0; i < num; ++i) {
+                if (times[i] < summary.minTime) summary.minTime = times[i];
+                if (times[i] > summary.maxTime) summary.maxTime = times[i];
+                if (logins[i]) ++summary.numLogins;
+            }
+            // Value range and when it was reached - that allows decimation without decoding the block
+            size_t iMin = 0, iMax = 0;
+            if (kind == ColumnValueKind::INTEGER) {
+                for (size_t i = 1; i < num; ++i) {
+                    if (integers[i] < integers[iMin]) iMin = i;
+                    if (integers[i] > integers[iMax]) iMax = i;
+                }
+                summary.minValue = static_cast<unsigned long long>(integers[iMin]);
+                summary.maxValue = static_cast<unsigned long long>(integers[iMax]);
+            } else if (kind == ColumnValueKind::FLOATING) {
+                for (size_t i = 1; i < num; ++i) {
+                    if (floats[i] < floats[iMin]) iMin = i;
+                    if (floats[i] > floats[iMax]) iMax = i;
+                }
+                std::memcpy(&summary.minValue, &floats[iMin], sizeof(double));
+                std::memcpy(&summary.maxValue, &floats[iMax], sizeof(double));
+            }
+            summary.minValueTime = times[iMin];
+            summary.maxValueTime = times[iMax];
+            summary.minValueTrainId = trainIds[iMin];
+            summary.maxValueTrainId = trainIds[iMax];
+
+            out.assign(k_blockMagic, sizeof(k_blockMagic));
+            writeVarint(out, num);
+            out.push_back(static_cast<char>(kind));
+            appendSection(out, type);
+
+            std::string section;
+            encodeDeltaOfDelta(times, section);
+            appendSection(out, section);
+
+            section.clear();
+            encodeDeltaOfDelta(trainIds, section);
+            appendSection(out, section);
+
+            section.clear();
+            writeVarint(section, summary.numLogins);
+            for (size_t i = 0, previous = 0; i < num; ++i) {
+                if (!logins[i]) continue;
+                writeVarint(section, i - previous);
+                previous = i;
+            }
+            appendSection(out, section);
+
+            section.clear();
+            switch (kind) {
+                case ColumnValueKind::INTEGER: {
+                    long long previous = 0ll;
+                    for (const long long value : integers) {
+                        writeVarint(section, zigzag(static_cast<long long>(static_cast<unsigned long long>(value) -
+                                                                           static_cast<unsigned long long>(previous))));
+                        previous = value;
+                    }
+                    break;
+                }
+                case ColumnValueKind::FLOATING:
+                    encodeXor(floats, section);
+                    break;
+                case ColumnValueKind::TEXT:
+                    encodeDictionary(texts, section);
+                    break;
+            }
+            appendSection(out, section);
+            summary.size = out.size();
+        }
+
+
+        void ColumnBlock::decode(const char* data, size_t size) {
+            clear();
+            const char* pos = data;
+            const char* end = data + size;
+            if (size < sizeof(k_blockMagic)) throw KARABO_IO_EXCEPTION("Column block too short");
+            if (std::memcmp(pos, k_blockMagic, sizeof(k_blockMagic)) != 0) {
+                throw KARABO_IO_EXCEPTION("Column block lacks magic marker");
+            }
+            pos += sizeof(k_blockMagic);
+
+            const unsigned long long num = readVarint(pos, end);
+            if (pos >= end || static_cast<unsigned char>(*pos) > static_cast<unsigned char>(ColumnValueKind::TEXT)) {
+                throw KARABO_IO_EXCEPTION("Corrupted column block kind");
+            }
+            kind = static_cast<ColumnValueKind>(*pos++);
+            const char* typeEnd = sectionEnd(pos, end);
+            type.assign(pos, typeEnd);
+            pos = typeEnd;
+
+            const char* timesEnd = sectionEnd(pos, end);
+            decodeDeltaOfDelta(pos, timesEnd, num, times);
+            pos = timesEnd;
+
+            const char* trainIdsEnd = sectionEnd(pos, end);
+            decodeDeltaOfDelta(pos, trainIdsEnd, num, trainIds);
+            pos = trainIdsEnd;
+
+            const char* loginsEnd = sectionEnd(pos, end);
+            logins.assign(num, 0);
+            const unsigned long long numLogins = readVarint(pos, loginsEnd);
+            for (unsigned long long i = 0, index = 0; i < numLogins; ++i) {
+                index += readVarint(pos, loginsEnd);
+                if (index >= num) throw KARABO_IO_EXCEPTION("Corrupted login column");
+                logins[index] = 1;
+            }
+            pos = loginsEnd;
+
+            const char* valuesEnd = sectionEnd(pos, end);
+            switch (kind) {
+                case ColumnValueKind::INTEGER: {
+                    integers.resize(num);
+                    unsigned long long previous = 0ull;
+                    for (size_t i = 0; i < num; ++i) {
+                        previous += static_cast<unsigned long long>(unzigzag(readVarint(pos, valuesEnd)));
+                        integers[i] = static_cast<long long>(previous);
+                    }
+                    break;
+                }
+                case ColumnValueKind::FLOATING:
+                    decodeXor(pos, valuesEnd, num, floats);
+                    break;
+                case ColumnValueKind::TEXT:
+                    decodeDictionary(pos, valuesEnd, num, texts);
+                    break;
+            }
+        }
+
+
+        ColumnValueKind columnValueKindOf(Types::ReferenceType type) {
+            switch (type) {
+                case Types::BOOL:
+                case Types::INT8:
+                case Types::UINT8:
+                case Types::INT16:
+                case Types::UINT16:
+                case Types::INT32:
+                case Types::UINT32:
+                case Types::INT64:
+                case Types::UINT64:
+                    return ColumnValueKind::INTEGER;
+                case Types::FLOAT:
+                case Types::DOUBLE:
+                    return ColumnValueKind::FLOATING;
+                default:
+                    return ColumnValueKind::TEXT;
+            }
+        }
+
+
+        long long toColumnTime(const karabo::data::Epochstamp& stamp) {
+            return static_cast<long long>(stamp.getSeconds() * 1000000ull +
+                                          stamp.getFractionalSeconds() / 1000000000000ull);
+        }
+
+
+        karabo::data::Epochstamp fromColumnTime(long long time) {
+            const unsigned long long us = static_cast<unsigned long long>(time);
+            return karabo::data::Epochstamp(us / 1000000ull, (us % 1000000ull) * 1000000000000ull);
+        }
+
+
+        Hash::Node& setColumnValue(Hash& hash, const std::string& path, Types::ReferenceType type,
+                                   unsigned long long raw) {
+            const long long integer = static_cast<long long>(raw);
+            double floating;
+            std::memcpy(&floating, &raw, sizeof(floating));
+            switch (type) {
+                case Types::BOOL:
+                    return hash.set(path, integer != 0ll);
+                case Types::INT8:
+                    return hash.set(path, static_cast<signed char>(integer));
+                case Types::UINT8:
+                    return hash.set(path, static_cast<unsigned char>(integer));
+                case Types::INT16:
+                    return hash.set(path, static_cast<short>(integer));
+                case Types::UINT16:
+                    return hash.set(path, static_cast<unsigned short>(integer));
+                case Types::INT32:
+                    return hash.set(path, static_cast<int>(integer));
+                case Types::UINT32:
+                    return hash.set(path, static_cast<unsigned int>(integer));
+                case Types::INT64:
+                    return hash.set(path, integer);
+                case Types::UINT64:
+                    return hash.set(path, raw);
+                case Types::FLOAT:
+                    return hash.set(path, static_cast<float>(floating));
+                case Types::DOUBLE:
+                    return hash.set(path, floating);
+                default:
+                    throw KARABO_PARAMETER_EXCEPTION("Type " + karabo::data::toString(static_cast<int>(type)) +
+                                                     " is not stored binary in column archive");
+            }
+        }
+
+
+        ColumnArchiveWriter::ColumnArchiveWriter(const std::string& directory, unsigned int maxRecordsPerBlock)
+            : m_directory(directory), m_maxRecordsPerBlock(std::max(1u, maxRecordsPerBlock)), m_pendingChanged(false) {
+            std::filesystem::create_directories(m_directory);
+            // Continue the blocks that were not yet full when the previous writer stopped
+            const std::string pendingFile(m_directory + "/" + k_pendingFile);
+            if (readFile(pendingFile, m_buffer)) {
+                forEachPending(m_buffer, pendingFile,
+                               [this](const std::string& path, unsigned long long numBlocks,
+                                      const ColumnBlockSummary& summary, const char* data) {
+                                   Column& col = column(path);
+                                   // Outdated if the block was written after the pending file
+                                   if (col.numBlocks == numBlocks) col.block.decode(data, summary.size);
+                               });
+            }
+        }
+
+
+        ColumnArchiveWriter::~ColumnArchiveWriter() {}
+
+
+        void ColumnArchiveWriter::append(const std::string& path, const karabo::data::Timestamp& stamp,
+                                         const Hash::Node& node, const std::string& type,
+                                         const std::string& valueAsText, bool login) {
+            Column& col = column(path);
+            ColumnBlock& block = col.block;
+            const ColumnValueKind kind = columnValueKindOf(node.getType());
+            if (block.size() > 0 && (block.kind != kind || block.type != type)) {
+                // Schema changed the type - a block has a single type
+                writeBlock(path, col);
+            }
+            if (block.size() == 0) {
+                block.kind = kind;
+                block.type = type;
+            }
+            block.times.push_back(toColumnTime(stamp.getEpochstamp()));
+            block.trainIds.push_back(stamp.getTid());
+            block.logins.push_back(login ? 1 : 0);
+            switch (kind) {
+                case ColumnValueKind::INTEGER: {
+                    long long value = 0ll;
+                    switch (node.getType()) {
+                        case Types::BOOL:
+                            value = node.getValue<bool>();
+                            break;
+                        case Types::INT8:
+                            value = node.getValue<signed char>();
+                            break;
+                        case Types::UINT8:
+                            value = node.getValue<unsigned char>();
+                            break;
+                        case Types::INT16:
+                            value = node.getValue<short>();
+                            break;
+                        case Types::UINT16:
+                            value = node.getValue<unsigned short>();
+                            break;
+                        case Types::INT32:
+                            value = node.getValue<int>();
+                            break;
+                        case Types::UINT32:
+                            value = node.getValue<unsigned int>();
+                            break;
+                        case Types::INT64:
+                            value = node.getValue<long long>();
+                            break;
+                        default: // i.e. UINT64
+                            value = static_cast<long long>(node.getValue<unsigned long long>());
+                    }
+                    block.integers.push_back(value);
+                    break;
+                }
+                case ColumnValueKind::FLOATING:
+                    block.floats.push_back(node.getType() == Types::FLOAT ? node.getValue<float>()
+                                                                          : node.getValue<double>());
+                    break;
+                case ColumnValueKind::TEXT:
+                    block.texts.push_back(valueAsText);
+                    break;
+            }
+            m_pendingChanged = true;
+            if (block.size() >= m_maxRecordsPerBlock) {
+                writeBlock(path, col);
+            }
+        }
+
+
+        void ColumnArchiveWriter::flush() {
+            if (!m_pendingChanged) return;
+
+            m_buffer = fileHeader(k_pendingMagic);
+            std::string encoded;
+            for (auto& pathColumn : m_columns) {
+                const Column& col = pathColumn.second;
+                if (col.block.size() == 0) continue;
+                ColumnBlockSummary summary;
+                col.block.encode(encoded, summary);
+                summary.offset = ColumnBlockSummary::PENDING;
+                appendSection(m_buffer, pathColumn.first);
+                writeVarint(m_buffer, col.numBlocks);
+                appendSummary(m_buffer, summary);
+                m_buffer.append(encoded);
+            }
+            // Replace the file as a whole, so readers never see it incomplete
+            const std::string pendingFile(m_directory + "/" + k_pendingFile);
+            const std::string tmpFile(pendingFile + ".tmp");
+            std::ofstream out(tmpFile, std::ios::out | std::ios::trunc | std::ios::binary);
+            out.write(m_buffer.data(), m_buffer.size());
+            out.close();
+            if (!out) {
+                throw KARABO_IO_EXCEPTION("Failed to write \"" + tmpFile + "\"");
+            }
+            std::filesystem::rename(tmpFile, pendingFile);
+            m_pendingChanged = false;
+        }
+
+
+        ColumnArchiveWriter::Column& ColumnArchiveWriter::column(const std::string& path) {
+            auto it = m_columns.find(path);
+            if (it != m_columns.end()) return it->second;
+
+            Column& col = m_columns[path];
+            try {
+                const std::string base(m_directory + "/" + path);
+                col.dataSize = openColumnFile(base + ".col", k_dataMagic, 0, col.data);
+                const unsigned long long indexSize =
+                      openColumnFile(base + ".cidx", k_indexMagic, k_summarySize, col.index);
+                col.numBlocks = (indexSize - k_headerSize) / k_summarySize;
+            } catch (...) {
+                m_columns.erase(path);
+                throw;
+            }
+            return col;
+        }
+
+
+        void ColumnArchiveWriter::writeBlock(const std::string& path, Column& col) {
+            ColumnBlockSummary summary;
+            col.block.encode(m_buffer, summary);
+            col.block.clear();
+            m_pendingChanged = true; // the pending file may still contain the records of the block
+
+            const std::string base(m_directory + "/" + path);
+            summary.offset = col.dataSize;
+            if (!col.data.write(m_buffer.data(), m_buffer.size()).flush()) {
+                // Continue with the next block behind whatever made it to the file
+                col.data.clear();
+                std::error_code ec;
+                col.dataSize = std::filesystem::file_size(base + ".col", ec);
+                throw KARABO_IO_EXCEPTION("Failed to write block to \"" + base + ".col\"");
+            }
+            col.dataSize += m_buffer.size();
+
+            // Write summary only after the data is complete, so readers never see incomplete blocks
+            m_buffer.clear();
+            appendSummary(m_buffer, summary);
+            if (!col.index.write(m_buffer.data(), m_buffer.size()).flush()) {
+                // Remove any partially written summary
+                col.index.clear();
+                std::error_code ec;
+                std::filesystem::resize_file(base + ".cidx", k_headerSize + col.numBlocks * k_summarySize, ec);
+                throw KARABO_IO_EXCEPTION("Failed to write block summary to \"" + base + ".cidx\"");
+            }
+            ++col.numBlocks;
+        }
+
+
+        ColumnArchiveReader::ColumnArchiveReader(const std::string& directory, const std::string& path)
+            : m_path(path),
+              m_dataFile(directory + "/" + path + ".col"),
+              m_indexFile(directory + "/" + path + ".cidx"),
+              m_pendingFile(directory + "/" + k_pendingFile),
+              m_summariesRead(false) {}
+
+
+        bool ColumnArchiveReader::exists() const {
+            std::error_code ec;
+            return std::filesystem::exists(m_indexFile, ec) && std::filesystem::exists(m_dataFile, ec);
+        }
+
+
+        const std::vector<ColumnBlockSummary>& ColumnArchiveReader::summaries() {
+            if (!m_summariesRead) {
+                m_summariesRead = true;
+                // A header or summary that is just being written might be incomplete - stop there
+                if (readFile(m_indexFile, m_buffer) && m_buffer.size() >= k_headerSize) {
+                    checkHeader(m_buffer.data(), k_indexMagic, m_indexFile);
+                    for (size_t pos = k_headerSize; pos + k_summarySize <= m_buffer.size(); pos += k_summarySize) {
+                        m_summaries.push_back(readSummary(m_buffer.data() + pos));
+                    }
+                }
+                if (readFile(m_pendingFile, m_buffer)) {
+                    forEachPending(m_buffer, m_pendingFile,
+                                   [this](const std::string& path, unsigned long long numBlocks,
+                                          const ColumnBlockSummary& summary, const char* data) {
+                                       // Outdated if the block was written after the pending file
+                                       if (path == m_path && numBlocks == m_summaries.size()) {
+                                           m_summaries.push_back(summary);
+                                           m_pendingBlock.assign(data, summary.size);
+                                       }
+                                   });
+                }
+            }
+            return m_summaries;
+        }
+
+
+        void ColumnArchiveReader::read(const ColumnBlockSummary& summary, ColumnBlock& block) {
+            if (summary.offset == ColumnBlockSummary::PENDING) {
+                block.decode(m_pendingBlock.data(), m_pendingBlock.size());
+                return;
+            }
+            std::ifstream data(m_dataFile, std::ios::in | std::ios::binary);
+            data.seekg(summary.offset);
+            m_buffer.resize(summary.size);
+            if (!data.read(m_buffer.data(), summary.size)) {
+                throw KARABO_IO_EXCEPTION("Failed to read block at " + karabo::data::toString(summary.offset) +
+                                          " from \"" + m_dataFile + "\"");
+            }
+            block.decode(m_buffer.data(), m_buffer.size());
+        }
+
+    } // namespace util
+} // namespace karabo
@@ -0,0 +1,233 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_UTIL_COLUMNARCHIVE_HH
+#define KARABO_UTIL_COLUMNARCHIVE_HH
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "karabo/data/time/Epochstamp.hh"
+#include "karabo/data/time/Timestamp.hh"
+#include "karabo/data/types/Hash.hh"
+
+namespace karabo {
+    namespace util {
+
+        /**
+         * Encoding used for the value column of a block in the columnar data logger archive.
+         * Integral and floating point scalars are stored in their binary form, everything else
+         * (strings, vectors, tables, ...) in the same textual form as in the text archive.
+         */
+        enum class ColumnValueKind : unsigned char {
+
+            INTEGER = 0, /// bool and all signed/unsigned integer scalars, delta + zigzag + varint encoded
+            FLOATING,    /// float and double, XOR with previous value encoded
+            TEXT         /// anything else, dictionary encoded
+        };
+
+        /**
+         * Summary of one block of a property column, stored as fixed size little endian record (in the order of the
+         * members) in the '<property>.cidx' file.
+         *
+         * Times are in microseconds since the epoch. Values are raw 64 bits: two's complement integer for
+         * ColumnValueKind::INTEGER, IEEE double bits for ColumnValueKind::FLOATING and zero for ColumnValueKind::TEXT.
+         */
+        struct ColumnBlockSummary {
+            /// 'offset' of the block that is not yet full and thus not yet in the '<property>.col' file
+            static constexpr unsigned long long PENDING = ~0ull;
+
+            long long minTime;
+            long long maxTime;
+            unsigned long long offset; // position of the block in the '<property>.col' file or PENDING
+            unsigned long long minValue;
+            unsigned long long maxValue;
+            long long minValueTime;
+            long long maxValueTime;
+            unsigned long long minValueTrainId;
+            unsigned long long maxValueTrainId;
+            unsigned int size; // number of bytes of the block
+            unsigned int numRecords;
+            unsigned int numLogins; // number of records flagged as being logged at (re-)start of logging
+            unsigned char kind;     // a ColumnValueKind
+            unsigned char type;     // a karabo::data::Types::ReferenceType, except for ColumnValueKind::TEXT
+            unsigned char padding[2];
+
+            ColumnBlockSummary();
+        };
+
+        /**
+         * Content of one block of a property column, used both to accumulate data for writing and as result of
+         * decoding. Only one of 'integers', 'floats' and 'texts' is filled, according to 'kind'.
+         */
+        struct ColumnBlock {
+            ColumnValueKind kind;
+            std::string type; // type as in the text archive, e.g. "INT32" or "VECTOR_STRING_BASE64"
+            std::vector<long long> times;
+            std::vector<unsigned long long> trainIds;
+            std::vector<unsigned char> logins; // 1 for records flagged as login, 0 otherwise
+            std::vector<long long> integers;
+            std::vector<double> floats;
+            std::vector<std::string> texts;
+
+            ColumnBlock();
+
+            size_t size() const {
+                return times.size();
+            }
+
+            void clear();
+
+            /**
+             * Compress block content into a byte sequence and fill the summary (except 'offset')
+             */
+            void encode(std::string& out, ColumnBlockSummary& summary) const;
+
+            /**
+             * Decode byte sequence as created by 'encode', replacing current content
+             *
+             * @throw karabo::data::IOException if data is corrupted
+             */
+            void decode(const char* data, size_t size);
+        };
+
+        /// Value kind used to store data of the given type
+        ColumnValueKind columnValueKindOf(karabo::data::Types::ReferenceType type);
+
+        /// Microseconds since the epoch of the given Epochstamp
+        long long toColumnTime(const karabo::data::Epochstamp& stamp);
+
+        /// Epochstamp of the given microseconds since the epoch
+        karabo::data::Epochstamp fromColumnTime(long long time);
+
+        /**
+         * Place the binary column value 'raw' (as in ColumnBlockSummary) interpreted as 'type' at 'path' of 'hash'.
+         * Kind of 'type' must not be ColumnValueKind::TEXT.
+         *
+         * @return the node that was set
+         */
+        karabo::data::Hash::Node& setColumnValue(karabo::data::Hash& hash, const std::string& path,
+                                                 karabo::data::Types::ReferenceType type, unsigned long long raw);
+
+        /**
+         * @class ColumnArchiveWriter
+         * @brief Writes property updates of a single device into per-property column files.
+         *
+         * For each property there is a '<property>.col' file that is a sequence of compressed blocks and a
+         * '<property>.cidx' file with a ColumnBlockSummary per block, both starting with a format header. A block is
+         * written when it reaches the configured number of records or when the type of the property changes. The
+         * records of blocks that are not yet full are stored by flush() in a 'pending.cpend' file that readers take
+         * into account and from which a new writer continues these blocks.
+         *
+         * The column files of a property are kept open once the property got its first update.
+         * Not thread safe - FileDeviceData uses it only from its strand.
+         */
+        class ColumnArchiveWriter {
+           public:
+            /**
+             * @param directory where to put the column files
+             * @param maxRecordsPerBlock number of records after which a block is written
+             *
+             * @throw karabo::data::IOException if existing files in 'directory' are not in the expected format
+             */
+            ColumnArchiveWriter(const std::string& directory, unsigned int maxRecordsPerBlock);
+
+            ~ColumnArchiveWriter();
+
+            /**
+             * Add an update of a property
+             *
+             * @param path of the property
+             * @param stamp timestamp of the update
+             * @param node the node with the new value
+             * @param type type as in the text archive
+             * @param valueAsText value as in the text archive - only used if value kind of node is TEXT
+             * @param login whether this update is part of the configuration received when logging (re-)started
+             */
+            void append(const std::string& path, const karabo::data::Timestamp& stamp,
+                        const karabo::data::Hash::Node& node, const std::string& type, const std::string& valueAsText,
+                        bool login);
+
+            /// Store the records of all blocks that are not yet full
+            void flush();
+
+           private:
+            struct Column {
+                ColumnBlock block; // records not yet written
+                std::ofstream data;
+                std::ofstream index;
+                unsigned long long dataSize;
+                unsigned long long numBlocks;
+            };
+
+            /// Get the column of 'path', opening its files at first usage
+            Column& column(const std::string& path);
+
+            void writeBlock(const std::string& path, Column& column);
+
+            std::string m_directory;
+            unsigned int m_maxRecordsPerBlock;
+            std::map<std::string, Column> m_columns;
+            bool m_pendingChanged;
+            std::string m_buffer;
+        };
+
+        /**
+         * @class ColumnArchiveReader
+         * @brief Reads the column files of a single property as written by ColumnArchiveWriter
+         */
+        class ColumnArchiveReader {
+           public:
+            ColumnArchiveReader(const std::string& directory, const std::string& path);
+
+            /// Whether there is any data for the property
+            bool exists() const;
+
+            /**
+             * Read all block summaries, the last one may be for the block that is not yet full
+             *
+             * @throw karabo::data::IOException if the files are not in the expected format
+             */
+            const std::vector<ColumnBlockSummary>& summaries();
+
+            /**
+             * Read and decode a block
+             *
+             * @param summary the summary of the block as returned by summaries()
+             * @param block to be filled
+             */
+            void read(const ColumnBlockSummary& summary, ColumnBlock& block);
+
+           private:
+            std::string m_path;
+            std::string m_dataFile;
+            std::string m_indexFile;
+            std::string m_pendingFile;
+            bool m_summariesRead;
+            std::vector<ColumnBlockSummary> m_summaries;
+            std::string m_pendingBlock;
+            std::string m_buffer;
+        };
+
+    } // namespace util
+} // namespace karabo
+
+#endif /* KARABO_UTIL_COLUMNARCHIVE_HH */
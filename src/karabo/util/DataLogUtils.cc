@@ -71,42 +71,13 @@ namespace karabo {
         void getLeaves(const data::Hash& configuration, const data::Schema& schema, std::vector<std::string>& result,
                        const char separator) {
             if (configuration.empty() || schema.empty()) return;
-            getLeaves_r(configuration, schema, result, "", separator, false);
-        }
-
-
-        void getLeaves_r(const data::Hash& hash, const data::Schema& schema, std::vector<std::string>& result,
-                         std::string prefix, const char separator, const bool fullPaths) {
-            if (hash.empty()) {
-                return;
-            }
-
-            for (data::Hash::const_iterator it = hash.begin(); it != hash.end(); ++it) {
-                std::string currentKey = it->getKey();
-
-                if (!prefix.empty()) {
-                    char separators[] = {separator, 0};
-                    currentKey = prefix + separators + currentKey;
-                }
-                if (it->is<data::Hash>() &&
-                    (fullPaths || !it->hasAttribute(KARABO_HASH_CLASS_ID))) { // Recursion, but no hash sub classes
-                    getLeaves_r(it->getValue<data::Hash>(), schema, result, currentKey, separator, fullPaths);
-                } else if (it->is<std::vector<data::Hash>>()) { // Recursion for vector
-                    // if this is a LEAF then don't go to recurse further ... leaf!
-                    if (schema.has(currentKey) && schema.isLeaf(currentKey)) {
-                        result.push_back(currentKey);
-                    } else {
-                        for (size_t i = 0; i < it->getValue<std::vector<data::Hash>>().size(); ++i) {
-                            std::ostringstream os;
-                            os << currentKey << "[" << i << "]";
-                            getLeaves_r(it->getValue<std::vector<data::Hash>>().at(i), schema, result, os.str(),
-                                        separator, fullPaths);
-                        }
-                    }
-                } else {
-                    result.push_back(currentKey);
-                }
-            }
+            configuration.forEachLeaf(
+                  [&result](const std::string& path, const data::Hash::Node&) { result.push_back(path); },
+                  [&schema](const std::string& path, const data::Hash::Node&) {
+                      // if this is a LEAF then don't go to recurse further ... leaf!
+                      return schema.has(path) && schema.isLeaf(path);
+                  },
+                  separator);
         }
 
 
@@ -138,10 +138,6 @@ namespace karabo {
         void getLeaves(const karabo::data::Hash& configuration, const karabo::data::Schema& schema,
                        std::vector<std::string>& result, const char separator = karabo::data::Hash::k_defaultSep);
 
-        void getLeaves_r(const karabo::data::Hash& hash, const karabo::data::Schema& schema,
-                         std::vector<std::string>& result, std::string prefix, const char separator,
-                         const bool fullPaths);
-
         std::string toInfluxDurationUnit(const karabo::data::TIME_UNITS& karaboDurationUnit);
 
         std::string epochAsMicrosecString(const karabo::data::Epochstamp& ep);
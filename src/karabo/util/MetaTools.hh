@@ -28,6 +28,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <utility>
 
 
@@ -73,6 +74,13 @@ namespace karabo {
         struct is_virtual_base_of
             : std::conjunction<std::is_base_of<Base, Derived>, std::negation<can_static_cast<Base*, Derived*>>> {};
 
+        // Type trait to check whether a type is a std::tuple
+        template <typename T>
+        struct is_tuple : std::false_type {};
+
+        template <typename... Ts>
+        struct is_tuple<std::tuple<Ts...>> : std::true_type {};
+
         // if this is not a direct base a dynamic cast must be made
 
         template <>
@@ -26,6 +26,7 @@
 #define KARABO_XMS_HPP
 
 #include "xms/ImageData.hh"
+#include "xms/ImageReduction.hh"
 #include "xms/InputChannel.hh"
 #include "xms/OutputChannel.hh"
 #include "xms/SignalSlotable.hh"
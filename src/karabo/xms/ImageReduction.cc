@@ -0,0 +1,279 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "ImageReduction.hh"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio> // before jpeglib.h that needs FILE
+#include <cstdlib>
+#include <jpeglib.h>
+#include <tuple>
+
+#include "karabo/data/types/ByteSwap.hh"
+#include "karabo/data/types/Exception.hh"
+#include "karabo/data/types/NDArray.hh"
+#include "karabo/data/types/StringTools.hh"
+
+using karabo::data::Dims;
+using karabo::data::Hash;
+using karabo::data::NDArray;
+using karabo::data::Types;
+
+namespace karabo {
+    namespace xms {
+
+        namespace {
+
+            /**
+             * Number of channels per pixel for the encodings that are reduced, 0 for all others
+             */
+            unsigned int channelsPerPixel(Encoding encoding) {
+                switch (encoding) {
+                    case Encoding::GRAY:
+                        return 1u;
+                    case Encoding::RGB:
+                    case Encoding::BGR:
+                        return 3u;
+                    case Encoding::RGBA:
+                    case Encoding::BGRA:
+                        return 4u;
+                    default:
+                        return 0u;
+                }
+            }
+
+            template <typename T>
+            NDArray scaleTo8Bit(const NDArray& pixels, unsigned int shift) {
+                const T* in = pixels.getData<T>();
+                const size_t n = pixels.size();
+                NDArray result(pixels.getShape(), Types::UINT8);
+                unsigned char* out = result.getData<unsigned char>();
+                for (size_t i = 0; i < n; ++i) {
+                    // Negative values (of signed types) become 0
+                    const T value = std::max(in[i], T(0)) >> shift;
+                    out[i] = static_cast<unsigned char>(std::min(value, T(255)));
+                }
+                return result;
+            }
+
+            /**
+             * Scale integer values of more than 8 bits to 8 bits, assuming 'bitsPerValue' significant bits.
+             * Returns an empty NDArray if not applicable.
+             */
+            NDArray scaleTo8Bit(const NDArray& pixels, int bitsPerValue) {
+                const unsigned int shift = (bitsPerValue > 8 ? bitsPerValue - 8 : 0u);
+                switch (pixels.getType()) {
+                    case Types::UINT16:
+                        return scaleTo8Bit<unsigned short>(pixels, std::min(shift, 8u));
+                    case Types::INT16:
+                        return scaleTo8Bit<short>(pixels, std::min(shift, 7u));
+                    case Types::UINT32:
+                        return scaleTo8Bit<unsigned int>(pixels, std::min(shift, 24u));
+                    case Types::INT32:
+                        return scaleTo8Bit<int>(pixels, std::min(shift, 23u));
+                    default:
+                        return NDArray();
+                }
+            }
+
+            struct JpegErrorManager {
+                jpeg_error_mgr pub;
+                std::jmp_buf jump;
+                char message[JMSG_LENGTH_MAX];
+            };
+
+            /// Replaces the default error_exit of libjpeg that would terminate the process
+            void onJpegError(j_common_ptr cinfo) {
+                JpegErrorManager* err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+                (*cinfo->err->format_message)(cinfo, err->message);
+                std::longjmp(err->jump, 1);
+            }
+
+            // Size type of jpeg_mem_dest: 'unsigned long' in libjpeg-turbo, 'size_t' in IJG libjpeg 9
+            template <typename Size>
+            Size jpegMemSize(void (*)(j_compress_ptr, unsigned char**, Size*));
+            using JpegMemSize = decltype(jpegMemSize(&jpeg_mem_dest));
+        } // namespace
+
+
+        ImageReduction ImageReduction::fromHash(const karabo::data::Hash& hash) {
+            ImageReduction result;
+            if (hash.has("to8Bit")) result.to8Bit = hash.getAs<bool>("to8Bit");
+            if (hash.has("jpegQuality")) result.jpegQuality = hash.getAs<unsigned int>("jpegQuality");
+            if (result.jpegQuality > 100u) {
+                throw KARABO_PARAMETER_EXCEPTION("JPEG quality must not exceed 100, but is " +
+                                                 karabo::data::toString(result.jpegQuality));
+            }
+            return result;
+        }
+
+
+        bool ImageReduction::isNoop() const {
+            return (!to8Bit && jpegQuality == 0u);
+        }
+
+
+        bool ImageReduction::operator<(const ImageReduction& other) const {
+            return std::tie(to8Bit, jpegQuality) < std::tie(other.to8Bit, other.jpegQuality);
+        }
+
+
+        ImageData reduceImage(const ImageData& image, const ImageReduction& reduction) {
+            const Encoding encoding = image.getEncoding();
+            const unsigned int channels = channelsPerPixel(encoding);
+            const NDArray& pixels = image.getData();
+            const Dims shape = pixels.getShape();
+            if (channels == 0u || shape.rank() < 2 || shape.rank() > 3 ||
+                pixels.isBigEndian() != karabo::data::isBigEndian()) {
+                return image;
+            }
+            // Rows, columns and (interleaved) values per pixel, e.g. colour channels or a stack of gray images
+            const size_t height = shape.x1();
+            const size_t width = shape.x2();
+            const size_t depth = (shape.rank() == 3 ? shape.x3() : 1ul);
+            if (height == 0ul || width == 0ul || depth == 0ul) return image;
+
+            NDArray reduced(pixels);
+            int bitsPerPixel = image.getBitsPerPixel();
+            if (reduction.to8Bit) {
+                const int valuesPerPixel = (encoding == Encoding::GRAY ? 1 : static_cast<int>(channels));
+                NDArray scaled = scaleTo8Bit(reduced, bitsPerPixel / valuesPerPixel);
+                if (scaled.size() > 0ul) {
+                    reduced = scaled;
+                    bitsPerPixel = 8 * valuesPerPixel;
+                }
+            }
+
+            const bool canCompress = (depth == channels && (channels == 1u || channels >= 3u));
+            if (reduction.jpegQuality > 0u && reduced.getType() == Types::UINT8 && canCompress &&
+                height <= 65535ul && width <= 65535ul) {
+                const unsigned int outHeight = height;
+                const unsigned int outWidth = width;
+                const unsigned char* in = reduced.getData<unsigned char>();
+                std::vector<unsigned char> rgb;
+                unsigned int jpegChannels = 1u;
+                if (channels >= 3u) {
+                    // JPEG wants RGB: reorder BGR and drop alpha
+                    jpegChannels = 3u;
+                    const bool bgr = (encoding == Encoding::BGR || encoding == Encoding::BGRA);
+                    const size_t numPixels = height * width;
+                    rgb.resize(numPixels * 3ul);
+                    for (size_t i = 0; i < numPixels; ++i) {
+                        const unsigned char* src = in + i * channels;
+                        rgb[3 * i] = src[bgr ? 2 : 0];
+                        rgb[3 * i + 1] = src[1];
+                        rgb[3 * i + 2] = src[bgr ? 0 : 2];
+                    }
+                    in = rgb.data();
+                }
+                const std::vector<unsigned char> jpeg =
+                      encodeJpeg(in, outWidth, outHeight, jpegChannels, reduction.jpegQuality);
+                const Dims dims(jpegChannels == 3u ? Dims(outHeight, outWidth, 3ull) : Dims(outHeight, outWidth));
+                ImageData result(NDArray(jpeg.data(), jpeg.size()), dims, Encoding::JPEG, 8 * jpegChannels);
+                std::vector<unsigned long long> binning(image.getBinning().toVector());
+                binning.resize(dims.rank(), 1ull);
+                result.setBinning(Dims(binning));
+                std::vector<unsigned long long> roiOffsets(image.getROIOffsets().toVector());
+                roiOffsets.resize(dims.rank(), 0ull);
+                result.setROIOffsets(Dims(roiOffsets));
+                result.setRotation(image.getRotation());
+                result.setFlipX(image.getFlipX());
+                result.setFlipY(image.getFlipY());
+                return result;
+            }
+
+            if (reduced.getType() == pixels.getType()) {
+                return image; // nothing done
+            }
+
+            ImageData result(reduced, shape, encoding, bitsPerPixel);
+            result.setBinning(image.getBinning());
+            result.setROIOffsets(image.getROIOffsets());
+            result.setRotation(image.getRotation());
+            result.setFlipX(image.getFlipX());
+            result.setFlipY(image.getFlipY());
+            return result;
+        }
+
+
+        size_t reduceImages(karabo::data::Hash& data, const ImageReduction& reduction) {
+            size_t result = 0ul;
+            for (Hash::Node& node : data) {
+                if (node.getType() != Types::HASH) continue;
+                const Hash::Attributes& attrs = node.getAttributes();
+                auto attrIt = attrs.find(KARABO_HASH_CLASS_ID);
+                if (attrIt == attrs.mend()) {
+                    result += reduceImages(node.getValue<Hash>(), reduction);
+                } else if (attrIt->second.getValue<std::string>() == ImageData::classInfo().getClassId()) {
+                    node.setValue(reduceImage(node.getValue<ImageData>(), reduction));
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+
+        std::vector<unsigned char> encodeJpeg(const unsigned char* pixels, unsigned int width, unsigned int height,
+                                              unsigned int channels, unsigned int quality) {
+            if (channels != 1u && channels != 3u) {
+                throw KARABO_PARAMETER_EXCEPTION("JPEG encoding needs 1 or 3 channels, not " +
+                                                 karabo::data::toString(channels));
+            }
+            if (width == 0u || height == 0u || width > 65535u || height > 65535u) {
+                throw KARABO_PARAMETER_EXCEPTION("JPEG encoding does not support image size " +
+                                                 karabo::data::toString(width) + " x " +
+                                                 karabo::data::toString(height));
+            }
+
+            // Only trivially destructible objects may live between setjmp and a longjmp from onJpegError
+            jpeg_compress_struct cinfo;
+            JpegErrorManager jerr;
+            cinfo.err = jpeg_std_error(&jerr.pub);
+            jerr.pub.error_exit = onJpegError;
+            unsigned char* buffer = nullptr;
+            JpegMemSize bufferSize = 0;
+            if (setjmp(jerr.jump)) {
+                jpeg_destroy_compress(&cinfo);
+                std::free(buffer);
+                throw KARABO_IO_EXCEPTION(std::string("JPEG encoding failed: ") + jerr.message);
+            }
+            jpeg_create_compress(&cinfo);
+            jpeg_mem_dest(&cinfo, &buffer, &bufferSize);
+            cinfo.image_width = width;
+            cinfo.image_height = height;
+            cinfo.input_components = static_cast<int>(channels);
+            cinfo.in_color_space = (channels == 3u ? JCS_RGB : JCS_GRAYSCALE);
+            jpeg_set_defaults(&cinfo);
+            jpeg_set_quality(&cinfo, static_cast<int>(std::clamp(quality, 1u, 100u)), TRUE);
+            jpeg_start_compress(&cinfo, TRUE);
+            const size_t rowSize = static_cast<size_t>(width) * channels;
+            while (cinfo.next_scanline < cinfo.image_height) {
+                // libjpeg does not modify the input, but its API is not const correct
+                JSAMPROW row = const_cast<unsigned char*>(pixels + cinfo.next_scanline * rowSize);
+                jpeg_write_scanlines(&cinfo, &row, 1);
+            }
+            jpeg_finish_compress(&cinfo);
+            jpeg_destroy_compress(&cinfo);
+
+            std::vector<unsigned char> out(buffer, buffer + bufferSize);
+            std::free(buffer);
+            return out;
+        }
+    } // namespace xms
+} // namespace karabo
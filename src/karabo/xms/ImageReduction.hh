@@ -0,0 +1,94 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_XMS_IMAGEREDUCTION_HH
+#define KARABO_XMS_IMAGEREDUCTION_HH
+
+#include <string>
+#include <vector>
+
+#include "ImageData.hh"
+#include "karabo/data/types/Hash.hh"
+
+namespace karabo {
+    namespace xms {
+
+        /**
+         * @class ImageReduction
+         * @brief Description how to reduce ImageData for display, e.g. before sending it to GUI clients
+         *
+         * The reduction steps are (each optional):
+         * - scale integer pixel values of more than 8 bits to 8 bits,
+         * - compress 8 bit GRAY, RGB(A) or BGR(A) images with JPEG, as GUI clients can decode it.
+         */
+        struct ImageReduction {
+            /// If true, scale integer pixel values down to 8 bits according to the bits per pixel
+            bool to8Bit = false;
+            /// JPEG quality 1 - 100, 0 means no compression
+            unsigned int jpegQuality = 0u;
+
+            /**
+             * Create from a Hash with (all optional) keys as the members, as e.g. sent by the GUI client.
+             * Throws a ParameterException if jpegQuality is above 100.
+             */
+            static ImageReduction fromHash(const karabo::data::Hash& hash);
+
+            /// True if nothing is to be done
+            bool isNoop() const;
+
+            bool operator<(const ImageReduction& other) const;
+        };
+
+        /**
+         * Reduce an image
+         *
+         * Images with a non-indexable encoding (e.g. JPEG or Bayer) or with less than two dimensions are returned
+         * unchanged. Also the scaling to 8 bits and the compression are skipped if they are not applicable.
+         *
+         * @param image to reduce
+         * @param reduction what to do
+         * @return the reduced image, sharing the pixel data with 'image' if nothing was done
+         */
+        ImageData reduceImage(const ImageData& image, const ImageReduction& reduction);
+
+        /**
+         * Replace all ImageData (also in nested Hashes) by their reduced versions
+         *
+         * @param data Hash, e.g. as received by an InputChannel
+         * @param reduction what to do
+         * @return number of images that were replaced
+         */
+        size_t reduceImages(karabo::data::Hash& data, const ImageReduction& reduction);
+
+        /**
+         * Compress 8 bit image data with baseline JPEG (JFIF) using libjpeg
+         *
+         * @param pixels row by row, channels interleaved
+         * @param width of the image, at most 65535
+         * @param height of the image, at most 65535
+         * @param channels 1 for gray, 3 for RGB
+         * @param quality 1 (worst) to 100 (best)
+         * @return the JPEG stream
+         * @throw ParameterException for unsupported channels or size, IOException if libjpeg fails
+         */
+        std::vector<unsigned char> encodeJpeg(const unsigned char* pixels, unsigned int width, unsigned int height,
+                                              unsigned int channels, unsigned int quality);
+    } // namespace xms
+} // namespace karabo
+
+#endif
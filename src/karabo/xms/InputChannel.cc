@@ -26,9 +26,11 @@
 
 #include "InputChannel.hh"
 
+#include <algorithm>
 #include <boost/system/error_code.hpp>
 #include <chrono>
 
+#include "PayloadCompression.hh"
 #include "karabo/data/schema/SimpleElement.hh"
 #include "karabo/data/schema/VectorElement.hh"
 #include "karabo/net/EventLoop.hh"
@@ -53,6 +55,9 @@ namespace karabo {
 
         const unsigned int InputChannel::DEFAULT_MAX_QUEUE_LENGTH = 2u;
 
+        // Upper limit of the adaptive credit window - limits the memory taken by chunks in flight
+        static const unsigned int kMaxAdaptiveCreditWindow = 8u;
+
         void InputChannel::expectedParameters(karabo::data::Schema& expected) {
             using namespace karabo::data;
 
@@ -138,6 +143,101 @@ namespace karabo {
                   .metricPrefix(MetricPrefix::MILLI)
                   .init()
                   .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("creditWindow")
+                  .displayedName("Credit Window")
+                  .description(
+                        "Number of data packets a connected output channel may send without waiting for this input "
+                        "to ask for more. Larger windows hide the latency of slow network links, but need more "
+                        "memory. 0 means to adapt to the round trip time of the connection and the time needed to "
+                        "process the data (up to " +
+                        toString(kMaxAdaptiveCreditWindow) + ").")
+                  .assignmentOptional()
+                  .defaultValue(0u)
+                  .maxInc(64u)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("sharedMemorySize")
+                  .displayedName("Shared Memory Size")
+                  .description(
+                        "Size of the shared memory offered to each connected output channel that runs in another "
+                        "process on the same host. Large arrays are then passed via this memory instead of the "
+                        "network stack - as long as they fit. 0 means to use the network stack only.")
+                  .unit(Unit::BYTE)
+                  .metricPrefix(MetricPrefix::MEGA)
+                  .assignmentOptional()
+                  .defaultValue(0u)
+                  .maxInc(4096u)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
+            BOOL_ELEMENT(expected)
+                  .key("pooledReceive")
+                  .displayedName("Pooled Receive")
+                  .description(
+                        "If true, the array data of each message received via the network is read into one buffer "
+                        "from the process wide buffer pool. That buffer is only recycled once all arrays of the "
+                        "message are released, so keeping a single array alive keeps the whole message in memory.")
+                  .assignmentOptional()
+                  .defaultValue(false)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
+            VECTOR_STRING_ELEMENT(expected)
+                  .key("alignedSources")
+                  .displayedName("Aligned Sources")
+                  .description(
+                        "Sources (as in the meta data of the received data) for which a registered train handler "
+                        "gets the data of all these sources for the same train together")
+                  .assignmentOptional()
+                  .defaultValue(std::vector<std::string>())
+                  .init()
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("alignmentWindow")
+                  .displayedName("Alignment Window")
+                  .description(
+                        "Maximum number of trains waiting for data from all 'Aligned Sources' - if exceeded, the "
+                        "oldest train is given up as incomplete")
+                  .assignmentOptional()
+                  .defaultValue(16u)
+                  .minInc(1u)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("alignmentTimeout")
+                  .displayedName("Alignment Timeout")
+                  .description(
+                        "Maximum time to wait for data from all 'Aligned Sources' for a train - if exceeded, the "
+                        "train is given up as incomplete. 0 means no timeout.")
+                  .unit(Unit::SECOND)
+                  .metricPrefix(MetricPrefix::MILLI)
+                  .assignmentOptional()
+                  .defaultValue(1000u)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
+            STRING_ELEMENT(expected)
+                  .key("onIncompleteTrain")
+                  .displayedName("On Incomplete Train")
+                  .description(
+                        "What to do with a train that is given up before all 'Aligned Sources' have sent data for "
+                        "it: drop it or deliver what has arrived")
+                  .options(std::vector<std::string>({"drop", "deliver"}))
+                  .assignmentOptional()
+                  .defaultValue("drop")
+                  .init()
+                  .commit();
         }
 
 
@@ -146,9 +246,25 @@ namespace karabo {
               m_deadline(karabo::net::EventLoop::getIOService()),
               // "guaranteeToRun" = true to ensure handlers are all called under all circumstances
               m_connectStrand(Configurator<Strand>::create("Strand", Hash("guaranteeToRun", true))),
-              m_respondToEndOfStream(true) {
+              m_respondToEndOfStream(true),
+              m_creditWindow(0u),
+              m_serviceTime(0ull),
+              m_sharedMemorySize(0u),
+              m_pooledReceive(false),
+              m_alignmentTimer(karabo::net::EventLoop::getIOService()) {
             reconfigure(config, false);
 
+            if (config.has("alignedSources") && !config.get<std::vector<std::string>>("alignedSources").empty()) {
+                const unsigned int window =
+                      (config.has("alignmentWindow") ? config.get<unsigned int>("alignmentWindow") : 16u);
+                const unsigned int timeout =
+                      (config.has("alignmentTimeout") ? config.get<unsigned int>("alignmentTimeout") : 1000u);
+                const bool deliverIncomplete = (config.has("onIncompleteTrain") &&
+                                                config.get<std::string>("onIncompleteTrain") == "deliver");
+                m_trainAligner = std::make_unique<TrainAligner>(config.get<std::vector<std::string>>("alignedSources"),
+                                                                window, milliseconds(timeout), deliverIncomplete);
+            }
+
             m_channelId = Memory::registerChannel();
             m_inactiveChunk = Memory::registerChunk(m_channelId);
             m_activeChunk = Memory::registerChunk(m_channelId);
@@ -178,6 +294,9 @@ namespace karabo {
                 config.get("respondToEndOfStream", m_respondToEndOfStream);
             if (!allowMissing || config.has("delayOnInput")) config.get("delayOnInput", m_delayOnInput);
             if (!allowMissing || config.has("maxQueueLength")) config.get("maxQueueLength", m_maxQueueLength);
+            if (config.has("creditWindow")) config.get("creditWindow", m_creditWindow);
+            if (config.has("sharedMemorySize")) config.get("sharedMemorySize", m_sharedMemorySize);
+            if (config.has("pooledReceive")) config.get("pooledReceive", m_pooledReceive);
         }
 
 
@@ -206,6 +325,11 @@ namespace karabo {
         }
 
 
+        void InputChannel::registerTrainHandler(const TrainHandler& trainHandler) {
+            m_trainHandler = trainHandler;
+        }
+
+
         void InputChannel::registerConnectionTracker(const ConnectionTracker& tracker) {
             m_connectionTracker = tracker;
         }
@@ -214,10 +338,16 @@ namespace karabo {
         InputChannel::Handlers InputChannel::getRegisteredHandlers() const {
             Handlers handlers(m_dataHandler, m_endOfStreamHandler);
             handlers.inputHandler = m_inputHandler;
+            handlers.trainHandler = m_trainHandler;
             return handlers;
         }
 
 
+        karabo::data::Hash InputChannel::getTrainAlignmentStatistics() const {
+            return (m_trainAligner ? m_trainAligner->getStatistics() : Hash());
+        }
+
+
         size_t InputChannel::dataQuantityRead() {
             std::lock_guard<std::mutex> lock(m_outputChannelsMutex);
             size_t bytesRead = 0;
@@ -449,8 +579,8 @@ namespace karabo {
               const karabo::data::Hash& outputChannelInfo) const {
             const std::string& hostname = outputChannelInfo.get<std::string>("hostname");
             const unsigned int& port = outputChannelInfo.get<unsigned int>("port");
-            karabo::data::Hash h("Tcp",
-                                 Hash("type", "client", "hostname", hostname, "port", port, "keepalive.enabled", true));
+            karabo::data::Hash h("Tcp", Hash("type", "client", "hostname", hostname, "port", port, "keepalive.enabled",
+                                             true, "pooledReceive", m_pooledReceive));
             return h;
         }
 
@@ -484,14 +614,42 @@ namespace karabo {
             std::lock_guard<std::mutex> lock(m_outputChannelsMutex);
             if (!ec) { // succeeded so far
                 try {
+                    Hash hello("reason", "hello", "instanceId", this->getInstanceId(), "memoryLocation",
+                               outputChannelInfo.get<std::string>("memoryLocation"), "dataDistribution",
+                               m_dataDistribution, "onSlowness", m_onSlowness, "maxQueueLength", m_maxQueueLength);
+                    if (outputChannelInfo.has("creditFlowControl") &&
+                        outputChannelInfo.get<bool>("creditFlowControl")) {
+                        // Grant the initial window - before any data can arrive
+                        const unsigned int window = creditWindow(channel);
+                        {
+                            std::lock_guard<std::mutex> creditsLock(m_creditsMutex);
+                            m_credits[channel] = window;
+                        }
+                        hello.set("credit", window);
+                    }
+                    if (outputChannelInfo.get<std::string>("memoryLocation") == "remote") {
+                        // Whether data is compressed is up to the output
+                        hello.set("compression", "lz4");
+                    }
+                    if (m_sharedMemorySize > 0u && outputChannelInfo.get<std::string>("memoryLocation") == "remote" &&
+                        outputChannelInfo.has("sharedMemory") && outputChannelInfo.get<bool>("sharedMemory")) {
+                        // Offer shared memory - the output will use it if it can attach, i.e. is on the same host
+                        try {
+                            SharedMemoryRing::Pointer ring = SharedMemoryRing::create(m_sharedMemorySize * 1000000ul);
+                            hello.set("sharedMemory", Hash("name", ring->getName(), "nonce", ring->getNonce()));
+                            std::lock_guard<std::mutex> sharedMemoryLock(m_sharedMemoryMutex);
+                            m_sharedMemoryRings[channel] = ring;
+                        } catch (const std::exception& e) {
+                            KARABO_LOG_FRAMEWORK_WARN << getInstanceId()
+                                                      << ": cannot offer shared memory, receive all via tcp: "
+                                                      << e.what();
+                        }
+                    }
                     channel->readAsyncHashVectorBufferSetPointer(
                           util::bind_weak(&karabo::xms::InputChannel::onTcpChannelRead, this, _1,
                                           net::Channel::WeakPointer(channel), _2, _3));
                     // synchronous write could throw if connection already broken again
-                    channel->write(karabo::data::Hash(
-                          "reason", "hello", "instanceId", this->getInstanceId(), "memoryLocation",
-                          outputChannelInfo.get<std::string>("memoryLocation"), "dataDistribution", m_dataDistribution,
-                          "onSlowness", m_onSlowness, "maxQueueLength", m_maxQueueLength)); // Say hello!
+                    channel->write(hello); // Say hello!
                 } catch (const std::exception& e) {
                     KARABO_LOG_FRAMEWORK_WARN << getInstanceId()
                                               << ": connecting failed while writing hello: " << e.what();
@@ -553,6 +711,29 @@ namespace karabo {
                 // handling
                 runEndOfStream = (!m_openConnections.empty() && m_eosChannels.size() == m_openConnections.size());
             }
+            {
+                std::lock_guard<std::mutex> creditsLock(m_creditsMutex);
+                for (auto it = m_credits.begin(); it != m_credits.end();) {
+                    net::Channel::Pointer ptr = it->first.lock();
+                    if (!ptr || ptr == channel) {
+                        it = m_credits.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            {
+                // Data already received from the ring stays valid since it keeps the ring alive
+                std::lock_guard<std::mutex> sharedMemoryLock(m_sharedMemoryMutex);
+                for (auto it = m_sharedMemoryRings.begin(); it != m_sharedMemoryRings.end();) {
+                    net::Channel::Pointer ptr = it->first.lock();
+                    if (!ptr || ptr == channel) {
+                        it = m_sharedMemoryRings.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
 
             if (runEndOfStream) {
                 std::lock_guard<std::mutex> twoPotsLock(m_twoPotsMutex);
@@ -611,6 +792,13 @@ namespace karabo {
             const std::string traceId("(" + boost::lexical_cast<std::string>(std::this_thread::get_id()) +
                                       ": onTcpChannelRead) ");
 
+            {
+                // Each chunk uses one credit
+                std::lock_guard<std::mutex> creditsLock(m_creditsMutex);
+                auto it = m_credits.find(channel);
+                if (it != m_credits.end() && it->second > 0u) --(it->second);
+            }
+
             try {
                 // The twoPotsLock has to be here before potentially assigning treatEndOfStream = true although it
                 // protects usually only m_[in]activeChunk: Otherwise, if receiving data from several output channels,
@@ -648,7 +836,15 @@ namespace karabo {
                     Memory::decrementChunkUsage(channelId, chunkId);
                 } else { // TCP data
                     KARABO_LOG_FRAMEWORK_TRACE << traceId << "Reading from remote memory (over tcp)";
-                    Memory::writeFromBuffers(data, header, m_channelId, m_inactiveChunk);
+                    std::vector<karabo::data::BufferSet::Pointer> decompressed;
+                    if (header.has("compression")) {
+                        decompressed = decompressBuffers(header.get<Hash>("compression"), data);
+                    }
+                    const auto& buffers = (header.has("compression") ? decompressed : data);
+                    if (header.has("sharedMemory")) {
+                        insertFromSharedMemory(channel, header.get<Hash>("sharedMemory"), buffers);
+                    }
+                    Memory::writeFromBuffers(buffers, header, m_channelId, m_inactiveChunk);
                 }
                 // Due to minData needs or multi-input, we may have a chunk marked as endOfStream that also contains
                 // data!
@@ -801,6 +997,7 @@ namespace karabo {
             }
 
             // Run handlers outside lock of m_twoPotsMutex, but be prepared for exceptions from external code
+            const auto handlersStart = steady_clock::now();
             try {
                 if (m_inputHandler && m_dataList.size() > 0) { // size could be zero if only endOfStream
                     KARABO_LOG_FRAMEWORK_TRACE << getInstanceId() << " Calling inputHandler";
@@ -817,14 +1014,32 @@ namespace karabo {
                         m_dataHandler(*(m_dataList[i]), m_metaDataList[i]);
                     }
                 }
+                if (m_trainAligner) {
+                    std::vector<TrainData> trains;
+                    for (size_t i = 0; i < m_dataList.size(); ++i) {
+                        m_trainAligner->add(m_dataList[i], m_metaDataList[i], trains);
+                    }
+                    if (treatEndOfStream) m_trainAligner->flush(trains);
+                    handleTrains(trains);
+                    armAlignmentTimer();
+                }
                 // endOfStream handling if required
                 if (treatEndOfStream && m_endOfStreamHandler && m_respondToEndOfStream) {
                     m_endOfStreamHandler(shared_from_this());
                 }
             } catch (const std::exception& e) {
-                KARABO_LOG_FRAMEWORK_ERROR << "Exception from input/data/endOfStream handler for instance '"
+                KARABO_LOG_FRAMEWORK_ERROR << "Exception from input/data/train/endOfStream handler for instance '"
                                            << m_instanceId << "': " << e.what();
             }
+            if (!m_dataList.empty()) {
+                // Keep track of the time needed per data item for the adaptive credit window (at least 1 ns to
+                // mark it measured)
+                const unsigned long long perItem = std::max(
+                      1ll, duration_cast<nanoseconds>(steady_clock::now() - handlersStart).count() /
+                                 static_cast<long long>(m_dataList.size()));
+                const unsigned long long average = m_serviceTime;
+                m_serviceTime = (average == 0ull ? perItem : (7ull * average + perItem) / 8ull);
+            }
             // Clear cached data - though m_inputhandler might have stored one Hash::Pointer somewhere.
             m_dataList.clear();
 
@@ -837,6 +1052,46 @@ namespace karabo {
         }
 
 
+        void InputChannel::handleTrains(std::vector<TrainData>& trains) {
+            if (!m_trainHandler) return;
+            KARABO_LOG_FRAMEWORK_TRACE << getInstanceId() << " Calling trainHandler: " << trains.size() << " trains";
+            for (const TrainData& train : trains) {
+                m_trainHandler(train);
+            }
+        }
+
+
+        void InputChannel::armAlignmentTimer() {
+            const steady_clock::time_point expiry = m_trainAligner->nextExpiry();
+            if (expiry == steady_clock::time_point::max()) {
+                m_alignmentTimer.cancel();
+            } else {
+                m_alignmentTimer.expires_at(expiry);
+                m_alignmentTimer.async_wait(util::bind_weak(&InputChannel::onAlignmentTimer, this, _1));
+            }
+        }
+
+
+        void InputChannel::onAlignmentTimer(const boost::system::error_code& ec) {
+            if (ec) return; // cancelled or re-armed
+            // Aligner is accessed on the strand only
+            m_strand->post(util::bind_weak(&InputChannel::expireTrains, this));
+        }
+
+
+        void InputChannel::expireTrains() {
+            std::vector<TrainData> trains;
+            m_trainAligner->expire(steady_clock::now(), trains);
+            try {
+                handleTrains(trains);
+            } catch (const std::exception& e) {
+                KARABO_LOG_FRAMEWORK_ERROR << "Exception from train handler for instance '" << m_instanceId
+                                           << "': " << e.what();
+            }
+            armAlignmentTimer();
+        }
+
+
         void InputChannel::deferredNotificationOfOutputChannelForPossibleRead(
               const karabo::net::Channel::WeakPointer& channelW) {
             const net::Channel::Pointer channel = channelW.lock();
@@ -847,7 +1102,7 @@ namespace karabo {
                                            << " is ready for next read.";
                 // write can fail if disconnected in wrong moment - but then channel should be closed afterwards:
                 try {
-                    channel->write(karabo::data::Hash("reason", "update", "instanceId", this->getInstanceId()));
+                    writeReadyForData(channel);
                 } catch (const std::exception& e) {
                     if (channel->isOpen()) {
                         KARABO_RETHROW_AS(KARABO_PROPAGATED_EXCEPTION("Channel still open!"));
@@ -892,7 +1147,7 @@ namespace karabo {
                 if (!channel) continue;
                 // write can fail if disconnected in wrong moment - but then channel should be closed afterwards:
                 try {
-                    channel->write(karabo::data::Hash("reason", "update", "instanceId", this->getInstanceId()));
+                    writeReadyForData(channel);
                 } catch (const std::exception& e) {
                     if (channel->isOpen()) {
                         // collect information propagate exception only after notifying all others
@@ -911,6 +1166,96 @@ namespace karabo {
         }
 
 
+        void InputChannel::writeReadyForData(const karabo::net::Channel::Pointer& channel) {
+            unsigned int credit = 0u;
+            {
+                std::unique_lock<std::mutex> creditsLock(m_creditsMutex);
+                auto it = m_credits.find(channel);
+                if (it == m_credits.end()) {
+                    creditsLock.unlock();
+                    channel->write(karabo::data::Hash("reason", "update", "instanceId", this->getInstanceId()));
+                    return;
+                }
+                creditsLock.unlock(); // creditWindow(..) asks the socket
+                const unsigned int window = creditWindow(channel);
+                creditsLock.lock();
+                // Channel might be gone meanwhile
+                it = m_credits.find(channel);
+                if (it == m_credits.end()) return;
+                unsigned int& outstanding = it->second;
+                // Refill window only once half of it is used to keep the number of messages low
+                if (window > outstanding && window - outstanding >= (window + 1u) / 2u) {
+                    credit = window - outstanding;
+                    outstanding = window;
+                }
+            }
+            if (credit > 0u) {
+                channel->write(
+                      karabo::data::Hash("reason", "credit", "instanceId", this->getInstanceId(), "credit", credit));
+            }
+        }
+
+
+        void InputChannel::insertFromSharedMemory(const karabo::net::Channel::WeakPointer& channel,
+                                                  const karabo::data::Hash& sharedMemory,
+                                                  const std::vector<karabo::data::BufferSet::Pointer>& data) {
+            SharedMemoryRing::Pointer ring;
+            {
+                std::lock_guard<std::mutex> sharedMemoryLock(m_sharedMemoryMutex);
+                auto it = m_sharedMemoryRings.find(channel);
+                if (it != m_sharedMemoryRings.end()) ring = it->second;
+            }
+            if (!ring) {
+                throw KARABO_LOGIC_EXCEPTION("Received data in shared memory, but none offered to that output");
+            }
+            const auto& items = sharedMemory.get<std::vector<unsigned int>>("item");
+            const auto& positions = sharedMemory.get<std::vector<unsigned int>>("position");
+            const auto& offsets = sharedMemory.get<std::vector<unsigned long long>>("offset");
+            const auto& sizes = sharedMemory.get<std::vector<unsigned long long>>("size");
+            // Regions that are not read stay in use forever and block the ring - so release them if we fail
+            auto releaseFrom = [&ring, &offsets, &sizes](size_t first) {
+                for (size_t i = first; i < std::min(offsets.size(), sizes.size()); ++i) {
+                    try {
+                        ring->read(offsets[i], sizes[i]); // pointer not kept, i.e. region released right away
+                    } catch (const std::exception&) {
+                        karabo::data::Exception::clearTrace(); // not a valid region, nothing to release
+                    }
+                }
+            };
+            if (positions.size() != items.size() || offsets.size() != items.size() || sizes.size() != items.size()) {
+                releaseFrom(0);
+                throw KARABO_LOGIC_EXCEPTION("Inconsistent shared memory description: " + toString(sharedMemory));
+            }
+            size_t firstUnread = 0; // regions before are released by the data or were invalid
+            try {
+                // Sorted by item and position, so inserting one after another restores the original order
+                for (size_t i = 0; i < items.size(); ++i) {
+                    if (items[i] >= data.size()) {
+                        throw KARABO_LOGIC_EXCEPTION("Shared memory array for item " + toString(items[i]) +
+                                                     ", but only " + toString(data.size()) + " received");
+                    }
+                    firstUnread = i + 1;
+                    data[items[i]]->insert(positions[i], ByteArray(ring->read(offsets[i], sizes[i]), sizes[i]));
+                }
+            } catch (...) {
+                releaseFrom(firstUnread);
+                throw;
+            }
+        }
+
+
+        unsigned int InputChannel::creditWindow(const karabo::net::Channel::Pointer& channel) const {
+            if (m_creditWindow > 0u) return m_creditWindow;
+
+            const unsigned long long serviceTime = m_serviceTime;
+            if (serviceTime == 0ull) return 1u; // nothing known yet
+            // Enough data in flight to keep the handlers busy while a request for more travels to the output
+            const unsigned long long roundTrip = 1000ull * channel->roundTripTime(); // micro to nano seconds
+            const unsigned long long window = (roundTrip + serviceTime - 1ull) / serviceTime;
+            return static_cast<unsigned int>(std::clamp(window, 1ull, 1ull * kMaxAdaptiveCreditWindow));
+        }
+
+
         void InputChannel::notifyOutputChannelsForPossibleRead() {
             if (m_delayOnInput <= 0) // no delay
                 deferredNotificationsOfOutputChannelsForPossibleRead();
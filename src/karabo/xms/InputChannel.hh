@@ -29,12 +29,16 @@
 
 #include <boost/asio.hpp>
 #include <boost/random/mersenne_twister.hpp>
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "Memory.hh"
+#include "SharedMemoryRing.hh"
+#include "TrainAligner.hh"
 #include "karabo/data/schema/NodeElement.hh"
 #include "karabo/data/types/Hash.hh"
 #include "karabo/net/Channel.hh"
@@ -79,6 +83,8 @@ namespace karabo {
             typedef Memory::MetaData MetaData;
             typedef std::function<void(const InputChannel::Pointer&)> InputHandler;
             typedef std::function<void(const karabo::data::Hash&, const MetaData&)> DataHandler;
+            typedef TrainAligner::TrainData TrainData;
+            typedef std::function<void(const TrainData&)> TrainHandler;
             using ConnectionTracker = std::function<void(const std::string&, net::ConnectionStatus)>;
 
             /**
@@ -104,6 +110,7 @@ namespace karabo {
                 DataHandler dataHandler;
                 InputHandler inputHandler;
                 InputHandler eosHandler;
+                TrainHandler trainHandler;
             };
 
             // Default maximum queue length on a connected output channel before
@@ -131,6 +138,9 @@ namespace karabo {
             // Callback on end-of-stream
             InputHandler m_endOfStreamHandler;
 
+            /// Callback on data of all "alignedSources" for a train
+            TrainHandler m_trainHandler;
+
             ConnectionTracker m_connectionTracker;
             karabo::net::Strand::Pointer m_connectStrand; // for handlers concerning connection setup/status
 
@@ -166,6 +176,33 @@ namespace karabo {
 
             int m_delayOnInput;
 
+            // Number of chunks an output channel may send ahead (credit), 0 means adapt to round trip time
+            unsigned int m_creditWindow;
+            // Per connection to an output channel that supports credit based flow control: the credit granted and
+            // not yet used - to be protected by m_creditsMutex
+            std::mutex m_creditsMutex;
+            std::map<karabo::net::Channel::WeakPointer, unsigned int,
+                     std::owner_less<karabo::net::Channel::WeakPointer>>
+                  m_credits;
+            // Average time the handlers need per data item (in nanoseconds, 0 if not yet measured)
+            std::atomic<unsigned long long> m_serviceTime;
+
+            // Size in MB of the shared memory ring offered to each connected output, 0 means not to offer any
+            unsigned int m_sharedMemorySize;
+            // Per connection to an output channel: the shared memory ring offered to it - to be protected by
+            // m_sharedMemoryMutex
+            std::mutex m_sharedMemoryMutex;
+            std::map<karabo::net::Channel::WeakPointer, SharedMemoryRing::Pointer,
+                     std::owner_less<karabo::net::Channel::WeakPointer>>
+                  m_sharedMemoryRings;
+
+            // Whether connections to remote outputs receive array data into one pooled buffer per message
+            bool m_pooledReceive;
+
+            // Groups data by train id if "alignedSources" are configured - to be used on m_strand only
+            std::unique_ptr<TrainAligner> m_trainAligner;
+            boost::asio::steady_timer m_alignmentTimer;
+
             std::vector<MetaData> m_metaDataList;
             std::vector<karabo::data::Hash::Pointer> m_dataList;
             std::multimap<std::string, unsigned int> m_sourceMap;
@@ -233,6 +270,21 @@ namespace karabo {
              */
             void registerEndOfStreamEventHandler(const InputHandler& endOfStreamEventHandler);
 
+            /**
+             * Register handler to be called with the data of all "alignedSources" of a train.
+             *
+             * Trains are handed over in increasing train id order, each Hash of a source is the same as given to a
+             * registered data handler, i.e. not copied. So a data handler must not alter the data if a train handler
+             * is registered as well. Trains that are given up as incomplete (see "onIncompleteTrain") are handed
+             * over with the data of the sources that have sent something.
+             * Without any "alignedSources", the handler is never called.
+             *
+             * Note: The internal variable that stores the handler is neither protected against concurrent calls
+             *       to getRegisteredHandlers() nor to concurrent usage of the handler when data arrives, i.e.
+             *       this registration must not be called if (being) connected to any output channel.
+             */
+            void registerTrainHandler(const TrainHandler& trainHandler);
+
             void registerConnectionTracker(const ConnectionTracker& tracker);
 
             /**
@@ -242,9 +294,32 @@ namespace karabo {
              */
             Handlers getRegisteredHandlers() const;
 
+            /**
+             * Statistics of the train alignment, see "alignedSources"
+             *
+             * @return Hash with keys "complete" and "incomplete" (number of trains), "late" (number of data items
+             *         arriving after their train was handled or given up) - all unsigned long long. Empty if no
+             *         "alignedSources" configured.
+             */
+            karabo::data::Hash getTrainAlignmentStatistics() const;
+
            private:
             void triggerIOEvent();
 
+            /**
+             * Call the train handler for trains that are ready - to be called on m_strand
+             */
+            void handleTrains(std::vector<TrainData>& trains);
+
+            /**
+             * (Re-)arm the timer that gives up incomplete trains that waited too long - to be called on m_strand
+             */
+            void armAlignmentTimer();
+
+            void onAlignmentTimer(const boost::system::error_code& ec);
+
+            void expireTrains();
+
            public:
             /**
              * Returns the number of bytes read since the last call of this method
@@ -435,6 +510,36 @@ namespace karabo {
 
             void deferredNotificationOfOutputChannelForPossibleRead(const karabo::net::Channel::WeakPointer& channel);
 
+            /**
+             * Tell the output channel behind 'channel' that we are ready for more data
+             *
+             * For outputs with credit based flow control, credit is granted to refill the window - but only if
+             * at least half of the window is used up. Otherwise an "update" is sent.
+             * Synchronous write, i.e. may throw.
+             */
+            void writeReadyForData(const karabo::net::Channel::Pointer& channel);
+
+            /**
+             * Number of chunks the output channel behind 'channel' may send ahead
+             *
+             * Either as configured or, in the adaptive case, as many as the handlers can process during one round
+             * trip of the connection.
+             */
+            unsigned int creditWindow(const karabo::net::Channel::Pointer& channel) const;
+
+            /**
+             * Put arrays that the output channel behind 'channel' has sent via shared memory back into the data
+             *
+             * @param channel the data came from
+             * @param sharedMemory description where the arrays are and where they belong to
+             * @param data as received over tcp, BufferSets get the arrays inserted
+             * Throws LogicException if the data does not fit to 'sharedMemory' or no shared memory is known for
+             * 'channel' - the regions not yet inserted into the data are released then.
+             */
+            void insertFromSharedMemory(const karabo::net::Channel::WeakPointer& channel,
+                                        const karabo::data::Hash& sharedMemory,
+                                        const std::vector<karabo::data::BufferSet::Pointer>& data);
+
             void disconnectAll();
 
             void prepareData();
@@ -59,6 +59,29 @@ namespace karabo {
         // initializeServerConnection(), so put 2000 here.
         const int kMaxServerInitializationAttempts = 2000;
 
+        // Arrays smaller than this are sent over tcp even if the input provides shared memory
+        const size_t kSharedMemoryMinSize = 4096ul;
+
+        // Arrays smaller than this are sent uncompressed even if compression is enabled for an input
+        const size_t kCompressionMinSize = 65536ul;
+
+        // Score of an input for a key in rendezvous hashing (splitmix64 finaliser on the combined hashes)
+        static unsigned long long rendezvousScore(size_t key, const std::string& inputId) {
+            unsigned long long x = key ^ (std::hash<std::string>()(inputId) * 0x9e3779b97f4a7c15ull);
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        // Whether the peer of a connection is on this host - in doubt it is
+        static bool isOnSameHost(const Channel::Pointer& channel) {
+            const Hash addresses = TcpChannel::getChannelInfo(std::static_pointer_cast<TcpChannel>(channel));
+            const std::string& remoteAddress = addresses.get<std::string>("remoteAddress");
+            boost::system::error_code ec;
+            const boost::asio::ip::address address = boost::asio::ip::make_address(remoteAddress, ec);
+            return (ec || address.is_loopback() || remoteAddress == addresses.get<std::string>("localAddress"));
+        }
+
         void OutputChannel::expectedParameters(karabo::data::Schema& expected) {
             using namespace karabo::data;
 
@@ -72,6 +95,63 @@ namespace karabo {
                   .init()
                   .commit();
 
+            STRING_ELEMENT(expected)
+                  .key("sharedDistribution")
+                  .displayedName("Shared Distribution")
+                  .description(
+                        "How data is distributed among share-input channels: 'loadBalanced' sends to whichever is "
+                        "ready, 'stickySource' and 'stickyTrain' always send data of the same source or train id, "
+                        "respectively, to the same input channel (as long as it is connected). Sticky modes decide "
+                        "by the first data item of an update. Ignored if a shared input selector is registered.")
+                  .options({"loadBalanced", "stickySource", "stickyTrain"})
+                  .assignmentOptional()
+                  .defaultValue("loadBalanced")
+                  .init()
+                  .commit();
+
+            STRING_ELEMENT(expected)
+                  .key("stickyFallback")
+                  .displayedName("Sticky Fallback")
+                  .description(
+                        "What to do in the sticky 'Shared Distribution' modes if the input channel for the data is "
+                        "not ready: 'none' treats it according to 'No Input (Shared)', 'nextReady' sends to the "
+                        "ready input channel that is next in line for the data.")
+                  .options(std::vector<std::string>({"none", "nextReady"}))
+                  .assignmentOptional()
+                  .defaultValue("none")
+                  .init()
+                  .commit();
+
+            STRING_ELEMENT(expected)
+                  .key("compression")
+                  .displayedName("Compression")
+                  .description(
+                        "Whether large arrays are compressed (LZ4) before being sent to connected input channels: "
+                        "'auto' compresses for input channels on other hosts only, 'always' also for those in other "
+                        "processes on the same host. Pays off for compressible data on network links slower than "
+                        "the compression (several hundred MB/s per sending thread).")
+                  .options(std::vector<std::string>({"off", "auto", "always"}))
+                  .assignmentOptional()
+                  .defaultValue("off")
+                  .init()
+                  .expertAccess()
+                  .commit();
+
+            UINT32_ELEMENT(expected)
+                  .key("compressionShuffle")
+                  .displayedName("Compression Shuffle")
+                  .description(
+                        "Element size of the arrays for byte shuffling before compression: 2 for 16 bit detector "
+                        "data, 4 for 32 bit data, etc. Shuffling groups the bytes by significance which usually "
+                        "makes typed arrays much more compressible. 1 means not to shuffle.")
+                  .unit(Unit::BYTE)
+                  .options(std::vector<unsigned int>({1u, 2u, 4u, 8u}))
+                  .assignmentOptional()
+                  .defaultValue(1u)
+                  .init()
+                  .expertAccess()
+                  .commit();
+
             STRING_ELEMENT(expected)
                   .key("hostname")
                   .displayedName("Hostname")
@@ -138,6 +218,13 @@ namespace karabo {
                   .readOnly()
                   .commit();
 
+            STRING_ELEMENT(columns)
+                  .key("compression")
+                  .displayedName("Compression")
+                  .description("Compression of large arrays sent to the input channel, empty if none")
+                  .readOnly()
+                  .commit();
+
             STRING_ELEMENT(columns)
                   .key("remoteAddress")
                   .displayedName("Remote IP")
@@ -212,6 +299,30 @@ namespace karabo {
                   .expertAccess()
                   .archivePolicy(Schema::NO_ARCHIVING)
                   .commit();
+
+            VECTOR_FLOAT_ELEMENT(expected)
+                  .key("compressionRatio")
+                  .displayedName("Compression ratio")
+                  .description(
+                        "Vector of the compression ratios so far per connection taken from 'connections' table, 0 if "
+                        "nothing is compressed for that connection.")
+                  .readOnly()
+                  .expertAccess()
+                  .archivePolicy(Schema::NO_ARCHIVING)
+                  .commit();
+
+            VECTOR_UINT64_ELEMENT(expected)
+                  .key("compressionTime")
+                  .displayedName("Compression time")
+                  .description(
+                        "Vector of the CPU time spent so far on compression per connection taken from 'connections' "
+                        "table.")
+                  .unit(Unit::SECOND)
+                  .metricPrefix(MetricPrefix::MICRO)
+                  .readOnly()
+                  .expertAccess()
+                  .archivePolicy(Schema::NO_ARCHIVING)
+                  .commit();
         }
 
 
@@ -224,10 +335,23 @@ namespace karabo {
               m_showConnectionsHandler([](const std::vector<Hash>&) {}),
               m_showStatisticsHandler(
                     [](const std::vector<unsigned long long>&, const std::vector<unsigned long long>&) {}),
+              m_showCompressionStatisticsHandler(
+                    [](const std::vector<float>&, const std::vector<unsigned long long>&) {}),
               m_connections(),
               m_updateDeadline(karabo::net::EventLoop::getIOService()),
               m_addedThreads(0) {
             config.get("noInputShared", m_onNoSharedInputChannelAvailable);
+            const std::string& sharedDistribution = config.get<std::string>("sharedDistribution");
+            if (sharedDistribution == "stickySource") {
+                m_sharedDistribution = SharedDistribution::STICKY_SOURCE;
+            } else if (sharedDistribution == "stickyTrain") {
+                m_sharedDistribution = SharedDistribution::STICKY_TRAIN;
+            } else {
+                m_sharedDistribution = SharedDistribution::LOAD_BALANCED;
+            }
+            m_stickyFallbackToNext = (config.get<std::string>("stickyFallback") == "nextReady");
+            config.get("compression", m_compression);
+            config.get("compressionShuffle", m_compressionShuffle);
             config.get("port", m_port);
             config.get("updatePeriod", m_period);
 
@@ -361,7 +485,8 @@ namespace karabo {
 
 
         karabo::data::Hash OutputChannel::getInformation() const {
-            return karabo::data::Hash("connectionType", "tcp", "hostname", m_hostname, "port", m_port);
+            return karabo::data::Hash("connectionType", "tcp", "hostname", m_hostname, "port", m_port,
+                                      "creditFlowControl", true, "sharedMemory", true);
         }
 
 
@@ -445,6 +570,10 @@ namespace karabo {
                  *     dataDistribution (std::string) [shared/copy]
                  *     onSlowness (std::string) [drop/queueDrop/wait]
                  *     maxQueueLength (unsigned int; when onSlowness is queueDrop)
+                 * and optionally
+                 *     credit (unsigned int; initial number of chunks the input can receive without "update")
+                 *     sharedMemory (Hash with name (std::string) and nonce (unsigned long long) of a SharedMemoryRing)
+                 *     compression (std::string; codec the input can decompress, i.e. lz4)
                  */
 
                 const std::string& instanceId = message.get<std::string>("instanceId");
@@ -466,6 +595,32 @@ namespace karabo {
                 info.set("bytesRead", 0ull);
                 info.set("bytesWritten", 0ull);
                 info.set("sendOngoing", false);
+                // The first credit is used by onInputAvailable below
+                const unsigned int credit = (message.has("credit") ? message.get<unsigned int>("credit") : 1u);
+                info.set("credit", credit > 0u ? credit - 1u : 0u);
+                if (memoryLocation == "remote" && message.has("sharedMemory")) {
+                    // Input offers shared memory - works only if it is on the same host, i.e. if attaching works
+                    const Hash& sharedMemory = message.get<Hash>("sharedMemory");
+                    const std::string& name = sharedMemory.get<std::string>("name");
+                    try {
+                        SharedMemoryRing::Pointer ring =
+                              SharedMemoryRing::attach(name, sharedMemory.get<unsigned long long>("nonce"));
+                        ring->unlink(); // Nobody else needs to attach, so no leftovers if processes crash
+                        info.set("sharedMemory", ring);
+                        KARABO_LOG_FRAMEWORK_INFO << getInstanceIdName() << ": send large arrays to '" << instanceId
+                                                  << "' via shared memory " << name;
+                    } catch (const std::exception& e) {
+                        KARABO_LOG_FRAMEWORK_DEBUG << getInstanceIdName() << ": no shared memory for '" << instanceId
+                                                   << "', send all via tcp: " << e.what();
+                    }
+                }
+                if (memoryLocation == "remote" && m_compression != "off" && !info.has("sharedMemory") &&
+                    message.has("compression") && message.get<std::string>("compression") == "lz4" &&
+                    (m_compression == "always" || !isOnSameHost(channel))) {
+                    info.set("compression", std::make_shared<CompressionStatistics>());
+                    KARABO_LOG_FRAMEWORK_INFO << getInstanceIdName() << ": send large arrays to '" << instanceId
+                                              << "' compressed";
+                }
 
                 {
                     std::lock_guard<std::mutex> lockShared(m_registeredInputsMutex);
@@ -495,6 +650,9 @@ namespace karabo {
                                                << instanceId << " has updated...";
                     onInputAvailable(instanceId);
                 }
+            } else if (reason == "credit") {
+                const std::string& instanceId = message.get<std::string>("instanceId");
+                onInputCredit(instanceId, message.get<unsigned int>("credit"));
             }
             if (channel->isOpen()) {
                 channel->readAsyncHash(
@@ -545,6 +703,7 @@ namespace karabo {
                 h.erase("weakChannel");
                 h.erase("bytesRead");
                 h.erase("bytesWritten");
+                h.erase("compressionStatistics");
             }
 
             return result;
@@ -571,6 +730,7 @@ namespace karabo {
                     row.set("memoryLocation", channelInfo.get<std::string>("memoryLocation"));
                     row.set("dataDistribution", "shared");
                     row.set("onSlowness", channelInfo.get<std::string>("onSlowness"));
+                    addCompressionColumns(channelInfo, row);
                     row.set("bytesRead", 0ull);
                     row.set("bytesWritten", 0ull);
                     row.set("weakChannel", wptr);
@@ -589,6 +749,7 @@ namespace karabo {
                     row.set("memoryLocation", channelInfo.get<std::string>("memoryLocation"));
                     row.set("dataDistribution", "copy");
                     row.set("onSlowness", channelInfo.get<std::string>("onSlowness"));
+                    addCompressionColumns(channelInfo, row);
                     row.set("bytesRead", 0ull);
                     row.set("bytesWritten", 0ull);
                     row.set("weakChannel", wptr);
@@ -601,6 +762,7 @@ namespace karabo {
                 h.erase("weakChannel");
                 h.erase("bytesRead");
                 h.erase("bytesWritten");
+                h.erase("compressionStatistics");
             }
             // Send filtered out table
             m_showConnectionsHandler(connections);
@@ -635,6 +797,19 @@ namespace karabo {
             }
             m_showStatisticsHandler(vBytesRead, vBytesWritten);
 
+            if (m_compression != "off") {
+                std::vector<float> vCompressionRatio(length, 0.f);
+                std::vector<unsigned long long> vCompressionTime(length, 0ull);
+                for (size_t i = 0; i < length; ++i) {
+                    const Hash& h = m_connections[i];
+                    if (!h.has("compressionStatistics")) continue;
+                    const auto& statistics = h.get<std::shared_ptr<CompressionStatistics>>("compressionStatistics");
+                    vCompressionRatio[i] = statistics->ratio();
+                    vCompressionTime[i] = statistics->cpuMicroseconds;
+                }
+                m_showCompressionStatisticsHandler(vCompressionRatio, vCompressionTime);
+            }
+
             m_updateDeadline.expires_after(seconds(m_period));
             m_updateDeadline.async_wait(
                   bind_weak(&OutputChannel::updateNetworkStatistics, this, boost::asio::placeholders::error));
@@ -740,6 +915,37 @@ namespace karabo {
         }
 
 
+        void OutputChannel::onInputCredit(const std::string& instanceId, unsigned int credit) {
+            if (credit == 0u) return;
+            {
+                std::lock_guard<std::mutex> lock(m_registeredInputsMutex);
+                Hash* channelInfo = nullptr;
+                bool ready = false;
+                auto itIdChannelInfo = m_registeredSharedInputs.find(instanceId);
+                if (itIdChannelInfo != m_registeredSharedInputs.end()) {
+                    channelInfo = &(itIdChannelInfo->second);
+                    ready = hasSharedInput(instanceId);
+                } else {
+                    itIdChannelInfo = m_registeredCopyInputs.find(instanceId);
+                    if (itIdChannelInfo != m_registeredCopyInputs.end()) {
+                        channelInfo = &(itIdChannelInfo->second);
+                        ready = (m_copyNext.find(instanceId) != m_copyNext.end());
+                    }
+                }
+                if (channelInfo) {
+                    unsigned int& storedCredit = channelInfo->get<unsigned int>("credit");
+                    if (ready || channelInfo->get<bool>("sendOngoing")) {
+                        // Input is served already - resetSendOngoing will use the credit when a send completes
+                        storedCredit += credit;
+                        return;
+                    }
+                    storedCredit += credit - 1u;
+                } // else onInputAvailable will complain
+            }
+            onInputAvailable(instanceId);
+        }
+
+
         void OutputChannel::onInputGone(const karabo::net::Channel::Pointer& channel,
                                         const karabo::net::ErrorCode& error) {
             using namespace karabo::net;
@@ -1129,6 +1335,8 @@ namespace karabo {
                     queue = asyncPrepareDistributeEos(chunkId, toSendImmediately, toQueue, toBlock);
                 } else if (m_sharedInputSelector) {
                     asyncPrepareDistributeSelected(chunkId, toSendImmediately, toQueue, toBlock);
+                } else if (m_sharedDistribution != SharedDistribution::LOAD_BALANCED) {
+                    asyncPrepareDistributeSticky(chunkId, toSendImmediately, toQueue, toBlock);
                 } else {
                     asyncPrepareDistributeLoadBal(chunkId, toSendImmediately, toQueue, toBlock, queue, block);
                 }
@@ -1185,6 +1393,47 @@ namespace karabo {
                                            << "' is not among shared inputs";
                 return;
             }
+            asyncPrepareDistributeTo(chunkId, itIdChannelInfo, toSendImmediately, toQueue, toBlock);
+        }
+
+
+        void OutputChannel::asyncPrepareDistributeSticky(unsigned int chunkId, std::vector<Hash*>& toSendImmediately,
+                                                         std::vector<Hash*>& toQueue, std::vector<Hash*>& toBlock) {
+            const std::vector<MetaData>& metaData = Memory::getMetaData(m_channelId, chunkId);
+            if (metaData.empty()) return; // Cannot happen: Only end-of-stream has no data and is treated elsewhere
+            const size_t key = (m_sharedDistribution == SharedDistribution::STICKY_SOURCE
+                                      ? std::hash<std::string>()(metaData.front().getSource())
+                                      : std::hash<unsigned long long>()(metaData.front().getTimestamp().getTid()));
+
+            // Rendezvous hashing: the input with the highest score for the key wins, the second highest is next
+            InputChannels::iterator itBest = m_registeredSharedInputs.end();
+            InputChannels::iterator itBestReady = m_registeredSharedInputs.end();
+            unsigned long long bestScore = 0ull;
+            unsigned long long bestReadyScore = 0ull;
+            for (auto it = m_registeredSharedInputs.begin(); it != m_registeredSharedInputs.end(); ++it) {
+                const unsigned long long score = rendezvousScore(key, it->first);
+                if (itBest == m_registeredSharedInputs.end() || score > bestScore) {
+                    itBest = it;
+                    bestScore = score;
+                }
+                if (m_stickyFallbackToNext && hasSharedInput(it->first) &&
+                    (itBestReady == m_registeredSharedInputs.end() || score > bestReadyScore)) {
+                    itBestReady = it;
+                    bestReadyScore = score;
+                }
+            }
+            if (itBestReady != m_registeredSharedInputs.end()) {
+                // The best one if that is ready, otherwise the ready one that is next in line
+                asyncPrepareDistributeTo(chunkId, itBestReady, toSendImmediately, toQueue, toBlock);
+            } else {
+                asyncPrepareDistributeTo(chunkId, itBest, toSendImmediately, toQueue, toBlock);
+            }
+        }
+
+
+        void OutputChannel::asyncPrepareDistributeTo(unsigned int chunkId, InputChannels::iterator itIdChannelInfo,
+                                                     std::vector<Hash*>& toSendImmediately,
+                                                     std::vector<Hash*>& toQueue, std::vector<Hash*>& toBlock) {
             karabo::data::Hash& channelInfo = itIdChannelInfo->second;
             const std::string& instanceId = itIdChannelInfo->first; // channelInfo.get<std::string>("instanceId");
 
@@ -1360,6 +1609,17 @@ namespace karabo {
                 m_showStatisticsHandler = handler;
             }
         }
+
+
+        void OutputChannel::registerShowCompressionStatisticsHandler(const ShowCompressionStatisticsHandler& handler) {
+            std::lock_guard<std::mutex> lock(m_showConnectionsHandlerMutex);
+            if (!handler) {
+                m_showCompressionStatisticsHandler = [](const std::vector<float>&,
+                                                        const std::vector<unsigned long long>&) {};
+            } else {
+                m_showCompressionStatisticsHandler = handler;
+            }
+        }
         void OutputChannel::registerSharedInputSelector(SharedInputSelector&& selector) {
             std::lock_guard<std::mutex> lock(m_registeredInputsMutex);
             m_sharedInputSelector = std::move(selector);
@@ -1375,13 +1635,17 @@ namespace karabo {
         void OutputChannel::resetSendOngoing(const std::string& instanceId) {
             std::lock_guard<std::mutex> lock(m_registeredInputsMutex);
             auto it = m_registeredCopyInputs.find(instanceId);
-            if (it != m_registeredCopyInputs.end()) {
-                it->second.set("sendOngoing", false);
-            } else {
+            if (it == m_registeredCopyInputs.end()) {
                 it = m_registeredSharedInputs.find(instanceId);
-                if (it != m_registeredSharedInputs.end()) {
-                    it->second.set("sendOngoing", false);
-                } // else: has disconnected!
+                if (it == m_registeredSharedInputs.end()) return; // has disconnected!
+            }
+            Hash& channelInfo = it->second;
+            channelInfo.set("sendOngoing", false);
+            // Input granted more than the chunk just sent: stream on without waiting for its next message
+            unsigned int& credit = channelInfo.get<unsigned int>("credit");
+            if (credit > 0u) {
+                --credit;
+                EventLoop::post(bind_weak(&OutputChannel::onInputAvailable, this, instanceId));
             }
         }
 
@@ -1405,8 +1669,14 @@ namespace karabo {
                     header.set("endOfStream", true);
                 }
                 std::vector<karabo::data::BufferSet::Pointer> data;
+                std::shared_ptr<CompressionStatistics> compression;
                 if (!isEos && !local) {
                     Memory::readIntoBuffers(data, header, m_channelId, chunkId); // Note: clears 'header'
+                    if (channelInfo.has("sharedMemory")) {
+                        moveToSharedMemory(channelInfo.get<SharedMemoryRing::Pointer>("sharedMemory"), data, header);
+                    } else if (channelInfo.has("compression")) {
+                        compression = channelInfo.get<std::shared_ptr<CompressionStatistics>>("compression");
+                    }
                 }
                 Channel::WriteCompleteHandler handler = [weakThis{weak_from_this()},
                                                          instanceId{channelInfo.get<std::string>("instanceId")},
@@ -1432,7 +1702,21 @@ namespace karabo {
                 // 2) Marking an input as available for more data is postponed in onInputAvailable for the case that
                 //    "sendOngoing" is still true. That ensures that writeAsyncHashVectorBufferSetPointer is not called
                 //    before a previous call for the same tcpChannel has completed.
-                tcpChannel->writeAsyncHashVectorBufferSetPointer(header, data, handler);
+                if (compression) {
+                    // Compression takes long for large data - do it on another thread than that serving the output
+                    EventLoop::post([tcpChannel, header{std::move(header)}, data{std::move(data)},
+                                     handler{std::move(handler)}, compression{std::move(compression)},
+                                     typeSize{m_compressionShuffle}]() mutable {
+                        try {
+                            compressBuffers(data, header, kCompressionMinSize, typeSize, *compression);
+                        } catch (const std::exception& e) {
+                            KARABO_LOG_FRAMEWORK_WARN << "Compression failed, send uncompressed: " << e.what();
+                        }
+                        tcpChannel->writeAsyncHashVectorBufferSetPointer(header, data, handler);
+                    });
+                } else {
+                    tcpChannel->writeAsyncHashVectorBufferSetPointer(header, data, handler);
+                }
             } else {
                 Memory::decrementChunkUsage(m_channelId, chunkId); // i.e. unregisterWriterFromChunk(chunkId);
                 KARABO_LOG_FRAMEWORK_WARN << "asyncSendOne failed - channel " << (tcpChannel ? "not open" : "gone");
@@ -1441,6 +1725,51 @@ namespace karabo {
         }
 
 
+        void OutputChannel::addCompressionColumns(const InputChannelInfo& channelInfo, karabo::data::Hash& row) const {
+            if (channelInfo.has("compression")) {
+                row.set("compression", (m_compressionShuffle > 1u ? "lz4, shuffle " + toString(m_compressionShuffle)
+                                                                  : "lz4"s));
+                row.set("compressionStatistics",
+                        channelInfo.get<std::shared_ptr<CompressionStatistics>>("compression"));
+            } else {
+                row.set("compression", std::string());
+            }
+        }
+
+
+        void OutputChannel::moveToSharedMemory(const SharedMemoryRing::Pointer& ring,
+                                               std::vector<karabo::data::BufferSet::Pointer>& data,
+                                               karabo::data::Hash& header) const {
+            std::vector<unsigned int> items;
+            std::vector<unsigned int> positions;
+            std::vector<unsigned long long> offsets;
+            std::vector<unsigned long long> sizes;
+            for (size_t i = 0; i < data.size(); ++i) {
+                auto leaveOut = [&ring, &items, &positions, &offsets, &sizes, i](size_t position,
+                                                                                 const ByteArray& array) {
+                    unsigned long long offset = 0ull;
+                    // Small arrays are cheaper to send over tcp than to manage in the ring
+                    if (array.second < kSharedMemoryMinSize || !ring->write(array.first.get(), array.second, offset)) {
+                        return false;
+                    }
+                    items.push_back(i);
+                    positions.push_back(position);
+                    offsets.push_back(offset);
+                    sizes.push_back(array.second);
+                    return true;
+                };
+                const size_t nMoved = items.size();
+                BufferSet::Pointer reduced = data[i]->copyWithout(leaveOut);
+                if (items.size() > nMoved) data[i] = reduced;
+            }
+            if (!items.empty()) {
+                header.set("sharedMemory",
+                           Hash("item", std::move(items), "position", std::move(positions), "offset",
+                                std::move(offsets), "size", std::move(sizes)));
+            }
+        }
+
+
         std::string OutputChannel::debugId() const {
             // m_channelId is unique per process and not per instance
             return std::string((("OUTPUT " + data::toString(m_channelId) += " of '") += this->getInstanceIdName()) +=
@@ -31,6 +31,8 @@
 #include <vector>
 
 #include "Memory.hh"
+#include "PayloadCompression.hh"
+#include "SharedMemoryRing.hh"
 #include "karabo/data/schema/NodeElement.hh"
 #include "karabo/data/types/Hash.hh"
 #include "karabo/net/Channel.hh"
@@ -47,6 +49,8 @@ namespace karabo {
         typedef std::function<void(const std::vector<karabo::data::Hash>&)> ShowConnectionsHandler;
         typedef std::function<void(const std::vector<unsigned long long>&, const std::vector<unsigned long long>&)>
               ShowStatisticsHandler;
+        typedef std::function<void(const std::vector<float>&, const std::vector<unsigned long long>&)>
+              ShowCompressionStatisticsHandler;
 
         typedef std::function<std::string(const std::vector<std::string>&)> SharedInputSelector;
 
@@ -100,6 +104,9 @@ namespace karabo {
              *     tcpChannel (karabo::net::Channel::WeakPointer)
              *     onSlowness (std::string) [queueDrop/drop/wait]
              *     queuedChunks (std::deque<int>)
+             *     sharedMemory (SharedMemoryRing::Pointer) [optional: only for remote inputs on the same host]
+             *     compression (std::shared_ptr<CompressionStatistics>) [optional: only for remote inputs that
+             *                                                            receive compressed data]
              *
              */
             typedef karabo::data::Hash InputChannelInfo;
@@ -120,7 +127,13 @@ namespace karabo {
 
             karabo::net::Connection::Pointer m_dataConnection;
 
+            enum class SharedDistribution { LOAD_BALANCED, STICKY_SOURCE, STICKY_TRAIN };
+
             std::string m_onNoSharedInputChannelAvailable;
+            SharedDistribution m_sharedDistribution;
+            bool m_stickyFallbackToNext;
+            std::string m_compression; // off, auto or always
+            unsigned int m_compressionShuffle;
 
             std::mutex m_inputNetChannelsMutex;
             std::set<karabo::net::Channel::Pointer> m_inputNetChannels;
@@ -153,6 +166,7 @@ namespace karabo {
             mutable std::mutex m_showConnectionsHandlerMutex;
             ShowConnectionsHandler m_showConnectionsHandler;
             ShowStatisticsHandler m_showStatisticsHandler;
+            ShowCompressionStatisticsHandler m_showCompressionStatisticsHandler;
             SharedInputSelector m_sharedInputSelector; // protected by m_registeredInputsMutex
             std::vector<karabo::data::Hash> m_connections;
             boost::asio::steady_timer m_updateDeadline;
@@ -396,6 +410,13 @@ namespace karabo {
 
             void registerShowStatisticsHandler(const ShowStatisticsHandler& handler);
 
+            /**
+             * Register handler that is called with the same period as the ShowStatisticsHandler with the compression
+             * ratio and the CPU time (in microseconds) spent for compression per connection, in the same order as
+             * in the table passed to the ShowConnectionsHandler
+             */
+            void registerShowCompressionStatisticsHandler(const ShowCompressionStatisticsHandler& handler);
+
             /**
              * Register handler that selects which of the connected input channels that have dataDistribution =
              * "shared" is to be served.
@@ -440,6 +461,17 @@ namespace karabo {
 
             void onInputAvailable(const std::string& instanceId);
 
+            /**
+             * Handle credit granted by an input channel that supports credit based flow control
+             *
+             * The input is served immediately if it is idle, all further credit is used one by one whenever a
+             * send to it has completed (see resetSendOngoing).
+             *
+             * @param instanceId of the input channel
+             * @param credit number of chunks the input is ready to receive
+             */
+            void onInputCredit(const std::string& instanceId, unsigned int credit);
+
             void onInputGone(const karabo::net::Channel::Pointer& channel, const karabo::net::ErrorCode& error);
 
             /**
@@ -547,6 +579,32 @@ namespace karabo {
                                                 std::vector<karabo::data::Hash*>& toSendImmediately,
                                                 std::vector<karabo::data::Hash*>& toQueue,
                                                 std::vector<karabo::data::Hash*>& toBlock);
+
+            /**
+             * Figure out how to treat shared inputs for the sticky "sharedDistribution" modes
+             *
+             * The input is chosen by rendezvous hashing of the source or train id of the first data item in the
+             * chunk, i.e. the same key always goes to the same input as long as that is connected. If an input
+             * connects or disconnects, only the keys it gains or loses are moved.
+             *
+             * Requires m_registeredInputsMutex to be locked
+             *
+             */
+            void asyncPrepareDistributeSticky(unsigned int chunkId,
+                                              std::vector<karabo::data::Hash*>& toSendImmediately,
+                                              std::vector<karabo::data::Hash*>& toQueue,
+                                              std::vector<karabo::data::Hash*>& toBlock);
+
+            /**
+             * Figure out how to treat the given shared input that is selected to receive the chunk
+             *
+             * Requires m_registeredInputsMutex to be locked
+             *
+             */
+            void asyncPrepareDistributeTo(unsigned int chunkId, InputChannels::iterator itIdChannelInfo,
+                                          std::vector<karabo::data::Hash*>& toSendImmediately,
+                                          std::vector<karabo::data::Hash*>& toQueue,
+                                          std::vector<karabo::data::Hash*>& toBlock);
             /**
              * Figure out how to treat shared inputs when load-balancing
              *
@@ -560,6 +618,8 @@ namespace karabo {
 
             /**
              * Helper that sets the sendOngoing flag to false for given instanceId
+             *
+             * If the input has credit left, it is marked available again.
              */
             void resetSendOngoing(const std::string& instanceId);
 
@@ -573,6 +633,25 @@ namespace karabo {
              */
             void asyncSendOne(unsigned int chunkId, InputChannelInfo& channelInfo, std::function<void()>&& doneHandler);
 
+            /**
+             * Helper for updateConnectionTable to add the "compression" column and, if compressing for that input,
+             * the "compressionStatistics" (std::shared_ptr<CompressionStatistics>) to a row
+             */
+            void addCompressionColumns(const InputChannelInfo& channelInfo, karabo::data::Hash& row) const;
+
+            /**
+             * Helper to move large arrays of the data to send to the shared memory ring of a receiver on the same host
+             *
+             * Arrays that do not fit into the ring stay in 'data'.
+             *
+             * @param ring to copy to
+             * @param data to be sent, the BufferSets with moved arrays are replaced
+             * @param header of the message, gets the key "sharedMemory" describing where the arrays are in 'ring'
+             */
+            void moveToSharedMemory(const SharedMemoryRing::Pointer& ring,
+                                    std::vector<karabo::data::BufferSet::Pointer>& data,
+                                    karabo::data::Hash& header) const;
+
             /**
              * Helper for waiting for future that in case of long delay adds a thread to unblock
              *
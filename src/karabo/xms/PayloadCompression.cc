@@ -0,0 +1,220 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "PayloadCompression.hh"
+
+#include <lz4.h>
+#include <time.h>
+
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+#include "karabo/data/types/BufferPool.hh"
+#include "karabo/data/types/Exception.hh"
+#include "karabo/data/types/StringTools.hh"
+
+using karabo::data::BufferPool;
+using karabo::data::BufferSet;
+using karabo::data::ByteArray;
+using karabo::data::Hash;
+using karabo::data::toString;
+
+namespace karabo {
+    namespace xms {
+
+        namespace {
+
+            unsigned long long threadCpuMicroseconds() {
+                timespec now;
+                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+                return now.tv_sec * 1000000ull + now.tv_nsec / 1000ull;
+            }
+        } // namespace
+
+
+        float CompressionStatistics::ratio() const {
+            const unsigned long long sent = sentBytes;
+            return (sent > 0ull ? static_cast<float>(rawBytes) / sent : 0.f);
+        }
+
+
+        size_t lz4CompressBound(size_t size) {
+            if (size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+                throw KARABO_PARAMETER_EXCEPTION("Too large for LZ4 compression: " + toString(size) + " bytes");
+            }
+            return static_cast<size_t>(LZ4_compressBound(static_cast<int>(size)));
+        }
+
+
+        size_t lz4Compress(const char* src, size_t size, char* dst) {
+            const int dstCapacity = static_cast<int>(lz4CompressBound(size)); // also checks 'size'
+            const int result = LZ4_compress_default(src, dst, static_cast<int>(size), dstCapacity);
+            if (result <= 0) {
+                throw KARABO_IO_EXCEPTION("LZ4 compression of " + toString(size) + " bytes failed");
+            }
+            return static_cast<size_t>(result);
+        }
+
+
+        void lz4Decompress(const char* src, size_t srcSize, char* dst, size_t dstSize) {
+            if (srcSize > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+                dstSize > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+                throw KARABO_IO_EXCEPTION("LZ4 block of " + toString(srcSize) + " bytes to decompress to " +
+                                          toString(dstSize) + " bytes exceeds the limits of LZ4");
+            }
+            const int result =
+                  LZ4_decompress_safe(src, dst, static_cast<int>(srcSize), static_cast<int>(dstSize));
+            if (result < 0) {
+                throw KARABO_IO_EXCEPTION("Corrupt LZ4 block of " + toString(srcSize) + " bytes");
+            }
+            if (static_cast<size_t>(result) != dstSize) {
+                throw KARABO_IO_EXCEPTION("LZ4 block decompressed to " + toString(result) + " instead of " +
+                                          toString(dstSize) + " bytes");
+            }
+        }
+
+
+        void byteShuffle(const char* src, size_t size, size_t typeSize, char* dst) {
+            const size_t nElements = size / typeSize;
+            for (size_t byte = 0; byte < typeSize; ++byte) {
+                char* out = dst + byte * nElements;
+                const char* in = src + byte;
+                for (size_t i = 0; i < nElements; ++i, in += typeSize) out[i] = *in;
+            }
+            const size_t done = nElements * typeSize;
+            std::memcpy(dst + done, src + done, size - done);
+        }
+
+
+        void byteUnshuffle(const char* src, size_t size, size_t typeSize, char* dst) {
+            const size_t nElements = size / typeSize;
+            for (size_t byte = 0; byte < typeSize; ++byte) {
+                const char* in = src + byte * nElements;
+                char* out = dst + byte;
+                for (size_t i = 0; i < nElements; ++i, out += typeSize) *out = in[i];
+            }
+            const size_t done = nElements * typeSize;
+            std::memcpy(dst + done, src + done, size - done);
+        }
+
+
+        void compressBuffers(std::vector<BufferSet::Pointer>& data, Hash& header, size_t minSize,
+                             unsigned int typeSize, CompressionStatistics& statistics) {
+            const unsigned long long startTime = threadCpuMicroseconds();
+            std::vector<unsigned int> items;
+            std::vector<unsigned int> positions;
+            std::vector<unsigned long long> sizes;
+            std::vector<BufferSet::Pointer> result(data);
+            for (size_t i = 0; i < data.size(); ++i) {
+                std::vector<std::tuple<size_t, size_t, ByteArray>> compressed; // position, raw size, compressed
+                auto leaveOut = [&compressed, &statistics, minSize, typeSize](size_t position, const ByteArray& array) {
+                    const size_t size = array.second;
+                    if (size < minSize || size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) return false;
+                    statistics.rawBytes += size;
+                    const char* src = array.first.get();
+                    std::shared_ptr<char> shuffled;
+                    if (typeSize > 1u) {
+                        shuffled = BufferPool::allocate(size);
+                        byteShuffle(src, size, typeSize, shuffled.get());
+                        src = shuffled.get();
+                    }
+                    std::shared_ptr<char> out = BufferPool::allocate(lz4CompressBound(size));
+                    const size_t outSize = lz4Compress(src, size, out.get());
+                    if (outSize > size - size / 8ul) { // not worth the decompression on the other side
+                        statistics.sentBytes += size;
+                        return false;
+                    }
+                    statistics.sentBytes += outSize;
+                    compressed.emplace_back(position, size, ByteArray(out, outSize));
+                    return true;
+                };
+                BufferSet::Pointer reduced = data[i]->copyWithout(leaveOut);
+                if (compressed.empty()) continue;
+                // Compressed buffers take the place of the original ones
+                for (const auto& [position, size, array] : compressed) {
+                    reduced->insert(position, array);
+                    items.push_back(i);
+                    positions.push_back(position);
+                    sizes.push_back(size);
+                }
+                result[i] = reduced;
+            }
+            if (!items.empty()) {
+                header.set("compression", Hash("codec", "lz4", "typeSize", typeSize, "item", std::move(items),
+                                               "position", std::move(positions), "size", std::move(sizes)));
+                data.swap(result);
+            }
+            statistics.cpuMicroseconds += threadCpuMicroseconds() - startTime;
+        }
+
+
+        std::vector<BufferSet::Pointer> decompressBuffers(const Hash& compression,
+                                                          const std::vector<BufferSet::Pointer>& data) {
+            if (compression.get<std::string>("codec") != "lz4") {
+                throw KARABO_LOGIC_EXCEPTION("Unknown compression codec: " + compression.get<std::string>("codec"));
+            }
+            const unsigned int typeSize = compression.get<unsigned int>("typeSize");
+            const auto& items = compression.get<std::vector<unsigned int>>("item");
+            const auto& positions = compression.get<std::vector<unsigned int>>("position");
+            const auto& sizes = compression.get<std::vector<unsigned long long>>("size");
+            if (positions.size() != items.size() || sizes.size() != items.size()) {
+                throw KARABO_LOGIC_EXCEPTION("Inconsistent compression description: " + toString(compression));
+            }
+
+            std::vector<BufferSet::Pointer> result(data);
+            // Sorted by item and position - handle all buffers of an item at once
+            for (size_t begin = 0, end = 0; begin < items.size(); begin = end) {
+                const unsigned int item = items[begin];
+                if (item >= data.size() || (begin > 0 && item <= items[begin - 1])) {
+                    throw KARABO_LOGIC_EXCEPTION("Compressed buffer for invalid item " + toString(item) + " of " +
+                                                 toString(data.size()));
+                }
+                while (end < items.size() && items[end] == item) ++end;
+
+                std::vector<ByteArray> decompressed;
+                auto leaveOut = [&](size_t position, const ByteArray& array) {
+                    const size_t index = begin + decompressed.size();
+                    if (index >= end || positions[index] != position) return false;
+                    const size_t size = sizes[index];
+                    std::shared_ptr<char> out = BufferPool::allocate(size);
+                    if (typeSize > 1u) {
+                        std::shared_ptr<char> shuffled = BufferPool::allocate(size);
+                        lz4Decompress(array.first.get(), array.second, shuffled.get(), size);
+                        byteUnshuffle(shuffled.get(), size, typeSize, out.get());
+                    } else {
+                        lz4Decompress(array.first.get(), array.second, out.get(), size);
+                    }
+                    decompressed.emplace_back(out, size);
+                    return true;
+                };
+                BufferSet::Pointer restored = data[item]->copyWithout(leaveOut);
+                if (decompressed.size() != end - begin) {
+                    throw KARABO_LOGIC_EXCEPTION("Only " + toString(decompressed.size()) + " of " +
+                                                 toString(end - begin) + " compressed buffers found for item " +
+                                                 toString(item));
+                }
+                for (size_t i = 0; i < decompressed.size(); ++i) {
+                    restored->insert(positions[begin + i], decompressed[i]);
+                }
+                result[item] = restored;
+            }
+            return result;
+        }
+    } // namespace xms
+} // namespace karabo
@@ -0,0 +1,119 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_XMS_PAYLOADCOMPRESSION_HH
+#define KARABO_XMS_PAYLOADCOMPRESSION_HH
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "karabo/data/io/BufferSet.hh"
+#include "karabo/data/types/Hash.hh"
+
+namespace karabo {
+    namespace xms {
+
+        /**
+         * Counters of the compression of pipeline data sent to one input channel
+         */
+        struct CompressionStatistics {
+            /// Bytes of all buffers that were large enough to be considered for compression
+            std::atomic<unsigned long long> rawBytes{0ull};
+            /// Bytes actually sent for these buffers - compressed or, if that did not pay off, raw
+            std::atomic<unsigned long long> sentBytes{0ull};
+            /// CPU time spent on shuffling and compressing
+            std::atomic<unsigned long long> cpuMicroseconds{0ull};
+
+            /// rawBytes / sentBytes, or 0 if nothing was considered yet
+            float ratio() const;
+        };
+
+        /**
+         * Upper limit of the size of lz4Compress(..) output for 'size' bytes of input
+         *
+         * @throw ParameterException if 'size' exceeds the maximum input size of LZ4 (LZ4_MAX_INPUT_SIZE, ~2 GB)
+         */
+        size_t lz4CompressBound(size_t size);
+
+        /**
+         * Compress into the LZ4 block format (without frame) using liblz4
+         *
+         * @param src data to compress
+         * @param size of 'src', at most LZ4_MAX_INPUT_SIZE
+         * @param dst output with space for at least lz4CompressBound(size) bytes
+         * @return number of bytes written to 'dst'
+         */
+        size_t lz4Compress(const char* src, size_t size, char* dst);
+
+        /**
+         * Decompress data in the LZ4 block format using liblz4, never writing beyond 'dstSize' bytes of 'dst'
+         *
+         * @param src compressed data, e.g. as received from the network
+         * @param srcSize size of 'src'
+         * @param dst output
+         * @param dstSize exact size of the decompressed data
+         * @throw IOException if 'src' is corrupt or does not decompress to exactly 'dstSize' bytes
+         */
+        void lz4Decompress(const char* src, size_t srcSize, char* dst, size_t dstSize);
+
+        /**
+         * Group the bytes of the elements of a typed array by their significance, i.e. first all lowest bytes, then
+         * all second lowest bytes, etc. Typical detector data (e.g. 16 bit ADC values) compresses much better then.
+         * Trailing bytes that do not fill a full element are copied as they are.
+         *
+         * @param src array
+         * @param size of 'src' in bytes
+         * @param typeSize element size in bytes
+         * @param dst output of 'size' bytes
+         */
+        void byteShuffle(const char* src, size_t size, size_t typeSize, char* dst);
+
+        /**
+         * Inverse of byteShuffle(..)
+         */
+        void byteUnshuffle(const char* src, size_t size, size_t typeSize, char* dst);
+
+        /**
+         * Compress the large buffers of data to be sent via TCP - in place of the original ones
+         *
+         * @param data one BufferSet per item as from Memory::readIntoBuffers, compressed buffers replace the originals
+         * @param header of the message, gets the key "compression" describing which buffers are compressed
+         * @param minSize buffers smaller than this are not compressed
+         * @param typeSize if larger than 1, byte shuffle before compression with this element size
+         * @param statistics to update
+         *
+         * If an exception is thrown (e.g. std::bad_alloc), 'data' and 'header' are unchanged.
+         */
+        void compressBuffers(std::vector<karabo::data::BufferSet::Pointer>& data, karabo::data::Hash& header,
+                             size_t minSize, unsigned int typeSize, CompressionStatistics& statistics);
+
+        /**
+         * Inverse of compressBuffers(..) on the receiving side
+         *
+         * @param compression as in the header of the received message
+         * @param data one BufferSet per item as received
+         * @return BufferSets with the compressed buffers replaced by the decompressed ones
+         * @throw IOException or LogicException if data and 'compression' do not fit together
+         */
+        std::vector<karabo::data::BufferSet::Pointer> decompressBuffers(
+              const karabo::data::Hash& compression, const std::vector<karabo::data::BufferSet::Pointer>& data);
+    } // namespace xms
+} // namespace karabo
+
+#endif
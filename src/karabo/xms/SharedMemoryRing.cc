@@ -0,0 +1,238 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "SharedMemoryRing.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "karabo/data/types/Exception.hh"
+#include "karabo/data/types/StringTools.hh"
+
+namespace karabo {
+    namespace xms {
+
+        namespace {
+
+            // Everything is aligned to this: the ring header, the region headers and the data in the regions
+            const size_t kAlignment = 64ul;
+            const unsigned long long kMagic = 0x4b5242534852494eull; // "KRBSHRIN"
+
+            struct RingHeader {
+                unsigned long long magic;
+                unsigned long long nonce;
+                unsigned long long capacity;
+            };
+
+            enum RegionState : std::uint32_t { FREE = 0u, USED = 1u };
+
+            struct RegionHeader {
+                std::atomic<std::uint32_t> state;
+                std::uint32_t reserved;
+                unsigned long long size; // of the full region, including this header
+            };
+
+            static_assert(sizeof(RingHeader) <= kAlignment && sizeof(RegionHeader) <= kAlignment);
+            static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Needed across processes");
+
+            size_t alignUp(size_t size) {
+                return (size + kAlignment - 1ul) / kAlignment * kAlignment;
+            }
+
+            std::string errnoText() {
+                return std::string(std::strerror(errno));
+            }
+        } // namespace
+
+
+        SharedMemoryRing::Pointer SharedMemoryRing::create(size_t capacity) {
+            static std::atomic<unsigned int> counter(0u);
+            const std::string name("/karabo-pipeline-" + data::toString(getpid()) + "-" +
+                                   data::toString(counter.fetch_add(1u)));
+            const size_t mappedSize = kAlignment + alignUp(capacity);
+
+            const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+            if (fd < 0) {
+                throw KARABO_IO_EXCEPTION("Failed to create shared memory " + name + ": " + errnoText());
+            }
+            void* mapping = MAP_FAILED;
+            if (ftruncate(fd, mappedSize) == 0) {
+                mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            const std::string error(errnoText());
+            close(fd);
+            if (mapping == MAP_FAILED) {
+                shm_unlink(name.c_str());
+                throw KARABO_IO_EXCEPTION("Failed to map shared memory " + name + ": " + error);
+            }
+            // Fresh memory is zeroed, i.e. all regions are FREE
+            RingHeader* header = static_cast<RingHeader*>(mapping);
+            header->magic = kMagic;
+            header->nonce = (static_cast<unsigned long long>(std::random_device()()) << 32) ^ std::random_device()();
+            header->capacity = mappedSize - kAlignment;
+
+            return Pointer(new SharedMemoryRing(name, static_cast<char*>(mapping), mappedSize, true));
+        }
+
+
+        SharedMemoryRing::Pointer SharedMemoryRing::attach(const std::string& name, unsigned long long nonce) {
+            const int fd = shm_open(name.c_str(), O_RDWR, 0);
+            if (fd < 0) {
+                throw KARABO_IO_EXCEPTION("Failed to open shared memory " + name + ": " + errnoText());
+            }
+            struct stat status;
+            void* mapping = MAP_FAILED;
+            size_t mappedSize = 0ul;
+            if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) > kAlignment) {
+                mappedSize = status.st_size;
+                mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            const std::string error(errnoText());
+            close(fd);
+            if (mapping == MAP_FAILED) {
+                throw KARABO_IO_EXCEPTION("Failed to map shared memory " + name + ": " + error);
+            }
+            const RingHeader* header = static_cast<const RingHeader*>(mapping);
+            if (header->magic != kMagic || header->nonce != nonce || header->capacity + kAlignment != mappedSize) {
+                munmap(mapping, mappedSize);
+                throw KARABO_IO_EXCEPTION("Shared memory " + name + " is not the expected ring");
+            }
+            return Pointer(new SharedMemoryRing(name, static_cast<char*>(mapping), mappedSize, false));
+        }
+
+
+        SharedMemoryRing::SharedMemoryRing(const std::string& name, char* mapping, size_t mappedSize, bool owner)
+            : m_name(name),
+              m_mapping(mapping),
+              m_mappedSize(mappedSize),
+              m_data(mapping + kAlignment),
+              m_capacity(mappedSize - kAlignment),
+              m_owner(owner),
+              m_unlinked(false),
+              m_head(0ul),
+              m_tail(0ul),
+              m_used(0ul) {}
+
+
+        SharedMemoryRing::~SharedMemoryRing() {
+            if (m_owner) unlink();
+            munmap(m_mapping, m_mappedSize);
+        }
+
+
+        const std::string& SharedMemoryRing::getName() const {
+            return m_name;
+        }
+
+
+        unsigned long long SharedMemoryRing::getNonce() const {
+            return reinterpret_cast<const RingHeader*>(m_mapping)->nonce;
+        }
+
+
+        size_t SharedMemoryRing::capacity() const {
+            return m_capacity;
+        }
+
+
+        void SharedMemoryRing::unlink() {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            if (!m_unlinked) {
+                m_unlinked = true;
+                shm_unlink(m_name.c_str()); // failure (e.g. already unlinked by the other side) does not matter
+            }
+        }
+
+
+        void SharedMemoryRing::reclaim() {
+            while (m_used > 0ul) {
+                RegionHeader* region = reinterpret_cast<RegionHeader*>(m_data + m_tail);
+                if (region->state.load(std::memory_order_acquire) != FREE) break;
+                m_tail = (m_tail + region->size) % m_capacity;
+                m_used -= region->size;
+            }
+            if (m_used == 0ul) {
+                m_head = m_tail = 0ul;
+            }
+        }
+
+
+        bool SharedMemoryRing::write(const char* data, size_t size, unsigned long long& offset) {
+            const size_t regionSize = kAlignment + alignUp(size);
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            reclaim();
+            if (regionSize > m_capacity - m_used) return false;
+
+            size_t position = m_head;
+            if (m_head >= m_tail) {
+                // Free space is behind the head and in front of the tail
+                if (m_capacity - m_head < regionSize) {
+                    if (m_tail < regionSize) return false;
+                    // Pad until the end and start from the beginning - the padding is reclaimed like a region
+                    if (m_head < m_capacity) {
+                        RegionHeader* padding = reinterpret_cast<RegionHeader*>(m_data + m_head);
+                        padding->size = m_capacity - m_head;
+                        padding->state.store(FREE, std::memory_order_relaxed);
+                        m_used += padding->size;
+                    }
+                    position = 0ul;
+                }
+            } else if (m_tail - m_head < regionSize) {
+                return false;
+            }
+
+            RegionHeader* region = reinterpret_cast<RegionHeader*>(m_data + position);
+            region->size = regionSize;
+            region->state.store(USED, std::memory_order_relaxed);
+            std::memcpy(m_data + position + kAlignment, data, size);
+            // Data has to be visible before the reader gets to know the offset
+            std::atomic_thread_fence(std::memory_order_release);
+
+            m_head = (position + regionSize) % m_capacity;
+            m_used += regionSize;
+            offset = position + kAlignment;
+            return true;
+        }
+
+
+        std::shared_ptr<char> SharedMemoryRing::read(unsigned long long offset, size_t size) {
+            if (offset < kAlignment || offset % kAlignment != 0ull || offset > m_capacity ||
+                size > m_capacity - offset) {
+                throw KARABO_IO_EXCEPTION("Invalid region " + data::toString(offset) + "/" + data::toString(size) +
+                                          " in shared memory " + m_name);
+            }
+            RegionHeader* region = reinterpret_cast<RegionHeader*>(m_data + offset - kAlignment);
+            if (region->state.load(std::memory_order_acquire) != USED || region->size < kAlignment + size) {
+                throw KARABO_IO_EXCEPTION("Region " + data::toString(offset) + " in shared memory " + m_name +
+                                          " not in use");
+            }
+            // The deleter keeps the mapping alive and gives the region back to the writer
+            return std::shared_ptr<char>(m_data + offset, [self{shared_from_this()}, region](char*) {
+                region->state.store(FREE, std::memory_order_release);
+            });
+        }
+    } // namespace xms
+} // namespace karabo
@@ -0,0 +1,129 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_XMS_SHAREDMEMORYRING_HH
+#define KARABO_XMS_SHAREDMEMORYRING_HH
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "karabo/data/types/ClassInfo.hh"
+
+namespace karabo {
+    namespace xms {
+
+        /**
+         * @class SharedMemoryRing
+         * @brief Ring buffer in POSIX shared memory to pass bulk data between processes on the same host
+         *
+         * One process creates the ring, another one attaches to it by its name. The writer copies data into regions
+         * of the ring. The reader accesses a region via a shared pointer into the mapped memory. When the last copy
+         * of that pointer is gone, the region is marked free in the shared memory itself, i.e. no message back to
+         * the writer is needed. Regions are reused in the order they were written, so a region that is held for
+         * long blocks the reuse of all regions written later.
+         *
+         * Used by InputChannel (creator and reader) and OutputChannel (writer) for connections within a host.
+         */
+        class SharedMemoryRing : public std::enable_shared_from_this<SharedMemoryRing> {
+           public:
+            KARABO_CLASSINFO(SharedMemoryRing, "SharedMemoryRing", "1.0")
+
+            /**
+             * Create a new ring with a unique name
+             *
+             * @param capacity in bytes, rounded up to a multiple of 64
+             * @return the ring - its name is removed from the system at destruction, if not before
+             * @throw IOException if the shared memory cannot be created
+             */
+            static Pointer create(size_t capacity);
+
+            /**
+             * Attach to a ring that was created elsewhere
+             *
+             * @param name of the ring as returned by getName() of the creator
+             * @param nonce as returned by getNonce() of the creator - protects against attaching to a different
+             *              ring with the same name, e.g. on another host
+             * @return the ring
+             * @throw IOException if attaching fails or nonce does not match
+             */
+            static Pointer attach(const std::string& name, unsigned long long nonce);
+
+            ~SharedMemoryRing();
+
+            const std::string& getName() const;
+
+            unsigned long long getNonce() const;
+
+            /**
+             * Number of bytes available for regions (including their 64 byte headers)
+             */
+            size_t capacity() const;
+
+            /**
+             * Remove the name from the system - already attached processes keep their mapping
+             */
+            void unlink();
+
+            /**
+             * Copy data into a free region - writer side
+             *
+             * @param data to copy
+             * @param size of data
+             * @param offset [out] where in the ring the data is, to be passed to the reader
+             * @return false if there is not enough contiguous free space
+             */
+            bool write(const char* data, size_t size, unsigned long long& offset);
+
+            /**
+             * Access data written by the other side - reader side
+             *
+             * @param offset as from write(..)
+             * @param size as given to write(..)
+             * @return pointer to the data in the shared memory that keeps this ring alive and frees the region when
+             *         it (and all its copies) are destructed
+             * @throw IOException if offset and size do not describe a region in use
+             */
+            std::shared_ptr<char> read(unsigned long long offset, size_t size);
+
+           private:
+            SharedMemoryRing(const std::string& name, char* mapping, size_t mappedSize, bool owner);
+
+            /**
+             * Give regions back that the reader has freed - writer side, requires m_writeMutex to be locked
+             */
+            void reclaim();
+
+            const std::string m_name;
+            char* const m_mapping;
+            const size_t m_mappedSize;
+            char* const m_data; // start of regions
+            const size_t m_capacity;
+            const bool m_owner;
+            bool m_unlinked;
+
+            std::mutex m_writeMutex;
+            size_t m_head; // where the next region is placed
+            size_t m_tail; // oldest region that might still be in use
+            size_t m_used; // bytes between m_tail and m_head
+        };
+    } // namespace xms
+} // namespace karabo
+
+#endif
@@ -27,7 +27,9 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <chrono>
+#include <charconv>
 #include <cstdlib>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -48,6 +50,9 @@ using std::placeholders::_3;
 using std::placeholders::_4;
 
 namespace {
+    /// An instance is lost if no heartbeat arrived for its heartbeatInterval times this
+    constexpr std::chrono::seconds kCountdownTick(3);
+
     /**
      * Check need for slot name mangling (i.e. replacing dots from slots under node by `_`)
      *
@@ -108,25 +113,7 @@ namespace karabo {
 
         void SignalSlotable::Requestor::receiveAsync(const std::function<void()>& replyCallback,
                                                      const SignalSlotable::Requestor::AsyncErrorHandler& errorHandler) {
-            m_signalSlotable->registerSlot(replyCallback, m_replyId);
-            registerErrorHandler(errorHandler);
-            sendRequest();
-        }
-
-
-        void SignalSlotable::Requestor::registerErrorHandler(const AsyncErrorHandler& errorHandler) {
-            // If timeout is not explicitely specified (default is zero), use twice the maximum travel time
-            // to the broker as default. Do not allow negative values either.
-            // Otherwise we have a little memory leak if the slotInstanceId is never responding, e.g.
-            // since no such instance exists...
-            const int timeout = (m_timeout > 0 ? m_timeout : m_defaultAsyncTimeout);
-
-            // Register a timer and error handler into map
-            auto timer = std::make_shared<boost::asio::steady_timer>(EventLoop::getIOService());
-            timer->expires_after(milliseconds(timeout));
-            timer->async_wait(bind_weak(&SignalSlotable::receiveAsyncTimeoutHandler, m_signalSlotable,
-                                        boost::asio::placeholders::error, m_replyId, errorHandler));
-            m_signalSlotable->addReceiveAsyncErrorHandles(m_replyId, timer, errorHandler);
+            receiveAsyncImpl<>(replyCallback, errorHandler);
         }
 
         void SignalSlotable::Requestor::getSignalInstanceId(const karabo::data::Hash::Pointer& header,
@@ -227,7 +214,7 @@ namespace karabo {
 
 
         SignalSlotable::Requestor::Requestor(SignalSlotable* signalSlotable)
-            : m_signalSlotable(signalSlotable), m_replyId(SignalSlotable::generateUUID()), m_timeout(0) {}
+            : m_signalSlotable(signalSlotable), m_replyId(signalSlotable->nextReplyId()), m_timeout(0) {}
 
 
         SignalSlotable::Requestor::~Requestor() {}
@@ -240,7 +227,8 @@ namespace karabo {
 
 
         karabo::data::Hash::Pointer SignalSlotable::Requestor::prepareRequestHeader() {
-            return Hash::MakeShared("replyTo", m_replyId, "signalInstanceId", m_signalSlotable->getInstanceId());
+            return Hash::MakeShared("replyTo", SignalSlotable::replyIdToString(m_replyId), "signalInstanceId",
+                                    m_signalSlotable->getInstanceId());
         }
 
 
@@ -297,9 +285,12 @@ namespace karabo {
         SignalSlotable::SignalSlotable()
             : m_randPing(rand() + 2),
               m_broadcastEventStrand(std::make_shared<karabo::net::Strand>(EventLoop::getIOService())),
+              m_replyIdPrefix(static_cast<unsigned long long>(std::random_device()()) << 32),
+              m_replyIdCounter(0u),
+              m_replyTimeouts(EventLoop::getTimerWheel()),
+              m_trackingGeneration(0ull),
               m_trackAllInstances(false),
               m_heartbeatInterval(120),
-              m_trackingTimer(EventLoop::getIOService()),
               m_heartbeatTimer(EventLoop::getIOService()),
               m_performanceTimer(EventLoop::getIOService()),
               m_channelConnectTimer(EventLoop::getIOService()) {
@@ -334,6 +325,13 @@ namespace karabo {
                 std::shared_lock<std::shared_mutex> lock(m_instanceInfoMutex);
                 call("*", "slotInstanceGone", m_instanceId, m_instanceInfo);
             }
+            {
+                // The timer wheel is shared, so free the timeouts now instead of when they expire
+                std::lock_guard<std::mutex> lock(m_pendingRepliesMutex);
+                for (const auto& idAndReply : m_pendingReplies) {
+                    m_replyTimeouts->cancel(idAndReply.second.timeoutId);
+                }
+            }
             EventLoop::removeThread();
         }
 
@@ -508,19 +506,24 @@ namespace karabo {
                                                                    : "unspecified sender");
             KARABO_LOG_FRAMEWORK_TRACE << m_instanceId << ": Injecting reply from: " << signalId << *header << *body;
 
-            const string& replyId = header->get<string>("replyFrom");
+            const string& replyIdStr = header->get<string>("replyFrom");
             // TODO: Think about "replyFrom" becoming a boolean and take the reply slot name from the 'slot' argument
-            if (slotName != replyId) {
-                KARABO_LOG_FRAMEWORK_WARN << m_instanceId << ": Reply with id '" << replyId << "' targeting slot '"
+            if (slotName != replyIdStr) {
+                KARABO_LOG_FRAMEWORK_WARN << m_instanceId << ": Reply with id '" << replyIdStr << "' targeting slot '"
                                           << slotName << "'!";
             }
-            std::pair<std::shared_ptr<boost::asio::steady_timer>, Requestor::AsyncErrorHandler> timerAndHandler =
-                  getReceiveAsyncErrorHandles(replyId);
-            // Check if a timer was registered for the reply and cancel it since message handled here before expiration
-            if (timerAndHandler.first && timerAndHandler.first->cancel() == 0) {
-                // Cancelling failed, error handler was already put to event loop and will handle timeout
+            unsigned long long replyId = 0ull;
+            if (!replyIdFromString(replyIdStr, replyId)) {
+                KARABO_LOG_FRAMEWORK_WARN << m_instanceId << ": Ignore reply from '" << signalId
+                                          << "' with invalid id '" << replyIdStr << "'";
                 return;
             }
+            // If an async request is waiting for this reply, take it and stop its timeout. If it is not there
+            // (anymore), the request is synchronous or has timed out before.
+            const PendingReply pending = takePendingReply(replyId);
+            if (pending.replySlot) {
+                m_replyTimeouts->cancel(pending.timeoutId);
+            }
 
             // Check whether the reply is an error
             bool asyncErrorHandlerCalled = false;
@@ -535,17 +538,17 @@ namespace karabo {
                 const std::string details(detailsNode && detailsNode->is<std::string>()
                                                 ? detailsNode->getValue<std::string>()
                                                 : std::string());
-                if (timerAndHandler.second) {
+                if (pending.errorHandler) {
                     try {
                         throw karabo::data::RemoteException(text, signalId, details);
                     } catch (const std::exception&) {
                         try {
                             // Handler can do: try {throw;} catch(const karabo::data::RemoteException&) {...;}
                             asyncErrorHandlerCalled = true;
-                            timerAndHandler.second();
+                            pending.errorHandler();
                         } catch (const std::exception& e) {
                             KARABO_LOG_FRAMEWORK_WARN << getInstanceId() << ": Received error from '" << signalId
-                                                      << "' for request id '" << replyId
+                                                      << "' for request id '" << replyIdStr
                                                       << "', but error handler throws exception:\n"
                                                       << e.what();
                         }
@@ -558,19 +561,17 @@ namespace karabo {
                 }
             }
 
-            // Check whether a callback (temporary slot) was registered for the reply
-            // (if it timed out before, the slot will already be gone)
-            SlotInstancePointer slot = getSlot(replyId);
+            // Call the reply handler of an async request
             try {
-                if (!asyncErrorHandlerCalled && slot) {
+                if (!asyncErrorHandlerCalled && pending.replySlot) {
                     // Do not check (false) arity-nargs equality for reply slots
-                    slot->callRegisteredSlotFunctions(header, body, false);
+                    pending.replySlot->callRegisteredSlotFunctions(header, body, false);
                 }
             } catch (const std::exception& e) {
-                if (timerAndHandler.second) {
+                if (pending.errorHandler) {
                     try {
                         // Handler can do: try {throw;} catch(const karabo::data::CastException&) {...;} catch (..){
-                        timerAndHandler.second();
+                        pending.errorHandler();
                     } catch (const std::exception& e) {
                         KARABO_LOG_FRAMEWORK_ERROR << m_instanceId << ": Exception when handling reply from '"
                                                    << signalId << "', but error handler throws exception:\n"
@@ -581,7 +582,6 @@ namespace karabo {
                                                << "': " << e.what() << "\nmessage body: " << *body;
                 }
             }
-            removeSlot(replyId);
             // Now check whether someone is synchronously waiting for us and if yes wake him up
             std::shared_ptr<BoostMutexCond> bmc;
             {
@@ -605,15 +605,23 @@ namespace karabo {
 
 
         void SignalSlotable::startTrackingSystem() {
-            // Countdown and finally timeout registered heartbeats
-            m_trackingTimer.expires_after(10ms);
-            m_trackingTimer.async_wait(bind_weak(&karabo::xms::SignalSlotable::letInstanceSlowlyDieWithoutHeartbeat,
-                                                 this, boost::asio::placeholders::error));
+            // Timeout instances already known, later ones get their timeout when added
+            std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
+            for (auto& idAndTracked : m_trackedInstances) {
+                scheduleTrackingTimeout(idAndTracked.first, idAndTracked.second);
+            }
         }
 
 
         void SignalSlotable::stopTrackingSystem() {
-            m_trackingTimer.cancel();
+            // The timer wheel is shared, so free the timeouts now instead of when they expire
+            std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
+            for (auto& idAndTracked : m_trackedInstances) {
+                if (idAndTracked.second.timeoutId) {
+                    m_replyTimeouts->cancel(idAndTracked.second.timeoutId);
+                    idAndTracked.second.timeoutId = 0ull;
+                }
+            }
         }
 
 
@@ -755,16 +763,10 @@ namespace karabo {
 
                 SlotInstancePointer slot = getSlot(slotFunction);
                 if (slot) {
-                    { // Store slot for asyncReply
-                        std::lock_guard<std::mutex> lock(m_currentSlotsMutex);
-                        m_currentSlots[std::this_thread::get_id()] = std::make_pair(slotFunction, globalCall);
-                    }
+                    // Context for reply(..) and AsyncReply while slot functions are called
+                    SlotCallContext context(this, slotFunction, globalCall, header);
                     slot->callRegisteredSlotFunctions(header, body);
-                    sendPotentialReply(*header, slotFunction, globalCall);
-                    { // Clean again
-                        std::lock_guard<std::mutex> lock(m_currentSlotsMutex);
-                        m_currentSlots.erase(std::this_thread::get_id());
-                    }
+                    sendPotentialReply(*header, slotFunction, globalCall, context.replyPlaced, context.reply);
                 } else if (!globalCall) {
                     // Warn on non-existing slot, but only if directly addressed:
                     KARABO_LOG_FRAMEWORK_WARN << m_instanceId << ": Received a message from '" << signalInstanceId
@@ -789,32 +791,56 @@ namespace karabo {
         }
 
 
+        thread_local SignalSlotable::SlotCallContext* SignalSlotable::m_currentSlotCall = nullptr;
+
+
+        SignalSlotable::SlotCallContext::SlotCallContext(const SignalSlotable* signalSlotable,
+                                                         const std::string& slotFunction, bool globalCall,
+                                                         const karabo::data::Hash::Pointer& header)
+            : signalSlotable(signalSlotable),
+              slotFunction(slotFunction),
+              globalCall(globalCall),
+              header(header),
+              replyPlaced(false),
+              reply(),
+              outer(m_currentSlotCall) {
+            m_currentSlotCall = this;
+        }
+
+
+        SignalSlotable::SlotCallContext::~SlotCallContext() {
+            m_currentSlotCall = outer;
+        }
+
+
+        SignalSlotable::SlotCallContext* SignalSlotable::getCurrentSlotCall() const {
+            for (SlotCallContext* context = m_currentSlotCall; context; context = context->outer) {
+                if (context->signalSlotable == this) return context;
+            }
+            return nullptr;
+        }
+
+
         void SignalSlotable::registerReply(const karabo::data::Hash::Pointer& reply) {
-            std::lock_guard<std::mutex> lock(m_replyMutex);
-            m_replies[std::this_thread::get_id()] = reply;
+            SlotCallContext* context = getCurrentSlotCall();
+            if (context) {
+                context->replyPlaced = true;
+                context->reply = reply;
+            }
+            // else { // not called inside a slot (e.g. Device::updateState), so nobody waits for a reply }
         }
 
 
         std::tuple<karabo::data::Hash::ConstPointer, std::string, bool> SignalSlotable::registerAsyncReply() {
-            // Get name of current slot (sometimes referred to as 'slotFunction'):
-            std::pair<std::string, bool> slotName_calledGlobally;
-            {
-                std::lock_guard<std::mutex> lock(m_currentSlotsMutex);
-                const auto it = m_currentSlots.find(std::this_thread::get_id());
-                if (it != m_currentSlots.end()) {
-                    slotName_calledGlobally = it->second;
-                }
-                // else { // slot is not called via processEvent and thus any reply does not matter!}
-            }
             std::tuple<karabo::data::Hash::ConstPointer, std::string, bool> result;
-            const std::string& slotName = slotName_calledGlobally.first;
-            // If no slotName placed, reply does not matter (see above) - we mark this with non-existing header pointer.
-            if (!slotName.empty()) {
-                result = std::make_tuple(getSenderInfo(slotName)->getHeaderOfSender(), slotName,
-                                         slotName_calledGlobally.second);
+            SlotCallContext* context = getCurrentSlotCall();
+            // If not inside a slot call, the reply does not matter - we mark this with non-existing header pointer.
+            if (context) {
+                result = std::make_tuple(context->header, context->slotFunction, context->globalCall);
 
                 // Place an invalid reply to avoid a default reply to be sent (see sendPotentialReply):
-                registerReply(karabo::data::Hash::Pointer());
+                context->replyPlaced = true;
+                context->reply.reset();
             }
 
             return result;
@@ -857,7 +883,8 @@ namespace karabo {
 
 
         void SignalSlotable::sendPotentialReply(const karabo::data::Hash& header, const std::string& slotFunction,
-                                                bool global) {
+                                                bool global, bool replyPlaced,
+                                                const karabo::data::Hash::Pointer& placedReply) {
             // We could be requested in two different ways.
             // TODO: Get rid of requestNoWait code path once receiveAsync is everywhere.
             // GF: But currently there is a difference: requestNoWait allows to get answers from
@@ -865,13 +892,8 @@ namespace karabo {
             const bool caseRequest = header.has("replyTo"); // with receive or receiveAsync
             const bool caseRequestNoWait = header.has("replyFunction");
 
-            std::lock_guard<std::mutex> lock(m_replyMutex);
-            Replies::iterator replyIter = m_replies.find(std::this_thread::get_id());
-            const bool replyPlaced = (replyIter != m_replies.end());
             if (!caseRequest && !caseRequestNoWait) {
-                // Not requested, so nothing to reply, but we have to remove the
-                // reply that may have been placed in the slot.
-                if (replyPlaced) m_replies.erase(replyIter);
+                // Not requested, so nothing to reply (and a reply that may have been placed in the slot is dropped)
                 return;
             }
             // The reply of a slot requested globally ("*") should be ignored.
@@ -881,7 +903,6 @@ namespace karabo {
             // will call the given slot.
             if (global && caseRequest) { // NOT: || caseRequestNoWait) {
                 if (replyPlaced) {
-                    m_replies.erase(replyIter);
                     // But it is fishy if the slot was requested instead of simply called!
                     KARABO_LOG_FRAMEWORK_WARN << this->getInstanceId() << ": Refusing to reply to "
                                               << header.get<std::string>("signalInstanceId") << " since it request-ed '"
@@ -905,8 +926,7 @@ namespace karabo {
             // reply will be handled later.
             Hash::Pointer replyBody;
             if (replyPlaced) {
-                replyBody = replyIter->second;
-                m_replies.erase(replyIter);
+                replyBody = placedReply;
                 if (!replyBody) { // empty pointer as placed by registerAsyncReply
                     return;
                 }
@@ -1069,7 +1089,7 @@ namespace karabo {
             KARABO_LOG_FRAMEWORK_DEBUG << "getAvailableInstances";
             if (!m_trackAllInstances) {
                 std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-                m_trackedInstances.clear();
+                m_trackedInstances.clear(); // not tracking, so no timeouts to cancel
             }
             call("*", "slotDiscover", m_instanceId);
             // The function slotDiscoverAnswer will be called by all instances available now
@@ -1078,9 +1098,23 @@ namespace karabo {
             EventLoop::addThread();
             std::this_thread::sleep_for(2000ms);
             EventLoop::removeThread();
-            std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-            KARABO_LOG_FRAMEWORK_DEBUG << "Available instances: " << m_trackedInstances;
-            return m_trackedInstances;
+            Hash result;
+            {
+                const auto now = steady_clock::now();
+                std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
+                for (const auto& idAndTracked : m_trackedInstances) {
+                    const TrackedInstance& tracked = idAndTracked.second;
+                    int countdown = tracked.countdown;
+                    if (tracked.timeoutId) { // Remaining ticks, rounded up
+                        const auto remaining = duration_cast<milliseconds>(tracked.deadline - now).count();
+                        const auto tick = duration_cast<milliseconds>(kCountdownTick).count();
+                        countdown = static_cast<int>(std::max(0l, (remaining + tick - 1l) / tick));
+                    }
+                    result.set(idAndTracked.first, Hash("instanceInfo", tracked.instanceInfo, "countdown", countdown));
+                }
+            }
+            KARABO_LOG_FRAMEWORK_DEBUG << "Available instances: " << result;
+            return result;
         }
 
 
@@ -1563,31 +1597,33 @@ namespace karabo {
             const int countdown = beatsNode->getValue<int>();
 
             std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-            boost::optional<Hash::Node&> node = m_trackedInstances.find(instanceId);
-            if (node) {
+            auto it = m_trackedInstances.find(instanceId);
+            if (it != m_trackedInstances.end()) {
                 // A known instance:
                 // We might be here from a heartbeat that sends incomplete instanceInfo, so merge what is available.
-                Hash& instanceHash = node->getValue<Hash>();
-                instanceHash.get<Hash>("instanceInfo").merge(instanceInfo);
-                instanceHash.set("countdown", countdown);
+                it->second.instanceInfo.merge(instanceInfo);
             } else {
                 // A new instance to be added
-                Hash h("instanceInfo", instanceInfo, "countdown", countdown);
-                m_trackedInstances.set(instanceId, std::move(h));
+                it = m_trackedInstances.emplace(instanceId, TrackedInstance{instanceInfo, 0, {}, 0ull, 0ull}).first;
             }
+            it->second.countdown = countdown;
+            scheduleTrackingTimeout(instanceId, it->second);
         }
 
 
         bool SignalSlotable::hasTrackedInstance(const std::string& instanceId) {
             std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-            return m_trackedInstances.has(instanceId);
+            return m_trackedInstances.find(instanceId) != m_trackedInstances.end();
         }
 
 
         bool SignalSlotable::eraseTrackedInstance(const std::string& instanceId) {
             bool wasTracked = false;
             std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-            if (m_trackedInstances.erase(instanceId)) {
+            auto it = m_trackedInstances.find(instanceId);
+            if (it != m_trackedInstances.end()) {
+                if (it->second.timeoutId) m_replyTimeouts->cancel(it->second.timeoutId);
+                m_trackedInstances.erase(it);
                 KARABO_LOG_FRAMEWORK_DEBUG << "Instance \"" << instanceId << "\" will not be tracked anymore";
                 wasTracked = true;
             }
@@ -1598,10 +1634,53 @@ namespace karabo {
         void SignalSlotable::updateTrackedInstanceInfo(const std::string& instanceId,
                                                        const karabo::data::Hash& instanceInfo) {
             std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-            if (m_trackedInstances.has(instanceId)) {
-                Hash& h = m_trackedInstances.get<Hash>(instanceId);
-                h.set("instanceInfo", instanceInfo);
-                h.set("countdown", instanceInfo.get<int>("heartbeatInterval"));
+            auto it = m_trackedInstances.find(instanceId);
+            if (it != m_trackedInstances.end()) {
+                it->second.instanceInfo = instanceInfo;
+                it->second.countdown = instanceInfo.get<int>("heartbeatInterval");
+                scheduleTrackingTimeout(instanceId, it->second);
+            }
+        }
+
+
+        void SignalSlotable::scheduleTrackingTimeout(const std::string& instanceId, TrackedInstance& tracked) {
+            // NOT: std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
+            //      As documented, that is callers responsibility.
+            if (tracked.timeoutId) {
+                m_replyTimeouts->cancel(tracked.timeoutId); // if too late, the handler will see the new generation
+                tracked.timeoutId = 0ull;
+            }
+            // A non-positive heartbeatInterval never times out
+            if (!m_trackAllInstances || tracked.countdown <= 0) return;
+
+            const milliseconds timeout(duration_cast<milliseconds>(tracked.countdown * kCountdownTick));
+            tracked.deadline = steady_clock::now() + timeout;
+            tracked.generation = ++m_trackingGeneration;
+            tracked.timeoutId = m_replyTimeouts->schedule(
+                  timeout, bind_weak(&SignalSlotable::instanceLostHeartbeat, this, instanceId, tracked.generation));
+        }
+
+
+        void SignalSlotable::instanceLostHeartbeat(const std::string& instanceId, unsigned long long generation) {
+            Hash instanceInfo;
+            {
+                std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
+                auto it = m_trackedInstances.find(instanceId);
+                if (it == m_trackedInstances.end() || it->second.generation != generation) {
+                    return; // Erased or a heartbeat arrived in between
+                }
+                it->second.timeoutId = 0ull;
+                instanceInfo = it->second.instanceInfo;
+            }
+            try {
+                KARABO_LOG_FRAMEWORK_WARN << m_instanceId << ": Instance \"" << instanceId
+                                          << "\" silently disappeared (no heartbeats received anymore)";
+                call(std::string(), "slotInstanceGone", instanceId, instanceInfo);
+                eraseTrackedInstance(instanceId);
+            } catch (const std::exception& e) {
+                KARABO_LOG_FRAMEWORK_ERROR << "instanceLostHeartbeat triggered an exception: " << e.what();
+            } catch (...) {
+                KARABO_LOG_FRAMEWORK_ERROR << "instanceLostHeartbeat triggered an unknown exception";
             }
         }
 
@@ -1745,8 +1824,6 @@ namespace karabo {
 
             std::lock_guard<std::mutex> lock(m_signalSlotInstancesMutex);
             m_slotInstances.erase(mangledSlotFunction);
-            // Will clean any associated timers to this slot
-            m_receiveAsyncErrorHandles.erase(mangledSlotFunction);
         }
 
 
@@ -1769,52 +1846,6 @@ namespace karabo {
         }
 
 
-        void SignalSlotable::letInstanceSlowlyDieWithoutHeartbeat(const boost::system::error_code& e) {
-            if (e) return;
-
-            try {
-                if (m_trackAllInstances) {
-                    vector<pair<string, Hash>> deadOnes;
-
-                    decreaseCountdown(deadOnes);
-
-                    for (size_t i = 0; i < deadOnes.size(); ++i) {
-                        KARABO_LOG_FRAMEWORK_WARN << m_instanceId << ": Instance \"" << deadOnes[i].first
-                                                  << "\" silently disappeared (no heartbeats received anymore)";
-                        call(std::string(), "slotInstanceGone", deadOnes[i].first, deadOnes[i].second);
-                        eraseTrackedInstance(deadOnes[i].first);
-                    }
-                }
-
-            } catch (const std::exception& e) {
-                KARABO_LOG_FRAMEWORK_ERROR << "letInstanceSlowlyDieWithoutHeartbeat triggered an exception: "
-                                           << e.what();
-            } catch (...) {
-                KARABO_LOG_FRAMEWORK_ERROR << "letInstanceSlowlyDieWithoutHeartbeat triggered an unknown exception";
-            }
-
-            // We are sleeping three times as long as the count-down ticks (which tick in seconds)
-            m_trackingTimer.expires_after(3s);
-            m_trackingTimer.async_wait(bind_weak(&karabo::xms::SignalSlotable::letInstanceSlowlyDieWithoutHeartbeat,
-                                                 this, boost::asio::placeholders::error));
-        }
-
-
-        void SignalSlotable::decreaseCountdown(std::vector<std::pair<std::string, karabo::data::Hash>>& deadOnes) {
-            std::lock_guard<std::mutex> lock(m_trackedInstancesMutex);
-
-            for (Hash::iterator it = m_trackedInstances.begin(); it != m_trackedInstances.end(); ++it) {
-                Hash& entry = it->getValue<Hash>();
-                int& countdown = entry.get<int>("countdown");
-                countdown--; // Regular count down
-
-                if (countdown == 0) { // Instance lost
-                    deadOnes.push_back(std::pair<string, Hash>(it->getKey(), entry.get<Hash>("instanceInfo")));
-                }
-            }
-        }
-
-
         void SignalSlotable::cleanSignals(const std::string& instanceId) {
             std::lock_guard<std::mutex> lock(m_signalSlotInstancesMutex);
 
@@ -2001,6 +2032,12 @@ namespace karabo {
         }
 
 
+        void SignalSlotable::registerTrainHandler(const std::string& channelName,
+                                                  const InputChannel::TrainHandler& handler) {
+            getInputChannel(channelName)->registerTrainHandler(handler);
+        }
+
+
         void SignalSlotable::connectInputChannels(const boost::system::error_code& e) {
             if (e) return; // cancelled
 
@@ -2484,13 +2521,13 @@ namespace karabo {
         }
 
 
-        bool SignalSlotable::hasReceivedReply(const std::string& replyId) const {
+        bool SignalSlotable::hasReceivedReply(unsigned long long replyId) const {
             std::lock_guard<std::mutex> lock(m_receivedRepliesMutex);
             return m_receivedReplies.find(replyId) != m_receivedReplies.end();
         }
 
 
-        void SignalSlotable::popReceivedReply(const std::string& replyId, karabo::data::Hash::Pointer& header,
+        void SignalSlotable::popReceivedReply(unsigned long long replyId, karabo::data::Hash::Pointer& header,
                                               karabo::data::Hash::Pointer& body) {
             std::lock_guard<std::mutex> lock(m_receivedRepliesMutex);
             ReceivedReplies::iterator it = m_receivedReplies.find(replyId);
@@ -2503,7 +2540,7 @@ namespace karabo {
         }
 
 
-        void SignalSlotable::registerSynchronousReply(const std::string& replyId) {
+        void SignalSlotable::registerSynchronousReply(unsigned long long replyId) {
             std::shared_ptr<BoostMutexCond> bmc = std::make_shared<BoostMutexCond>();
             {
                 std::lock_guard<std::mutex> lock(m_receivedRepliesBMCMutex);
@@ -2512,8 +2549,7 @@ namespace karabo {
         }
 
 
-        bool SignalSlotable::timedWaitAndPopReceivedReply(const std::string& replyId,
-                                                          karabo::data::Hash::Pointer& header,
+        bool SignalSlotable::timedWaitAndPopReceivedReply(unsigned long long replyId, karabo::data::Hash::Pointer& header,
                                                           karabo::data::Hash::Pointer& body, int timeout) {
             bool result = true;
             std::shared_ptr<BoostMutexCond> bmc;
@@ -2557,14 +2593,32 @@ namespace karabo {
         }
 
 
-        void SignalSlotable::receiveAsyncTimeoutHandler(const boost::system::error_code& e, const std::string& replyId,
-                                                        const SignalSlotable::AsyncErrorHandler& errorHandler) {
-            if (e) return; // Timer got cancelled.
+        unsigned long long SignalSlotable::nextReplyId() {
+            // Counter may wrap around - but not before all requests of that time are gone
+            return m_replyIdPrefix | m_replyIdCounter.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+
+        std::string SignalSlotable::replyIdToString(unsigned long long replyId) {
+            char buffer[16]; // 16 hex digits are enough for 64 bits
+            const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), replyId, 16);
+            return std::string(buffer, result.ptr);
+        }
 
-            // Remove the slot with function name replyId, as the message took too long
-            removeSlot(replyId);
-            std::string msg("Timeout of asynchronous request with id '" + replyId + "'");
-            if (errorHandler) {
+
+        bool SignalSlotable::replyIdFromString(const std::string& replyIdStr, unsigned long long& replyId) {
+            const char* const end = replyIdStr.data() + replyIdStr.size();
+            const std::from_chars_result result = std::from_chars(replyIdStr.data(), end, replyId, 16);
+            return (result.ec == std::errc() && result.ptr == end);
+        }
+
+
+        void SignalSlotable::receiveAsyncTimeoutHandler(unsigned long long replyId) {
+            const PendingReply pending = takePendingReply(replyId);
+            if (!pending.replySlot) return; // Reply came in the meantime
+
+            std::string msg("Timeout of asynchronous request with id '" + replyIdToString(replyId) + "'");
+            if (pending.errorHandler) {
                 try {
                     throw KARABO_TIMEOUT_EXCEPTION(msg);
                 } catch (const std::exception&) {
@@ -2572,7 +2626,7 @@ namespace karabo {
                     try {
                         // Now the errorHandler can do try { throw; } catch (catch karabo::data::TimeoutException& e)
                         // {...;}
-                        errorHandler();
+                        pending.errorHandler();
                         return;
                     } catch (const std::exception& e) {
                         (msg += ", but error handler throws exception: ") += e.what();
@@ -2583,22 +2637,32 @@ namespace karabo {
         }
 
 
-        void SignalSlotable::addReceiveAsyncErrorHandles(const std::string& replyId,
-                                                         const std::shared_ptr<boost::asio::steady_timer>& timer,
-                                                         const SignalSlotable::AsyncErrorHandler& errorHandler) {
-            std::lock_guard<std::mutex> lock(m_signalSlotInstancesMutex);
-            m_receiveAsyncErrorHandles[replyId] = std::make_pair(timer, errorHandler);
+        void SignalSlotable::addPendingReply(unsigned long long replyId, const SlotInstancePointer& replySlot,
+                                             const AsyncErrorHandler& errorHandler, int timeoutMs) {
+            // If timeout is not explicitely specified (default is zero), use the default timeout.
+            // Do not allow negative values either.
+            // Otherwise we have a little memory leak if the slotInstanceId is never responding, e.g.
+            // since no such instance exists...
+            const int timeout = (timeoutMs > 0 ? timeoutMs : Requestor::m_defaultAsyncTimeout);
+
+            std::lock_guard<std::mutex> lock(m_pendingRepliesMutex);
+            // Timeout is scheduled under the lock, but receiveAsyncTimeoutHandler has to lock as well, so it will
+            // find the entry
+            const TimerWheel::Id timeoutId = m_replyTimeouts->schedule(
+                  milliseconds(timeout), bind_weak(&SignalSlotable::receiveAsyncTimeoutHandler, this, replyId));
+            m_pendingReplies[replyId] = PendingReply{replySlot, errorHandler, timeoutId};
         }
 
 
-        std::pair<std::shared_ptr<boost::asio::steady_timer>, SignalSlotable::AsyncErrorHandler>
-        SignalSlotable::getReceiveAsyncErrorHandles(const std::string& replyId) const {
-            std::lock_guard<std::mutex> lock(m_signalSlotInstancesMutex);
-            auto it = m_receiveAsyncErrorHandles.find(replyId);
-            if (it != m_receiveAsyncErrorHandles.end()) {
-                return it->second;
+        SignalSlotable::PendingReply SignalSlotable::takePendingReply(unsigned long long replyId) {
+            std::lock_guard<std::mutex> lock(m_pendingRepliesMutex);
+            auto it = m_pendingReplies.find(replyId);
+            if (it == m_pendingReplies.end()) {
+                return PendingReply{SlotInstancePointer(), AsyncErrorHandler(), 0ull};
             }
-            return std::make_pair(std::shared_ptr<boost::asio::steady_timer>(), AsyncErrorHandler());
+            PendingReply result(std::move(it->second));
+            m_pendingReplies.erase(it);
+            return result;
         }
 
 
@@ -25,12 +25,22 @@
 #ifndef KARABO_CORE_SIGNALSLOTABLE_HH
 #define KARABO_CORE_SIGNALSLOTABLE_HH
 
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <boost/uuid/uuid.hpp>            // uuid class
 #include <boost/uuid/uuid_generators.hpp> // generators
 #include <boost/uuid/uuid_io.hpp>         // streaming operators etc.
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <map>
 #include <queue>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 
 #include "InputChannel.hh"
@@ -41,7 +51,9 @@
 #include "karabo/data/types/Hash.hh"
 #include "karabo/log/Logger.hh"
 #include "karabo/net/Broker.hh"
+#include "karabo/net/EventLoop.hh"
 #include "karabo/net/Strand.hh"
+#include "karabo/net/TimerWheel.hh"
 #include "karabo/net/utils.hh"
 #include "karabo/util/MetaTools.hh"
 #include "karabo/util/PackParameters.hh"
@@ -375,6 +387,23 @@ namespace karabo {
             SignalSlotable::Requestor requestNoWait(const std::string& requestInstanceId,
                                                     const std::string& requestFunctionName,
                                                     const std::string& replyFunctionName, const Args&... args);
+
+            /**
+             * Reply to the current slot call with the result of a coroutine.
+             * To be called inside a slot function instead of placing a reply.
+             *
+             * The coroutine is spawned on the event loop. When it returns, its result is replied: nothing for
+             * awaitable<void>, the elements of a std::tuple as separate arguments, or the single value otherwise.
+             * If it throws, an error is replied as for exceptions thrown inside a slot.
+             * Inside the coroutine, replies to requests can be awaited without blocking any thread, see
+             * Requestor::asyncReceive.
+             *
+             * As for AsyncReply, the coroutine must not use this SignalSlotable once it is (being) destructed.
+             *
+             * @param coroutine e.g. the result of calling a member function returning boost::asio::awaitable<Hash>
+             */
+            template <typename T>
+            void replyFromCoroutine(boost::asio::awaitable<T> coroutine);
             /**
              * Place the reply of a slot call
              *
@@ -514,6 +543,8 @@ namespace karabo {
 
             void registerEndOfStreamHandler(const std::string& channelName, const InputHandler& handler);
 
+            void registerTrainHandler(const std::string& channelName, const InputChannel::TrainHandler& handler);
+
             /**
              * Deprecated, use asyncConnectInputChannel!
              *
@@ -640,6 +671,23 @@ namespace karabo {
                 void receiveAsync(const std::function<void(const A1&, const A2&, const A3&, const A4&)>& replyCallback,
                                   const AsyncErrorHandler& errorHandlerHandler = AsyncErrorHandler());
 
+                /**
+                 * Asynchronously receive the reply - like receiveAsync, but completing an asio completion token
+                 * instead of calling callbacks. The completion signature is void(std::exception_ptr, Args...).
+                 * With the default token boost::asio::use_awaitable, the reply can be awaited inside a coroutine
+                 * (see SignalSlotable::replyFromCoroutine or boost::asio::co_spawn):
+                 *
+                 *   auto [config, id] = co_await request(deviceId, "slotGetConfiguration")
+                 *                             .timeout(1000)
+                 *                             .asyncReceive<Hash, std::string>();
+                 *
+                 * The coroutine is suspended without blocking a thread until the reply arrives. Failures (e.g.
+                 * timeout or remote exception) are thrown as the same exceptions that receiveAsync passes to its
+                 * error handler.
+                 */
+                template <typename... Args, typename CompletionToken = boost::asio::use_awaitable_t<>>
+                auto asyncReceive(CompletionToken&& token = CompletionToken());
+
                 template <typename... Args>
                 void receive(Args&... args);
 
@@ -670,8 +718,11 @@ namespace karabo {
                  */
                 std::pair<karabo::data::Hash::Pointer, karabo::data::Hash::Pointer> receiveResponseHashes();
 
-                /// Register handler for errors in async requests, e.g. timeout or remote exception
-                void registerErrorHandler(const AsyncErrorHandler& errorHandler);
+                /// Register reply and error handler (e.g. for timeout or remote exception) of an async request
+                /// and send the request
+                template <typename... Args>
+                void receiveAsyncImpl(const std::function<void(const Args&...)>& replyCallback,
+                                      const AsyncErrorHandler& errorHandler);
 
                 /**
                  * @brief Extracts the value of the SignalInstanceId path in a response header hash.
@@ -685,7 +736,7 @@ namespace karabo {
                 SignalSlotable* m_signalSlotable;
 
                private:
-                std::string m_replyId;
+                const unsigned long long m_replyId;
                 std::string m_slotInstanceId;
                 std::string m_slotFunction;
                 karabo::data::Hash::Pointer m_header;
@@ -715,10 +766,6 @@ namespace karabo {
             typedef std::map<std::string, SlotInstancePointer> SlotInstances;
             SlotInstances m_slotInstances;
 
-            typedef std::map<std::string, std::pair<std::shared_ptr<boost::asio::steady_timer>, AsyncErrorHandler>>
-                  ReceiveAsyncErrorHandles;
-            ReceiveAsyncErrorHandles m_receiveAsyncErrorHandles;
-
             // TODO Split into two mutexes
             mutable std::mutex m_signalSlotInstancesMutex;
 
@@ -737,35 +784,71 @@ namespace karabo {
 
             // Reply/Request related
 
-            // Map slot name and whether it was called globally
-            std::map<std::jthread::id, std::pair<std::string, bool>>
-                  m_currentSlots; // unordered? needs std::hash<std::jthread::id>...
-            mutable std::mutex m_currentSlotsMutex;
+            // Context of a slot call, lives on the stack of processSingleSlot while the slot functions are called.
+            // The innermost context of the current thread is m_currentSlotCall, so neither placing a reply nor
+            // creating an AsyncReply needs any lock.
+            struct SlotCallContext {
+                SlotCallContext(const SignalSlotable* signalSlotable, const std::string& slotFunction, bool globalCall,
+                                const karabo::data::Hash::Pointer& header);
+                ~SlotCallContext();
+
+                SlotCallContext(const SlotCallContext&) = delete;
+                SlotCallContext& operator=(const SlotCallContext&) = delete;
+
+                const SignalSlotable* const signalSlotable;
+                const std::string& slotFunction;
+                const bool globalCall;
+                const karabo::data::Hash::Pointer& header;
+                bool replyPlaced;
+                karabo::data::Hash::Pointer reply; // empty if AsyncReply takes care although replyPlaced is true
+                SlotCallContext* const outer;      // context of a slot call further up in the stack of this thread
+            };
+            static thread_local SlotCallContext* m_currentSlotCall;
 
             static std::mutex m_uuidGeneratorMutex;
             static boost::uuids::random_generator m_uuidGenerator;
 
-           protected:
-            typedef std::map<std::jthread::id, karabo::data::Hash::Pointer> Replies;
-            Replies m_replies;
-            mutable std::mutex m_replyMutex;
+            // Requests waiting for their reply via Requestor::receiveAsync, key is the reply id:
+            // A random prefix (high 32 bits) per instance and a counter (low 32 bits). On the wire (i.e. in the
+            // "replyTo"/"replyFrom" header entries) the id is hex-encoded.
+            struct PendingReply {
+                SlotInstancePointer replySlot; // unpacks the reply into the arguments of the reply handler
+                AsyncErrorHandler errorHandler;
+                karabo::net::TimerWheel::Id timeoutId;
+            };
+            const unsigned long long m_replyIdPrefix;
+            std::atomic<unsigned int> m_replyIdCounter;
+            std::unordered_map<unsigned long long, PendingReply> m_pendingReplies;
+            std::mutex m_pendingRepliesMutex;
+            // Timeouts of all pending replies (and of tracked instances), on the wheel shared via the event loop
+            karabo::net::TimerWheel::Pointer m_replyTimeouts;
 
+           protected:
             typedef std::pair<karabo::data::Hash::Pointer /*header*/, karabo::data::Hash::Pointer /*body*/> Event;
-            typedef std::map<std::string, Event> ReceivedReplies;
+            typedef std::unordered_map<unsigned long long, Event> ReceivedReplies;
             ReceivedReplies m_receivedReplies;
             mutable std::mutex m_receivedRepliesMutex;
 
-            typedef std::map<std::string, std::shared_ptr<BoostMutexCond>> ReceivedRepliesBMC;
+            typedef std::unordered_map<unsigned long long, std::shared_ptr<BoostMutexCond>> ReceivedRepliesBMC;
             ReceivedRepliesBMC m_receivedRepliesBMC;
             mutable std::mutex m_receivedRepliesBMCMutex;
 
-            karabo::data::Hash m_trackedInstances;
+            // Instances known via instanceNew, discovery or heartbeats. If tracking, each has a timeout on
+            // m_replyTimeouts that is rescheduled with every heartbeat, so only instances that are lost are visited.
+            struct TrackedInstance {
+                karabo::data::Hash instanceInfo;
+                int countdown;                                  // heartbeatInterval - lost after 3 s per count
+                std::chrono::steady_clock::time_point deadline; // when lost if timeoutId != 0
+                karabo::net::TimerWheel::Id timeoutId;          // 0 if no timeout scheduled
+                unsigned long long generation;                  // identifies the latest timeout
+            };
+            std::unordered_map<std::string, TrackedInstance> m_trackedInstances;
+            unsigned long long m_trackingGeneration;
             bool m_trackAllInstances;
             int m_heartbeatInterval;
 
             mutable std::mutex m_trackedInstancesMutex;
 
-            boost::asio::steady_timer m_trackingTimer;
             boost::asio::steady_timer m_heartbeatTimer;
             boost::asio::steady_timer m_performanceTimer;
 
@@ -882,7 +965,20 @@ namespace karabo {
             void replyException(const karabo::data::Hash& header, const std::string& message,
                                 const std::string& details);
 
-            void sendPotentialReply(const karabo::data::Hash& header, const std::string& slotFunction, bool global);
+            /**
+             * Send the reply to a slot call if it was requested
+             * @param header of the slot call message
+             * @param slotFunction name of the slot
+             * @param global whether slot was called globally
+             * @param replyPlaced whether a reply was placed (if not, an empty reply is sent to a request)
+             * @param replyBody the reply - if empty although replyPlaced is true, nothing is sent since AsyncReply
+             *                  takes care
+             */
+            void sendPotentialReply(const karabo::data::Hash& header, const std::string& slotFunction, bool global,
+                                    bool replyPlaced, const karabo::data::Hash::Pointer& replyBody);
+
+            /// Context of the slot of this instance that is currently called in this thread, nullptr if none
+            SlotCallContext* getCurrentSlotCall() const;
 
             /**
              * Internal method to provide info for AsyncReply object
@@ -951,9 +1047,14 @@ namespace karabo {
 
             void slotHeartbeat(const std::string& networkId, const karabo::data::Hash& heartbeatInfo);
 
-            void letInstanceSlowlyDieWithoutHeartbeat(const boost::system::error_code& e);
+            /**
+             * (Re-)schedule the timeout after which the instance is considered lost without further heartbeats.
+             * Requires m_trackedInstancesMutex to be locked.
+             */
+            void scheduleTrackingTimeout(const std::string& instanceId, TrackedInstance& tracked);
 
-            void decreaseCountdown(std::vector<std::pair<std::string, karabo::data::Hash>>& deadOnes);
+            /// Handler of the timeout scheduled by scheduleTrackingTimeout
+            void instanceLostHeartbeat(const std::string& instanceId, unsigned long long generation);
 
             // Thread safe
             void addTrackedInstance(const std::string& instanceId, const karabo::data::Hash& instanceInfo);
@@ -1028,30 +1129,37 @@ namespace karabo {
             bool tryToUnregisterSlot(const std::string& signalFunction, const std::string& slotInstanceId,
                                      const std::string& slotFunction);
 
-            bool hasReceivedReply(const std::string& replyFromValue) const;
+            bool hasReceivedReply(unsigned long long replyId) const;
 
-            void popReceivedReply(const std::string& replyFromValue, karabo::data::Hash::Pointer& header,
+            void popReceivedReply(unsigned long long replyId, karabo::data::Hash::Pointer& header,
                                   karabo::data::Hash::Pointer& body);
 
-            void registerSynchronousReply(const std::string& replyId);
+            void registerSynchronousReply(unsigned long long replyId);
 
-            bool timedWaitAndPopReceivedReply(const std::string& replyId, karabo::data::Hash::Pointer& header,
+            bool timedWaitAndPopReceivedReply(unsigned long long replyId, karabo::data::Hash::Pointer& header,
                                               karabo::data::Hash::Pointer& body, int timeout);
             long long getEpochMillis() const;
 
             void slotGetOutputChannelNames();
 
-            void receiveAsyncTimeoutHandler(const boost::system::error_code& e, const std::string& replyId,
-                                            const AsyncErrorHandler& errorHandler);
+            /// Create a new id for a request, unique within this instance
+            unsigned long long nextReplyId();
+
+            /// Convert reply id to the string that is sent as "replyTo" and comes back as "replyFrom"
+            static std::string replyIdToString(unsigned long long replyId);
+
+            /// Convert string from "replyFrom" header back to reply id, return false if not a valid id
+            static bool replyIdFromString(const std::string& replyIdStr, unsigned long long& replyId);
 
-            /// For the given replyId of a 'request.receiveAsync', register error handling,
-            /// i.e. the timer for timeout and the handler for remote exceptions.
-            void addReceiveAsyncErrorHandles(const std::string& replyId,
-                                             const std::shared_ptr<boost::asio::steady_timer>& timer,
-                                             const AsyncErrorHandler& errorHandler);
+            void receiveAsyncTimeoutHandler(unsigned long long replyId);
 
-            std::pair<std::shared_ptr<boost::asio::steady_timer>, AsyncErrorHandler> getReceiveAsyncErrorHandles(
-                  const std::string& replyId) const;
+            /// For the given replyId of a 'request.receiveAsync', register the reply handler (wrapped in a Slot),
+            /// the error handler for remote exceptions and the timeout
+            void addPendingReply(unsigned long long replyId, const SlotInstancePointer& replySlot,
+                                 const AsyncErrorHandler& errorHandler, int timeoutMs);
+
+            /// Remove the PendingReply of given replyId and return it - if there is none, its replySlot is empty
+            PendingReply takePendingReply(unsigned long long replyId);
 
             /// Helper that calls 'handler' such that it can do
             ///
@@ -1116,37 +1224,64 @@ namespace karabo {
         template <class A1>
         void SignalSlotable::Requestor::receiveAsync(const std::function<void(const A1&)>& replyCallback,
                                                      const AsyncErrorHandler& errorHandler) {
-            m_signalSlotable->registerSlot<A1>(replyCallback, m_replyId);
-            registerErrorHandler(errorHandler);
-            sendRequest();
+            receiveAsyncImpl<A1>(replyCallback, errorHandler);
         }
 
         template <class A1, class A2>
         void SignalSlotable::Requestor::receiveAsync(const std::function<void(const A1&, const A2&)>& replyCallback,
                                                      const AsyncErrorHandler& errorHandler) {
-            m_signalSlotable->registerSlot<A1, A2>(replyCallback, m_replyId);
-            registerErrorHandler(errorHandler);
-            sendRequest();
+            receiveAsyncImpl<A1, A2>(replyCallback, errorHandler);
         }
 
         template <class A1, class A2, class A3>
         void SignalSlotable::Requestor::receiveAsync(
               const std::function<void(const A1&, const A2&, const A3&)>& replyCallback,
               const AsyncErrorHandler& errorHandler) {
-            m_signalSlotable->registerSlot<A1, A2, A3>(replyCallback, m_replyId);
-            registerErrorHandler(errorHandler);
-            sendRequest();
+            receiveAsyncImpl<A1, A2, A3>(replyCallback, errorHandler);
         }
 
         template <class A1, class A2, class A3, class A4>
         void SignalSlotable::Requestor::receiveAsync(
               const std::function<void(const A1&, const A2&, const A3&, const A4&)>& replyCallback,
               const AsyncErrorHandler& errorHandler) {
-            m_signalSlotable->registerSlot<A1, A2, A3, A4>(replyCallback, m_replyId);
-            registerErrorHandler(errorHandler);
+            receiveAsyncImpl<A1, A2, A3, A4>(replyCallback, errorHandler);
+        }
+
+        template <typename... Args>
+        void SignalSlotable::Requestor::receiveAsyncImpl(const std::function<void(const Args&...)>& replyCallback,
+                                                         const AsyncErrorHandler& errorHandler) {
+            // The reply is not routed via a registered slot, but the Slot takes care to unpack the arguments
+            auto replySlot = std::make_shared<SlotN<void, Args...>>(SignalSlotable::replyIdToString(m_replyId));
+            replySlot->registerSlotFunction(replyCallback);
+            m_signalSlotable->addPendingReply(m_replyId, replySlot, errorHandler, m_timeout);
             sendRequest();
         }
 
+        template <typename... Args, typename CompletionToken>
+        auto SignalSlotable::Requestor::asyncReceive(CompletionToken&& token) {
+            static_assert(sizeof...(Args) <= 4, "Replies have up to four arguments");
+            // Copy of requestor since initiation may be deferred, e.g. for use_awaitable until co_await
+            auto initiation = [requestor = *this](auto handler) mutable {
+                // receiveAsync needs copyable callbacks, but handler may be move-only - share it: only one of the
+                // two callbacks is called
+                auto sharedHandler = std::make_shared<std::decay_t<decltype(handler)>>(std::move(handler));
+                auto complete = [sharedHandler](std::exception_ptr error, const Args&... args) {
+                    // Complete on the executor of the handler, e.g. that of the awaiting coroutine
+                    auto executor = boost::asio::get_associated_executor(*sharedHandler);
+                    boost::asio::dispatch(executor, [sharedHandler, error, args...]() mutable {
+                        std::move(*sharedHandler)(error, std::move(args)...);
+                    });
+                };
+                requestor.receiveAsync(
+                      std::function<void(const Args&...)>(
+                            [complete](const Args&... args) { complete(std::exception_ptr(), args...); }),
+                      // Error handler is called inside a catch block:
+                      [complete]() { complete(std::current_exception(), Args()...); });
+            };
+            return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, Args...)>(
+                  std::move(initiation), token);
+        }
+
         template <typename... Args>
         void SignalSlotable::Requestor::receive(Args&... args) {
             auto headerBodyPair = receiveResponseHashes();
@@ -1186,9 +1321,12 @@ namespace karabo {
             const data::Hash::ConstPointer& headerPtr = std::get<0>(m_slotInfo);
             if (!headerPtr) return;
 
-            // Place reply and send it
-            m_signalSlotable->reply(args...);
-            m_signalSlotable->sendPotentialReply(*headerPtr, std::get<1>(m_slotInfo), std::get<2>(m_slotInfo));
+            // Send reply directly - not via reply(..) that would place it for a slot that is possibly called in this
+            // thread right now
+            auto replyBody = std::make_shared<karabo::data::Hash>();
+            karabo::util::pack(*replyBody, args...);
+            m_signalSlotable->sendPotentialReply(*headerPtr, std::get<1>(m_slotInfo), std::get<2>(m_slotInfo), true,
+                                                 replyBody);
         }
 
         /**** SignalSlotable Template Function Implementations ****/
@@ -1230,6 +1368,38 @@ namespace karabo {
                                                                  args...);
         }
 
+        template <typename T>
+        void SignalSlotable::replyFromCoroutine(boost::asio::awaitable<T> coroutine) {
+            const AsyncReply aReply(this);
+            auto replyError = [aReply](std::exception_ptr error) {
+                try {
+                    std::rethrow_exception(error);
+                } catch (const karabo::data::Exception& e) {
+                    aReply.error(e.userFriendlyMsg(false), e.detailedMsg());
+                } catch (const std::exception& e) {
+                    aReply.error(e.what());
+                }
+            };
+            if constexpr (std::is_void_v<T>) {
+                boost::asio::co_spawn(karabo::net::EventLoop::getIOService(), std::move(coroutine),
+                                      [aReply, replyError](std::exception_ptr error) {
+                                          if (error) replyError(error);
+                                          else aReply();
+                                      });
+            } else {
+                boost::asio::co_spawn(karabo::net::EventLoop::getIOService(), std::move(coroutine),
+                                      [aReply, replyError](std::exception_ptr error, const T& result) {
+                                          if (error) {
+                                              replyError(error);
+                                          } else if constexpr (karabo::util::is_tuple<T>::value) {
+                                              std::apply(aReply, result);
+                                          } else {
+                                              aReply(result);
+                                          }
+                                      });
+            }
+        }
+
         template <typename... Args>
         void SignalSlotable::reply(const Args&... args) {
             karabo::data::Hash::Pointer hash = std::make_shared<karabo::data::Hash>();
@@ -1343,6 +1513,8 @@ namespace karabo {
 #define KARABO_ON_EOS(channelName, funcName)      \
     this->registerEndOfStreamHandler(channelName, \
                                      karabo::util::bind_weak(&Self::funcName, this, std::placeholders::_1));
+#define KARABO_ON_TRAIN(channelName, funcName) \
+    this->registerTrainHandler(channelName, karabo::util::bind_weak(&Self::funcName, this, std::placeholders::_1));
 
 #define _KARABO_SIGNAL_N(x0, x1, x2, x3, x4, x5, FUNC, ...) FUNC
 #define _KARABO_SLOT_N(x0, x1, x2, x3, x4, x5, FUNC, ...) FUNC
@@ -0,0 +1,125 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "TrainAligner.hh"
+
+#include <algorithm>
+#include <limits>
+
+using namespace karabo::data;
+using std::chrono::steady_clock;
+
+namespace karabo {
+    namespace xms {
+
+
+        TrainAligner::TrainAligner(const std::vector<std::string>& sources, unsigned int window,
+                                   std::chrono::milliseconds timeout, bool deliverIncomplete)
+            : m_sources(sources.begin(), sources.end()),
+              m_window(std::max(window, 1u)),
+              m_timeout(timeout),
+              m_deliverIncomplete(deliverIncomplete),
+              m_anyFinished(false),
+              m_lastFinished(0ull),
+              m_nComplete(0ull),
+              m_nIncomplete(0ull),
+              m_nLate(0ull) {}
+
+
+        void TrainAligner::add(const karabo::data::Hash::Pointer& data, const MetaData& metaData,
+                               std::vector<TrainData>& ready) {
+            const std::string& source = metaData.getSource();
+            if (m_sources.find(source) == m_sources.end()) return;
+
+            const unsigned long long trainId = metaData.getTimestamp().getTid();
+            if (m_anyFinished && trainId <= m_lastFinished) {
+                ++m_nLate;
+                return;
+            }
+
+            auto it = m_pending.find(trainId);
+            if (it == m_pending.end()) {
+                it = m_pending.emplace(trainId, PendingTrain{TrainData{trainId, false, {}}, steady_clock::now()}).first;
+            }
+            // If a source sends the same train twice, the first one wins
+            it->second.data.sources.emplace(source, std::make_pair(data, metaData));
+
+            if (it->second.data.sources.size() == m_sources.size()) {
+                finishUpTo(trainId, ready);
+            } else if (m_pending.size() > m_window) {
+                finishUpTo(m_pending.begin()->first, ready);
+            }
+        }
+
+
+        void TrainAligner::expire(std::chrono::steady_clock::time_point now, std::vector<TrainData>& ready) {
+            if (m_timeout.count() <= 0) return;
+            // Arrival times need not be ordered like train ids - finish up to the newest train that has expired
+            bool expired = false;
+            unsigned long long newestExpired = 0ull;
+            for (const auto& idAndTrain : m_pending) {
+                if (idAndTrain.second.arrival + m_timeout <= now) {
+                    expired = true;
+                    newestExpired = idAndTrain.first;
+                }
+            }
+            if (expired) finishUpTo(newestExpired, ready);
+        }
+
+
+        void TrainAligner::flush(std::vector<TrainData>& ready) {
+            finishUpTo(std::numeric_limits<unsigned long long>::max(), ready);
+            m_anyFinished = false;
+        }
+
+
+        std::chrono::steady_clock::time_point TrainAligner::nextExpiry() const {
+            steady_clock::time_point result = steady_clock::time_point::max();
+            if (m_timeout.count() > 0) {
+                for (const auto& idAndTrain : m_pending) {
+                    result = std::min(result, idAndTrain.second.arrival + m_timeout);
+                }
+            }
+            return result;
+        }
+
+
+        karabo::data::Hash TrainAligner::getStatistics() const {
+            return Hash("complete", m_nComplete.load(), "incomplete", m_nIncomplete.load(), "late", m_nLate.load());
+        }
+
+
+        void TrainAligner::finishUpTo(unsigned long long trainId, std::vector<TrainData>& ready) {
+            while (!m_pending.empty() && m_pending.begin()->first <= trainId) {
+                auto node = m_pending.extract(m_pending.begin());
+                TrainData& train = node.mapped().data;
+                train.complete = (train.sources.size() == m_sources.size());
+                if (train.complete) {
+                    ++m_nComplete;
+                } else {
+                    ++m_nIncomplete;
+                }
+                m_anyFinished = true;
+                m_lastFinished = node.key();
+                if (train.complete || m_deliverIncomplete) {
+                    ready.push_back(std::move(train));
+                }
+            }
+        }
+    } // namespace xms
+} // namespace karabo
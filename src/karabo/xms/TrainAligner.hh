@@ -0,0 +1,144 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_XMS_TRAINALIGNER_HH
+#define KARABO_XMS_TRAINALIGNER_HH
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Memory.hh"
+#include "karabo/data/types/ClassInfo.hh"
+#include "karabo/data/types/Hash.hh"
+
+namespace karabo {
+    namespace xms {
+
+        /**
+         * @class TrainAligner
+         * @brief Groups data items from several sources by train id
+         *
+         * Data of a train is collected until all expected sources have provided data for it. Since each source
+         * sends its data in increasing train id order, all older trains cannot become complete anymore once a train
+         * is complete, so they are given up as incomplete. Trains are also given up if more than 'window' trains are
+         * pending or if the first data of a train arrived more than 'timeout' ago.
+         * Trains are given out strictly in increasing train id order, data arriving for a train that is already
+         * given out (or given up) is dropped as late.
+         *
+         * Not thread safe, except for getStatistics().
+         */
+        class TrainAligner {
+           public:
+            KARABO_CLASSINFO(TrainAligner, "TrainAligner", "1.0")
+
+            typedef Memory::MetaData MetaData;
+
+            /**
+             * All data of one train
+             */
+            struct TrainData {
+                unsigned long long trainId;
+                /// false if not all expected sources have provided data
+                bool complete;
+                /// Data and its meta data per source - missing sources have no entry
+                std::map<std::string, std::pair<karabo::data::Hash::Pointer, MetaData>> sources;
+            };
+
+            /**
+             * Construct
+             *
+             * @param sources the data of which is expected for each train
+             * @param window maximum number of trains waiting to become complete
+             * @param timeout how long a train may wait to become complete, zero means no limit
+             * @param deliverIncomplete whether trains given up are given out nevertheless (or dropped)
+             */
+            TrainAligner(const std::vector<std::string>& sources, unsigned int window,
+                         std::chrono::milliseconds timeout, bool deliverIncomplete);
+
+            /**
+             * Add data - data of sources that are not expected is ignored
+             *
+             * @param data the data, not copied
+             * @param metaData its meta data, defines source and train id
+             * @param ready [out] trains that got ready to be given out are appended
+             */
+            void add(const karabo::data::Hash::Pointer& data, const MetaData& metaData, std::vector<TrainData>& ready);
+
+            /**
+             * Give up trains that have waited too long
+             *
+             * @param now current time
+             * @param ready [out] trains that got ready to be given out are appended
+             */
+            void expire(std::chrono::steady_clock::time_point now, std::vector<TrainData>& ready);
+
+            /**
+             * Give up all pending trains, e.g. at end of stream. Afterwards, train ids may start again from scratch.
+             *
+             * @param ready [out] trains that got ready to be given out are appended
+             */
+            void flush(std::vector<TrainData>& ready);
+
+            /**
+             * Time when the next pending train will have waited too long
+             *
+             * @return time_point::max() if no train is pending or there is no timeout
+             */
+            std::chrono::steady_clock::time_point nextExpiry() const;
+
+            /**
+             * Counters of trains given out (or dropped) since construction
+             *
+             * @return Hash with keys "complete" and "incomplete" (number of trains), "late" (number of data items
+             *         arriving for trains already given out) - all unsigned long long
+             */
+            karabo::data::Hash getStatistics() const;
+
+           private:
+            /**
+             * Give out all pending trains up to (and including) trainId
+             */
+            void finishUpTo(unsigned long long trainId, std::vector<TrainData>& ready);
+
+            struct PendingTrain {
+                TrainData data;
+                std::chrono::steady_clock::time_point arrival;
+            };
+
+            const std::set<std::string> m_sources;
+            const unsigned int m_window;
+            const std::chrono::milliseconds m_timeout;
+            const bool m_deliverIncomplete;
+
+            std::map<unsigned long long, PendingTrain> m_pending;
+            bool m_anyFinished;
+            unsigned long long m_lastFinished;
+
+            std::atomic<unsigned long long> m_nComplete;
+            std::atomic<unsigned long long> m_nIncomplete;
+            std::atomic<unsigned long long> m_nLate;
+        };
+    } // namespace xms
+} // namespace karabo
+
+#endif
@@ -449,30 +449,12 @@ void startAmqpMonitor(const std::vector<std::string>& brokers, const std::string
                       const data::TimeValue& interval) {
     net::AmqpConnection::Pointer connection(std::make_shared<net::AmqpConnection>(brokers));
 
-    // std::shared_ptr<BrokerStatistics> stats(std::make_shared<BrokerStatistics>(interval, receivers, senders));
-    // auto binSerializer = data::BinarySerializer<data::Hash>::create("Bin");
-
-    auto readHandler = [stats{std::make_shared<BrokerStatistics>(domain, interval, senders)},
-                        binSerializer{data::BinarySerializer<data::Hash>::create("Bin")}](
-                             const data::Hash::Pointer& header, const data::Hash::Pointer& body,
-                             const std::string& exchange, const std::string& routingKey) {
-        // `BrokerStatistics' expects the message formatted as a Hash: with 'header' as Hash and 'body' as Hash with the
-        // single key 'raw' as vector<char> which is the serialized 'body' value.
-        // If the incoming 'body' does not contain a proper 'raw' key, serialize the body part.
-        size_t bodySize = 0;
-        if (body->has("raw") && body->is<std::vector<char>>("raw")) {
-            bodySize = body->get<std::vector<char>>("raw").size();
-        } else {
-            std::vector<char> raw;
-            raw.reserve(1000);
-            binSerializer->save(body, raw); // body -> raw
-            bodySize = raw.size();
-        }
-        stats->registerMessage(exchange, routingKey, header, bodySize);
-    };
+    // Only the header is needed for statistics: the body is not deserialised, only its size is used
+    net::AmqpHashClient::LazyReadHandler readHandler =
+          [stats{std::make_shared<BrokerStatistics>(domain, interval, senders)}](
+                const data::Hash::Pointer& header, const net::LazyHashBody::Pointer& body, const std::string& exchange,
+                const std::string& routingKey) { stats->registerMessage(exchange, routingKey, header, body->size()); };
 
-    // FIXME: Add a 'skipFlag' to client to skip deserialisation of message body.
-    //        If done, can get rid of the serializer above.
     AMQP::Table queueArgs;
     queueArgs
           .set("x-max-length", 10'000)    // Queue limit
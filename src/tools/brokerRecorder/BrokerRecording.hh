@@ -0,0 +1,90 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef KARABO_TOOLS_BROKERRECORDING_HH
+#define KARABO_TOOLS_BROKERRECORDING_HH
+
+#include <string>
+#include <vector>
+
+#include "karabo/data/types/Exception.hh"
+#include "karabo/data/types/Hash.hh"
+
+/**
+ * @brief Block of broker messages as recorded by karabo-brokerrecord and replayed by karabo-brokerreplay
+ *
+ * A recording is a binary Hash file with record index (see BinaryFileOutput), each record is one block.
+ * Messages are kept as the raw AMQP payload (serialised header and body) together with their exchange,
+ * routing key and the time they were received, so a block of many small messages is stored compactly
+ * and the index allows to jump to any block without reading the file before.
+ */
+struct BrokerRecordingBlock {
+    std::string domain;                         // the domain that was recorded
+    std::vector<std::string> exchanges;         // per message, with domain as prefix
+    std::vector<std::string> routingKeys;       // per message
+    std::vector<unsigned long long> timestamps; // per message, microseconds since the epoch
+    std::vector<unsigned long long> sizes;      // per message, size of its payload
+    std::vector<char> payloads;                 // all payloads, one after another
+
+    void add(const std::string& exchange, const std::string& routingKey, unsigned long long timestamp,
+             const std::vector<char>& payload) {
+        exchanges.push_back(exchange);
+        routingKeys.push_back(routingKey);
+        timestamps.push_back(timestamp);
+        sizes.push_back(payload.size());
+        payloads.insert(payloads.end(), payload.begin(), payload.end());
+    }
+
+    size_t size() const {
+        return exchanges.size();
+    }
+
+    void clear() {
+        exchanges.clear();
+        routingKeys.clear();
+        timestamps.clear();
+        sizes.clear();
+        payloads.clear();
+    }
+
+    karabo::data::Hash toHash() const {
+        return karabo::data::Hash("domain", domain, "exchanges", exchanges, "routingKeys", routingKeys,
+                                  "timestamps", timestamps, "sizes", sizes, "payloads", payloads);
+    }
+
+    /// Inverse of toHash(), moves the vectors out of 'hash'
+    void fromHash(karabo::data::Hash& hash) {
+        domain = hash.get<std::string>("domain");
+        exchanges = std::move(hash.get<std::vector<std::string>>("exchanges"));
+        routingKeys = std::move(hash.get<std::vector<std::string>>("routingKeys"));
+        timestamps = std::move(hash.get<std::vector<unsigned long long>>("timestamps"));
+        sizes = std::move(hash.get<std::vector<unsigned long long>>("sizes"));
+        payloads = std::move(hash.get<std::vector<char>>("payloads"));
+        if (routingKeys.size() != exchanges.size() || timestamps.size() != exchanges.size() ||
+            sizes.size() != exchanges.size()) {
+            throw KARABO_IO_EXCEPTION("Inconsistent number of messages in recorded block");
+        }
+        unsigned long long total = 0ull;
+        for (unsigned long long size : sizes) total += size;
+        if (total != payloads.size()) {
+            throw KARABO_IO_EXCEPTION("Inconsistent size of payloads in recorded block");
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,280 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <unistd.h>
+
+#include <array>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <karabo/data/io/Output.hh>
+#include <karabo/data/time/Epochstamp.hh>
+#include <karabo/data/types/Hash.hh>
+#include <karabo/log/Logger.hh>
+#include <karabo/net/AmqpConnection.hh>
+#include <karabo/net/AmqpHashClient.hh>
+#include <karabo/net/Broker.hh>
+#include <karabo/net/EventLoop.hh>
+#include <karabo/net/utils.hh>
+#include <memory>
+#include <mutex>
+
+#include "BrokerRecording.hh"
+
+using namespace karabo;
+
+
+/**
+ * Collects the messages into blocks and writes each block when full or old enough
+ */
+class BrokerRecorder : public std::enable_shared_from_this<BrokerRecorder> {
+   public:
+    BrokerRecorder(const std::string& filename, const std::string& domain, size_t blockSize,
+                   unsigned int blockSeconds)
+        : m_output(data::Configurator<data::Output<data::Hash>>::create(
+                "BinaryFile", data::Hash("filename", filename, "writeMode", "exclusive", "format", "Bin",
+                                         "recordIndex", true, "enableAppendMode", true))),
+          m_blockSize(blockSize),
+          m_blockMicroseconds(blockSeconds * 1'000'000ull),
+          m_blockTimer(net::EventLoop::getIOService()),
+          m_numMessages(0ull),
+          m_numBytes(0ull),
+          m_numBlocks(0ull) {
+        m_block.domain = domain;
+    }
+
+    void record(const std::string& exchange, const std::string& routingKey, const std::vector<char>& payload) {
+        const unsigned long long timestamp = nowMicroseconds();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_block.add(exchange, routingKey, timestamp, payload);
+        ++m_numMessages;
+        m_numBytes += payload.size();
+        if (m_block.size() >= m_blockSize || timestamp - m_block.timestamps.front() >= m_blockMicroseconds) {
+            writeBlock();
+        } else if (m_block.size() == 1) {
+            // First message of a block: write the block when it gets too old, even if no further message comes
+            armBlockTimer(m_blockMicroseconds);
+        }
+    }
+
+    /// Write what is not yet written - to be called at the end
+    void flush() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_blockTimer.cancel();
+        writeBlock();
+    }
+
+    void printSummary(std::ostream& out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out << "Recorded " << m_numMessages << " messages with " << m_numBytes << " bytes in " << m_numBlocks
+            << " blocks." << std::endl;
+    }
+
+   private:
+    static unsigned long long nowMicroseconds() {
+        const data::Epochstamp now;
+        return now.getSeconds() * 1'000'000ull + now.getFractionalSeconds() / 1'000'000'000'000ull;
+    }
+
+    /// Requires m_mutex to be locked
+    void armBlockTimer(unsigned long long microseconds) {
+        m_blockTimer.expires_after(std::chrono::microseconds(microseconds));
+        m_blockTimer.async_wait([weakSelf{weak_from_this()}](const boost::system::error_code& ec) {
+            if (ec) return;
+            if (auto self = weakSelf.lock()) self->onBlockTimer();
+        });
+    }
+
+    void onBlockTimer() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_block.size() == 0) return; // written meanwhile since full
+        // A timer of an already written block may have fired just before the next block started
+        const unsigned long long age = nowMicroseconds() - m_block.timestamps.front();
+        if (age >= m_blockMicroseconds) {
+            writeBlock();
+        } else {
+            armBlockTimer(m_blockMicroseconds - age);
+        }
+    }
+
+    /// Requires m_mutex to be locked
+    void writeBlock() {
+        m_blockTimer.cancel(); // re-armed with the first message of the next block
+        if (m_block.size() == 0) return;
+        m_output->write(m_block.toHash());
+        m_output->update(); // (re-)writes the index: the file is complete after every block
+        m_block.clear();
+        ++m_numBlocks;
+    }
+
+    std::mutex m_mutex;
+    data::Output<data::Hash>::Pointer m_output;
+    BrokerRecordingBlock m_block;
+    const size_t m_blockSize;
+    const unsigned long long m_blockMicroseconds;
+    boost::asio::steady_timer m_blockTimer;
+    unsigned long long m_numMessages;
+    unsigned long long m_numBytes;
+    unsigned long long m_numBlocks;
+};
+
+
+void printHelp(const char* name) {
+    // Get name without leading directories
+    std::string nameStr(name ? name : "'command'");
+    const std::string::size_type lastSlashPos = nameStr.find_last_of('/');
+    if (lastSlashPos != std::string::npos) {
+        nameStr.replace(0, lastSlashPos + 1, "");
+    }
+    std::cout << "\n  " << nameStr << " [-h|--help] [options with values] file\n\n"
+              << "Records all messages sent to the broker into a new binary file that can be\n"
+              << "replayed with karabo-brokerreplay. Messages are kept as they were sent\n"
+              << "(i.e. serialised) together with exchange, routing key and time of receipt,\n"
+              << "in blocks of messages that are indexed at the end of the file.\n"
+              << "Broker host and topic are read from the usual environment variables\n"
+              << "KARABO_BROKER and KARABO_BROKER_TOPIC or, if these are not defined, use the\n"
+              << "usual defaults. Recording stops with Ctrl-C.\n"
+              << "Available options:\n"
+              << "   --blockSize n                Maximum number of messages per block (default: 1000)\n"
+              << "   --blockSeconds s             Maximum seconds until a block is written (default: 5)\n"
+              << "   --duration s                 Stop after s seconds (default: 0, i.e. never)\n"
+              << std::endl;
+}
+
+
+void startAmqpRecorder(const std::vector<std::string>& brokers, const std::string& domain,
+                       const std::shared_ptr<BrokerRecorder>& recorder) {
+    net::AmqpConnection::Pointer connection(std::make_shared<net::AmqpConnection>(brokers));
+
+    // The header is deserialised to read the message at all, but the body is not needed
+    net::AmqpHashClient::LazyReadHandler readHandler =
+          [recorder](const data::Hash::Pointer& header, const net::LazyHashBody::Pointer& body,
+                     const std::string& exchange, const std::string& routingKey) {
+              recorder->record(exchange, routingKey, *body->message());
+          };
+
+    AMQP::Table queueArgs;
+    queueArgs
+          .set("x-max-length", 100'000)   // Queue limit - larger than for other tools: do not miss bursts
+          .set("x-overflow", "drop-head") // drop oldest if limit reached
+          .set("x-message-ttl", 30'000);  // message time-to-live in ms
+    std::ostringstream idStr;
+    idStr << domain << ".messageRecorder/" << karabo::net::bareHostName() << "/" << getpid();
+    net::AmqpHashClient::Pointer client =
+          net::AmqpHashClient::create(connection, idStr.str(), queueArgs, readHandler, [](const std::string& msg) {
+              std::cerr << "Error reading message, not recorded: " << msg << std::endl;
+          });
+    std::promise<boost::system::error_code> isConnected;
+    auto futConnected = isConnected.get_future();
+    connection->asyncConnect([&isConnected](const boost::system::error_code& ec) { isConnected.set_value(ec); });
+    const boost::system::error_code ec = futConnected.get();
+    if (ec) {
+        throw KARABO_NETWORK_EXCEPTION("Broker connection failed: " + ec.message());
+    }
+
+    // Bind to all possible messages
+    const std::vector<std::array<std::string, 2>> defaultTable = {
+          {domain + ".Signals", "#"},     // any INSTANCE, any SIGNAL
+          {domain + ".Slots", "#"},       // any INSTANCE, any direct slot call
+          {domain + ".Global_Slots", "#"} // any INSTANCE, any broadcast slot
+    };
+    std::vector<std::future<boost::system::error_code>> futures;
+    for (const auto& a : defaultTable) {
+        auto done = std::make_shared<std::promise<boost::system::error_code>>();
+        futures.push_back(done->get_future());
+        client->asyncSubscribe(a[0], a[1],
+                               [done{std::move(done)}](const boost::system::error_code& ec) { done->set_value(ec); });
+    }
+    for (auto& fut : futures) {
+        const boost::system::error_code ec = fut.get();
+        if (ec) {
+            throw KARABO_NETWORK_EXCEPTION(std::string("Failed to subscribe to AMQP broker: ") += ec.message());
+        }
+    }
+    std::cout << "\nStart recording messages of\n   domain        '" << domain << "'\n   on broker     '"
+              << connection->getCurrentUrl() << "'." << std::endl;
+
+    // Block until interrupted or stopped after duration
+    net::EventLoop::work();
+}
+
+
+int main(int argc, const char** argv) {
+    net::EventLoop::addThread(2);
+
+    // Setup option defaults
+    data::Hash options("--blockSize", "1000", "--blockSeconds", "5", "--duration", "0");
+    std::string filename;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string argv_i(argv[i]);
+        if (argv_i == "-h" || argv_i == "--help") {
+            printHelp(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (argc == i + 1) {
+            // The last of an odd number of arguments is the file
+            filename = argv_i;
+        } else if (!options.has(argv_i)) {
+            printHelp(argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            options.set(argv_i, argv[i + 1]);
+        }
+    }
+    if (filename.empty()) {
+        printHelp(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Start Logger, but suppress INFO and DEBUG
+    log::Logger::configure(data::Hash("level", "WARN"));
+    log::Logger::useConsole();
+
+    const std::string topic(net::Broker::brokerDomainFromEnv());
+    const std::vector<std::string> brokers(net::Broker::brokersFromEnv());
+
+    try {
+        const std::string brkType = net::Broker::brokerTypeFrom(brokers);
+        if (brkType != "amqp") {
+            throw KARABO_NOT_IMPLEMENTED_EXCEPTION(brkType + " not supported!");
+        }
+        auto recorder = std::make_shared<BrokerRecorder>(
+              filename, topic, data::fromString<size_t>(options.get<std::string>("--blockSize")),
+              data::fromString<unsigned int>(options.get<std::string>("--blockSeconds")));
+
+        const unsigned int duration = data::fromString<unsigned int>(options.get<std::string>("--duration"));
+        boost::asio::steady_timer timer(net::EventLoop::getIOService());
+        if (duration > 0u) {
+            timer.expires_after(std::chrono::seconds(duration));
+            timer.async_wait([](const boost::system::error_code& ec) {
+                if (!ec) net::EventLoop::stop();
+            });
+        }
+
+        startAmqpRecorder(brokers, topic, recorder);
+
+        recorder->flush();
+        recorder->printSummary(std::cout);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
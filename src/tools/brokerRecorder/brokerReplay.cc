@@ -0,0 +1,219 @@
+/*
+ * This file is part of Karabo.
+ *
+ * http://www.karabo.eu
+ *
+ * Copyright (C) European XFEL GmbH Schenefeld. All rights reserved.
+ *
+ * Karabo is free software: you can redistribute it and/or modify it under
+ * the terms of the MPL-2 Mozilla Public License.
+ *
+ * You should have received a copy of the MPL-2 Public License along with
+ * Karabo. If not, see <https://www.mozilla.org/en-US/MPL/2.0/>.
+ *
+ * Karabo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <karabo/data/io/Input.hh>
+#include <karabo/data/types/Hash.hh>
+#include <karabo/log/Logger.hh>
+#include <karabo/net/AmqpConnection.hh>
+#include <karabo/net/AmqpHashClient.hh>
+#include <karabo/net/Broker.hh>
+#include <karabo/net/EventLoop.hh>
+#include <karabo/net/utils.hh>
+#include <memory>
+#include <thread>
+
+#include "BrokerRecording.hh"
+
+using namespace karabo;
+
+
+void printHelp(const char* name) {
+    // Get name without leading directories
+    std::string nameStr(name ? name : "'command'");
+    const std::string::size_type lastSlashPos = nameStr.find_last_of('/');
+    if (lastSlashPos != std::string::npos) {
+        nameStr.replace(0, lastSlashPos + 1, "");
+    }
+    std::cout << "\n  " << nameStr << " [-h|--help] [options with values] file\n\n"
+              << "Replays the messages recorded by karabo-brokerrecord into the broker, in the\n"
+              << "order and with the time intervals they were recorded with, scaled by 'speed'.\n"
+              << "The messages are sent to the domain given by KARABO_BROKER_TOPIC (or its\n"
+              << "defaults), not to the recorded one. Broker host is read from KARABO_BROKER.\n"
+              << "Finally, the achieved rates and how far replay was behind schedule are printed.\n"
+              << "Available options:\n"
+              << "   --speed x                    Replay x times faster than recorded, 0 means as\n"
+              << "                                   fast as possible (default: 1)\n"
+              << "   --window n                   Maximum number of messages sent, but not yet\n"
+              << "                                   confirmed as published (default: 1000)\n"
+              << std::endl;
+}
+
+
+int main(int argc, const char** argv) {
+    net::EventLoop::addThread(2);
+
+    // Setup option defaults
+    data::Hash options("--speed", "1", "--window", "1000");
+    std::string filename;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string argv_i(argv[i]);
+        if (argv_i == "-h" || argv_i == "--help") {
+            printHelp(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (argc == i + 1) {
+            // The last of an odd number of arguments is the file
+            filename = argv_i;
+        } else if (!options.has(argv_i)) {
+            printHelp(argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            options.set(argv_i, argv[i + 1]);
+        }
+    }
+    if (filename.empty()) {
+        printHelp(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Start Logger, but suppress INFO and DEBUG
+    log::Logger::configure(data::Hash("level", "WARN"));
+    log::Logger::useConsole();
+
+    const std::string domain(net::Broker::brokerDomainFromEnv());
+    const std::vector<std::string> brokers(net::Broker::brokersFromEnv());
+
+    try {
+        const double speed = data::fromString<double>(options.get<std::string>("--speed"));
+        const unsigned int window = std::max(1u, data::fromString<unsigned int>(options.get<std::string>("--window")));
+        if (speed < 0.) {
+            throw KARABO_PARAMETER_EXCEPTION("Speed must not be negative");
+        }
+        const std::string brkType = net::Broker::brokerTypeFrom(brokers);
+        if (brkType != "amqp") {
+            throw KARABO_NOT_IMPLEMENTED_EXCEPTION(brkType + " not supported!");
+        }
+
+        // Blocks are deserialised only when needed - the next ones in the background
+        data::Input<data::Hash>::Pointer input = data::Configurator<data::Input<data::Hash>>::create(
+              "BinaryFile", data::Hash("filename", filename, "format", "Bin", "memoryMapped", true, "prefetch", 2u));
+        const size_t numBlocks = input->size();
+
+        net::AmqpConnection::Pointer connection(std::make_shared<net::AmqpConnection>(brokers));
+        AMQP::Table queueArgs;
+        queueArgs.set("x-max-length", 1'000).set("x-overflow", "drop-head").set("x-message-ttl", 30'000);
+        std::ostringstream idStr;
+        idStr << domain << ".messageReplay/" << karabo::net::bareHostName() << "/" << getpid();
+        // Never subscribes, so the handlers are not called
+        net::AmqpHashClient::Pointer client = net::AmqpHashClient::create(
+              connection, idStr.str(), queueArgs,
+              [](const data::Hash::Pointer&, const net::LazyHashBody::Pointer&, const std::string&,
+                 const std::string&) {},
+              [](const std::string&) {});
+        std::promise<boost::system::error_code> isConnected;
+        auto futConnected = isConnected.get_future();
+        connection->asyncConnect([&isConnected](const boost::system::error_code& ec) { isConnected.set_value(ec); });
+        const boost::system::error_code ec = futConnected.get();
+        if (ec) {
+            throw KARABO_NETWORK_EXCEPTION("Broker connection failed: " + ec.message());
+        }
+        std::cout << "\nStart replaying " << numBlocks << " blocks of messages from '" << filename
+                  << "'\n   into domain   '" << domain << "'\n   on broker     '" << connection->getCurrentUrl()
+                  << "',\n   speed is      " << (speed > 0. ? data::toString(speed) : std::string("maximum")) << "."
+                  << std::endl;
+
+        // Publishing is confirmed in the io context of the connection - do not block there, but wait here
+        std::atomic<unsigned int> pending(0u);
+        std::atomic<unsigned long long> numFailed(0ull);
+        auto onPublished = [&pending, &numFailed](const boost::system::error_code& ec) {
+            if (ec) ++numFailed;
+            pending.fetch_sub(1u);
+            pending.notify_one();
+        };
+
+        unsigned long long numMessages = 0ull;
+        unsigned long long numBytes = 0ull;
+        std::chrono::microseconds maxLag(0);
+        // Time since the first message, advanced only by the positive steps between messages: if the recording
+        // clock stepped backwards, the unsigned difference to the first timestamp would be huge
+        unsigned long long recordedOffset = 0ull;
+        unsigned long long previousTimestamp = 0ull;
+        const auto start = std::chrono::steady_clock::now();
+        data::Hash blockHash;
+        BrokerRecordingBlock block;
+        for (size_t iBlock = 0; iBlock < numBlocks; ++iBlock) {
+            input->read(blockHash, iBlock);
+            block.fromHash(blockHash);
+            const std::string recordedPrefix(block.domain + ".");
+            size_t offset = 0;
+            for (size_t i = 0; i < block.size(); ++i) {
+                const unsigned long long timestamp = block.timestamps[i];
+                if (numMessages > 0ull && timestamp > previousTimestamp) {
+                    recordedOffset += timestamp - previousTimestamp;
+                }
+                previousTimestamp = timestamp;
+                if (speed > 0.) {
+                    const auto due =
+                          start + std::chrono::microseconds(static_cast<long long>(recordedOffset / speed));
+                    const auto now = std::chrono::steady_clock::now();
+                    if (now < due) {
+                        std::this_thread::sleep_until(due);
+                    } else {
+                        maxLag = std::max(maxLag, std::chrono::duration_cast<std::chrono::microseconds>(now - due));
+                    }
+                }
+                unsigned int nowPending = pending.load();
+                while (nowPending >= window) {
+                    pending.wait(nowPending);
+                    nowPending = pending.load();
+                }
+
+                const std::string& exchange = block.exchanges[i];
+                const std::string replayExchange(exchange.starts_with(recordedPrefix)
+                                                       ? (domain + ".") += exchange.substr(recordedPrefix.size())
+                                                       : exchange);
+                auto payload = std::make_shared<std::vector<char>>(block.payloads.begin() + offset,
+                                                                   block.payloads.begin() + offset + block.sizes[i]);
+                offset += block.sizes[i];
+                ++pending;
+                client->asyncPublishRaw(replayExchange, block.routingKeys[i], payload, onPublished);
+                ++numMessages;
+                numBytes += payload->size();
+            }
+        }
+        for (unsigned int nowPending = pending.load(); nowPending > 0u; nowPending = pending.load()) {
+            pending.wait(nowPending);
+        }
+
+        const double seconds =
+              std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() /
+              1.e6;
+        std::cout << std::setprecision(2) << std::fixed << "\nReplayed " << numMessages << " messages with "
+                  << numBytes / 1.e6 << " MB in " << seconds << " s, i.e. "
+                  << (seconds > 0. ? numMessages / seconds : 0.) << " Hz and "
+                  << (seconds > 0. ? numBytes / 1.e6 / seconds : 0.) << " MB/s.\n";
+        if (speed > 0.) {
+            std::cout << "Maximum delay behind schedule was " << maxLag.count() / 1.e3 << " ms.\n";
+        }
+        if (numFailed > 0ull) {
+            std::cout << numFailed << " messages failed to be published.\n";
+        }
+        std::cout << std::flush;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
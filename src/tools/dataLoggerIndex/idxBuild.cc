@@ -17,10 +17,12 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/predicate.hpp>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
+#include <mutex>
 #include "karabo/data/io/TextSerializer.hh"
 #include <karabo/util/DataLogUtils.hh>
 #include "karabo/data/time/Epochstamp.hh"
@@ -28,6 +30,7 @@
 #include "karabo/data/types/Schema.hh"
 #include <boost/regex.hpp>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 namespace bf = std::filesystem;
@@ -36,7 +39,8 @@ using namespace karabo::util;
 using namespace karabo::data;
 using namespace karabo::data;
 
-static std::map<string, MetaData::Pointer> idxMap;
+// Serialises console output of the worker threads
+static std::mutex coutMutex;
 
 
 struct SchemaHistoryRange {
@@ -50,11 +54,69 @@ struct SchemaHistoryRange {
     std::string toSchemaArchive;
 };
 
-static SchemaHistoryRange schemaRange;
+/**
+ * Follows the schema history file while an archive file is processed.
+ * Each worker thread has its own instance since archive files are processed in parallel and in no particular order.
+ * The schema is only deserialised when it is needed for a record.
+ */
+class SchemaTracker {
+   public:
+    SchemaTracker(const std::string& schemaFile)
+        : m_sfs(schemaFile.c_str()), m_serializer(TextSerializer<Schema>::create(Hash("Xml"))), m_loaded(false) {
+        readEntry(m_range.fromSeconds, m_range.fromFraction, m_range.fromTrainId, m_range.fromSchemaArchive);
+        readEntry(m_range.toSeconds, m_range.toFraction, m_range.toTrainId, m_range.toSchemaArchive);
+    }
+
+    const Schema& schemaFor(const Epochstamp& epstamp) {
+        while (epstamp.getSeconds() > m_range.toSeconds ||
+               (epstamp.getSeconds() == m_range.toSeconds && epstamp.getFractionalSeconds() > m_range.toFraction)) {
+            if (m_sfs.fail()) break;
+            m_range.fromSeconds = m_range.toSeconds;
+            m_range.fromFraction = m_range.toFraction;
+            m_range.fromTrainId = m_range.toTrainId;
+            m_range.fromSchemaArchive.swap(m_range.toSchemaArchive);
+            readEntry(m_range.toSeconds, m_range.toFraction, m_range.toTrainId, m_range.toSchemaArchive);
+            m_loaded = false;
+        }
+        if (!m_loaded) {
+            m_schema = Schema();
+            m_serializer->load(m_schema, m_range.fromSchemaArchive);
+            m_loaded = true;
+        }
+        return m_schema;
+    }
+
+   private:
+    void readEntry(unsigned long long& seconds, unsigned long long& fraction, unsigned long long& trainId,
+                   std::string& archive) {
+        m_sfs >> seconds >> fraction >> trainId;
+        m_sfs.seekg(1, ios::cur); // skip 'space' character
+        getline(m_sfs, archive, '\n');
+    }
+
+    ifstream m_sfs;
+    SchemaHistoryRange m_range;
+    TextSerializer<Schema>::Pointer m_serializer;
+    Schema m_schema;
+    bool m_loaded;
+};
+
+/**
+ * Checkpoint of an archive file: for each property the byte offset in the archive file up to which its index file
+ * is complete and the size of the index file at that point. Stored as lines "<offset> <indexSize> <property>" in
+ * 'idx/archive_<number>-checkpoint.txt'.
+ */
+struct IndexCheckpointEntry {
+    unsigned long long archiveOffset;
+    unsigned long long indexSize;
+};
+typedef std::map<std::string, IndexCheckpointEntry> IndexCheckpoint;
 
 bool byLastFileModificationTime(const bf::path& lhs, const bf::path& rhs);
-void processNextFile(const std::string& deviceId, size_t number, const std::string& historyDir, std::ifstream& schema,
-                     bool contentFlag, const std::vector<std::string>& properties);
+size_t processNextFile(const std::string& deviceId, size_t number, const std::string& historyDir, bool contentFlag,
+                       const std::vector<std::string>& properties, std::string& contentEntries);
+IndexCheckpoint readCheckpoint(const std::string& checkpointFile);
+void writeCheckpoint(const std::string& checkpointFile, const IndexCheckpoint& checkpoint);
 
 
 void findDevices(const std::string& root, const std::string& prefix, std::vector<std::string>& devices) {
@@ -93,20 +155,31 @@ void findDevices(const std::string& root, const std::string& prefix, std::vector
  */
 int main(int argc, char** argv) {
     if (argc < 2) {
-        cout << "\nUsage: " << argv[0] << " <karabo_history_dir> [deviceId [property [filenum]]]\n" << endl;
+        cout << "\nUsage: " << argv[0] << " <karabo_history_dir> [deviceId [property [filenum|first:last]]]\n"
+             << endl;
         return 1;
     }
 
     string karaboHistory(argv[1]);
     string requestedDeviceId = ""; // means "all devices found in karaboHistory"
     string requestedProperty = ""; // means "all registered properties"
-    int requestedFilenum = -1;     // means "all file numbers found in raw subdirectory"
+    int firstFilenum = -1;         // -1 for both means "all file numbers found in raw subdirectory"
+    int lastFilenum = -1;
 
     if (argc > 2) {
         requestedDeviceId.assign(argv[2]);
         if (argc > 3) {
             requestedProperty.assign(argv[3]);
-            if (argc > 4) requestedFilenum = fromString<int>(string(argv[4]));
+            if (argc > 4) {
+                const string filenums(argv[4]);
+                const size_t colon = filenums.find(':');
+                if (colon == string::npos) {
+                    firstFilenum = lastFilenum = fromString<int>(filenums);
+                } else {
+                    firstFilenum = fromString<int>(filenums.substr(0, colon));
+                    lastFilenum = fromString<int>(filenums.substr(colon + 1));
+                }
+            }
         }
     }
 
@@ -114,7 +187,8 @@ int main(int argc, char** argv) {
     cout << "\nInput parameters are ...\n\tkaraboHistory =\t\"" << karaboHistory << "\"\n"
          << "\tdeviceId =\t\"" << requestedDeviceId << "\"\n"
          << "\tproperty =\t\"" << requestedProperty << "\"\n"
-         << "\tfile_num =\t\"" << requestedFilenum << "\"\n"
+         << "\tfile_num =\t\"" << firstFilenum << (lastFilenum != firstFilenum ? ":" + toString(lastFilenum) : "")
+         << "\"\n"
          << endl;
 
     bf::path history(karaboHistory);
@@ -177,8 +251,10 @@ int main(int argc, char** argv) {
             throw KARABO_PARAMETER_EXCEPTION("File \"" + rawdir.string() + "\" is not a directory!");
 
         bf::path idxdir(karaboHistory + "/" + deviceId + "/idx");
+        if (!bf::exists(idxdir)) bf::create_directories(idxdir);
     }
 
+    int ret = 0;
     cout << devices.size() << " devices to process found... process only properties that require indexing ..." << endl;
 
     for (vector<string>::const_iterator it = devices.begin(); it != devices.end(); ++it) {
@@ -237,34 +313,60 @@ int main(int argc, char** argv) {
 
         cout << "Process the device : \"" << deviceId << "\"" << endl;
 
-        ifstream sfs(schemaPath.c_str());
-        {
-            sfs >> schemaRange.fromSeconds >> schemaRange.fromFraction >> schemaRange.fromTrainId;
-            sfs.seekg(1, ios::cur); // skip 'space' character
-            getline(sfs, schemaRange.fromSchemaArchive, '\n');
-        }
-        {
-            sfs >> schemaRange.toSeconds >> schemaRange.toFraction >> schemaRange.toTrainId;
-            sfs.seekg(1, ios::cur);
-            getline(sfs, schemaRange.toSchemaArchive, '\n');
-        }
-
-        string pattern = "archive_";
         // Process most recent file first as it is most likely what is needed
         // first from user that triggers indexing
+        string pattern = "archive_";
+        vector<size_t> filenums;
         for (vector<bf::path>::reverse_iterator i = rawtxt.rbegin(); i != rawtxt.rend(); ++i) {
             // extract filenum from file name
             int filenum = fromString<size_t>(i->filename().stem().string().substr(pattern.size()));
-            if (requestedFilenum < 0 || requestedFilenum == filenum) {
-                cout << "\tFile : " << i->filename() << endl;
-                processNextFile(deviceId, filenum, karaboHistory, sfs, buildContentFile, idxprops);
+            if (firstFilenum < 0 || (filenum >= firstFilenum && filenum <= lastFilenum)) {
+                filenums.push_back(filenum);
             }
         }
 
-        sfs.close();
+        // Archive files are independent of each other, so index them in parallel. The number of threads is limited
+        // to not have too many jobs accessing the disk at the same time.
+        const size_t numThreads = std::min<size_t>({std::max(1u, std::thread::hardware_concurrency()), 8u,
+                                                    std::max<size_t>(1u, filenums.size())});
+        vector<string> contentEntries(filenums.size());
+        std::atomic<size_t> nextJob(0);
+        std::atomic<size_t> numFailed(0);
+        auto worker = [&]() {
+            for (size_t job = nextJob++; job < filenums.size(); job = nextJob++) {
+                try {
+                    const size_t numRecords = processNextFile(deviceId, filenums[job], karaboHistory,
+                                                              buildContentFile, idxprops, contentEntries[job]);
+                    std::lock_guard<std::mutex> lock(coutMutex);
+                    cout << "\tFile : archive_" << filenums[job] << ".txt, " << numRecords << " records indexed"
+                         << endl;
+                } catch (const std::exception& e) {
+                    ++numFailed;
+                    std::lock_guard<std::mutex> lock(coutMutex);
+                    cout << "*** idxBuild: failed to process archive_" << filenums[job] << ".txt : " << e.what()
+                         << endl;
+                }
+            }
+        };
+        vector<std::thread> threads;
+        for (size_t i = 1; i < numThreads; ++i) threads.emplace_back(worker);
+        worker();
+        for (std::thread& t : threads) t.join();
+
+        if (buildContentFile) {
+            // Content file entries have to be in chronological order, i.e. ordered by file number
+            vector<size_t> order(filenums.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            sort(order.begin(), order.end(), [&filenums](size_t a, size_t b) { return filenums[a] < filenums[b]; });
+            ofstream ocs(cfile.c_str(), ios::out | ios::app);
+            for (size_t i : order) ocs << contentEntries[i];
+            ocs.close();
+        }
+
+        if (numFailed > 0) ret = 1;
     }
 
-    return 0;
+    return ret;
 }
 
 
@@ -273,31 +375,114 @@ bool byLastFileModificationTime(const bf::path& lhs, const bf::path& rhs) {
 }
 
 
-void processNextFile(const std::string& deviceId, size_t number, const std::string& historyDir, ifstream& sfs,
-                     bool buildContent, const vector<string>& idxprops) {
-    TextSerializer<Schema>::Pointer serializer = TextSerializer<Schema>::create(Hash("Xml"));
-    Schema::Pointer schema(new Schema);
-    serializer->load(*schema, schemaRange.fromSchemaArchive);
+IndexCheckpoint readCheckpoint(const std::string& checkpointFile) {
+    IndexCheckpoint checkpoint;
+    ifstream in(checkpointFile.c_str());
+    string line;
+    while (getline(in, line)) {
+        // Lines not matching the format are ignored, i.e. that property is indexed from scratch
+        std::istringstream iss(line);
+        IndexCheckpointEntry entry;
+        string property;
+        if (iss >> entry.archiveOffset >> entry.indexSize >> property) checkpoint[property] = entry;
+    }
+    return checkpoint;
+}
+
+
+void writeCheckpoint(const std::string& checkpointFile, const IndexCheckpoint& checkpoint) {
+    // Write to a temporary file first so that an interrupted run never leaves a truncated checkpoint
+    const string tmpFile(checkpointFile + ".tmp");
+    {
+        ofstream out(tmpFile.c_str(), ios::out | ios::trunc);
+        for (IndexCheckpoint::const_iterator it = checkpoint.begin(); it != checkpoint.end(); ++it) {
+            out << it->second.archiveOffset << " " << it->second.indexSize << " " << it->first << "\n";
+        }
+        if (!out) throw KARABO_IO_EXCEPTION("Failed to write checkpoint file '" + tmpFile + "'");
+    }
+    bf::rename(tmpFile, checkpointFile);
+}
+
+
+size_t processNextFile(const std::string& deviceId, size_t number, const std::string& historyDir, bool buildContent,
+                       const vector<string>& idxprops, std::string& contentEntries) {
+    const string infile = historyDir + "/" + deviceId + "/raw/archive_" + toString(number) + ".txt";
+    const string idxPrefix = historyDir + "/" + deviceId + "/idx/archive_" + toString(number) + "-";
+    const string checkpointFile = idxPrefix + "checkpoint.txt";
+    const unsigned long long fileSize = bf::file_size(infile);
+
+    // Properties whose index is not complete yet and the offset in the archive file to resume from. Index records
+    // before that offset were written by a previous run.
+    IndexCheckpoint checkpoint = readCheckpoint(checkpointFile);
+    std::map<string, unsigned long long> resumeFrom;
+    for (const string& property : idxprops) {
+        if (property.empty()) continue;
+        IndexCheckpoint::iterator it = checkpoint.find(property);
+        if (it == checkpoint.end()) {
+            resumeFrom[property] = 0ull;
+            continue;
+        }
+        if (it->second.archiveOffset >= fileSize) continue;
+        // A previous run may have been interrupted after appending records beyond the checkpoint: cut them off.
+        // If the index file is shorter than recorded, it cannot be trusted at all and is rebuilt.
+        const string idxFile = idxPrefix + property + "-index.bin";
+        std::error_code ec;
+        const unsigned long long idxSize = bf::file_size(idxFile, ec); // no file yet if no record so far
+        if ((ec ? 0ull : idxSize) < it->second.indexSize) {
+            it->second = IndexCheckpointEntry{0ull, 0ull};
+        } else if (!ec && idxSize > it->second.indexSize) {
+            bf::resize_file(idxFile, it->second.indexSize);
+        }
+        resumeFrom[property] = it->second.archiveOffset;
+    }
+    if (resumeFrom.empty() && !buildContent) return 0; // all indices up to date
+
+    // The content file needs all LOGIN/LOGOUT events, so then scan the full file
+    unsigned long long startOffset = fileSize;
+    for (std::map<string, unsigned long long>::const_iterator it = resumeFrom.begin(); it != resumeFrom.end(); ++it) {
+        startOffset = std::min(startOffset, it->second);
+    }
+    if (buildContent) startOffset = 0;
+
+    SchemaTracker schemaTracker(historyDir + "/" + deviceId + "/raw/archive_schema.txt");
     boost::regex lineRegex(karabo::util::DATALOG_LINE_REGEX, boost::regex::extended);
+    std::map<string, MetaData::Pointer> idxMap;
+    for (std::map<string, unsigned long long>::const_iterator it = resumeFrom.begin(); it != resumeFrom.end(); ++it) {
+        if (it->second > 0 && it->second == startOffset) {
+            // Resuming right after the last indexed record: there is no pending marker from events before
+            MetaData::Pointer& mdp = idxMap[it->first];
+            mdp = MetaData::Pointer(new MetaData);
+            mdp->idxFile = idxPrefix + it->first + "-index.bin";
+            mdp->marker = false;
+        }
+    }
 
-    string infile = historyDir + "/" + deviceId + "/raw/archive_" + toString(number) + ".txt";
     ifstream irs(infile.c_str());
-    bool newFileFlag = true;
+    irs.seekg(startOffset);
+    bool newFileFlag = (startOffset == 0);
     unsigned int expNum = 0x0F0A1A2A;
     unsigned int runNum = 0x0F0B1B2B;
 
     size_t recnum = 0;
+    size_t numIndexed = 0;
+    unsigned long long endOffset = startOffset; // end of the last complete line
 
     while (irs.good()) {
         string line;
         std::istream::pos_type position = irs.tellg();
 
         if (getline(irs, line)) {
+            if (irs.eof()) {
+                // No trailing newline: the DataLogger is still writing this record, leave it for the next run
+                break;
+            }
+            endOffset = irs.tellg();
             if (line.empty() || position == -1) {
                 // Skips the writing of the index entry if the log
                 // entry to be indexed was empty or its position in
                 // the log file could not be obtained.
                 if (position == -1) {
+                    std::lock_guard<std::mutex> lock(coutMutex);
                     cout << "Skip processing of record " << recnum + 1 << " of file '" << infile << "':\n"
                          << "\tProcessing that record would result on an entry with position -1 in the "
                             "archive_index.txt file"
@@ -308,6 +493,7 @@ void processNextFile(const std::string& deviceId, size_t number, const std::stri
             boost::smatch tokens;
             bool search_res = boost::regex_search(line, tokens, lineRegex);
             if (!search_res) {
+                std::lock_guard<std::mutex> lock(coutMutex);
                 cout << "*** idxBuild: skip corrupted record : line = " << line << ", token.size() = " << tokens.size()
                      << endl;
                 continue; // This record is corrupted -- skip it
@@ -324,34 +510,10 @@ void processNextFile(const std::string& deviceId, size_t number, const std::stri
             const string& user = tokens[7];
             const string& flag = tokens[8];
 
-            const Epochstamp epstamp(karabo::util::stringDoubleToEpochstamp(epochDoubleStr));
-
-            // cout << "*** " << recnum << " *** "
-            //         "\t" << "position in input : " << position << ", epoch: " << seconds << "." << fraction << endl;
-
-            while (epstamp.getSeconds() > schemaRange.toSeconds ||
-                   (epstamp.getSeconds() == schemaRange.toSeconds &&
-                    epstamp.getFractionalSeconds() > schemaRange.toFraction)) {
-                if (sfs.fail()) break;
-                schemaRange.fromSeconds = schemaRange.toSeconds;
-                schemaRange.fromFraction = schemaRange.toFraction;
-                schemaRange.fromTrainId = schemaRange.toTrainId;
-                schemaRange.fromSchemaArchive = schemaRange.toSchemaArchive;
-                sfs >> schemaRange.toSeconds >> schemaRange.toFraction >> schemaRange.toTrainId;
-                sfs.seekg(1, ios::cur);
-                getline(sfs, schemaRange.toSchemaArchive, '\n');
-                schema = Schema::Pointer(new Schema);
-                serializer->load(*schema, schemaRange.fromSchemaArchive);
-            }
-            // cout << "*** Current schema for range from " << schemaRange.fromSeconds << "." <<
-            // schemaRange.fromFraction
-            //         << " to " << schemaRange.toSeconds << "." << schemaRange.toFraction << endl;
-
             if ((flag == "LOGIN" || flag == "LOGOUT" || newFileFlag)) {
                 newFileFlag = false;
                 if (buildContent) {
-                    string contentFile = historyDir + "/" + deviceId + "/raw/archive_index.txt";
-                    ofstream ocs(contentFile.c_str(), ios::out | ios::app);
+                    std::ostringstream ocs;
                     if (flag == "LOGIN") ocs << "+LOG ";
                     else if (flag == "LOGOUT") ocs << "-LOG ";
                     else ocs << "=NEW ";
@@ -359,13 +521,9 @@ void processNextFile(const std::string& deviceId, size_t number, const std::stri
                     ocs << epochISO8601 << " " << epochDoubleStr << " "
                         << " " << trainIdStr << " " << position << " " << (user.empty() ? "." : user) << " " << number
                         << "\n";
-
-                    ocs.close();
+                    contentEntries += ocs.str();
                 }
 
-                // cout << epochISO8601 << " " << epochDouble << " " << trainIdStr
-                //         << " " << position << " " << user << " " << number << endl;
-
                 if (flag == "LOGOUT") {
                     map<string, MetaData::Pointer>::iterator ii = idxMap.begin();
                     while (ii != idxMap.end()) {
@@ -388,22 +546,27 @@ void processNextFile(const std::string& deviceId, size_t number, const std::stri
 
             if (property == ".") continue;
 
-            // check if we have any property registered
-            if (idxprops.empty()) continue; // no interest for building binary index
-            if (find(idxprops.begin(), idxprops.end(), property) == idxprops.end())
-                continue; // property is not in the prop file
+            // check if we have any property to index in this file
+            std::map<string, unsigned long long>::const_iterator resumeIt = resumeFrom.find(property);
+            if (resumeIt == resumeFrom.end()) continue;
 
             // Check if we need to build index for this property by inspecting schema ... checking only existence
-            if (schema->has(property)) {
+            const Epochstamp epstamp(karabo::util::stringDoubleToEpochstamp(epochDoubleStr));
+            if (schemaTracker.schemaFor(epstamp).has(property)) {
                 MetaData::Pointer& mdp = idxMap[property]; // Pointer by reference!
                 if (!mdp) {
                     // a property not yet indexed - create meta data and set file
                     mdp = MetaData::Pointer(new MetaData);
-                    mdp->idxFile = historyDir + "/" + deviceId + "/idx/archive_" + toString(number) + "-" + property +
-                                   "-index.bin";
+                    mdp->idxFile = idxPrefix + property + "-index.bin";
+                }
+                if (static_cast<unsigned long long>(position) < resumeIt->second) {
+                    // Already indexed by a previous run - just consume the marker
+                    mdp->marker = false;
+                    continue;
                 }
                 if (!mdp->idxStream.is_open()) {
-                    mdp->idxStream.open(mdp->idxFile.c_str(), ios::out | ios::trunc | ios::binary);
+                    const ios::openmode mode = (resumeIt->second > 0 ? ios::app : ios::trunc);
+                    mdp->idxStream.open(mdp->idxFile.c_str(), ios::out | mode | ios::binary);
                 }
                 mdp->record.epochstamp = fromString<double>(epochDoubleStr);
                 mdp->record.trainId = fromString<unsigned long long>(trainIdStr);
@@ -415,13 +578,29 @@ void processNextFile(const std::string& deviceId, size_t number, const std::stri
                     mdp->record.extent2 |= (1 << 30);
                 }
                 mdp->idxStream.write((char*)&mdp->record, sizeof(MetaData::Record));
+                ++numIndexed;
             }
         }
     }
     if (irs.is_open()) irs.close();
     for (map<string, MetaData::Pointer>::iterator ii = idxMap.begin(); ii != idxMap.end(); ++ii) {
         MetaData::Pointer mdp = ii->second;
-        if (mdp && mdp->idxStream.is_open()) mdp->idxStream.close();
+        if (mdp && mdp->idxStream.is_open()) {
+            mdp->idxStream.close();
+            if (mdp->idxStream.fail()) throw KARABO_IO_EXCEPTION("Failed to write index file '" + mdp->idxFile + "'");
+        }
     }
-    idxMap.clear();
+
+    // Remember how far the indices are complete - a later run for a new property or for a file that is still growing
+    // then only has to scan from there
+    for (std::map<string, unsigned long long>::const_iterator it = resumeFrom.begin(); it != resumeFrom.end(); ++it) {
+        IndexCheckpointEntry& entry = checkpoint[it->first];
+        entry.archiveOffset = std::max(it->second, endOffset);
+        std::error_code ec;
+        const unsigned long long idxSize = bf::file_size(idxPrefix + it->first + "-index.bin", ec);
+        entry.indexSize = (ec ? 0ull : idxSize);
+    }
+    if (!resumeFrom.empty()) writeCheckpoint(checkpointFile, checkpoint);
+
+    return numIndexed;
 }